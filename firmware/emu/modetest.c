@@ -0,0 +1,630 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#if !defined(WINDOWS)
+    #include <unistd.h>
+    #include <sys/wait.h>
+#endif
+#include "rawdraw/os_generic.h"
+#include "swadgemu.h"
+#include "replay.h"
+#include "modetest.h"
+#include "user_main.h"
+#include "buttons.h"
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+// Every mode starts from the same random state
+#define TEST_SEED 0x5AD6E
+
+// The script repeats with this period, and each press is held this long
+#define TEST_SCRIPT_PERIOD_MS 4000
+#define TEST_PRESS_MS 100
+
+// Microphone samples generated every main loop pass
+#define TEST_SAMPLES_PER_PASS ((DFREQ * EMU_VIRTUAL_STEP_US) / 1000000)
+
+/*============================================================================
+ * Structs
+ *==========================================================================*/
+
+typedef struct
+{
+    uint32_t timeMs;
+    button_num button;
+} testPress_t;
+
+/// A frame hash, which holds until the next one's frame
+typedef struct
+{
+    uint32_t frame;
+    uint32_t hash;
+} testHash_t;
+
+/// The run length encoded hashes of every frame of a mode
+typedef struct
+{
+    bool present;
+    char name[32];
+    uint32_t numFrames;
+    testHash_t* hashes;
+    uint32_t numHashes;
+    uint32_t maxHashes;
+} testRun_t;
+
+/// What a mode's run measured, besides its hashes
+typedef struct
+{
+    double hostTime;
+    uint32_t bytesFlushed;
+    uint32_t maxBytes;
+} testStats_t;
+
+/*============================================================================
+ * Variables
+ *==========================================================================*/
+
+/// Button presses, relative to the start of each script period
+static const testPress_t testScript[] =
+{
+    { 500,  ACTION }, // Usually starts the first item of the mode's menu
+    { 1000, RIGHT  },
+    { 1250, RIGHT  },
+    { 1500, UP     },
+    { 2000, LEFT   },
+    { 2250, DOWN   },
+    { 2500, ACTION },
+    { 3000, DOWN   },
+    { 3250, LEFT   },
+    { 3500, UP     },
+};
+
+/// The notes of the synthetic microphone tone, one per virtual second
+static const float testNotesHz[] = { 220.0f, 277.2f, 329.6f, 440.0f };
+
+static bool testRunning = false;
+static testRun_t* testCur = NULL;
+static double testMicPhase = 0;
+static uint32_t testLastBytes = 0;
+static uint32_t testMaxBytes = 0;
+
+/*============================================================================
+ * Internal Functions
+ *==========================================================================*/
+
+/**
+ * Add a frame's hash to a run, if it's different from the prior frame's
+ *
+ * @param run  The run to add to
+ * @param hash The hash of the next frame
+ */
+static void testAddHash( testRun_t* run, uint32_t hash )
+{
+    if( run->numHashes && run->hashes[run->numHashes - 1].hash == hash )
+    {
+        run->numFrames++;
+        return;
+    }
+    if( run->numHashes == run->maxHashes )
+    {
+        run->maxHashes = run->maxHashes ? run->maxHashes * 2 : 64;
+        run->hashes = realloc( run->hashes, run->maxHashes * sizeof( testHash_t ) );
+    }
+    run->hashes[run->numHashes].frame = run->numFrames++;
+    run->hashes[run->numHashes].hash = hash;
+    run->numHashes++;
+}
+
+/**
+ * Find the first frame where two runs differ
+ *
+ * @param a A run
+ * @param b Another run
+ * @return The first differing frame, or -1 if they match
+ */
+static int32_t testFirstMismatch( const testRun_t* a, const testRun_t* b )
+{
+    uint32_t ai = 0, bi = 0;
+    uint32_t numFrames = ( a->numFrames > b->numFrames ) ? a->numFrames : b->numFrames;
+    for( uint32_t frame = 0; frame < numFrames; frame++ )
+    {
+        if( frame >= a->numFrames || frame >= b->numFrames )
+        {
+            return frame;
+        }
+        while( ai + 1 < a->numHashes && a->hashes[ai + 1].frame <= frame )
+        {
+            ai++;
+        }
+        while( bi + 1 < b->numHashes && b->hashes[bi + 1].frame <= frame )
+        {
+            bi++;
+        }
+        if( a->hashes[ai].hash != b->hashes[bi].hash )
+        {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Hash assets.bin, which what's drawn depends on
+ *
+ * @return The hash, or 0 if assets.bin couldn't be read
+ */
+static uint32_t testHashAssets( void )
+{
+    FILE* f = fopen( "assets.bin", "rb" );
+    if( !f )
+    {
+        return 0;
+    }
+    fseek( f, 0, SEEK_END );
+    long len = ftell( f );
+    fseek( f, 0, SEEK_SET );
+    uint8_t* data = malloc( len );
+    uint32_t hash = 0;
+    if( 1 == fread( data, len, 1, f ) )
+    {
+        hash = emuReplayHashFb( data, len );
+    }
+    free( data );
+    fclose( f );
+    return hash;
+}
+
+/**
+ * Load golden hashes
+ *
+ * @param fname      The file to load
+ * @param runs       The runs to load into, indexed by mode
+ * @param numModes   The number of modes
+ * @param assetsHash Written with the hash of the assets.bin they were written
+ *                   with, or 0 if it isn't in the file
+ * @return true if the file was loaded, false if it couldn't be opened
+ */
+static bool testLoadGolden( const char* fname, testRun_t* runs, uint8_t numModes, uint32_t* assetsHash )
+{
+    FILE* f = fopen( fname, "r" );
+    if( !f )
+    {
+        return false;
+    }
+
+    char line[128];
+    testRun_t* run = NULL;
+    *assetsHash = 0;
+    while( fgets( line, sizeof( line ), f ) )
+    {
+        unsigned int mode, a, b;
+        char name[32];
+        if( 1 == sscanf( line, "assets %x", &a ) )
+        {
+            *assetsHash = a;
+        }
+        else if( 3 == sscanf( line, "mode %u %u %31[^\n]", &mode, &a, name ) )
+        {
+            run = ( mode < numModes ) ? &runs[mode] : NULL;
+            if( run )
+            {
+                run->present = true;
+                strcpy( run->name, name );
+            }
+        }
+        else if( run && 2 == sscanf( line, "%u %x", &a, &b ) )
+        {
+            // Fill in frames up to this one with the prior hash
+            while( run->numHashes && run->numFrames < a )
+            {
+                testAddHash( run, run->hashes[run->numHashes - 1].hash );
+            }
+            testAddHash( run, b );
+        }
+        else if( run && 1 == sscanf( line, "end %u", &a ) )
+        {
+            while( run->numHashes && run->numFrames < a )
+            {
+                testAddHash( run, run->hashes[run->numHashes - 1].hash );
+            }
+        }
+    }
+    fclose( f );
+    return true;
+}
+
+/**
+ * Save golden hashes
+ *
+ * @param fname      The file to write
+ * @param runs       The runs to save, indexed by mode
+ * @param numModes   The number of modes
+ * @param seconds    The virtual seconds each mode was run for
+ * @param assetsHash The hash of the assets.bin they were written with
+ * @return true if the file was written, false if it couldn't be opened
+ */
+static bool testSaveGolden( const char* fname, const testRun_t* runs, uint8_t numModes, uint32_t seconds,
+                            uint32_t assetsHash )
+{
+    FILE* f = fopen( fname, "w" );
+    if( !f )
+    {
+        return false;
+    }
+
+    fprintf( f, "# swadgemu mode test golden framebuffer hashes, %u virtual s per mode\n", seconds );
+    fprintf( f, "# Each hash holds from its frame until the next hash's frame\n" );
+    fprintf( f, "assets %08x\n", assetsHash );
+    for( uint8_t m = 0; m < numModes; m++ )
+    {
+        fprintf( f, "mode %u %u %s\n", m, runs[m].numFrames, runs[m].name );
+        for( uint32_t i = 0; i < runs[m].numHashes; i++ )
+        {
+            fprintf( f, "%u %08x\n", runs[m].hashes[i].frame, runs[m].hashes[i].hash );
+        }
+        fprintf( f, "end %u\n", runs[m].numFrames );
+    }
+    fclose( f );
+    return true;
+}
+
+/**
+ * Press and release buttons according to the script
+ *
+ * @param timeMs   The virtual time since the mode started
+ * @param allowAct false to skip ACTION presses
+ */
+static void testScriptInput( uint32_t timeMs, bool allowAct )
+{
+    uint32_t t = timeMs % TEST_SCRIPT_PERIOD_MS;
+    for( uint8_t i = 0; i < sizeof( testScript ) / sizeof( testScript[0] ); i++ )
+    {
+        if( ACTION == testScript[i].button && !allowAct )
+        {
+            continue;
+        }
+        if( t == testScript[i].timeMs )
+        {
+            emuSetButtonStatus( testScript[i].button, true );
+        }
+        else if( t == testScript[i].timeMs + TEST_PRESS_MS )
+        {
+            emuSetButtonStatus( testScript[i].button, false );
+        }
+    }
+}
+
+/**
+ * Generate one main loop pass of the microphone tone
+ *
+ * @param timeMs The virtual time since the mode started
+ */
+static void testMicInput( uint32_t timeMs )
+{
+    uint8_t samples[TEST_SAMPLES_PER_PASS];
+    float hz = testNotesHz[( timeMs / 1000 ) % ( sizeof( testNotesHz ) / sizeof( testNotesHz[0] ) )];
+    for( uint16_t i = 0; i < TEST_SAMPLES_PER_PASS; i++ )
+    {
+        samples[i] = 128 + (int)( 64 * sin( testMicPhase ) );
+        testMicPhase = fmod( testMicPhase + 2 * M_PI * hz / DFREQ, 2 * M_PI );
+    }
+    emuReplayMicSamples( samples, TEST_SAMPLES_PER_PASS );
+}
+
+/**
+ * Run one mode from a fresh start for a number of main loop passes
+ *
+ * @param m         The mode to run
+ * @param numPasses How many main loop passes to run it for
+ * @param run       Where the frame hashes are added
+ * @param stats     Returns what else was measured
+ */
+static void testRunMode( uint8_t m, uint32_t numPasses, testRun_t* run, testStats_t* stats )
+{
+    // Nothing saved by any other mode
+    remove( "flash.dat" );
+    remove( "rtc.dat" );
+    testMicPhase = 0;
+    srand( TEST_SEED );
+    emuSeedMallocFill( TEST_SEED );
+    testCur = run;
+    testRunning = true;
+    testMaxBytes = 0;
+    uint32_t startBytes = oledBytesFlushed;
+    testLastBytes = startBytes;
+    double hostStart = OGGetAbsoluteTime();
+
+    switchToSwadgeMode( m );
+    for( uint32_t pass = 0; pass < numPasses; pass++ )
+    {
+        uint32_t timeMs = ( pass * EMU_VIRTUAL_STEP_US ) / 1000;
+        // ACTION would leave the menu for another mode, which is tested on its own
+        testScriptInput( timeMs, 0 != m );
+        testMicInput( timeMs );
+
+        system_os_check_tasks();
+        ets_timer_check_timers();
+        emuReplayAdvanceTime();
+    }
+
+    stats->hostTime = OGGetAbsoluteTime() - hostStart;
+    stats->bytesFlushed = oledBytesFlushed - startBytes;
+    stats->maxBytes = testMaxBytes;
+    testRunning = false;
+
+    // Release anything still held and stop the mode
+    for( uint8_t b = 0; b < NUM_BUTTONS; b++ )
+    {
+        if( gpio_status & ( 1 << b ) )
+        {
+            emuSetButtonStatus( b, false );
+        }
+    }
+    exitCurrentSwadgeMode();
+}
+
+#if !defined(WINDOWS)
+/**
+ * Write all of a buffer to a pipe
+ *
+ * @param fd  The pipe to write to
+ * @param buf The data to write
+ * @param len The number of bytes to write
+ * @return true if everything was written, false otherwise
+ */
+static bool testWriteAll( int fd, const void* buf, size_t len )
+{
+    const uint8_t* p = buf;
+    while( len )
+    {
+        ssize_t n = write( fd, p, len );
+        if( n <= 0 )
+        {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+/**
+ * Read all of a buffer from a pipe
+ *
+ * @param fd  The pipe to read from
+ * @param buf Where to put the data
+ * @param len The number of bytes to read
+ * @return true if everything was read, false otherwise
+ */
+static bool testReadAll( int fd, void* buf, size_t len )
+{
+    uint8_t* p = buf;
+    while( len )
+    {
+        ssize_t n = read( fd, p, len );
+        if( n <= 0 )
+        {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+#endif
+
+/**
+ * Run one mode so that nothing left behind by another mode can change it.
+ *
+ * Besides the saved settings, modes leave behind the virtual time, armed
+ * timers and their own static variables, so each mode is run in a child
+ * process forked from the same state, which sends its hashes back through a
+ * pipe. Windows can't fork, so there the modes only start from fresh
+ * settings and may depend on the order they are run in.
+ *
+ * @param m         The mode to run
+ * @param numPasses How many main loop passes to run it for
+ * @param run       Where the frame hashes are added
+ * @param stats     Returns what else was measured
+ * @return true if the mode was run, false if the child process failed
+ */
+static bool testRunModeIsolated( uint8_t m, uint32_t numPasses, testRun_t* run, testStats_t* stats )
+{
+#if defined(WINDOWS)
+    testRunMode( m, numPasses, run, stats );
+    return true;
+#else
+    int fds[2];
+    if( pipe( fds ) )
+    {
+        return false;
+    }
+
+    // Don't print anything buffered twice
+    fflush( stdout );
+    fflush( stderr );
+    pid_t pid = fork();
+    if( pid < 0 )
+    {
+        close( fds[0] );
+        close( fds[1] );
+        return false;
+    }
+
+    if( 0 == pid )
+    {
+        close( fds[0] );
+        testRunMode( m, numPasses, run, stats );
+        bool sent = testWriteAll( fds[1], stats, sizeof( *stats ) ) &&
+                    testWriteAll( fds[1], &run->numFrames, sizeof( run->numFrames ) ) &&
+                    testWriteAll( fds[1], &run->numHashes, sizeof( run->numHashes ) ) &&
+                    testWriteAll( fds[1], run->hashes, run->numHashes * sizeof( testHash_t ) );
+        fflush( stdout );
+        fflush( stderr );
+        _exit( sent ? 0 : 1 );
+    }
+
+    close( fds[1] );
+    bool received = testReadAll( fds[0], stats, sizeof( *stats ) ) &&
+                    testReadAll( fds[0], &run->numFrames, sizeof( run->numFrames ) ) &&
+                    testReadAll( fds[0], &run->numHashes, sizeof( run->numHashes ) );
+    if( received && run->numHashes )
+    {
+        run->maxHashes = run->numHashes;
+        run->hashes = malloc( run->numHashes * sizeof( testHash_t ) );
+        received = testReadAll( fds[0], run->hashes, run->numHashes * sizeof( testHash_t ) );
+    }
+    close( fds[0] );
+
+    int status;
+    if( waitpid( pid, &status, 0 ) != pid || !WIFEXITED( status ) || WEXITSTATUS( status ) )
+    {
+        received = false;
+    }
+    return received;
+#endif
+}
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * Called by procTask() after each fnRenderTask and updateOLED(). Hashes the
+ * framebuffer and tracks bytes flushed while the mode test is running
+ */
+void emuModeTestFrame( void )
+{
+    extern uint8_t currentFb[];
+
+    if( !testRunning )
+    {
+        return;
+    }
+
+    testAddHash( testCur, emuReplayHashFb( currentFb, OLED_WIDTH * OLED_HEIGHT / 8 ) );
+
+    uint32_t frameBytes = oledBytesFlushed - testLastBytes;
+    testLastBytes = oledBytesFlushed;
+    if( frameBytes > testMaxBytes )
+    {
+        testMaxBytes = frameBytes;
+    }
+}
+
+/**
+ * Run every mode headless and check it against golden framebuffer hashes, or
+ * write new golden hashes
+ *
+ * @param goldenFname  The golden hash file
+ * @param updateGolden true to write the golden hashes, false to check them
+ * @param seconds      How many virtual seconds to run each mode for
+ * @return 0 if every mode matched, 1 otherwise
+ */
+int emuModeTest( const char* goldenFname, bool updateGolden, uint32_t seconds )
+{
+    swadgeMode** modes;
+    uint8_t numModes = getSwadgeModes( &modes );
+    testRun_t* golden = calloc( numModes, sizeof( testRun_t ) );
+    testRun_t* runs = calloc( numModes, sizeof( testRun_t ) );
+    int failures = 0;
+    uint32_t assetsHash = testHashAssets();
+    uint32_t goldenAssetsHash = 0;
+
+    if( !updateGolden && !testLoadGolden( goldenFname, golden, numModes, &goldenAssetsHash ) )
+    {
+        fprintf( stderr, "EMU Error: Could not open %s, write it with --golden\n", goldenFname );
+        free( golden );
+        free( runs );
+        return 1;
+    }
+
+    // The hashes can only match if the same assets are drawn
+    if( !updateGolden && goldenAssetsHash && goldenAssetsHash != assetsHash )
+    {
+        fprintf( stderr, "EMU Error: %s was written with a different assets.bin (%08x, this is %08x), "
+                 "write it again with --golden from a known good build\n", goldenFname, goldenAssetsHash, assetsHash );
+        for( uint8_t m = 0; m < numModes; m++ )
+        {
+            free( golden[m].hashes );
+        }
+        free( golden );
+        free( runs );
+        return 1;
+    }
+
+    // Don't show anything
+    rawvidmem = calloc( OLED_WIDTH * px_scale * ( HEADER_PIXELS + OLED_HEIGHT + FOOTER_PIXELS ) * px_scale,
+                        sizeof( uint32_t ) );
+    emuReplayInit( EMU_HEADLESS, NULL );
+    boottime = emuGetTime();
+
+    uint32_t numPasses = ( seconds * 1000000 ) / EMU_VIRTUAL_STEP_US;
+    for( uint8_t m = 0; m < numModes; m++ )
+    {
+        testRun_t* run = &runs[m];
+        snprintf( run->name, sizeof( run->name ), "%s", modes[m]->modeName ? modes[m]->modeName : "?" );
+
+        testStats_t stats;
+        if( !testRunModeIsolated( m, numPasses, run, &stats ) )
+        {
+            fprintf( stderr, "EMU Error: Could not run %s on its own\n", run->name );
+            failures++;
+            continue;
+        }
+
+        const char* result;
+        char mismatch[32];
+        if( updateGolden )
+        {
+            result = "written";
+        }
+        else if( !golden[m].present )
+        {
+            result = "NO GOLDEN";
+            failures++;
+        }
+        else
+        {
+            int32_t frame = testFirstMismatch( run, &golden[m] );
+            if( frame < 0 )
+            {
+                result = "ok";
+            }
+            else
+            {
+                snprintf( mismatch, sizeof( mismatch ), "MISMATCH at frame %d", frame );
+                result = mismatch;
+                failures++;
+            }
+        }
+
+        printf( "%-16s %5u frames %8.1f frames/host s %7.1f bytes/frame (max %4u)  %s\n",
+                run->name, run->numFrames,
+                stats.hostTime > 0 ? run->numFrames / stats.hostTime : 0,
+                run->numFrames ? stats.bytesFlushed / (double)run->numFrames : 0,
+                stats.maxBytes, result );
+    }
+    emuReplayDeinit();
+
+    if( updateGolden && !testSaveGolden( goldenFname, runs, numModes, seconds, assetsHash ) )
+    {
+        fprintf( stderr, "EMU Error: Could not write %s\n", goldenFname );
+        failures++;
+    }
+
+    for( uint8_t m = 0; m < numModes; m++ )
+    {
+        free( golden[m].hashes );
+        free( runs[m].hashes );
+    }
+    free( golden );
+    free( runs );
+    free( rawvidmem );
+    rawvidmem = NULL;
+
+    return failures ? 1 : 0;
+}
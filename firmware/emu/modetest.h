@@ -0,0 +1,29 @@
+#ifndef _MODETEST_H
+#define _MODETEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Headless golden frame and throughput test for swadgemu
+ *
+ * Every mode from getSwadgeModes() is started in turn and driven by a scripted
+ * sequence of button presses and a synthetic microphone tone for a number of
+ * virtual seconds. After each fnRenderTask, currentFb is hashed and compared
+ * against the golden hashes for that mode and frame.
+ *
+ * For each mode, the frames rendered per host second and the bytes flushed by
+ * updateOLEDScreenRange() per frame are printed too, so rendering
+ * optimizations can be checked for both correctness and speed.
+ *
+ * Each mode runs in a child process forked from the same state, so it can't
+ * depend on the modes run before it. Every mode starts from a fresh flash.dat
+ * and rtc.dat, so run it somewhere without saved settings worth keeping.
+ */
+
+// How long each mode is run for, in virtual seconds
+#define EMU_TEST_DEFAULT_SECONDS 10
+
+int emuModeTest( const char* goldenFname, bool updateGolden, uint32_t seconds );
+
+#endif
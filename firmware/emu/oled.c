@@ -1,5 +1,6 @@
 #include <display/oled.h>
 #include "swadgemu.h"
+#include "trace.h"
 
 #define SSD1306_NUM_PAGES 8
 #define SSD1306_NUM_COLS 128
@@ -10,9 +11,10 @@ uint8_t priorFb[OLEDMEM] = {0};
 uint8_t mBarLen = 0;
 bool fbChanges = false;
 bool fbOnline = false;
+uint32_t oledBytesFlushed = 0;
 
 
-bool initOLED(bool reset)
+bool initOLED(bool reset __attribute__((unused)))
 {
     int i;
     for( i = 0; i < OLEDMEM; i++ )
@@ -124,16 +126,85 @@ bool ICACHE_FLASH_ATTR setOLEDparams(bool turnOnOff)
     return true;
 }
 
+/**
+ * Flush a range of the framebuffer to the emulated display. This mirrors the
+ * device, which only sends the given columns and pages over I2C, and counts
+ * how many bytes the device would have sent
+ *
+ * @param minX    The first column to flush
+ * @param maxX    The last column to flush
+ * @param minPage The first page to flush
+ * @param maxPage The last page to flush
+ * @return FRAME_DRAWN
+ */
+int ICACHE_FLASH_ATTR updateOLEDScreenRange( uint8_t minX, uint8_t maxX, uint8_t minPage, uint8_t maxPage )
+{
+    uint8_t x;
+    for( x = minX; x <= maxX; x++ )
+    {
+        int index = x * SSD1306_NUM_PAGES + minPage;
+        ets_memcpy( &priorFb[index], &currentFb[index], maxPage - minPage + 1 );
+    }
+    oledBytesFlushed += ( maxX - minX + 1 ) * ( maxPage - minPage + 1 );
+    emuSendOLEDData( 1, currentFb );
+    return FRAME_DRAWN;
+}
+
+/**
+ * Push the framebuffer to the emulated display. Like the device, only the
+ * rectangle which changed since the prior frame is flushed when drawing the
+ * difference. The device's slow background refresh of one column per call
+ * isn't emulated
+ *
+ * @param drawDifference true to only draw differences from the prior frame
+ *                       false to draw the entire frame
+ * @return FRAME_DRAWN if anything was flushed, NOTHING_TO_DO otherwise
+ */
 oledResult_t updateOLED(bool drawDifference)
 {
-    if( fbChanges )
+    TRACE_SCOPE("updateOLED");
+
+    if(true == drawDifference && false == fbChanges)
+    {
+        // We know nothing happened, just return
+        return NOTHING_TO_DO;
+    }
+    fbChanges = false;
+
+    if( !drawDifference )
+    {
+        return updateOLEDScreenRange( 0, OLED_WIDTH - 1, 0, SSD1306_NUM_PAGES - 1 );
+    }
+
+    // Find the rect on the screen which encompasses the changed area
+    uint8_t minX = OLED_WIDTH;
+    uint8_t maxX = 0;
+    uint8_t minPage = SSD1306_NUM_PAGES;
+    uint8_t maxPage = 0;
+    uint8_t x, page;
+    uint8_t* pPrev = priorFb;
+    uint8_t* pCur = currentFb;
+    for( x = 0; x < OLED_WIDTH; x++ )
+    {
+        for( page = 0; page < SSD1306_NUM_PAGES; page++ )
+        {
+            if( *pPrev != *pCur )
+            {
+                minX = ( x < minX ) ? x : minX;
+                maxX = ( x > maxX ) ? x : maxX;
+                minPage = ( page < minPage ) ? page : minPage;
+                maxPage = ( page > maxPage ) ? page : maxPage;
+            }
+            pPrev++;
+            pCur++;
+        }
+    }
+
+    if( maxX >= minX && maxPage >= minPage )
     {
-        emuSendOLEDData( 1, currentFb );
-        //For the emulator, we don't care about differences.
-        ets_memcpy(priorFb, currentFb, sizeof(currentFb));
-        return FRAME_DRAWN;
+        return updateOLEDScreenRange( minX, maxX, minPage, maxPage );
     }
-    return FRAME_NOT_DRAWN;
+    return NOTHING_TO_DO;
 }
 
 void clearDisplay(void)
@@ -0,0 +1,231 @@
+#if !defined(WINDOWS) && !defined(ANDROID)
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "radio.h"
+#include "replay.h"
+#include "user_main.h"
+#include "espNowRxQueue.h"
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+// The sender's MAC and the RSSI come before the payload
+#define EMU_RADIO_HDR_LEN 7
+
+/*============================================================================
+ * Variables
+ *==========================================================================*/
+
+static int radioFd = -1;
+static bool radioTried = false;
+static bool radioOn = false;
+static uint8_t radioNode = 0;
+static uint8_t radioRssi = EMU_RADIO_DEFAULT_RSSI;
+static uint8_t radioLossPct = 0;
+static uint32_t radioRand = 0x5357;
+static uint32_t pendingSendCbs = 0;
+
+static const uint8_t radioBroadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+/*============================================================================
+ * Internal Functions
+ *==========================================================================*/
+
+/**
+ * A private xorshift generator for packet loss, so dropping packets doesn't
+ * disturb rand() for the firmware
+ *
+ * @return A pseudorandom number
+ */
+static uint32_t radioRandom( void )
+{
+    radioRand ^= radioRand << 13;
+    radioRand ^= radioRand >> 17;
+    radioRand ^= radioRand << 5;
+    return radioRand;
+}
+
+/**
+ * Join the emulated radio by binding the first free port in the range. This
+ * is only tried once, so the node and MAC don't change when ESP-NOW is
+ * stopped and started again. When replaying or testing, nothing is bound and
+ * the node comes from the recording instead
+ *
+ * @return true if the socket is open
+ */
+static bool radioOpen( void )
+{
+    if( radioTried )
+    {
+        return radioFd >= 0;
+    }
+    radioTried = true;
+
+    if( EMU_REPLAY == emuReplayGetMode() || EMU_HEADLESS == emuReplayGetMode() )
+    {
+        radioNode = emuReplayGetRadioNode();
+        return false;
+    }
+
+    radioFd = socket( AF_INET, SOCK_DGRAM, 0 );
+    if( radioFd < 0 )
+    {
+        fprintf( stderr, "EMU Error: Could not open the radio socket\n" );
+        return false;
+    }
+    fcntl( radioFd, F_SETFL, O_NONBLOCK );
+
+    for( radioNode = 0; radioNode < EMU_RADIO_MAX_NODES; radioNode++ )
+    {
+        struct sockaddr_in addr = {0};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        addr.sin_port = htons( EMU_RADIO_BASE_PORT + radioNode );
+        if( 0 == bind( radioFd, (struct sockaddr*)&addr, sizeof( addr ) ) )
+        {
+            radioRand ^= radioNode * 0x9E3779B9;
+            fprintf( stderr, "EMU: Radio node %d\n", radioNode );
+            emuReplaySetRadioNode( radioNode );
+            return true;
+        }
+    }
+
+    fprintf( stderr, "EMU Error: All %d radio nodes are taken\n", EMU_RADIO_MAX_NODES );
+    close( radioFd );
+    radioFd = -1;
+    radioNode = 0;
+    return false;
+}
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * Start receiving packets from the emulated radio, called from espNowInit()
+ *
+ * @return true if the radio is on
+ */
+bool emuRadioInit( void )
+{
+    radioOn = radioOpen();
+    return radioOn;
+}
+
+/**
+ * Stop receiving packets, called from espNowDeinit(). The port is kept so
+ * this node's MAC doesn't change
+ */
+void emuRadioDeinit( void )
+{
+    radioOn = false;
+    pendingSendCbs = 0;
+}
+
+/**
+ * Set how packets are received, from the command line
+ *
+ * @param rssi    The RSSI every packet is received with
+ * @param lossPct The percentage of packets which are randomly dropped
+ */
+void emuRadioConfig( uint8_t rssi, uint8_t lossPct )
+{
+    radioRssi = rssi;
+    radioLossPct = lossPct;
+}
+
+/**
+ * Get this node's MAC, 02:53:57:00:00:<node>. The port is bound if it wasn't
+ * already, since the MAC depends on which port was free
+ *
+ * @param mac Six bytes to write the MAC to
+ */
+void emuRadioGetMac( uint8_t* mac )
+{
+    radioOpen();
+    const uint8_t base[6] = {0x02, 0x53, 0x57, 0x00, 0x00, 0x00};
+    memcpy( mac, base, sizeof( base ) );
+    mac[5] = radioNode;
+}
+
+/**
+ * Broadcast a packet to every other node. Like ESP-NOW, the send callback is
+ * called later, from emuRadioPoll(), even if the radio is off
+ *
+ * @param data The ESP-NOW payload
+ * @param len  The length of the payload
+ */
+void emuRadioSend( const uint8_t* data, uint8_t len )
+{
+    pendingSendCbs++;
+
+    if( !radioOn )
+    {
+        return;
+    }
+
+    uint8_t pkt[EMU_RADIO_HDR_LEN + 255];
+    emuRadioGetMac( pkt );
+    pkt[6] = radioRssi;
+    memcpy( &pkt[EMU_RADIO_HDR_LEN], data, len );
+
+    for( uint8_t node = 0; node < EMU_RADIO_MAX_NODES; node++ )
+    {
+        if( node == radioNode )
+        {
+            continue;
+        }
+        struct sockaddr_in addr = {0};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        addr.sin_port = htons( EMU_RADIO_BASE_PORT + node );
+        // Nodes which aren't running just don't get it
+        sendto( radioFd, pkt, EMU_RADIO_HDR_LEN + len, 0, (struct sockaddr*)&addr, sizeof( addr ) );
+    }
+}
+
+/**
+ * Call the send callbacks for packets sent since the last call, then pass
+ * every received packet to the firmware. Called once per main loop pass
+ */
+void emuRadioPoll( void )
+{
+    while( pendingSendCbs > 0 )
+    {
+        pendingSendCbs--;
+        swadgeModeEspNowSendCb( (uint8_t*)radioBroadcastMac, MT_TX_STATUS_OK );
+    }
+
+    if( radioFd < 0 )
+    {
+        return;
+    }
+
+    uint8_t pkt[EMU_RADIO_HDR_LEN + 256];
+    ssize_t len;
+    while( ( len = recv( radioFd, pkt, sizeof( pkt ), 0 ) ) > 0 )
+    {
+        // Packets that arrive while ESP-NOW is off are dropped, like on a swadge
+        if( !radioOn || len < EMU_RADIO_HDR_LEN || len > EMU_RADIO_HDR_LEN + 250 )
+        {
+            continue;
+        }
+        if( radioLossPct > 0 && ( radioRandom() % 100 ) < radioLossPct )
+        {
+            continue;
+        }
+
+        uint8_t dataLen = len - EMU_RADIO_HDR_LEN;
+        emuReplayEspNowRecv( &pkt[0], &pkt[EMU_RADIO_HDR_LEN], dataLen, pkt[6] );
+        espNowRxEnqueue( &pkt[0], &pkt[EMU_RADIO_HDR_LEN], dataLen, pkt[6] );
+    }
+}
+
+#endif
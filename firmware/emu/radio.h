@@ -0,0 +1,37 @@
+#ifndef _RADIO_H
+#define _RADIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Emulated ESP-NOW radio for swadgemu on Linux
+ *
+ * Every emulator on the same host is a node on one emulated radio. Each node
+ * binds the first free UDP port on 127.0.0.1 starting at EMU_RADIO_BASE_PORT,
+ * and its MAC is derived from that port, so it stays the same for a given
+ * launch order. espNowSend() sends a datagram to every port in the range,
+ * like a broadcast, and received datagrams are passed to the firmware once
+ * per main loop pass.
+ *
+ * Each datagram is the sender's MAC, the RSSI the receiver should see, then
+ * the ESP-NOW payload.
+ *
+ * The radio is only on for live and recorded sessions. Replays and the mode
+ * test feed recorded packets instead.
+ */
+
+#define EMU_RADIO_BASE_PORT 28400
+#define EMU_RADIO_MAX_NODES 16
+
+// The RSSI every packet is received with, unless --radio-rssi is given
+#define EMU_RADIO_DEFAULT_RSSI 60
+
+bool emuRadioInit( void );
+void emuRadioDeinit( void );
+void emuRadioConfig( uint8_t rssi, uint8_t lossPct );
+void emuRadioGetMac( uint8_t* mac );
+void emuRadioSend( const uint8_t* data, uint8_t len );
+void emuRadioPoll( void );
+
+#endif
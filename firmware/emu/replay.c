@@ -0,0 +1,572 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rawdraw/os_generic.h"
+#include "swadgemu.h"
+#include "replay.h"
+#include "espNowRxQueue.h"
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+#define REPLAY_MAGIC   "SWRP"
+#define REPLAY_VERSION 1
+
+// The file starts with the magic, the version, then the radio node the
+// recording was made on, which was 0 in older recordings
+#define REPLAY_NODE_OFFSET 6
+#define REPLAY_HDR_LEN     8
+
+#define MIC_RING_LEN 16384
+
+/*============================================================================
+ * Enums & Structs
+ *==========================================================================*/
+
+typedef enum
+{
+    RP_BUTTON,   // button, down
+    RP_MIC,      // uint8_t samples
+    RP_ACCEL,    // accel_t
+    RP_RANDOM,   // uint32_t
+    RP_ESPNOW,   // mac[6], rssi, data
+    RP_FB_HASH,  // uint32_t
+} replayEvtType_t;
+
+/// Each event in the file is this header followed by len bytes of payload
+typedef struct __attribute__((packed))
+{
+    uint32_t timeUs;
+    uint8_t type;
+    uint16_t len;
+} replayEvtHdr_t;
+
+/*============================================================================
+ * Variables
+ *==========================================================================*/
+
+static emuReplayMode_t replayMode = EMU_LIVE;
+static FILE* replayFile = NULL;
+
+static uint8_t* replayData = NULL;
+static uint32_t replayDataLen = 0;
+static uint32_t replayPos = 0;
+
+static uint64_t virtualTimeUs = 0;
+static uint8_t replayRadioNode = 0;
+
+static uint8_t micRing[MIC_RING_LEN];
+static uint32_t micHead = 0;
+static uint32_t micTail = 0;
+
+static uint32_t numFrames = 0;
+static uint32_t numHashMismatches = 0;
+static uint32_t numDesyncs = 0;
+static double hostStartTime = 0;
+
+/*============================================================================
+ * Internal Functions
+ *==========================================================================*/
+
+/**
+ * Write an event with the current virtual time to the recording
+ *
+ * @param type    The type of event
+ * @param payload The event's payload
+ * @param len     The length of the payload
+ */
+static void replayWrite( replayEvtType_t type, const void* payload, uint16_t len )
+{
+    replayEvtHdr_t hdr =
+    {
+        .timeUs = (uint32_t)virtualTimeUs,
+        .type = type,
+        .len = len,
+    };
+    fwrite( &hdr, sizeof( hdr ), 1, replayFile );
+    if( len )
+    {
+        fwrite( payload, len, 1, replayFile );
+    }
+}
+
+/**
+ * Look at the next event in the recording without consuming it
+ *
+ * @param hdr Filled with the next event's header
+ * @return true if there is another complete event, false if the recording is over
+ */
+static bool replayPeek( replayEvtHdr_t* hdr )
+{
+    if( replayPos + sizeof( *hdr ) > replayDataLen )
+    {
+        return false;
+    }
+    memcpy( hdr, &replayData[replayPos], sizeof( *hdr ) );
+    return ( replayPos + sizeof( *hdr ) + hdr->len ) <= replayDataLen;
+}
+
+/**
+ * Consume the next event in the recording
+ *
+ * @param hdr The event's header, from replayPeek()
+ * @return A pointer to the event's payload
+ */
+static const uint8_t* replayConsume( const replayEvtHdr_t* hdr )
+{
+    const uint8_t* payload = &replayData[replayPos + sizeof( *hdr )];
+    replayPos += sizeof( *hdr ) + hdr->len;
+    return payload;
+}
+
+/**
+ * Consume the next event if it is the expected type. This is for inputs the
+ * firmware pulls, like os_random(), which must be consumed in the same order
+ * they were recorded
+ *
+ * @param type The expected type
+ * @param len  The expected payload length
+ * @return A pointer to the payload, or NULL if the replay has desynced
+ */
+static const uint8_t* replayPull( replayEvtType_t type, uint16_t len )
+{
+    replayEvtHdr_t hdr;
+    if( replayPeek( &hdr ) && hdr.type == type && hdr.len == len )
+    {
+        return replayConsume( &hdr );
+    }
+    if( 0 == numDesyncs++ )
+    {
+        fprintf( stderr, "EMU Replay: desynced at frame %u, expected event %d\n", numFrames, type );
+    }
+    return NULL;
+}
+
+/**
+ * Dispatch all recorded events of the given types which are due by now.
+ * Events of other types which should have been consumed already are skipped
+ *
+ * @param typeMask A bitmask of (1 << replayEvtType_t) to dispatch
+ */
+static void replayDispatch( uint32_t typeMask )
+{
+    replayEvtHdr_t hdr;
+    while( replayPeek( &hdr ) && hdr.timeUs <= (uint32_t)virtualTimeUs )
+    {
+        if( !( typeMask & ( 1 << hdr.type ) ) )
+        {
+            if( hdr.timeUs < (uint32_t)virtualTimeUs )
+            {
+                // This should have been pulled in a prior frame, skip it
+                replayConsume( &hdr );
+                if( 0 == numDesyncs++ )
+                {
+                    fprintf( stderr, "EMU Replay: desynced at frame %u, skipped event %d\n", numFrames, hdr.type );
+                }
+                continue;
+            }
+            // This is for later in this frame
+            break;
+        }
+
+        const uint8_t* payload = replayConsume( &hdr );
+        switch( (replayEvtType_t)hdr.type )
+        {
+            case RP_BUTTON:
+            {
+                emuSetButtonStatus( payload[0], payload[1] );
+                break;
+            }
+            case RP_MIC:
+            {
+                for( uint16_t i = 0; i < hdr.len; i++ )
+                {
+                    if( micTail != ( ( micHead + 1 ) % MIC_RING_LEN ) )
+                    {
+                        micRing[micHead] = payload[i];
+                        micHead = ( micHead + 1 ) % MIC_RING_LEN;
+                    }
+                }
+                break;
+            }
+            case RP_ESPNOW:
+            {
+                espNowRxEnqueue( &payload[0], &payload[7], hdr.len - 7, payload[6] );
+                break;
+            }
+            case RP_ACCEL:
+            case RP_RANDOM:
+            case RP_FB_HASH:
+            default:
+            {
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Print how the replay went and exit with a nonzero code if any frame
+ * didn't match the recording
+ */
+static void replayFinish( void )
+{
+    double hostTime = OGGetAbsoluteTime() - hostStartTime;
+    printf( "EMU Replay: %u frames, %.2f virtual s, %.2f host s, %.1f frames per host s\n",
+            numFrames, virtualTimeUs / 1000000.0, hostTime, hostTime > 0 ? numFrames / hostTime : 0 );
+    printf( "EMU Replay: %u framebuffer mismatches, %u desyncs\n", numHashMismatches, numDesyncs );
+    emuReplayDeinit();
+    exit( ( numHashMismatches || numDesyncs ) ? 1 : 0 );
+}
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * Start recording or replaying
+ *
+ * @param mode  EMU_RECORD, EMU_REPLAY or EMU_HEADLESS
+ * @param fname The file to record to or replay from, unused for EMU_HEADLESS
+ * @return true if it started, false if the file couldn't be used
+ */
+bool emuReplayInit( emuReplayMode_t mode, const char* fname )
+{
+    switch( mode )
+    {
+        case EMU_RECORD:
+        {
+            replayFile = fopen( fname, "wb" );
+            if( !replayFile )
+            {
+                fprintf( stderr, "EMU Error: Could not open %s for recording\n", fname );
+                return false;
+            }
+            uint16_t version[2] = {REPLAY_VERSION, 0};
+            fwrite( REPLAY_MAGIC, 4, 1, replayFile );
+            fwrite( version, sizeof( version ), 1, replayFile );
+            break;
+        }
+        case EMU_REPLAY:
+        {
+            FILE* f = fopen( fname, "rb" );
+            if( !f )
+            {
+                fprintf( stderr, "EMU Error: Could not open %s for replay\n", fname );
+                return false;
+            }
+            fseek( f, 0, SEEK_END );
+            replayDataLen = ftell( f );
+            fseek( f, 0, SEEK_SET );
+            replayData = malloc( replayDataLen );
+            bool ok = ( replayDataLen >= REPLAY_HDR_LEN ) && ( 1 == fread( replayData, replayDataLen, 1, f ) );
+            fclose( f );
+            if( !ok || 0 != memcmp( replayData, REPLAY_MAGIC, 4 ) || REPLAY_VERSION != *(uint16_t*)&replayData[4] )
+            {
+                fprintf( stderr, "EMU Error: %s is not a swadgemu recording\n", fname );
+                free( replayData );
+                replayData = NULL;
+                return false;
+            }
+            replayRadioNode = *(uint16_t*)&replayData[REPLAY_NODE_OFFSET];
+            replayPos = REPLAY_HDR_LEN;
+            break;
+        }
+        case EMU_HEADLESS:
+        {
+            break;
+        }
+        case EMU_LIVE:
+        default:
+        {
+            return false;
+        }
+    }
+
+    replayMode = mode;
+    virtualTimeUs = 0;
+    hostStartTime = OGGetAbsoluteTime();
+    return true;
+}
+
+/**
+ * Save which radio node this emulator is, so a replay addresses packets the
+ * same way. Called by the radio once it has picked a node
+ *
+ * @param node The radio node
+ */
+void emuReplaySetRadioNode( uint8_t node )
+{
+    replayRadioNode = node;
+    if( replayFile )
+    {
+        uint16_t node16 = node;
+        fseek( replayFile, REPLAY_NODE_OFFSET, SEEK_SET );
+        fwrite( &node16, sizeof( node16 ), 1, replayFile );
+        fseek( replayFile, 0, SEEK_END );
+    }
+}
+
+/**
+ * @return The radio node the replay was recorded on
+ */
+uint8_t emuReplayGetRadioNode( void )
+{
+    return replayRadioNode;
+}
+
+/**
+ * Finish writing the recording, or free the replay
+ */
+void emuReplayDeinit( void )
+{
+    if( replayFile )
+    {
+        fclose( replayFile );
+        replayFile = NULL;
+    }
+    if( replayData )
+    {
+        free( replayData );
+        replayData = NULL;
+    }
+    replayMode = EMU_LIVE;
+}
+
+/**
+ * @return EMU_LIVE, EMU_RECORD, EMU_REPLAY or EMU_HEADLESS
+ */
+emuReplayMode_t emuReplayGetMode( void )
+{
+    return replayMode;
+}
+
+/**
+ * @return The virtual time in seconds. Only meaningful when not EMU_LIVE
+ */
+double emuReplayGetTime( void )
+{
+    return virtualTimeUs / 1000000.0;
+}
+
+/**
+ * Advance the virtual clock one main loop pass
+ */
+void emuReplayAdvanceTime( void )
+{
+    virtualTimeUs += EMU_VIRTUAL_STEP_US;
+}
+
+/**
+ * Give microphone samples captured live, or generated when headless, to the
+ * firmware. They are logged when recording and thrown away when replaying
+ *
+ * @param samples    The samples
+ * @param numSamples The number of samples
+ */
+void emuReplayMicSamples( uint8_t* samples, uint16_t numSamples )
+{
+    if( EMU_RECORD != replayMode && EMU_HEADLESS != replayMode )
+    {
+        return;
+    }
+    if( EMU_RECORD == replayMode && numSamples )
+    {
+        replayWrite( RP_MIC, samples, numSamples );
+    }
+    for( uint16_t i = 0; i < numSamples; i++ )
+    {
+        if( micTail != ( ( micHead + 1 ) % MIC_RING_LEN ) )
+        {
+            micRing[micHead] = samples[i];
+            micHead = ( micHead + 1 ) % MIC_RING_LEN;
+        }
+    }
+}
+
+/**
+ * @return true if a recorded or logged microphone sample is available
+ */
+bool emuReplaySampleAvailable( void )
+{
+    return micHead != micTail;
+}
+
+/**
+ * @return The next recorded or logged microphone sample
+ */
+uint8_t emuReplayGetSample( void )
+{
+    if( micHead == micTail )
+    {
+        return 0;
+    }
+    uint8_t samp = micRing[micTail];
+    micTail = ( micTail + 1 ) % MIC_RING_LEN;
+    return samp;
+}
+
+/**
+ * Called at the start of each main loop pass. When replaying this queues this
+ * pass's microphone samples, or finishes if the recording is over
+ */
+void emuReplayFrameStart( void )
+{
+    if( EMU_REPLAY != replayMode )
+    {
+        return;
+    }
+    replayEvtHdr_t hdr;
+    if( !replayPeek( &hdr ) )
+    {
+        replayFinish();
+    }
+    replayDispatch( 1 << RP_MIC );
+}
+
+/**
+ * Called where live input is handled in each main loop pass. When replaying
+ * this dispatches this pass's button events and ESP-NOW packets
+ */
+void emuReplayInput( void )
+{
+    if( EMU_REPLAY != replayMode )
+    {
+        return;
+    }
+    replayDispatch( ( 1 << RP_BUTTON ) | ( 1 << RP_ESPNOW ) );
+}
+
+/**
+ * Log a button event when recording
+ *
+ * @param button The button which changed
+ * @param bDown  true if it was pressed, false if it was released
+ */
+void emuReplayButton( int button, int bDown )
+{
+    if( EMU_RECORD == replayMode )
+    {
+        uint8_t payload[2] = {button, bDown ? 1 : 0};
+        replayWrite( RP_BUTTON, payload, sizeof( payload ) );
+    }
+}
+
+/**
+ * Log or replay a random number
+ *
+ * @param liveVal The live random number
+ * @return liveVal, or the recorded random number when replaying
+ */
+unsigned long emuReplayRandom( unsigned long liveVal )
+{
+    uint32_t val = liveVal;
+    if( EMU_RECORD == replayMode )
+    {
+        replayWrite( RP_RANDOM, &val, sizeof( val ) );
+    }
+    else if( EMU_REPLAY == replayMode )
+    {
+        const uint8_t* payload = replayPull( RP_RANDOM, sizeof( val ) );
+        if( payload )
+        {
+            memcpy( &val, payload, sizeof( val ) );
+        }
+    }
+    return val;
+}
+
+/**
+ * Log or replay an accelerometer reading
+ *
+ * @param accel The live reading, overwritten with the recorded one when replaying
+ */
+void emuReplayAccel( accel_t* accel )
+{
+    if( EMU_RECORD == replayMode )
+    {
+        replayWrite( RP_ACCEL, accel, sizeof( *accel ) );
+    }
+    else if( EMU_REPLAY == replayMode )
+    {
+        const uint8_t* payload = replayPull( RP_ACCEL, sizeof( *accel ) );
+        if( payload )
+        {
+            memcpy( accel, payload, sizeof( *accel ) );
+        }
+    }
+}
+
+/**
+ * Log a received ESP-NOW packet when recording. The emulated radio should call
+ * this for every packet it passes to the firmware
+ *
+ * @param mac_addr The sender's MAC address
+ * @param data     The received data
+ * @param len      The length of the received data
+ * @param rssi     The received signal strength
+ */
+void emuReplayEspNowRecv( uint8_t* mac_addr, uint8_t* data, uint8_t len, uint8_t rssi )
+{
+    if( EMU_RECORD == replayMode )
+    {
+        uint8_t payload[6 + 1 + 255];
+        memcpy( &payload[0], mac_addr, 6 );
+        payload[6] = rssi;
+        memcpy( &payload[7], data, len );
+        replayWrite( RP_ESPNOW, payload, 7 + len );
+    }
+}
+
+/**
+ * Hash a framebuffer with 32 bit FNV-1a
+ *
+ * @param fb  The framebuffer
+ * @param len The length of the framebuffer
+ * @return The hash
+ */
+uint32_t emuReplayHashFb( const uint8_t* fb, uint32_t len )
+{
+    uint32_t hash = 2166136261u;
+    for( uint32_t i = 0; i < len; i++ )
+    {
+        hash = ( hash ^ fb[i] ) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Hash the framebuffer after a main loop pass. When recording the hash is
+ * logged, when replaying it's compared against the logged one
+ *
+ * @param fb  The framebuffer
+ * @param len The length of the framebuffer
+ */
+void emuReplayFrameHash( const uint8_t* fb, uint32_t len )
+{
+    if( EMU_RECORD != replayMode && EMU_REPLAY != replayMode )
+    {
+        return;
+    }
+
+    uint32_t hash = emuReplayHashFb( fb, len );
+    if( EMU_RECORD == replayMode )
+    {
+        replayWrite( RP_FB_HASH, &hash, sizeof( hash ) );
+    }
+    else
+    {
+        const uint8_t* payload = replayPull( RP_FB_HASH, sizeof( hash ) );
+        uint32_t recorded;
+        if( payload )
+        {
+            memcpy( &recorded, payload, sizeof( recorded ) );
+            if( recorded != hash && 0 == numHashMismatches++ )
+            {
+                fprintf( stderr, "EMU Replay: framebuffer mismatch at frame %u\n", numFrames );
+            }
+        }
+    }
+    numFrames++;
+}
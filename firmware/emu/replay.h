@@ -0,0 +1,64 @@
+#ifndef _REPLAY_H
+#define _REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "user_main.h"
+
+/*
+ * Record and replay for swadgemu
+ *
+ * In record mode, every nondeterministic input to the firmware is logged with
+ * a virtual timestamp to a compact binary file: button events, microphone
+ * samples, accelerometer readings, os_random() results and received ESP-NOW
+ * packets. A hash of the framebuffer is logged every main loop pass too.
+ *
+ * In replay mode, live input is ignored and the logged inputs are fed back at
+ * the same virtual times. Each framebuffer hash is compared against the logged
+ * one, so rendering or timing regressions show up as mismatches.
+ *
+ * In both modes the emulator runs on a virtual clock which advances a fixed
+ * step every main loop pass instead of wall clock time. Replay doesn't sleep
+ * between passes, so it doubles as a benchmark for each mode.
+ *
+ * Note that flash.dat and rtc.dat are not part of the recording. Replay with
+ * the same saved settings the recording was made with.
+ *
+ * EMU_HEADLESS uses the same virtual clock and ignores live input, but has no
+ * file. Whatever drives the emulator, like the mode test, supplies the input.
+ */
+
+typedef enum
+{
+    EMU_LIVE,
+    EMU_RECORD,
+    EMU_REPLAY,
+    EMU_HEADLESS
+} emuReplayMode_t;
+
+// How much virtual time passes every main loop pass, in microseconds
+#define EMU_VIRTUAL_STEP_US 10000
+
+bool emuReplayInit( emuReplayMode_t mode, const char* fname );
+void emuReplayDeinit( void );
+emuReplayMode_t emuReplayGetMode( void );
+
+double emuReplayGetTime( void );
+void emuReplayAdvanceTime( void );
+
+void emuReplayMicSamples( uint8_t* samples, uint16_t numSamples );
+bool emuReplaySampleAvailable( void );
+uint8_t emuReplayGetSample( void );
+void emuReplayFrameStart( void );
+void emuReplayInput( void );
+
+void emuReplayButton( int button, int bDown );
+unsigned long emuReplayRandom( unsigned long liveVal );
+void emuReplayAccel( accel_t* accel );
+void emuReplayEspNowRecv( uint8_t* mac_addr, uint8_t* data, uint8_t len, uint8_t rssi );
+void emuReplaySetRadioNode( uint8_t node );
+uint8_t emuReplayGetRadioNode( void );
+uint32_t emuReplayHashFb( const uint8_t* fb, uint32_t len );
+void emuReplayFrameHash( const uint8_t* fb, uint32_t len );
+
+#endif
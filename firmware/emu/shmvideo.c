@@ -0,0 +1,154 @@
+#if !defined(WINDOWS) && !defined(ANDROID)
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "swadgemu.h"
+#include "shmvideo.h"
+
+/*============================================================================
+ * Variables
+ *==========================================================================*/
+
+static char shmName[32];
+static int shmFd = -1;
+static uint8_t* shmData = NULL;
+static size_t shmSize = 0;
+static uint32_t backBuf = 0;
+
+/*============================================================================
+ * Internal Functions
+ *==========================================================================*/
+
+/**
+ * @param idx The index of a buffer
+ * @return A pointer to that buffer
+ */
+static swadgeShmBuf_t* shmBuf( uint32_t idx )
+{
+    swadgeShmHeader_t* hdr = (swadgeShmHeader_t*)shmData;
+    return (swadgeShmBuf_t*)( shmData + hdr->bufOffset + idx * hdr->bufStride );
+}
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * Create the shared memory segment, sized for the biggest image it can hold so
+ * it never has to be resized
+ *
+ * @param name The name of the segment, like "/swadgevideo"
+ * @return A pointer to the RGBA image to draw the first frame into, or NULL if
+ *         the segment couldn't be created
+ */
+uint32_t* emuShmVideoInit( const char* name )
+{
+    uint32_t maxPixels = ( OLED_WIDTH * EMU_SHM_MAX_SCALE ) *
+                         ( ( HEADER_PIXELS + OLED_HEIGHT + FOOTER_PIXELS ) * EMU_SHM_MAX_SCALE );
+    // Keep each buffer page aligned. Pages aren't allocated until they're drawn to
+    uint32_t bufStride = ( sizeof( swadgeShmBuf_t ) + maxPixels * sizeof( uint32_t ) + 4095 ) & ~4095;
+    uint32_t bufOffset = 4096;
+
+    snprintf( shmName, sizeof( shmName ), "%s", name );
+    shmSize = bufOffset + EMU_SHM_NUM_BUFS * bufStride;
+    shmFd = shm_open( shmName, O_CREAT | O_RDWR, 0644 );
+    if( shmFd < 0 || 0 != ftruncate( shmFd, shmSize ) )
+    {
+        fprintf( stderr, "EMU Error: Could not create %s\n", shmName );
+        return NULL;
+    }
+    shmData = mmap( 0, shmSize, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0 );
+    if( MAP_FAILED == shmData )
+    {
+        fprintf( stderr, "EMU Error: Could not map %s\n", shmName );
+        shmData = NULL;
+        return NULL;
+    }
+
+    // Start out invalid, so readers don't use a half written header
+    swadgeShmHeader_t* hdr = (swadgeShmHeader_t*)shmData;
+    hdr->magic = 0;
+    hdr->version = SWADGE_SHM_VIDEO_VERSION;
+    hdr->headerSize = sizeof( swadgeShmHeader_t );
+    hdr->numBufs = EMU_SHM_NUM_BUFS;
+    hdr->bufOffset = bufOffset;
+    hdr->bufStride = bufStride;
+    hdr->maxPixels = maxPixels;
+    hdr->frameSeq = 0;
+    hdr->latestBuf = 0;
+    for( uint32_t i = 0; i < EMU_SHM_NUM_BUFS; i++ )
+    {
+        shmBuf( i )->seq = 0;
+    }
+
+    // Mark the first buffer as being drawn
+    backBuf = 0;
+    shmBuf( backBuf )->seq = 1;
+    __atomic_store_n( &hdr->magic, SWADGE_SHM_VIDEO_MAGIC, __ATOMIC_RELEASE );
+    return shmBuf( backBuf )->rgba;
+}
+
+/**
+ * Unmap and unlink the shared memory segment
+ */
+void emuShmVideoDeinit( void )
+{
+    if( shmData )
+    {
+        munmap( shmData, shmSize );
+        shmData = NULL;
+    }
+    if( shmFd >= 0 )
+    {
+        close( shmFd );
+        shm_unlink( shmName );
+        shmFd = -1;
+    }
+}
+
+/**
+ * Publish the frame which was drawn into the current buffer and wake anything
+ * waiting for it, then start drawing into the next buffer
+ *
+ * @param width   The width of the RGBA image which was drawn
+ * @param height  The height of the RGBA image which was drawn
+ * @param fb      The raw framebuffer
+ * @param leds    The LED colors
+ * @param numLeds The number of LEDs
+ * @return A pointer to the RGBA image to draw the next frame into
+ */
+uint32_t* emuShmVideoPublish( uint32_t width, uint32_t height, const uint8_t* fb,
+                              const uint32_t* leds, uint32_t numLeds )
+{
+    swadgeShmHeader_t* hdr = (swadgeShmHeader_t*)shmData;
+    swadgeShmBuf_t* buf = shmBuf( backBuf );
+    uint32_t frameSeq = hdr->frameSeq + 1;
+
+    buf->frameSeq = frameSeq;
+    buf->width = width;
+    buf->height = height;
+    buf->numLeds = ( numLeds < EMU_SHM_MAX_LEDS ) ? numLeds : EMU_SHM_MAX_LEDS;
+    memcpy( buf->leds, leds, buf->numLeds * sizeof( uint32_t ) );
+    memcpy( buf->fb, fb, EMU_SHM_FB_LEN );
+
+    // Complete this buffer, then point readers at it
+    __atomic_store_n( &buf->seq, buf->seq + 1, __ATOMIC_RELEASE );
+    __atomic_store_n( &hdr->latestBuf, backBuf, __ATOMIC_RELEASE );
+    __atomic_store_n( &hdr->frameSeq, frameSeq, __ATOMIC_RELEASE );
+    syscall( SYS_futex, &hdr->frameSeq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0 );
+
+    // Start drawing into the oldest buffer
+    backBuf = ( backBuf + 1 ) % EMU_SHM_NUM_BUFS;
+    buf = shmBuf( backBuf );
+    __atomic_store_n( &buf->seq, buf->seq + 1, __ATOMIC_RELEASE );
+    return buf->rgba;
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef _SHMVIDEO_H
+#define _SHMVIDEO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Shared memory video for swadgemu on Linux
+ *
+ * Every frame the emulator draws is published to the "/swadgevideo" shm
+ * segment, or "/swadgevideo<instance>" when run with --instance, so external
+ * tools can mirror it. This header only uses fixed width types so those tools
+ * can include it too.
+ *
+ * The segment starts with a swadgeShmHeader_t, followed by numBufs buffers of
+ * bufStride bytes each, starting at bufOffset. Each buffer is a
+ * swadgeShmBuf_t holding one frame: the raw framebuffer, the LEDs, and the
+ * scaled RGBA image the emulator window shows. The emulator draws straight
+ * into one buffer while the others hold complete frames, so nothing is copied
+ * to publish a frame.
+ *
+ * To read frames:
+ *  1. Wait for frameSeq to change from the last value seen, either by polling
+ *     or with FUTEX_WAIT on &frameSeq. The emulator does a FUTEX_WAKE on it
+ *     after every frame. Don't use FUTEX_PRIVATE_FLAG, it's shared memory
+ *  2. Read latestBuf and that buffer's seq. If seq is odd, it's being drawn,
+ *     so go back to 1
+ *  3. Copy what's needed out of the buffer, then read seq again. If it
+ *     changed, the emulator lapped the reader and the copy may be torn, so go
+ *     back to 2
+ *
+ * The segment is sized once for images up to EMU_SHM_MAX_SCALE times the OLED
+ * size, so resizing the window never remaps it. Use width and height from
+ * each buffer rather than assuming a size.
+ */
+
+#define SWADGE_SHM_VIDEO_MAGIC   0x44565753 // "SWVD"
+#define SWADGE_SHM_VIDEO_VERSION 1
+
+#define EMU_SHM_NUM_BUFS  3
+#define EMU_SHM_MAX_SCALE 16
+#define EMU_SHM_FB_LEN    1024 // OLED_WIDTH * OLED_HEIGHT / 8
+#define EMU_SHM_MAX_LEDS  8
+
+typedef struct
+{
+    uint32_t magic;              // SWADGE_SHM_VIDEO_MAGIC
+    uint16_t version;            // SWADGE_SHM_VIDEO_VERSION
+    uint16_t headerSize;         // sizeof(swadgeShmHeader_t)
+    uint32_t numBufs;            // The number of frame buffers
+    uint32_t bufOffset;          // Bytes from the start of the segment to buffer 0
+    uint32_t bufStride;          // Bytes from the start of one buffer to the next
+    uint32_t maxPixels;          // The most pixels an RGBA image can have
+    volatile uint32_t frameSeq;  // Frames published so far, wait on this
+    volatile uint32_t latestBuf; // The index of the most recently published buffer
+} swadgeShmHeader_t;
+
+typedef struct
+{
+    volatile uint32_t seq;          // Even when the frame is complete, odd while it's being drawn
+    uint32_t frameSeq;              // The header's frameSeq when this was published
+    uint32_t width;                 // The width of the RGBA image
+    uint32_t height;                // The height of the RGBA image
+    uint32_t numLeds;               // The number of LEDs
+    uint32_t leds[EMU_SHM_MAX_LEDS]; // 0xXXRRGGBB LED colors, ignore the top byte
+    uint8_t fb[EMU_SHM_FB_LEN];     // The raw framebuffer, column major. Pixel (x, y) is
+                                    // bit (y % 8) of byte ((x * OLED_HEIGHT) + y) / 8
+    uint32_t rgba[];                // width * height 0xXXRRGGBB pixels, row major
+} swadgeShmBuf_t;
+
+uint32_t* emuShmVideoInit( const char* name );
+void emuShmVideoDeinit( void );
+uint32_t* emuShmVideoPublish( uint32_t width, uint32_t height, const uint8_t* fb,
+                              const uint32_t* leds, uint32_t numLeds );
+
+#endif
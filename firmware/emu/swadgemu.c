@@ -9,6 +9,10 @@
 #include "rawdraw/CNFG.h"
 #include "rawdraw/os_generic.h"
 #include "swadgemu.h"
+#include "replay.h"
+#include "modetest.h"
+#include "shmvideo.h"
+#include "radio.h"
 
 //ESP Includes
 #include "user_interface.h"
@@ -18,6 +22,8 @@
 #include "../user/hdw/buzzer.h"
 #include "../user/hdw/buttons.h"
 #include "../user/utils/assets.h"
+#include "../user/utils/trace.h"
+#include "../user/utils/wireless/espNowRxQueue.h"
 #include "spi_flash.h"
 
 #define BACKGROUND_COLOR  0x040510
@@ -43,11 +49,10 @@
     #include <sys/stat.h>        /* For mode constants */
     #include <fcntl.h>           /* For O_* constants */
 
-    int swadgeshm_video;
+    char swadgeshm_input_name[32];
     int swadgeshm_input;
-    uint32_t* swadgeshm_video_data;
     uint8_t* swadgeshm_input_data;
-    size_t swadgeshm_video_data_size;
+    bool swadgeshm_video = false;
 #endif
 
 int px_scale = INIT_PX_SCALE;
@@ -61,6 +66,7 @@ double boottime;
 uint8_t gpio_status;
 
 void HandleButtonStatus( int button, int bDown );
+static void emuPullMicSamples( void );
 void system_os_check_tasks(void);
 void ets_timer_check_timers(void);
 
@@ -199,6 +205,146 @@ void emuFooter()
 }
 
 
+/**
+ * Convert a color to what the display expects
+ *
+ * @param pxcol A 0x00RRGGBB color
+ * @return The color to put in rawvidmem
+ */
+static uint32_t emuPixelColor( uint32_t pxcol )
+{
+#ifdef ANDROID
+    pxcol = 0xff000000 | ( (pxcol & 0xff) << 16 ) | ( pxcol & 0xff00 ) | ( (pxcol & 0xff0000) >> 16 );
+#endif
+    return pxcol;
+}
+
+/**
+ * Draw the OLED framebuffer to rawvidmem, scaled up by px_scale
+ *
+ * Each group of eight columns is 64 contiguous framebuffer bytes, which are
+ * compared against what was last drawn to the same rawvidmem so only changed
+ * groups are drawn. A resize redraws every buffer at the new scale, and
+ * rawvidmem may be reallocated, so everything drawn before it is forgotten. In a changed group, each 8x8 block is bit transposed so
+ * each byte is eight horizontal pixels, which are expanded through a lookup
+ * table of scaled scanline spans. Finally the first scaled row is copied to the
+ * other px_scale - 1 rows
+ *
+ * @param fb The OLED framebuffer
+ */
+static void emuSendOLEDFb( const uint8_t* fb )
+{
+    // The expanded span for every byte of eight horizontal pixels at oledLutScale
+    static uint32_t* oledLut = NULL;
+    static int oledLutScale = 0;
+    // What was last drawn to each rawvidmem at drawnScale, since the shared
+    // memory has more than one
+    static struct
+    {
+        uint32_t* vidmem;
+        uint8_t fb[OLED_WIDTH * OLED_HEIGHT / 8];
+    } drawn[EMU_SHM_NUM_BUFS + 1];
+    static uint8_t nextDrawn = 0;
+    static int drawnScale = 0;
+
+    if( drawnScale != px_scale )
+    {
+        drawnScale = px_scale;
+        memset( drawn, 0, sizeof( drawn ) );
+    }
+
+    if( oledLutScale != px_scale )
+    {
+        oledLutScale = px_scale;
+        oledLut = realloc( oledLut, 256 * 8 * px_scale * sizeof( uint32_t ) );
+        uint32_t* span = oledLut;
+        for( int b = 0; b < 256; b++ )
+        {
+            for( int i = 0; i < 8; i++ )
+            {
+                uint32_t pxcol = emuPixelColor( ( b & ( 1 << i ) ) ? OLED_ON_COLOR : BACKGROUND_COLOR );
+                for( int s = 0; s < px_scale; s++ )
+                {
+                    *(span++) = pxcol;
+                }
+            }
+        }
+    }
+
+    // Find what was last drawn here, or start over if it wasn't
+    uint8_t d;
+    bool redrawAll = false;
+    for( d = 0; d < sizeof( drawn ) / sizeof( drawn[0] ); d++ )
+    {
+        if( drawn[d].vidmem == rawvidmem )
+        {
+            break;
+        }
+    }
+    if( d == sizeof( drawn ) / sizeof( drawn[0] ) )
+    {
+        d = nextDrawn;
+        nextDrawn = ( nextDrawn + 1 ) % ( sizeof( drawn ) / sizeof( drawn[0] ) );
+        drawn[d].vidmem = rawvidmem;
+        redrawAll = true;
+    }
+
+    int spanLen = 8 * px_scale;
+    int stride = OLED_WIDTH * px_scale;
+    uint32_t* oledStart = rawvidmem + HEADER_PIXELS * px_scale * stride;
+    int minGroup = OLED_WIDTH / 8;
+    int maxGroup = -1;
+    for( int g = 0; g < OLED_WIDTH / 8; g++ )
+    {
+        const uint8_t* gfb = &fb[g * 64];
+        if( !redrawAll && 0 == memcmp( gfb, &drawn[d].fb[g * 64], 64 ) )
+        {
+            continue;
+        }
+        memcpy( &drawn[d].fb[g * 64], gfb, 64 );
+        minGroup = ( g < minGroup ) ? g : minGroup;
+        maxGroup = g;
+
+        for( int page = 0; page < OLED_HEIGHT / 8; page++ )
+        {
+            // Transpose the 8x8 block, so byte j bit i is pixel (8g + i, 8page + j)
+            uint64_t x = 0, t;
+            for( int i = 0; i < 8; i++ )
+            {
+                x |= (uint64_t)gfb[i * 8 + page] << ( 8 * i );
+            }
+            t = ( x ^ ( x >> 7 ) ) & 0x00AA00AA00AA00AAULL;
+            x = x ^ t ^ ( t << 7 );
+            t = ( x ^ ( x >> 14 ) ) & 0x0000CCCC0000CCCCULL;
+            x = x ^ t ^ ( t << 14 );
+            t = ( x ^ ( x >> 28 ) ) & 0x00000000F0F0F0F0ULL;
+            x = x ^ t ^ ( t << 28 );
+
+            uint32_t* dst = oledStart + ( page * 8 * px_scale ) * stride + g * spanLen;
+            for( int j = 0; j < 8; j++ )
+            {
+                memcpy( dst, &oledLut[( ( x >> ( 8 * j ) ) & 0xFF ) * spanLen], spanLen * sizeof( uint32_t ) );
+                dst += px_scale * stride;
+            }
+        }
+    }
+
+    // Copy the first scaled row of each pixel row to the rest
+    if( maxGroup >= 0 )
+    {
+        int rangeLen = ( maxGroup - minGroup + 1 ) * spanLen * sizeof( uint32_t );
+        uint32_t* src = oledStart + minGroup * spanLen;
+        for( int y = 0; y < OLED_HEIGHT; y++ )
+        {
+            for( int ly = 1; ly < px_scale; ly++ )
+            {
+                memcpy( src + ly * stride, src, rangeLen );
+            }
+            src += px_scale * stride;
+        }
+    }
+}
+
 void emuSendOLEDData( int disp, uint8_t* currentFb )
 {
     int x, y;
@@ -215,9 +361,8 @@ void emuSendOLEDData( int disp, uint8_t* currentFb )
         case 1:
         {
             // OLED
-            yStart = HEADER_PIXELS;
-            yHeight = OLED_HEIGHT;
-            break;
+            emuSendOLEDFb( currentFb );
+            return;
         }
         case 2:
         {
@@ -232,35 +377,26 @@ void emuSendOLEDData( int disp, uint8_t* currentFb )
         }
     }
 
+    int stride = OLED_WIDTH * px_scale;
     for( y = 0; y < yHeight; y++ )
     {
+        uint32_t* row = rawvidmem + ( y + yStart ) * px_scale * stride;
+        uint32_t* pxloc = row;
         for( x = 0; x < OLED_WIDTH; x++ )
         {
-
-            uint32_t pxcol;
-            if( disp == 1 )
-            {
-                uint8_t col = currentFb[(y + x * OLED_HEIGHT) / 8] & (1 << (y & 7));
-                pxcol = col ? OLED_ON_COLOR : BACKGROUND_COLOR;
-            }
-            else
+            uint32_t pxcol = emuPixelColor( ((uint32_t*)currentFb)[x + y * OLED_WIDTH] );
+            int lx;
+            for( lx = 0; lx < px_scale; lx++ )
             {
-                pxcol = ((uint32_t*)currentFb)[x + y * OLED_WIDTH];
-            }
-#ifdef ANDROID
-            pxcol = 0xff000000 | ( (pxcol & 0xff) << 16 ) | ( pxcol & 0xff00 ) | ( (pxcol & 0xff0000) >> 16 );
-#endif
-            int lx, ly;
-            uint32_t* pxloc = rawvidmem + ( x +  ( ( y + yStart ) ) * OLED_WIDTH * px_scale ) * px_scale;
-            for( ly = 0; ly < px_scale; ly++ )
-            {
-                for( lx = 0; lx < px_scale; lx++ )
-                {
-                    pxloc[lx] = pxcol;
-                }
-                pxloc += OLED_WIDTH * px_scale;
+                *(pxloc++) = pxcol;
             }
         }
+        // Copy the first scaled row to the rest
+        int ly;
+        for( ly = 1; ly < px_scale; ly++ )
+        {
+            memcpy( row + ly * stride, row, stride * sizeof( uint32_t ) );
+        }
     }
 }
 
@@ -268,34 +404,25 @@ void emuCheckResize()
 {
     CNFGGetDimensions( &screenx, &screeny );
     int targsx = screenx / OLED_WIDTH;
+#ifdef LINUX
+    // The shared memory buffers are sized for scales up to EMU_SHM_MAX_SCALE,
+    // so they never have to be remapped
+    if( swadgeshm_video && targsx > EMU_SHM_MAX_SCALE )
+    {
+        targsx = EMU_SHM_MAX_SCALE;
+    }
+#endif
     if( targsx != px_scale )
     {
         px_scale = targsx;
         printf( "Rescaling OLED to scale %d\n", px_scale );
 #ifdef LINUX
-        // Unmap old memory
-        munmap(swadgeshm_video_data, swadgeshm_video_data_size);
-
-        // Figure out new size
-        int rawvmsize = px_scale * OLED_WIDTH * px_scale * (HEADER_PIXELS + OLED_HEIGHT + FOOTER_PIXELS) * px_scale * 4;
-        swadgeshm_video_data_size = rawvmsize + 64;
-
-        // Resize the file, should still be open
-        ftruncate( swadgeshm_video, swadgeshm_video_data_size);
-
-        // Remap memory
-        swadgeshm_video_data = (uint32_t*)mmap(0, swadgeshm_video_data_size, PROT_READ | PROT_WRITE, MAP_SHARED,
-                                               swadgeshm_video, 0);
-        swadgeshm_video_data[0] = px_scale * OLED_WIDTH;
-        swadgeshm_video_data[1] = px_scale * OLED_HEIGHT;
-        //[0] = width
-        //[1] = height
-        //[4..12] = LEDs
-        rawvidmem = swadgeshm_video_data + 16;
-#else
-        rawvidmem = realloc( rawvidmem, px_scale * OLED_WIDTH * px_scale * (HEADER_PIXELS + OLED_HEIGHT + FOOTER_PIXELS) *
-                             px_scale * 4 );
+        if( !swadgeshm_video )
 #endif
+        {
+            rawvidmem = realloc( rawvidmem, px_scale * OLED_WIDTH * px_scale * (HEADER_PIXELS + OLED_HEIGHT + FOOTER_PIXELS) *
+                                 px_scale * 4 );
+        }
         updateOLED( false );
     }
 }
@@ -306,8 +433,21 @@ void emuCheckResize()
 //  exitCurrentSwadgeMode();
 // }
 
+/**
+ * @return The time in seconds. This is the wall clock unless recording or
+ *         replaying, in which case it is a deterministic virtual clock
+ */
+double emuGetTime( void )
+{
+    if( EMU_LIVE == emuReplayGetMode() )
+    {
+        return OGGetAbsoluteTime();
+    }
+    return emuReplayGetTime();
+}
+
 #ifndef ANDROID
-    int main()
+    int main( int argc, char** argv )
 #else
     int emumain()
 #endif
@@ -319,6 +459,71 @@ void emuCheckResize()
     double LastFrameTime = OGGetAbsoluteTime();
     double SecToWait;
     int linesegs = 0;
+    extern uint8_t currentFb[];
+
+#ifndef ANDROID
+    const char* goldenFname = NULL;
+    bool updateGolden = false;
+    uint32_t testSeconds = EMU_TEST_DEFAULT_SECONDS;
+    const char* instance = "";
+#ifdef LINUX
+    uint8_t radioRssi = EMU_RADIO_DEFAULT_RSSI;
+    uint8_t radioLossPct = 0;
+#endif
+
+    // Check for record, replay or mode test arguments
+    for( i = 1; i + 1 < argc; i++ )
+    {
+        if( 0 == strcmp( argv[i], "--record" ) )
+        {
+            if( !emuReplayInit( EMU_RECORD, argv[i + 1] ) )
+            {
+                return -1;
+            }
+            atexit( emuReplayDeinit );
+        }
+        else if( 0 == strcmp( argv[i], "--replay" ) )
+        {
+            if( !emuReplayInit( EMU_REPLAY, argv[i + 1] ) )
+            {
+                return -1;
+            }
+        }
+        else if( 0 == strcmp( argv[i], "--test" ) || 0 == strcmp( argv[i], "--golden" ) )
+        {
+            goldenFname = argv[i + 1];
+            updateGolden = ( 0 == strcmp( argv[i], "--golden" ) );
+        }
+        else if( 0 == strcmp( argv[i], "--test-seconds" ) )
+        {
+            testSeconds = atoi( argv[i + 1] );
+        }
+        else if( 0 == strcmp( argv[i], "--instance" ) )
+        {
+            // Appended to the shared memory names, so several emulators can run at once
+            instance = argv[i + 1];
+        }
+#ifdef LINUX
+        else if( 0 == strcmp( argv[i], "--radio-rssi" ) )
+        {
+            radioRssi = atoi( argv[i + 1] );
+        }
+        else if( 0 == strcmp( argv[i], "--radio-loss" ) )
+        {
+            radioLossPct = atoi( argv[i + 1] );
+        }
+#endif
+    }
+#ifdef LINUX
+    emuRadioConfig( radioRssi, radioLossPct );
+#endif
+
+    // The mode test runs headless and exits without opening a window
+    if( NULL != goldenFname )
+    {
+        return emuModeTest( goldenFname, updateGolden, testSeconds );
+    }
+#endif
 
     CNFGBGColor = 0x800000;
     // CNFGDialogColor = 0x444444;
@@ -334,26 +539,23 @@ void emuCheckResize()
 #endif
 
 #ifdef LINUX
-    swadgeshm_video = shm_open("/swadgevideo", O_CREAT | O_RDWR, 0644);
-    swadgeshm_input = shm_open("/swadgeinput", O_CREAT | O_RDWR, 0644);
+    char videoName[32];
+    snprintf( swadgeshm_input_name, sizeof( swadgeshm_input_name ), "/swadgeinput%s", instance );
+    snprintf( videoName, sizeof( videoName ), "/swadgevideo%s", instance );
+    swadgeshm_input = shm_open(swadgeshm_input_name, O_CREAT | O_RDWR, 0644);
     ftruncate( swadgeshm_input, 10 );
     swadgeshm_input_data = mmap(0, 10, PROT_READ | PROT_WRITE, MAP_SHARED, swadgeshm_input, 0);
 
-    swadgeshm_video_data_size = rawvmsize + 64;
-    ftruncate( swadgeshm_video, swadgeshm_video_data_size);
-    swadgeshm_video_data = (uint32_t*)mmap(0, swadgeshm_video_data_size, PROT_READ | PROT_WRITE, MAP_SHARED,
-                                           swadgeshm_video, 0);
-    swadgeshm_video_data[0] = px_scale * OLED_WIDTH;
-    swadgeshm_video_data[1] = px_scale * OLED_HEIGHT;
-    //[0] = width
-    //[1] = height
-    //[4..12] = LEDs
-    rawvidmem = swadgeshm_video_data + 16;
-#else
-    rawvidmem = malloc( rawvmsize );
+    // Draw straight into the shared memory, if it could be created
+    rawvidmem = emuShmVideoInit( videoName );
+    swadgeshm_video = ( NULL != rawvidmem );
+    if( !swadgeshm_video )
 #endif
+    {
+        rawvidmem = malloc( rawvmsize );
+    }
 
-    boottime = OGGetAbsoluteTime();
+    boottime = emuGetTime();
 
     initOLED(0);
 
@@ -365,10 +567,20 @@ void emuCheckResize()
         int i, pos;
         float f;
 
+        if( EMU_LIVE != emuReplayGetMode() )
+        {
+            emuPullMicSamples();
+            emuReplayFrameStart();
+        }
+
         system_os_check_tasks();
         ets_timer_check_timers();
+#ifdef LINUX
+        emuRadioPoll();
+#endif
 
         updateOLED(0);
+        emuReplayFrameHash( currentFb, OLED_WIDTH * OLED_HEIGHT / 8 );
 
         CNFGHandleInput();
 #ifdef LINUX
@@ -381,6 +593,7 @@ void emuCheckResize()
             }
         }
 #endif
+        emuReplayInput();
 
         CNFGClearFrame();
         CNFGColor( 0xFFFFFF );
@@ -389,6 +602,14 @@ void emuCheckResize()
         emuHeader();
         emuFooter();
         CNFGUpdateScreenWithBitmap( rawvidmem, OLED_WIDTH * px_scale, (HEADER_PIXELS + OLED_HEIGHT + FOOTER_PIXELS)*px_scale  );
+#ifdef LINUX
+        if( swadgeshm_video )
+        {
+            // Publish this frame and draw the next one into the next buffer
+            rawvidmem = emuShmVideoPublish( OLED_WIDTH * px_scale, (HEADER_PIXELS + OLED_HEIGHT + FOOTER_PIXELS) * px_scale,
+                                            currentFb, ws2812s, NR_WS2812 );
+        }
+#endif
 
         frames++;
         //CNFGSwapBuffers();
@@ -402,9 +623,14 @@ void emuCheckResize()
             LastFPSTime += 1;
         }
 
+        if( EMU_LIVE != emuReplayGetMode() )
+        {
+            emuReplayAdvanceTime();
+        }
+
         SecToWait = .01 - ( ThisTime - LastFrameTime );
         LastFrameTime += .01;
-        if( SecToWait > 0 )
+        if( SecToWait > 0 && EMU_REPLAY != emuReplayGetMode() )
         {
             OGUSleep( (int)( SecToWait * 1000000 ) );
         }
@@ -418,7 +644,7 @@ void emuCheckResize()
 //General emulation stubs.
 unsigned long os_random()
 {
-    return rand();
+    return emuReplayRandom( rand() );
 }
 void*   ets_memcpy( void* dest, const void* src, size_t n )
 {
@@ -495,7 +721,7 @@ int os_sprintf(char* str, const char* format, ...)
 void LoadDefaultPartitionMap(void) {}
 uint32 system_get_time(void)
 {
-    return (OGGetAbsoluteTime() - boottime) * 1000000;
+    return (emuGetTime() - boottime) * 1000000;
 }
 
 struct rst_info srst =
@@ -606,14 +832,20 @@ void ws2812_push( uint8_t* buffer, uint16_t buffersize )
         col |= (buffer[led * 3 + 0] * 240 / 255 + 15) << 8; // g
         col |= (buffer[led * 3 + 2] * 240 / 255 + 15) << 0; // b
         ws2812s[led] = col;
-#ifdef LINUX
-        swadgeshm_video_data[4 + led] = col;
-#endif
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
+// The garbage os_malloc() fills memory with comes from its own generator, so
+// how much a mode allocates doesn't change what os_random() returns
+static uint32_t mallocFillState = 0xA5A5A5A5;
+
+void emuSeedMallocFill( uint32_t seed )
+{
+    mallocFillState = seed ? seed : 0xA5A5A5A5;
+}
+
 void* os_malloc( int x )
 {
     // Allocate some space
@@ -623,7 +855,11 @@ void* os_malloc( int x )
     {
         for( int i = 0; i < x; i++ )
         {
-            ((uint8_t*)ptr)[i] = rand() & 0xff;
+            // xorshift32
+            mallocFillState ^= mallocFillState << 13;
+            mallocFillState ^= mallocFillState >> 17;
+            mallocFillState ^= mallocFillState << 5;
+            ((uint8_t*)ptr)[i] = mallocFillState & 0xff;
         }
     }
     // Return the space
@@ -724,44 +960,65 @@ void EMUSoundCBType( struct SoundDriver* sd, short* in, short* out, int samplesr
     }
 }
 
+/**
+ * Start the sound driver if it isn't running. There's no sound when headless
+ */
+static void emuInitSound( void )
+{
+    if( !sounddriver && EMU_HEADLESS != emuReplayGetMode() )
+    {
+        sounddriver = InitSound( 0, EMUSoundCBType, 16000, 1, 1, 256, 0, 0 );
+    }
+}
+
 void initMic(void)
 {
     if( !buzzernotemutex )
     {
         buzzernotemutex = OGCreateMutex();
     }
-    if( !sounddriver )
-    {
-        sounddriver = InitSound( 0, EMUSoundCBType, 16000, 1, 1, 256, 0, 0 );
-    }
+    emuInitSound();
 }
 
-uint8_t getSample(void)
+uint16_t getSamples( uint8_t* samples, uint16_t maxSamples )
 {
-    if( sshead != sstail )
+    uint16_t numSamples = 0;
+    if( EMU_LIVE != emuReplayGetMode() )
     {
-        uint8_t r = ssamples[sstail];
-        sstail = (sstail + 1) % SSBUF;
-        return r;
+        while( numSamples < maxSamples && emuReplaySampleAvailable() )
+        {
+            samples[numSamples++] = emuReplayGetSample();
+        }
+        return numSamples;
     }
-    else
+    while( numSamples < maxSamples && sshead != sstail )
     {
-        return 0;
+        samples[numSamples++] = ssamples[sstail];
+        sstail = (sstail + 1) % SSBUF;
     }
+    return numSamples;
 }
 
-bool sampleAvailable(void)
+/**
+ * Pass all microphone samples captured by the sound driver so far to the
+ * recorder. When replaying, live samples are thrown away
+ */
+static void emuPullMicSamples( void )
 {
-    return sstail != sshead;
+    static uint8_t block[SSBUF];
+    uint16_t numSamples = 0;
+    while( sshead != sstail )
+    {
+        block[numSamples++] = ssamples[sstail];
+        sstail = ( sstail + 1 ) % SSBUF;
+    }
+    emuReplayMicSamples( block, numSamples );
 }
 
 void initBuzzer(void)
 {
     stopBuzzerSong();
-    if( !sounddriver )
-    {
-        sounddriver = InitSound( 0, EMUSoundCBType, 16000, 1, 1, 256, 0, 0 );
-    }
+    emuInitSound();
 
     // Keep it high in the idle state
     //setBuzzerGpio(false);
@@ -921,6 +1178,7 @@ void setGpiosForBoot(void)
 #ifndef ANDROID
 void QMA6981_poll(accel_t* currentAccel)
 {
+    emuReplayAccel( currentAccel );
 }
 
 bool QMA6981_setup(void)
@@ -1071,7 +1329,7 @@ void ets_timer_check_timers(void)
     static long long timeMs = -1;
 
     // Get the current time in milliseconds
-    long long currTimeMs = (OGGetAbsoluteTime() - boottime) * 1000;
+    long long currTimeMs = (emuGetTime() - boottime) * 1000;
 
     // If time hasn't been initialized yet
     if(timeMs == -1)
@@ -1233,6 +1491,26 @@ uint32 system_get_free_heap_size(void)
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#ifdef LINUX
+
+void espNowInit(void)
+{
+    emuRadioInit();
+}
+
+void espNowDeinit()
+{
+    emuRadioDeinit();
+    espNowRxFlush();
+}
+
+void ICACHE_FLASH_ATTR espNowSend(const uint8_t* data, uint8_t len)
+{
+    emuRadioSend( data, len );
+}
+
+#else
+
 void espNowInit(void)
 {
     fprintf( stderr, "EMU Warning: TODO: need to implement espNow as a broadcast UDP system\n" );
@@ -1240,6 +1518,7 @@ void espNowInit(void)
 
 void espNowDeinit()
 {
+    espNowRxFlush();
 }
 
 void ICACHE_FLASH_ATTR espNowSend(const uint8_t* data, uint8_t len)
@@ -1247,6 +1526,8 @@ void ICACHE_FLASH_ATTR espNowSend(const uint8_t* data, uint8_t len)
     fprintf( stderr, "EMU Warning: TODO: need to implement espNow as a broadcast UDP system\n" );
 }
 
+#endif
+
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 //Deep sleep.  How do we want to handle it?
@@ -1271,7 +1552,8 @@ bool system_deep_sleep(uint64 time_in_us)
 
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
-//XXX TODO: Handle this more gracefully and test it.
+// flash.dat acts like NOR flash. Erased bytes are 0xFF and writes can only
+// clear bits, so code which writes over unerased flash misbehaves here too
 
 
 static void system_flash_init()
@@ -1280,27 +1562,40 @@ static void system_flash_init()
     if( f )
     {
         uint8_t* raw = malloc(1024 * 1024 * 2);
-        memset( raw, 0, 1024 * 1024 * 2 );
+        memset( raw, 0xff, 1024 * 1024 * 2 );
         fwrite( raw, 1024 * 1024 * 2, 1, f );
         fclose( f );
         free( raw );
     }
     else
     {
-        fprintf( stderr, "EMU Error: Could not open rtc.dat for reading/writing\n" );
+        fprintf( stderr, "EMU Error: Could not open flash.dat for reading/writing\n" );
     }
 }
 
+static FILE* emuFlashOpen( void )
+{
+    FILE* f = fopen( "flash.dat", "rb+" );
+    if( !f )
+    {
+        system_flash_init();
+        f = fopen( "flash.dat", "rb+" );
+    }
+    if( !f )
+    {
+        fprintf( stderr, "EMU Error: Could not open flash.dat for reading/writing\n" );
+    }
+    return f;
+}
 
 SpiFlashOpResult spi_flash_erase_sector(uint16 sec)
 {
-    FILE* f = fopen( "flash.dat", "wb+" );
+    FILE* f = emuFlashOpen();
     if( !f )
     {
-        fprintf( stderr, "EMU Error: Could not open rtc.dat for reading/writing\n" );
         return SPI_FLASH_RESULT_ERR;
     }
-    fseek( f, SEEK_SET, sec *  SPI_FLASH_SEC_SIZE );
+    fseek( f, sec * SPI_FLASH_SEC_SIZE, SEEK_SET );
     uint8_t* erased = malloc(  SPI_FLASH_SEC_SIZE );
     memset( erased, 0xff, SPI_FLASH_SEC_SIZE );
     fwrite( erased, SPI_FLASH_SEC_SIZE, 1, f );
@@ -1311,34 +1606,38 @@ SpiFlashOpResult spi_flash_erase_sector(uint16 sec)
 
 SpiFlashOpResult spi_flash_write(uint32 des_addr, uint32* src_addr, uint32 size)
 {
-    FILE* f = fopen( "flash.dat", "wb+" );
+    if( ( des_addr & 3 ) || ( size & 3 ) || ( (uintptr_t)src_addr & 3 ) )
+    {
+        fprintf( stderr, "EMU Error: spi_flash_write(0x%x, %p, %u) is not four byte aligned\n", des_addr, src_addr, size );
+        return SPI_FLASH_RESULT_ERR;
+    }
+    FILE* f = emuFlashOpen();
     if( !f )
     {
-        fprintf( stderr, "EMU Error: Could not open rtc.dat for reading/writing\n" );
         return SPI_FLASH_RESULT_ERR;
     }
-    fseek( f, SEEK_SET, des_addr );
-    fwrite( src_addr, size, 1, f );
+    uint8_t* data = malloc( size );
+    fseek( f, des_addr, SEEK_SET );
+    int success = fread( data, size, 1, f );
+    for( uint32 i = 0; i < size; i++ )
+    {
+        data[i] &= ((uint8_t*)src_addr)[i];
+    }
+    fseek( f, des_addr, SEEK_SET );
+    success = success && fwrite( data, size, 1, f );
+    free( data );
     fclose( f );
-    return SPI_FLASH_RESULT_OK;
+    return success ? SPI_FLASH_RESULT_OK : SPI_FLASH_RESULT_ERR;
 }
 
 SpiFlashOpResult spi_flash_read(uint32 src_addr, uint32* des_addr, uint32 size)
 {
-    FILE* f = fopen( "flash.dat", "rb" );
+    FILE* f = emuFlashOpen();
     if( !f )
     {
-        system_flash_init();
-        f = fopen( "flash.dat", "rb" );
-    }
-
-    if( !f )
-    {
-        fprintf( stderr, "EMU Error: Could not open flash.dat for reading/writing\n" );
         return SPI_FLASH_RESULT_ERR;
     }
-
-    fseek( f, SEEK_SET, src_addr );
+    fseek( f, src_addr, SEEK_SET );
     int success = fread( des_addr, size, 1, f );
     fclose( f );
     return (success == 1) ? SPI_FLASH_RESULT_OK : SPI_FLASH_RESULT_ERR;
@@ -1348,6 +1647,23 @@ SpiFlashOpResult spi_flash_read(uint32 src_addr, uint32* des_addr, uint32 size)
 // Required functions
 
 void HandleButtonStatus( int button, int bDown )
+{
+    // Live input is ignored when replaying or headless, buttons come from the
+    // recording or the mode test
+    if( EMU_REPLAY == emuReplayGetMode() || EMU_HEADLESS == emuReplayGetMode() )
+    {
+        return;
+    }
+    emuSetButtonStatus( button, bDown );
+}
+
+/**
+ * Set a button's state and queue a button event if it changed
+ *
+ * @param button The button
+ * @param bDown  true if it is pressed, false if it is released
+ */
+void emuSetButtonStatus( int button, int bDown )
 {
     if( bDown )
     {
@@ -1365,9 +1681,38 @@ void HandleButtonStatus( int button, int bDown )
         }
         gpio_status &= ~(1 << button);
     }
+    emuReplayButton( button, bDown );
     HandleButtonEventIRQ( gpio_status, button, (bDown) ? 1 : 0 );
 }
 
+/**
+ * Write a chunk of trace JSON to a file
+ *
+ * @param str The chunk to write
+ * @param ctx The FILE* to write to
+ */
+static void emuTraceWrite( const char* str, void* ctx )
+{
+    fputs( str, (FILE*)ctx );
+}
+
+/**
+ * Dump the trace recorder's buffer as Chrome trace JSON. Open the file in
+ * chrome://tracing or ui.perfetto.dev
+ */
+static void emuDumpTrace( void )
+{
+    FILE* f = fopen( "trace.json", "w" );
+    if( !f )
+    {
+        fprintf( stderr, "EMU Error: Could not open trace.json for writing\n" );
+        return;
+    }
+    traceDumpJson( emuTraceWrite, f );
+    fclose( f );
+    printf( "Wrote %d trace events to trace.json\n", traceGetNumEvents() );
+}
+
 #ifndef ANDROID
 
 void HandleKey( int keycode, int bDown )
@@ -1376,6 +1721,11 @@ void HandleKey( int keycode, int bDown )
     {
         exit( 0 );
     }
+    if( ( keycode == 't' || keycode == 'T' ) && bDown )
+    {
+        emuDumpTrace();
+        return;
+    }
     // printf( "Key: %d -> %d\n", keycode, bDown );
     int button = -1;
     switch( keycode )
@@ -1420,6 +1770,7 @@ void HandleDestroy()
 {
     printf( "Destroying\n" );
     exitCurrentSwadgeMode();
+    emuDumpTrace();
 
     CloseSound(sounddriver);
     if(buzzernotemutex)
@@ -1428,19 +1779,19 @@ void HandleDestroy()
     }
 
 #ifdef LINUX
-    // Unmap old memory
-    munmap(swadgeshm_video_data, swadgeshm_video_data_size);
+    // Unmap and unlink shared memory
     munmap(swadgeshm_input_data, 10);
-
-    // Unlink shared memory
-    shm_unlink("/swadgevideo");
-    shm_unlink("/swadgeinput");
-#else
+    shm_unlink(swadgeshm_input_name);
+    if(swadgeshm_video)
+    {
+        emuShmVideoDeinit();
+        rawvidmem = NULL;
+    }
+#endif
     if(rawvidmem)
     {
         free(rawvidmem);
     }
-#endif
 
     freeAssets();
 }
@@ -1452,6 +1803,10 @@ void HandleDestroy()
 
 bool wifi_get_macaddr(uint8 if_index, uint8* macaddr)
 {
+#ifdef LINUX
+    emuRadioGetMac( macaddr );
+    return true;
+#endif
     static bool warned = false;
     if(!warned)
     {
@@ -21,6 +21,7 @@ extern uint32_t footerpix[FOOTER_PIXELS*OLED_WIDTH];
 extern uint32_t ws2812s[NR_WS2812];
 extern double boottime;
 extern uint8_t gpio_status;
+extern uint32_t oledBytesFlushed;
 
 
 
@@ -31,6 +32,11 @@ void emuSendOLEDData( int which_display, uint8_t * currentFb );
 void emuHeader();
 void emuFooter();
 void emuCheckResize();
+void emuSetButtonStatus( int button, int bDown );
+double emuGetTime( void );
+void system_os_check_tasks( void );
+void ets_timer_check_timers( void );
+void emuSeedMallocFill( uint32_t seed );
 
 
 #endif
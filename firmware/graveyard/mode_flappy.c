@@ -103,7 +103,8 @@ void ICACHE_FLASH_ATTR flappyEnterMode(void);
 void ICACHE_FLASH_ATTR flappyExitMode(void);
 void ICACHE_FLASH_ATTR flappyButtonCallback(uint8_t state __attribute__((unused)),
         int button, int down);
-void ICACHE_FLASH_ATTR flappySampleHandler(int32_t samp);
+void ICACHE_FLASH_ATTR flappySampleHandler(const int16_t* samples, int numSamples);
+void ICACHE_FLASH_ATTR flappyHandleFrame(void);
 
 static void ICACHE_FLASH_ATTR flappyUpdate(void* arg __attribute__((unused)));
 static void ICACHE_FLASH_ATTR flappyMenuCb(const char* menuItem);
@@ -128,7 +129,7 @@ swadgeMode flappyMode =
     .fnEspNowRecvCb = NULL,
     .fnEspNowSendCb = NULL,
     .fnAccelerometerCallback = NULL,
-    .fnAudioCallback = flappySampleHandler,
+    .fnAudioBlockCallback = flappySampleHandler,
     .menuImg = "copter-menu.gif"
 };
 
@@ -590,13 +591,14 @@ void ICACHE_FLASH_ATTR flappyButtonCallback( uint8_t state,
 }
 
 /**
- * This is called every time an audio sample is read from the ADC
- * This processes the sample and will display update the LEDs every
+ * This is called with each block of audio samples read from the ADC
+ * This processes the samples and will display update the LEDs every
  * 128 samples
  *
- * @param samp A 32 bit audio sample read from the ADC (microphone)
+ * @param samples    Filtered audio samples read from the ADC (microphone)
+ * @param numSamples The number of samples
  */
-void ICACHE_FLASH_ATTR flappySampleHandler(int32_t samp)
+void ICACHE_FLASH_ATTR flappySampleHandler(const int16_t* samples, int numSamples)
 {
     switch(flappy->mode)
     {
@@ -607,70 +609,70 @@ void ICACHE_FLASH_ATTR flappySampleHandler(int32_t samp)
         }
         case FLAPPY_GAME:
         {
-            PushSample32( samp );
-            flappy->samplesProcessed++;
-
-            // If at least 128 samples have been processed
-            if( flappy->samplesProcessed >= 128 )
-            {
-                // Colorchord magic
-                HandleFrameInfo();
+            PushSamplesFramed32(samples, numSamples, 128, &flappy->samplesProcessed, flappyHandleFrame);
+            break;
+        }
+    }
+}
 
-                if(checkClap())
-                {
-                    os_printf("CLAP\n");
-                }
+/**
+ * This is called after every 128 samples while the game is played. It
+ * processes them and checks for claps
+ */
+void ICACHE_FLASH_ATTR flappyHandleFrame(void)
+{
+    // Colorchord magic
+    HandleFrameInfo();
 
-                // flappy->oldPeakFreq = flappy->peakFreq;
-                // flappy->peakFreq = findPeakFreq();
-                // // os_printf("%d\n", flappy->peakFreq);
-
-                // static int maxF = 0;
-                // if(flappy->peakFreq > maxF)
-                // {
-                //     maxF = flappy->peakFreq;
-                //     os_printf("MF %d\n", maxF);
-                // }
-
-                // int16_t delta = flappy->peakFreq - flappy->oldPeakFreq;
-                // if(delta > 80)
-                // {
-                //     delta = -(delta - 191);
-                // }
-                // else if (delta < -80)
-                // {
-                //     delta = -(delta + 191);
-                // }
-
-                // if((1 < delta && delta < 7) || (-7 < delta && delta < -1) )
-                // {
-                //     os_printf("%d\n", delta);
-
-                //     flappy->chopperPos -= (delta / 2);
-                //     if(flappy->chopperPos < 0)
-                //     {
-                //         flappy->chopperPos = 0;
-                //     }
-                //     else if (flappy->chopperPos > OLED_HEIGHT - 16)
-                //     {
-                //         flappy->chopperPos = OLED_HEIGHT - 16;
-                //     }
-                // }
-
-                // if(flappy->peakFreq > flappy->oldPeakFreq)
-                // {
-                //     // TODO go up!
-                // }
-                // else if(flappy->peakFreq > flappy->oldPeakFreq)
-                // {
-                //     // TODO go down!
-                // }
-
-                // Reset the sample count
-                flappy->samplesProcessed = 0;
-            }
-        }
+    if(checkClap())
+    {
+        os_printf("CLAP\n");
     }
+
+    // flappy->oldPeakFreq = flappy->peakFreq;
+    // flappy->peakFreq = findPeakFreq();
+    // // os_printf("%d\n", flappy->peakFreq);
+
+    // static int maxF = 0;
+    // if(flappy->peakFreq > maxF)
+    // {
+    //     maxF = flappy->peakFreq;
+    //     os_printf("MF %d\n", maxF);
+    // }
+
+    // int16_t delta = flappy->peakFreq - flappy->oldPeakFreq;
+    // if(delta > 80)
+    // {
+    //     delta = -(delta - 191);
+    // }
+    // else if (delta < -80)
+    // {
+    //     delta = -(delta + 191);
+    // }
+
+    // if((1 < delta && delta < 7) || (-7 < delta && delta < -1) )
+    // {
+    //     os_printf("%d\n", delta);
+
+    //     flappy->chopperPos -= (delta / 2);
+    //     if(flappy->chopperPos < 0)
+    //     {
+    //         flappy->chopperPos = 0;
+    //     }
+    //     else if (flappy->chopperPos > OLED_HEIGHT - 16)
+    //     {
+    //         flappy->chopperPos = OLED_HEIGHT - 16;
+    //     }
+    // }
+
+    // if(flappy->peakFreq > flappy->oldPeakFreq)
+    // {
+    //     // TODO go up!
+    // }
+    // else if(flappy->peakFreq > flappy->oldPeakFreq)
+    // {
+    //     // TODO go down!
+    // }
 }
 
 /**
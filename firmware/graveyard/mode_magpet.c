@@ -341,7 +341,7 @@ void ICACHE_FLASH_ATTR magpetMsgTxCbFn(p2pInfo* p2p __attribute__((unused)),
 void ICACHE_FLASH_ATTR sendWhoAmI(p2pInfo* p2p)
 {
     char myPetStr[] = {'0' + myPet, 0};
-    p2pSendMsg(p2p, ID_NUM, myPetStr, ets_strlen(myPetStr), magpetMsgTxCbFn);
+    p2pSendMsg(p2p, ID_NUM, (const uint8_t*)myPetStr, ets_strlen(myPetStr), magpetMsgTxCbFn);
 }
 
 /**
@@ -175,7 +175,7 @@ void ICACHE_FLASH_ATTR ringButtonCallback(uint8_t state __attribute__((unused)),
                 {
                     // Otherwise send a message
                     p2pSendMsg(&(getSideConnection(side)->p2p), TST_LABEL,
-                               TST_MSG, sizeof(TST_MSG), ringMsgTxCbFn);
+                               (const uint8_t*)TST_MSG, sizeof(TST_MSG), ringMsgTxCbFn);
                 }
                 break;
             }
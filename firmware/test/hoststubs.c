@@ -0,0 +1,156 @@
+/*
+ * hoststubs.c
+ *
+ * The few SDK and emulator functions the firmware utilities need, so they can
+ * be linked into a plain host program without swadgemu's window and sound
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "c_types.h"
+#include "user_interface.h"
+#include "ccconfig.h"
+
+// The defaults from mode_colorchord.c
+struct CCSettings CCS =
+{
+    .gSETTINGS_KEY         = 0,
+    .gROOT_NOTE_OFFSET     = 0,
+    .gDFTIIR               = 6,
+    .gFUZZ_IIR_BITS        = 1,
+    .gFILTER_BLUR_PASSES   = 2,
+    .gSEMIBITSPERBIN       = 3,
+    .gMAX_JUMP_DISTANCE    = 4,
+    .gMAX_COMBINE_DISTANCE = 7,
+    .gAMP_1_IIR_BITS       = 4,
+    .gAMP_2_IIR_BITS       = 2,
+    .gMIN_AMP_FOR_NOTE     = 80,
+    .gMINIMUM_AMP_FOR_NOTE_TO_DISAPPEAR = 64,
+    .gNOTE_FINAL_AMP       = 12,
+    .gNERF_NOTE_PORP       = 15,
+    .gUSE_NUM_LIN_LEDS     = 6,
+    .gCOLORCHORD_ACTIVE    = 1,
+    .gCOLORCHORD_OUTPUT_DRIVER = 1,
+    .gINITIAL_AMP          = 16
+};
+
+void* ets_memcpy( void* dest, const void* src, size_t n )
+{
+    return memcpy( dest, src, n );
+}
+
+void* ets_memset( void* s, int c, size_t n )
+{
+    return memset( s, c, n );
+}
+
+void* ets_memmove( void* dest, const void* src, size_t n )
+{
+    return memmove( dest, src, n );
+}
+
+int ets_memcmp( const void* a, const void* b, size_t n )
+{
+    return memcmp( a, b, n );
+}
+
+int ets_strlen( const char* s )
+{
+    return strlen( s );
+}
+
+char* ets_strncpy( char* destination, const char* source, size_t num )
+{
+    return strncpy( destination, source, num );
+}
+
+int ets_strcmp( const char* str1, const char* str2 )
+{
+    return strcmp( str1, str2 );
+}
+
+void* os_malloc( int x )
+{
+    return malloc( x );
+}
+
+void* os_zalloc( int x )
+{
+    return calloc( 1, x );
+}
+
+void os_free( void* x )
+{
+    free( x );
+}
+
+unsigned long os_random()
+{
+    return rand();
+}
+
+int os_printf( const char* format, ... )
+{
+    va_list argp;
+    va_start( argp, format );
+    int out = vprintf( format, argp );
+    va_end( argp );
+    return out;
+}
+
+// While the clock is stopped, system_get_time() returns this instead, so tests
+// of timeouts can step time themselves
+static bool hostClockStopped = false;
+static uint32 hostClockUs = 0;
+
+uint32 system_get_time( void )
+{
+    if( hostClockStopped )
+    {
+        return hostClockUs;
+    }
+
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( uint32 )( ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000 );
+}
+
+/**
+ * Stop system_get_time() at the current time
+ */
+void hostClockStop( void )
+{
+    hostClockUs = system_get_time();
+    hostClockStopped = true;
+}
+
+/**
+ * Move the stopped clock forward
+ *
+ * @param us How many microseconds to move it
+ */
+void hostClockAdvance( uint32 us )
+{
+    hostClockUs += us;
+}
+
+/**
+ * Let system_get_time() follow the real clock again
+ */
+void hostClockRun( void )
+{
+    hostClockStopped = false;
+}
+
+/**
+ * The emulator's OLED sends frames to the window, there is no window here
+ */
+void emuSendOLEDData( int which_display __attribute__( ( unused ) ),
+                      uint8_t* currentFb __attribute__( ( unused ) ) )
+{
+    ;
+}
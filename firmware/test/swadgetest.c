@@ -0,0 +1,2224 @@
+/*
+ * swadgetest.c
+ *
+ * Correctness tests and microbenchmarks for the firmware utilities, built as
+ * a plain host program. Run with no arguments to test, or with --bench to
+ * also time each benchmark and report nanoseconds per operation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "c_types.h"
+#include "user_interface.h"
+#include "oled.h"
+#include "bresenham.h"
+#include "cndraw.h"
+#include "font.h"
+#include "menu2d.h"
+#include "assets.h"
+#include "gif_cache.h"
+#include "fastlz.h"
+#include "linked_list.h"
+#include "hsv_utils.h"
+#include "led_compositor.h"
+#include "fixed_math.h"
+#include "goertzel_tuner.h"
+#include "p2pConnection.h"
+#include "p2pSession.h"
+#include "DFT32.h"
+#include "embeddednf.h"
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+#define TEST_SEED 0x5AD6E
+
+// Each benchmark is repeated until it has run at least this long
+#define BENCH_MIN_NS 50000000.0
+
+// fastlz level 1 limits
+#define LZ_MAX_LITERALS 32
+#define LZ_MAX_MATCH    264
+#define LZ_MAX_DISTANCE 8192
+#define LZ_WINDOW       2048
+
+#define LZ_TEST_LEN 4096
+#define SPRITE_W 32
+#define SPRITE_H 32
+#define NUM_BENCH_LINES 64
+#define LIST_OPS 64
+#define FB_BYTES ( OLED_WIDTH * ( OLED_HEIGHT / 8 ) )
+
+// Gifs in the test asset pack, and how many words it can hold
+#define GIF_TEST_NUM 6
+#define GIF_TEST_WORDS 8192
+
+// Swadges on the emulated air, and how many packets can be in flight
+#define P2P_TEST_NODES 3
+#define P2P_TEST_AIR_LEN 64
+#define P2P_TEST_RX_LOG 16
+#define P2P_TEST_RSSI 60
+
+#define ARRAY_LEN( a ) ( sizeof( a ) / sizeof( ( a )[0] ) )
+
+#define TEST_CHECK( cond ) do { \
+        if( !( cond ) ) \
+        { \
+            printf( "  %s:%d: %s\n", __FILE__, __LINE__, #cond ); \
+            return false; \
+        } \
+    } while( 0 )
+
+/*============================================================================
+ * Structs
+ *==========================================================================*/
+
+typedef struct
+{
+    const char* name;
+    bool ( *fn )( void );
+} testCase_t;
+
+typedef struct
+{
+    const char* name;
+    void ( *fn )( void );
+} benchCase_t;
+
+/// A packet sent by one swadge, which every other swadge receives
+typedef struct
+{
+    uint8_t from;
+    uint8_t len;
+    uint8_t data[P2P_MAX_PACKET_LEN];
+} p2pTestPkt_t;
+
+/// A message a swadge mode received
+typedef struct
+{
+    uint8_t node;
+    char cmd[4];
+    uint8_t len;
+    uint8_t payload[P2P_MAX_PACKET_LEN];
+} p2pTestRx_t;
+
+// Passes a packet to a swadge's p2p code
+typedef void ( *p2pTestRecvFn )( uint8_t node, uint8_t* mac, uint8_t* data, uint8_t len );
+
+// Returns true to lose a packet on the way from one swadge to another
+typedef bool ( *p2pTestDropFn )( uint8_t from, uint8_t to, const uint8_t* data, uint8_t len );
+
+/*============================================================================
+ * Variables
+ *==========================================================================*/
+
+static uint8_t lzRaw[LZ_TEST_LEN];
+static uint8_t lzPacked[LZ_TEST_LEN * 2];
+static int lzPackedLen;
+static uint8_t lzOut[LZ_TEST_LEN];
+
+static pngHandle sprite;
+static color spritePx[SPRITE_H][SPRITE_W];
+
+static int16_t benchLines[NUM_BENCH_LINES][4];
+static int16_t audioBlock[128];
+static goertzelTuner_t benchTuner;
+
+static node_t listNodes[LIST_OPS];
+static nodePool_t listPool;
+
+// The framebuffer, from oled.c
+extern uint8_t currentFb[OLED_WIDTH * ( OLED_HEIGHT / 8 )];
+extern bool fbChanges;
+
+// Not in font.h, but the text cache must match it
+int16_t plotChar( int16_t x, int16_t y, char character, const font_t* font, color col );
+
+// What ws2812_push() last sent to the LEDs, and how many times
+static uint8_t ledShown[NUM_LIN_LEDS * sizeof( led_t )];
+
+// An asset pack of one frame gifs, from assets.c
+extern uint32_t* assets;
+static uint32_t gifAssets[GIF_TEST_WORDS];
+static uint32_t ledNumPushes;
+
+// Benchmarks write here so their work isn't optimized away
+static volatile uint32_t benchSink;
+
+// The p2p tests' swadges. They're static because their timers stay linked
+// into the timer wheel while armed
+static p2pInfo p2pNodes[P2P_TEST_NODES];
+static p2pSession sesNodes[P2P_TEST_NODES];
+
+// Packets sent but not yet received, and what's done with them
+static p2pTestPkt_t p2pAir[P2P_TEST_AIR_LEN];
+static uint8_t p2pAirHead;
+static uint8_t p2pAirTail;
+static p2pTestRecvFn p2pRecv;
+static p2pTestDropFn p2pDrop;
+
+// The swadge whose code is running, which espNowSend() sends as
+static uint8_t p2pCurNode;
+
+// What the swadge modes were told
+static p2pTestRx_t p2pRxLog[P2P_TEST_RX_LOG];
+static uint16_t p2pRxLogLen;
+static uint16_t p2pNumAcked;
+static uint16_t p2pNumFailed;
+static uint8_t sesNumJoined;
+static uint8_t sesNumLeft;
+
+// The sequence number p2pTestDropSeqOnce() loses, and the last ACK it saw
+static uint8_t p2pDropSeq;
+static bool p2pDropArmed;
+static uint8_t p2pLastAck[sizeof( p2pPktHdr_t ) + 2];
+
+// Step the clock, from hoststubs.c
+void hostClockStop( void );
+void hostClockAdvance( uint32 us );
+void hostClockRun( void );
+
+// Not in p2pConnection.h, but the tests run the timers themselves
+void p2pConnectionTimeout( void* arg );
+void p2pTxRetryTimeout( void* arg );
+void p2pRttSample( p2pInfo* p2p, uint32_t rttUs );
+void p2pAggTimeout( void* arg );
+void p2pSessionTick( void* arg );
+
+/*============================================================================
+ * Helpers
+ *==========================================================================*/
+
+/**
+ * @return A monotonic time in nanoseconds
+ */
+static double nowNs( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @return The number of lit pixels on the OLED
+ */
+static uint32_t countWhite( void )
+{
+    uint32_t lit = 0;
+    for( int16_t y = 0; y < OLED_HEIGHT; y++ )
+    {
+        for( int16_t x = 0; x < OLED_WIDTH; x++ )
+        {
+            if( WHITE == getPixel( x, y ) )
+            {
+                lit++;
+            }
+        }
+    }
+    return lit;
+}
+
+/**
+ * Receive a frame from the LED compositor, instead of the LEDs
+ */
+void ws2812_push( uint8_t* buffer, uint16_t buffersize )
+{
+    memcpy( ledShown, buffer, buffersize < sizeof( ledShown ) ? buffersize : sizeof( ledShown ) );
+    ledNumPushes++;
+}
+
+/**
+ * Run ledCompUpdate() like procTask() does, many times per dither period, and
+ * find how bright each channel looked on average
+ *
+ * @param periods How many dither periods to run for
+ * @param avg     Written with each channel's average value
+ */
+static void ledTestRun( uint32_t periods, double* avg )
+{
+    uint64_t sum[ARRAY_LEN( ledShown )] = {0};
+    uint32_t steps = periods * ( LED_DITHER_PERIOD_US / 100 );
+    for( uint32_t i = 0; i < steps; i++ )
+    {
+        ledCompUpdate();
+        for( uint8_t c = 0; c < ARRAY_LEN( ledShown ); c++ )
+        {
+            sum[c] += ledShown[c];
+        }
+        hostClockAdvance( 100 );
+    }
+    for( uint8_t c = 0; c < ARRAY_LEN( ledShown ); c++ )
+    {
+        avg[c] = ( double )sum[c] / steps;
+    }
+}
+
+/**
+ * Get a test swadge's MAC
+ *
+ * @param node The swadge
+ * @param mac  Six bytes to write the MAC to
+ */
+static void p2pTestMac( uint8_t node, uint8_t* mac )
+{
+    const uint8_t base[6] = { 0x02, 0x53, 0x57, 0x00, 0x00, 0x00 };
+    memcpy( mac, base, sizeof( base ) );
+    mac[5] = node;
+}
+
+/**
+ * The SDK's MAC, which is the MAC of the swadge whose code is running
+ */
+bool wifi_get_macaddr( uint8 if_index __attribute__( ( unused ) ), uint8* macaddr )
+{
+    p2pTestMac( p2pCurNode, macaddr );
+    return true;
+}
+
+/**
+ * Put a packet on the air, from the swadge whose code is running
+ */
+void espNowSend( const uint8_t* data, uint8_t len )
+{
+    p2pTestPkt_t* pkt = &p2pAir[p2pAirTail % P2P_TEST_AIR_LEN];
+    pkt->from = p2pCurNode;
+    pkt->len = len;
+    memcpy( pkt->data, data, len );
+    p2pAirTail++;
+}
+
+/**
+ * @return The number of packets sent but not yet received
+ */
+static uint8_t p2pAirLen( void )
+{
+    return p2pAirTail - p2pAirHead;
+}
+
+/**
+ * @param i Which packet in flight, 0 is the oldest
+ * @return The packet
+ */
+static p2pTestPkt_t* p2pAirPeek( uint8_t i )
+{
+    return &p2pAir[( uint8_t )( p2pAirHead + i ) % P2P_TEST_AIR_LEN];
+}
+
+/**
+ * Pass every packet in flight to every other swadge, unless p2pDrop loses it,
+ * until nothing more is sent
+ */
+static void p2pTestDeliver( void )
+{
+    while( p2pAirHead != p2pAirTail )
+    {
+        // Copy it out, receiving may send more
+        p2pTestPkt_t pkt = *p2pAirPeek( 0 );
+        p2pAirHead++;
+
+        uint8_t mac[6];
+        p2pTestMac( pkt.from, mac );
+        for( uint8_t to = 0; to < P2P_TEST_NODES; to++ )
+        {
+            if( to != pkt.from && ( NULL == p2pDrop || !p2pDrop( pkt.from, to, pkt.data, pkt.len ) ) )
+            {
+                p2pCurNode = to;
+                p2pRecv( to, mac, pkt.data, pkt.len );
+            }
+        }
+    }
+}
+
+/**
+ * Throw away every packet in flight
+ */
+static void p2pTestClearAir( void )
+{
+    p2pAirHead = p2pAirTail;
+}
+
+/**
+ * Stop the clock and forget the last test's packets and messages
+ *
+ * @param recv How swadges receive packets
+ */
+static void p2pTestBegin( p2pTestRecvFn recv )
+{
+    hostClockStop();
+    p2pTestClearAir();
+    p2pRecv = recv;
+    p2pDrop = NULL;
+    p2pRxLogLen = 0;
+    p2pNumAcked = 0;
+    p2pNumFailed = 0;
+    sesNumJoined = 0;
+    sesNumLeft = 0;
+}
+
+/**
+ * Stop the swadges' timers and start the clock again
+ */
+static void p2pTestEnd( void )
+{
+    for( uint8_t n = 0; n < P2P_TEST_NODES; n++ )
+    {
+        p2pDeinit( &p2pNodes[n] );
+        p2pSessionDeinit( &sesNodes[n] );
+    }
+    hostClockRun();
+}
+
+/**
+ * Log a message a swadge mode received. Only the first P2P_TEST_RX_LOG are
+ * kept, but all are counted
+ */
+static void p2pTestLogRx( uint8_t node, const char* cmd, const uint8_t* payload, uint8_t len )
+{
+    if( p2pRxLogLen < P2P_TEST_RX_LOG )
+    {
+        p2pTestRx_t* rx = &p2pRxLog[p2pRxLogLen];
+        rx->node = node;
+        snprintf( rx->cmd, sizeof( rx->cmd ), "%s", cmd );
+        rx->len = len;
+        memcpy( rx->payload, payload, len );
+    }
+    p2pRxLogLen++;
+}
+
+/**
+ * Lose the first message with sequence number p2pDropSeq, once, and save the
+ * last ACK sent
+ */
+static bool p2pTestDropSeqOnce( uint8_t from __attribute__( ( unused ) ), uint8_t to __attribute__( ( unused ) ),
+                                const uint8_t* data, uint8_t len )
+{
+    const p2pPktHdr_t* hdr = ( const p2pPktHdr_t* )data;
+    if( P2P_PKT_ACK == hdr->type && sizeof( p2pLastAck ) == len )
+    {
+        memcpy( p2pLastAck, data, len );
+    }
+    if( p2pDropArmed && P2P_PKT_MSG == hdr->type && p2pDropSeq == hdr->seq )
+    {
+        p2pDropArmed = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * A p2pConnection swadge receives a packet
+ */
+static void p2pTestRecvCb( uint8_t node, uint8_t* mac, uint8_t* data, uint8_t len )
+{
+    p2pRecvCb( &p2pNodes[node], mac, data, len, P2P_TEST_RSSI );
+}
+
+/**
+ * A p2pConnection swadge mode receives a message
+ */
+static void p2pTestMsgRxCb( p2pInfo* p2p, char* msg, uint8_t* payload, uint8_t len )
+{
+    p2pTestLogRx( p2p - p2pNodes, msg, payload, len );
+}
+
+/**
+ * A p2pConnection swadge mode hears whether its message was ACKed
+ */
+static void p2pTestMsgTxCb( p2pInfo* p2p __attribute__( ( unused ) ), messageStatus_t status )
+{
+    if( MSG_ACKED == status )
+    {
+        p2pNumAcked++;
+    }
+    else
+    {
+        p2pNumFailed++;
+    }
+}
+
+/**
+ * Connect swadges 0 and 1 with p2pConnection, like two modes would
+ *
+ * @return true if they both connected
+ */
+static bool p2pTestConnect( void )
+{
+    for( uint8_t n = 0; n < 2; n++ )
+    {
+        p2pCurNode = n;
+        p2pInitialize( &p2pNodes[n], "tst", NULL, p2pTestMsgRxCb, 0 );
+        p2pStartConnection( &p2pNodes[n] );
+    }
+
+    // Each broadcasts once, which is enough when nothing is lost. They're
+    // heard one after the other, so one goes first
+    for( uint8_t n = 0; n < 2; n++ )
+    {
+        p2pCurNode = n;
+        p2pConnectionTimeout( &p2pNodes[n] );
+        p2pTestDeliver();
+    }
+
+    playOrder_t order0 = p2pGetPlayOrder( &p2pNodes[0] );
+    playOrder_t order1 = p2pGetPlayOrder( &p2pNodes[1] );
+    return NOT_SET != order0 && NOT_SET != order1 && order0 != order1;
+}
+
+/**
+ * Have a p2pConnection swadge send a message now, without waiting to
+ * aggregate it
+ *
+ * @return true if it was sent
+ */
+static bool p2pTestSend( uint8_t node, char* cmd, const char* payload )
+{
+    p2pCurNode = node;
+    return p2pSendMsg( &p2pNodes[node], cmd, ( const uint8_t* )payload, strlen( payload ), p2pTestMsgTxCb ) &&
+           p2pFlushMsgs( &p2pNodes[node] );
+}
+
+/**
+ * A p2pSession swadge receives a packet
+ */
+static void sesTestRecvCb( uint8_t node, uint8_t* mac, uint8_t* data, uint8_t len )
+{
+    p2pSessionRecvCb( &sesNodes[node], mac, data, len, P2P_TEST_RSSI );
+}
+
+/**
+ * A p2pSession swadge mode hears that a peer joined or left
+ */
+static void sesTestPeerCb( p2pSession* ses __attribute__( ( unused ) ),
+                           p2pSesPeer_t* peer __attribute__( ( unused ) ), p2pSesPeerEvt_t evt )
+{
+    if( PEER_JOINED == evt )
+    {
+        sesNumJoined++;
+    }
+    else
+    {
+        sesNumLeft++;
+    }
+}
+
+/**
+ * A p2pSession swadge mode receives a message
+ */
+static void sesTestMsgRxCb( p2pSession* ses, p2pSesPeer_t* peer __attribute__( ( unused ) ),
+                            char* msg, uint8_t* payload, uint8_t len )
+{
+    p2pTestLogRx( ses - sesNodes, msg, payload, len );
+}
+
+/**
+ * A p2pSession swadge mode hears whether every peer ACKed its message
+ */
+static void sesTestMsgTxCb( p2pSession* ses __attribute__( ( unused ) ), messageStatus_t status )
+{
+    p2pTestMsgTxCb( NULL, status );
+}
+
+/**
+ * Move the clock forward, run the ticks of some session swadges, then
+ * deliver what they sent
+ *
+ * @param us    How many microseconds to move the clock
+ * @param nodes A bitmask of the swadges to tick
+ */
+static void sesTestTick( uint32_t us, uint8_t nodes )
+{
+    hostClockAdvance( us );
+    for( uint8_t n = 0; n < P2P_TEST_NODES; n++ )
+    {
+        if( nodes & ( 1 << n ) )
+        {
+            p2pCurNode = n;
+            p2pSessionTick( &sesNodes[n] );
+        }
+    }
+    p2pTestDeliver();
+}
+
+/**
+ * @param node Which swadge to look in
+ * @param peer Which swadge to look for
+ * @return The index of a peer in a session swadge's table, or -1
+ */
+static int8_t sesTestPeerIdx( uint8_t node, uint8_t peer )
+{
+    uint8_t mac[6];
+    p2pTestMac( peer, mac );
+    p2pSesPeer_t* p = p2pSessionGetPeer( &sesNodes[node], mac );
+    return ( NULL == p ) ? -1 : ( p - sesNodes[node].peers );
+}
+
+/**
+ * Count the messages a swadge's mode received, and check they're the ones
+ * expected, in order
+ *
+ * @param node The swadge
+ * @param cmds The messages it should have received, in order
+ * @param numCmds The number of messages
+ * @return true if it received exactly those
+ */
+static bool sesTestReceived( uint8_t node, const char* const* cmds, uint8_t numCmds )
+{
+    uint8_t found = 0;
+    for( uint16_t i = 0; i < p2pRxLogLen && i < P2P_TEST_RX_LOG; i++ )
+    {
+        if( node == p2pRxLog[i].node )
+        {
+            if( found >= numCmds || 0 != strcmp( cmds[found], p2pRxLog[i].cmd ) )
+            {
+                return false;
+            }
+            found++;
+        }
+    }
+    return found == numCmds;
+}
+
+/**
+ * Lose the first session message from swadge 0 to swadge 1, once
+ */
+static bool sesTestDropFirstTo1( uint8_t from, uint8_t to, const uint8_t* data,
+                                 uint8_t len __attribute__( ( unused ) ) )
+{
+    const p2pSesHdr_t* hdr = ( const p2pSesHdr_t* )data;
+    if( p2pDropArmed && 0 == from && 1 == to && P2P_SES_PKT_MSG == hdr->type )
+    {
+        p2pDropArmed = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Cut swadge 2 off from the others
+ */
+static bool sesTestDrop2( uint8_t from, uint8_t to, const uint8_t* data __attribute__( ( unused ) ),
+                          uint8_t len __attribute__( ( unused ) ) )
+{
+    return 2 == from || 2 == to;
+}
+
+/**
+ * A small greedy compressor for the fastlz level 1 format, since the firmware
+ * only carries the decompressor
+ *
+ * @param in  The data to compress
+ * @param len The length of the data
+ * @param out Where to write the compressed data, at least 2 * len bytes
+ * @return The compressed length
+ */
+static int lzCompress( const uint8_t* in, int len, uint8_t* out )
+{
+    int ip = 0;
+    int op = 0;
+    int litStart = 0;
+
+    while( ip < len )
+    {
+        int bestLen = 0;
+        int bestDist = 0;
+        for( int d = 1; d <= LZ_WINDOW && d <= ip; d++ )
+        {
+            int l = 0;
+            while( ip + l < len && l < LZ_MAX_MATCH && in[ip + l] == in[ip + l - d] )
+            {
+                l++;
+            }
+            if( l > bestLen )
+            {
+                bestLen = l;
+                bestDist = d;
+            }
+        }
+
+        if( bestLen < 3 )
+        {
+            ip++;
+            if( ip - litStart == LZ_MAX_LITERALS || ip == len )
+            {
+                out[op++] = ip - litStart - 1;
+                memcpy( &out[op], &in[litStart], ip - litStart );
+                op += ip - litStart;
+                litStart = ip;
+            }
+            continue;
+        }
+
+        // Flush pending literals before the match
+        if( ip > litStart )
+        {
+            out[op++] = ip - litStart - 1;
+            memcpy( &out[op], &in[litStart], ip - litStart );
+            op += ip - litStart;
+        }
+
+        int dist = bestDist - 1;
+        if( bestLen < 9 )
+        {
+            out[op++] = ( ( bestLen - 2 ) << 5 ) | ( dist >> 8 );
+        }
+        else
+        {
+            out[op++] = ( 7 << 5 ) | ( dist >> 8 );
+            out[op++] = bestLen - 9;
+        }
+        out[op++] = dist & 0xFF;
+
+        ip += bestLen;
+        litStart = ip;
+    }
+    return op;
+}
+
+/**
+ * Pack one frame gifs into gifAssets, the way the asset packer does, and use
+ * it as the asset pack. Gif i is named "gif<i>", is dims[i][0] by dims[i][1],
+ * and every byte of its frame is i
+ *
+ * @param dims The width and height of each gif
+ */
+static void gifAssetsPack( const uint16_t dims[GIF_TEST_NUM][2] )
+{
+    static uint8_t frame[FB_BYTES + 1];
+    static uint8_t packed[2 * sizeof( frame )];
+
+    memset( gifAssets, 0, sizeof( gifAssets ) );
+    uint32_t idx = 0;
+    gifAssets[idx++] = GIF_TEST_NUM;
+    uint32_t dataIdx = 1 + GIF_TEST_NUM * 6;
+    for( uint8_t i = 0; i < GIF_TEST_NUM; i++ )
+    {
+        snprintf( ( char* )&gifAssets[idx], 16, "gif%u", i );
+        idx += 4;
+        gifAssets[idx++] = dataIdx * sizeof( uint32_t );
+        uint32_t start = dataIdx;
+
+        gifAssets[dataIdx++] = dims[i][0];
+        gifAssets[dataIdx++] = dims[i][1];
+        gifAssets[dataIdx++] = 1;
+        gifAssets[dataIdx++] = 100;
+        uint32_t frameLen = ( dims[i][0] * dims[i][1] + 8 ) / 8;
+        memset( frame, i, frameLen );
+        int packedLen = lzCompress( frame, frameLen, packed );
+        gifAssets[dataIdx++] = packedLen;
+        memcpy( &gifAssets[dataIdx], packed, packedLen );
+        dataIdx += ( packedLen + 3 ) / 4;
+        gifAssets[idx++] = ( dataIdx - start ) * sizeof( uint32_t );
+    }
+    assets = gifAssets;
+}
+
+/**
+ * Encode pixels the way the asset packer does: 1 is black, 00 is white and 01
+ * is transparent, packed MSB first into 32 bit words
+ *
+ * @param handle The handle to fill, its data is malloc'd
+ * @param px     The pixels, row by row
+ * @param w      The width
+ * @param h      The height
+ */
+static void spriteEncode( pngHandle* handle, const color* px, uint16_t w, uint16_t h )
+{
+    uint32_t maxWords = ( 2 * w * h + 31 ) / 32 + 1;
+    handle->data = calloc( maxWords, sizeof( uint32_t ) );
+    handle->width = w;
+    handle->height = h;
+
+    uint32_t bit = 0;
+    for( uint32_t i = 0; i < ( uint32_t )( w * h ); i++ )
+    {
+        uint8_t code;
+        uint8_t bits;
+        switch( px[i] )
+        {
+            case BLACK:
+            {
+                code = 0x1;
+                bits = 1;
+                break;
+            }
+            case WHITE:
+            {
+                code = 0x0;
+                bits = 2;
+                break;
+            }
+            case INVERSE:
+            case TRANSPARENT_COLOR:
+            default:
+            {
+                code = 0x1;
+                bits = 2;
+                break;
+            }
+        }
+        for( int8_t b = bits - 1; b >= 0; b-- )
+        {
+            if( code & ( 1 << b ) )
+            {
+                handle->data[bit / 32] |= 0x80000000 >> ( bit % 32 );
+            }
+            bit++;
+        }
+    }
+    handle->dataLen = ( bit + 31 ) / 32;
+}
+
+/**
+ * Set up the data shared by the tests and benchmarks
+ */
+static void setupFixtures( void )
+{
+    srand( TEST_SEED );
+
+    // Text-like data with repeats at many distances
+    static const char* words[] = { "swadge ", "colorchord ", "demon ", "ddr ", "magfest ", "\n", "0123 " };
+    int n = 0;
+    while( n < LZ_TEST_LEN )
+    {
+        const char* w = words[rand() % ARRAY_LEN( words )];
+        while( *w && n < LZ_TEST_LEN )
+        {
+            lzRaw[n++] = *w++;
+        }
+        if( 0 == rand() % 8 && n < LZ_TEST_LEN )
+        {
+            lzRaw[n++] = rand() & 0xFF;
+        }
+    }
+    lzPackedLen = lzCompress( lzRaw, LZ_TEST_LEN, lzPacked );
+
+    for( uint16_t y = 0; y < SPRITE_H; y++ )
+    {
+        for( uint16_t x = 0; x < SPRITE_W; x++ )
+        {
+            static const color cols[] = { BLACK, WHITE, TRANSPARENT_COLOR };
+            spritePx[y][x] = cols[( x * 7 + y * 3 + ( x ^ y ) ) % 3];
+        }
+    }
+    spriteEncode( &sprite, &spritePx[0][0], SPRITE_W, SPRITE_H );
+
+    for( uint8_t i = 0; i < NUM_BENCH_LINES; i++ )
+    {
+        benchLines[i][0] = rand() % OLED_WIDTH;
+        benchLines[i][1] = rand() % OLED_HEIGHT;
+        benchLines[i][2] = rand() % OLED_WIDTH;
+        benchLines[i][3] = rand() % OLED_HEIGHT;
+    }
+
+    for( uint8_t i = 0; i < ARRAY_LEN( audioBlock ); i++ )
+    {
+        audioBlock[i] = 2000 * sin( 2 * M_PI * 440 * i / DFREQ );
+    }
+    static const int8_t guitar[] = { -29, -24, -19, -14, -10, -5 };
+    gtInit( &benchTuner, guitar, ARRAY_LEN( guitar ) );
+
+    initNodePool( &listPool, listNodes, LIST_OPS );
+}
+
+/*============================================================================
+ * Tests
+ *==========================================================================*/
+
+static bool testPlotLine( void )
+{
+    clearDisplay();
+    plotLine( 0, 0, OLED_WIDTH - 1, OLED_HEIGHT - 1, WHITE );
+    TEST_CHECK( WHITE == getPixel( 0, 0 ) );
+    TEST_CHECK( WHITE == getPixel( OLED_WIDTH - 1, OLED_HEIGHT - 1 ) );
+    // One pixel per column along the major axis
+    TEST_CHECK( OLED_WIDTH == countWhite() );
+
+    clearDisplay();
+    plotLine( 5, 40, 5, 10, WHITE );
+    TEST_CHECK( 31 == countWhite() );
+    return true;
+}
+
+static bool testSpeedyLine( void )
+{
+    clearDisplay();
+    speedyWhiteLine( 0, 10, OLED_WIDTH - 1, 10, false );
+    TEST_CHECK( OLED_WIDTH == countWhite() );
+    TEST_CHECK( WHITE == getPixel( 64, 10 ) );
+
+    clearDisplay();
+    speedyWhiteLine( 3, 3, 40, 50, false );
+    TEST_CHECK( WHITE == getPixel( 3, 3 ) );
+    TEST_CHECK( 48 == countWhite() );
+    return true;
+}
+
+static bool testFillDisplayArea( void )
+{
+    clearDisplay();
+    fillDisplayArea( 10, 20, 19, 24, WHITE );
+    TEST_CHECK( 50 == countWhite() );
+    fillDisplayArea( 12, 20, 13, 24, BLACK );
+    TEST_CHECK( 40 == countWhite() );
+    return true;
+}
+
+static bool testDrawPng( void )
+{
+    // Start from an inverted background so transparent pixels show
+    clearDisplay();
+    fillDisplayArea( 0, 0, OLED_WIDTH - 1, OLED_HEIGHT - 1, WHITE );
+    fillDisplayArea( 0, 0, SPRITE_W - 1, SPRITE_H - 1, BLACK );
+
+    drawPng( &sprite, 0, 0, false, false, 0 );
+    for( uint16_t y = 0; y < SPRITE_H; y++ )
+    {
+        for( uint16_t x = 0; x < SPRITE_W; x++ )
+        {
+            color expect = ( TRANSPARENT_COLOR == spritePx[y][x] ) ? BLACK : spritePx[y][x];
+            TEST_CHECK( expect == getPixel( x, y ) );
+        }
+    }
+
+    fillDisplayArea( 0, 0, SPRITE_W - 1, SPRITE_H - 1, BLACK );
+    drawPng( &sprite, 0, 0, true, false, 0 );
+    for( uint16_t y = 0; y < SPRITE_H; y++ )
+    {
+        for( uint16_t x = 0; x < SPRITE_W; x++ )
+        {
+            color src = spritePx[y][SPRITE_W - 1 - x];
+            color expect = ( TRANSPARENT_COLOR == src ) ? BLACK : src;
+            TEST_CHECK( expect == getPixel( x, y ) );
+        }
+    }
+
+    // Rotations are three shears, which move every pixel somewhere different.
+    // Check each lands where shears by rounded tan(a / 2) and sin(a), each
+    // rounded down, put it
+    for( int16_t deg = 1; deg < 360; deg++ )
+    {
+        clearDisplay();
+        drawPng( &sprite, 40, 16, false, false, deg );
+        double rad = ( deg % 90 ) * M_PI / 180;
+        double shearTan = round( tan( rad / 2 ) * 1024 );
+        double shearSin = round( sin( rad ) * 1024 );
+        for( int16_t sy = 0; sy < SPRITE_H; sy++ )
+        {
+            for( int16_t sx = 0; sx < SPRITE_W; sx++ )
+            {
+                int16_t x = sx - SPRITE_W / 2;
+                int16_t y = sy - SPRITE_H / 2;
+                for( int16_t quad = deg / 90; quad > 0; quad-- )
+                {
+                    int16_t tmp = x;
+                    x = -y;
+                    y = tmp;
+                }
+                x -= floor( ( y * shearTan + 512 ) / 1024 );
+                y += floor( ( x * shearSin + 512 ) / 1024 );
+                x -= floor( ( y * shearTan + 512 ) / 1024 );
+
+                color src = spritePx[sy][sx];
+                color expect = ( TRANSPARENT_COLOR == src ) ? BLACK : src;
+                TEST_CHECK( expect == getPixel( 40 + SPRITE_W / 2 + x, 16 + SPRITE_H / 2 + y ) );
+            }
+        }
+    }
+    return true;
+}
+
+static bool testFastlz( void )
+{
+    TEST_CHECK( lzPackedLen < LZ_TEST_LEN );
+    memset( lzOut, 0, sizeof( lzOut ) );
+    TEST_CHECK( LZ_TEST_LEN == fastlz_decompress( lzPacked, lzPackedLen, lzOut, sizeof( lzOut ) ) );
+    TEST_CHECK( 0 == memcmp( lzRaw, lzOut, LZ_TEST_LEN ) );
+
+    // Output which doesn't fit must fail, not overrun
+    TEST_CHECK( 0 == fastlz_decompress( lzPacked, lzPackedLen, lzOut, LZ_TEST_LEN / 2 ) );
+    return true;
+}
+
+static bool testListOrder( void )
+{
+    list_t heapList = {0};
+    list_t poolList = {0};
+    poolList.pool = &listPool;
+
+    list_t* lists[] = { &heapList, &poolList };
+    for( uint8_t l = 0; l < ARRAY_LEN( lists ); l++ )
+    {
+        list_t* list = lists[l];
+        push( list, ( void* )2 );
+        push( list, ( void* )3 );
+        unshift( list, ( void* )0 );
+        add( list, ( void* )1, 1 );
+        TEST_CHECK( 4 == list->length );
+
+        intptr_t expect = 0;
+        for( node_t* node = list->first; NULL != node; node = node->next )
+        {
+            TEST_CHECK( expect++ == ( intptr_t )node->val );
+        }
+
+        TEST_CHECK( ( void* )2 == removeEntry( list, list->first->next->next ) );
+        TEST_CHECK( ( void* )3 == pop( list ) );
+        TEST_CHECK( ( void* )0 == shift( list ) );
+        TEST_CHECK( ( void* )1 == removeIdx( list, 0 ) );
+        TEST_CHECK( 0 == list->length );
+        TEST_CHECK( NULL == list->first && NULL == list->last );
+    }
+
+    TEST_CHECK( 0 == listPool.inUse );
+    TEST_CHECK( 4 == listPool.maxInUse );
+    return true;
+}
+
+static bool testListRemoveEntry( void )
+{
+    // Every node between the head and tail can be removed, including the
+    // one right after the head
+    for( uint8_t target = 1; target < 4; target++ )
+    {
+        list_t list = {0};
+        for( intptr_t v = 0; v < 5; v++ )
+        {
+            push( &list, ( void* )v );
+        }
+        node_t* entry = list.first;
+        for( uint8_t i = 0; i < target; i++ )
+        {
+            entry = entry->next;
+        }
+
+        TEST_CHECK( ( void* )( intptr_t )target == removeEntry( &list, entry ) );
+        TEST_CHECK( 4 == list.length );
+        intptr_t expect = 0;
+        node_t* prev = NULL;
+        for( node_t* node = list.first; NULL != node; node = node->next )
+        {
+            expect += ( target == expect ) ? 1 : 0;
+            TEST_CHECK( expect++ == ( intptr_t )node->val );
+            TEST_CHECK( prev == node->prev );
+            prev = node;
+        }
+        TEST_CHECK( prev == list.last );
+        clear( &list );
+    }
+
+    // An entry which isn't in the list is left alone
+    list_t list = {0};
+    list_t other = {0};
+    push( &list, ( void* )0 );
+    push( &list, ( void* )1 );
+    push( &list, ( void* )2 );
+    push( &other, ( void* )9 );
+    TEST_CHECK( NULL == removeEntry( &list, other.first ) );
+    TEST_CHECK( 3 == list.length && 1 == other.length );
+    clear( &list );
+    clear( &other );
+    return true;
+}
+
+static bool testListPoolExhausted( void )
+{
+    node_t nodes[2];
+    nodePool_t pool;
+    initNodePool( &pool, nodes, ARRAY_LEN( nodes ) );
+    list_t list = {0};
+    list.pool = &pool;
+
+    // The third node comes from the heap
+    for( intptr_t i = 0; i < 3; i++ )
+    {
+        push( &list, ( void* )i );
+    }
+    TEST_CHECK( 1 == pool.exhausted );
+    TEST_CHECK( 2 == pool.inUse );
+    clear( &list );
+    TEST_CHECK( 0 == pool.inUse );
+    return true;
+}
+
+static bool testHsv( void )
+{
+    // Pure hues, 0xBBGGRR, full value rounds to just under 0xFF
+    TEST_CHECK( 0x0000F0 < EHSVtoHEXhelper( 0, 255, 255, false ) );
+    TEST_CHECK( 0x0000FF >= EHSVtoHEXhelper( 0, 255, 255, false ) );
+    TEST_CHECK( 0x00F000 == ( 0x00F0F0F0 & EHSVtoHEXhelper( 85, 255, 255, false ) ) );
+    TEST_CHECK( 0xF00000 == ( 0x00F0F0F0 & EHSVtoHEXhelper( 171, 255, 255, false ) ) );
+    TEST_CHECK( 0 == EHSVtoHEX( 123, 255, 0 ) );
+    TEST_CHECK( 255 == GAMMA_CORRECT( 255 ) && 0 == GAMMA_CORRECT( 0 ) );
+
+    hsv_t hsv[64];
+    led_t leds[64];
+    for( uint8_t i = 0; i < ARRAY_LEN( hsv ); i++ )
+    {
+        hsv[i].h = rand();
+        hsv[i].s = rand();
+        hsv[i].v = rand();
+    }
+    hsvToLeds( hsv, leds, ARRAY_LEN( hsv ) );
+    for( uint8_t i = 0; i < ARRAY_LEN( hsv ); i++ )
+    {
+        uint32_t c = EHSVtoHEX( hsv[i].h, hsv[i].s, hsv[i].v );
+        TEST_CHECK( leds[i].r == ( c & 0xFF ) );
+        TEST_CHECK( leds[i].g == ( ( c >> 8 ) & 0xFF ) );
+        TEST_CHECK( leds[i].b == ( ( c >> 16 ) & 0xFF ) );
+    }
+    return true;
+}
+
+static bool testLedCompositor( void )
+{
+    // Channels are set in the order they're sent to the LEDs
+    led_t leds[NUM_LIN_LEDS] = {{0}};
+    led_t over[NUM_LIN_LEDS] = {{0}};
+    uint8_t* chans = ( uint8_t* )leds;
+    double avg[ARRAY_LEN( ledShown )];
+    hostClockStop();
+
+    // Whole levels are pushed once, and not again until they change
+    uint32_t pushes = ledNumPushes;
+    chans[0] = 200;
+    ledCompSetLayer( LED_LAYER_MODE, leds, sizeof( leds ) );
+    ledTestRun( 8, avg );
+    TEST_CHECK( pushes + 1 == ledNumPushes );
+    TEST_CHECK( 200 == ledShown[0] && 0 == ledShown[1] );
+    ledCompSetLayer( LED_LAYER_MODE, leds, sizeof( leds ) );
+    ledTestRun( 8, avg );
+    TEST_CHECK( pushes + 1 == ledNumPushes );
+
+    // Fractional levels from the brightness are dithered over time, however
+    // often ledCompUpdate() is called. 1 at brightness 31 is 32/256
+    memset( leds, 0, sizeof( leds ) );
+    chans[0] = 1;
+    chans[1] = 3;
+    chans[2] = 200;
+    chans[3] = 255;
+    ledCompSetLayer( LED_LAYER_MODE, leds, sizeof( leds ) );
+    ledCompSetBrightness( 31 );
+    ledTestRun( 256, avg );
+    for( uint8_t c = 0; c < 4; c++ )
+    {
+        TEST_CHECK( fabs( avg[c] - chans[c] * 32 / 256.0 ) < 0.01 );
+    }
+    ledCompSetBrightness( 127 );
+    ledTestRun( 256, avg );
+    for( uint8_t c = 0; c < 4; c++ )
+    {
+        TEST_CHECK( fabs( avg[c] - chans[c] * 128 / 256.0 ) < 0.01 );
+    }
+    ledCompSetBrightness( 255 );
+
+    // Gamma correction is interpolated, so whole values land on the table
+    ledCompSetLayerGamma( LED_LAYER_MODE, true );
+    ledTestRun( 8, avg );
+    for( uint8_t c = 0; c < 4; c++ )
+    {
+        TEST_CHECK( GAMMA_CORRECT( chans[c] ) == ledShown[c] );
+    }
+    ledCompSetLayerGamma( LED_LAYER_MODE, false );
+
+    // The overlay covers the mode's layer, or blends with it. Half alpha
+    // rounds up to 129/256
+    ( ( uint8_t* )over )[0] = 101;
+    ledCompSetLayer( LED_LAYER_OVERLAY, over, sizeof( over ) );
+    ledTestRun( 8, avg );
+    TEST_CHECK( 1 == ledShown[0] );
+    ledCompSetLayerAlpha( LED_LAYER_OVERLAY, 255 );
+    ledTestRun( 8, avg );
+    TEST_CHECK( 101 == ledShown[0] && 0 == ledShown[1] && 0 == ledShown[3] );
+    ledCompSetLayerAlpha( LED_LAYER_OVERLAY, 128 );
+    ledTestRun( 256, avg );
+    TEST_CHECK( fabs( avg[0] - ( 1 * 127 + 101 * 129 ) / 256.0 ) < 0.01 );
+    TEST_CHECK( fabs( avg[3] - 255 * 127 / 256.0 ) < 0.01 );
+    ledCompSetLayerAlpha( LED_LAYER_OVERLAY, 0 );
+
+    memset( leds, 0, sizeof( leds ) );
+    ledCompSetLayer( LED_LAYER_MODE, leds, sizeof( leds ) );
+    ledCompFlush();
+    hostClockRun();
+    return true;
+}
+
+static bool testColorchordNote( void )
+{
+    InitColorChord();
+
+    // A4 is a whole number of octaves above BASE_FREQ, so it folds to bin 0
+    int16_t samples[128];
+    double phase = 0;
+    for( uint16_t frame = 0; frame < 200; frame++ )
+    {
+        for( uint8_t i = 0; i < ARRAY_LEN( samples ); i++ )
+        {
+            samples[i] = 2000 * sin( phase );
+            phase += 2 * M_PI * 440 / DFREQ;
+        }
+        PushSamples32( samples, ARRAY_LEN( samples ) );
+        HandleFrameInfo();
+    }
+
+    uint8_t peak = 0;
+    for( uint8_t i = 1; i < FIXBPERO; i++ )
+    {
+        if( folded_bins[i] > folded_bins[peak] )
+        {
+            peak = i;
+        }
+    }
+    TEST_CHECK( 0 == peak || 1 == peak || FIXBPERO - 1 == peak );
+    TEST_CHECK( folded_bins[peak] > 0 );
+    return true;
+}
+
+static uint32_t ccTestFrames = 0;
+
+static void ccTestOnFrame( void )
+{
+    ccTestFrames++;
+}
+
+static bool testColorchordFrames( void )
+{
+    InitColorChord();
+
+    // Blocks which don't line up with frames still call onFrame() once per 128 samples
+    static const int blockLens[] = { 1, 127, 37, 200, 128, 300, 5, 0, 255 };
+    int16_t samples[300] = { 0 };
+    int framePos = 0;
+    uint32_t total = 0;
+    ccTestFrames = 0;
+    for( uint8_t i = 0; i < ARRAY_LEN( blockLens ); i++ )
+    {
+        PushSamplesFramed32( samples, blockLens[i], 128, &framePos, ccTestOnFrame );
+        total += blockLens[i];
+        TEST_CHECK( total / 128 == ccTestFrames );
+        TEST_CHECK( ( int )( total % 128 ) == framePos );
+    }
+    return true;
+}
+
+static bool testGoertzelTuner( void )
+{
+    // The guitar strings, A4 and E5, from the lowest note up
+    static const int8_t semitones[] = { -29, -24, -19, -14, -10, -5, 0, 7 };
+    static const int8_t offsets[] = { -25, -10, 0, 10, 25 };
+    static const int16_t amplitudes[] = { 500, 8000 };
+    int16_t samples[128];
+
+    for( uint8_t n = 0; n < ARRAY_LEN( semitones ); n++ )
+    {
+        for( uint8_t o = 0; o < ARRAY_LEN( offsets ); o++ )
+        {
+            for( uint8_t a = 0; a < ARRAY_LEN( amplitudes ); a++ )
+            {
+                goertzelTuner_t gt;
+                gtInit( &gt, &semitones[n], 1 );
+                double hz = 440 * pow( 2, semitones[n] / 12.0 + offsets[o] / 1200.0 );
+
+                // Check the second measurement, which doesn't start at phase 0
+                uint8_t measurements = 0;
+                double phase = 0;
+                while( measurements < 2 )
+                {
+                    for( uint8_t i = 0; i < ARRAY_LEN( samples ); i++ )
+                    {
+                        samples[i] = lround( amplitudes[a] * sin( phase ) );
+                        phase = fmod( phase + 2 * M_PI * hz / DFREQ, 2 * M_PI );
+                    }
+                    if( gtPushSamples( &gt, samples, ARRAY_LEN( samples ) ) )
+                    {
+                        measurements++;
+                    }
+                }
+
+                TEST_CHECK( abs( gt.notes[0].cents - offsets[o] ) <= 2 );
+                TEST_CHECK( abs( gt.notes[0].amplitude - amplitudes[a] ) <= amplitudes[a] / 8 );
+            }
+        }
+    }
+    return true;
+}
+
+static bool testGifCache( void )
+{
+    // Full screen gifs, 1025 bytes each, and a small one
+    static const uint16_t dims[GIF_TEST_NUM][2] =
+    {
+        { 128, 64 }, { 128, 64 }, { 128, 64 }, { 128, 64 }, { 128, 64 }, { 16, 16 }
+    };
+    gifAssetsPack( dims );
+
+    // Three full screen gifs fit the menu's budget
+    gifCache_t cache;
+    gifCacheInit( &cache, 3200 );
+    gifHandle* gifs[GIF_TEST_NUM] = { NULL };
+    char name[16];
+    for( uint8_t i = 0; i < 3; i++ )
+    {
+        snprintf( name, sizeof( name ), "gif%u", i );
+        gifs[i] = gifCacheGet( &cache, i, name, NULL, 0 );
+        TEST_CHECK( NULL != gifs[i] && 1025 == gifs[i]->allocedSize );
+        TEST_CHECK( i == gifs[i]->frame[0] && i == gifs[i]->frame[1024] );
+    }
+    TEST_CHECK( 3075 == gifCacheUsedBytes( &cache ) );
+
+    // Cached gifs aren't loaded again, and count as used
+    TEST_CHECK( gifs[0] == gifCacheGet( &cache, 0, "gif0", NULL, 0 ) );
+
+    // A fourth evicts the least recently used, which is now gif1
+    gifs[3] = gifCacheGet( &cache, 3, "gif3", NULL, 0 );
+    TEST_CHECK( NULL != gifs[3] && 3 == gifs[3]->frame[0] );
+    TEST_CHECK( gifCacheHas( &cache, 0 ) && !gifCacheHas( &cache, 1 ) );
+    TEST_CHECK( gifCacheHas( &cache, 2 ) && gifCacheHas( &cache, 3 ) );
+    TEST_CHECK( gifCacheUsedBytes( &cache ) <= 3200 );
+
+    // Gifs being drawn aren't evicted, even if they're the least recently used
+    gifHandle* drawing[] = { gifs[0], gifs[2] };
+    gifs[4] = gifCacheGet( &cache, 4, "gif4", drawing, 2 );
+    TEST_CHECK( NULL != gifs[4] && 4 == gifs[4]->frame[0] );
+    TEST_CHECK( gifCacheHas( &cache, 0 ) && gifCacheHas( &cache, 2 ) );
+    TEST_CHECK( gifCacheHas( &cache, 4 ) && !gifCacheHas( &cache, 3 ) );
+
+    // A small one fits beside them without evicting anything
+    gifs[5] = gifCacheGet( &cache, 5, "gif5", drawing, 2 );
+    TEST_CHECK( NULL != gifs[5] && ( 16 * 16 + 8 ) / 8 == gifs[5]->allocedSize );
+    TEST_CHECK( 3 * 1025 + 33 == gifCacheUsedBytes( &cache ) );
+
+    // A gif which can't be loaded isn't cached, and doesn't evict anything
+    TEST_CHECK( NULL == gifCacheGet( &cache, 9, "nope", NULL, 0 ) );
+    TEST_CHECK( !gifCacheHas( &cache, 9 ) && gifCacheHas( &cache, 5 ) );
+    gifCacheFree( &cache );
+    TEST_CHECK( 0 == gifCacheUsedBytes( &cache ) );
+
+    // When everything is being drawn, the cache goes over budget rather than
+    // evicting, then gets back within it
+    gifCacheInit( &cache, 1000 );
+    gifs[0] = gifCacheGet( &cache, 0, "gif0", NULL, 0 );
+    gifs[1] = gifCacheGet( &cache, 1, "gif1", &gifs[0], 1 );
+    TEST_CHECK( NULL != gifs[0] && NULL != gifs[1] && 2050 == gifCacheUsedBytes( &cache ) );
+    gifs[2] = gifCacheGet( &cache, 2, "gif2", NULL, 0 );
+    TEST_CHECK( NULL != gifs[2] && 1025 == gifCacheUsedBytes( &cache ) );
+    TEST_CHECK( gifCacheHas( &cache, 2 ) );
+
+    // Nothing is loaded when every slot is being drawn
+    gifCacheFree( &cache );
+    gifCacheInit( &cache, 100000 );
+    for( uint8_t i = 0; i < GIF_CACHE_SLOTS; i++ )
+    {
+        snprintf( name, sizeof( name ), "gif%u", i );
+        gifs[i] = gifCacheGet( &cache, i, name, NULL, 0 );
+    }
+    TEST_CHECK( NULL == gifCacheGet( &cache, 5, "gif5", gifs, GIF_CACHE_SLOTS ) );
+    TEST_CHECK( GIF_CACHE_SLOTS * 1025 == gifCacheUsedBytes( &cache ) );
+
+    gifCacheFree( &cache );
+    assets = NULL;
+    return true;
+}
+
+static bool testFixedMath( void )
+{
+    // The tables are generated offline, so check them against libm
+    for( uint32_t a = 0; a < 65536; a++ )
+    {
+        double expect = FX_ONE * sin( a * 2 * M_PI / 65536 );
+        TEST_CHECK( fabs( fxSin( a ) - expect ) <= 1 );
+    }
+    TEST_CHECK( FX_ONE == fxSin( FX_ANGLE_90 ) && -FX_ONE == fxCos( FX_ANGLE_180 ) );
+    TEST_CHECK( FX_ANGLE_90 == fxDegToAngle( 90 ) && FX_ANGLE_270 == fxDegToAngle( -90 ) );
+
+    for( int32_t y = -1000; y <= 1000; y += 37 )
+    {
+        for( int32_t x = -1000; x <= 1000; x += 41 )
+        {
+            double expect = atan2( y, x ) * 65536 / ( 2 * M_PI );
+            int32_t err = ( ( int32_t )fxAtan2( y, x ) - ( int32_t )lround( expect ) ) & 0xFFFF;
+            TEST_CHECK( err <= 2 || err >= 0xFFFE );
+        }
+    }
+    TEST_CHECK( FX_ANGLE_180 == fxAtan2( 0, INT32_MIN ) );
+
+    for( uint32_t x = 0; x < 0xFFFF0000; x += ( x < 100000 ) ? 1 : 65521 )
+    {
+        uint32_t root = fxSqrt( x );
+        TEST_CHECK( root * root <= x && ( uint64_t )( root + 1 ) * ( root + 1 ) > x );
+        TEST_CHECK( fabs( fxSqrtRounded( x ) - sqrt( x ) ) <= 0.5 );
+        if( x )
+        {
+            double rsqrt = ( 1 << 30 ) / sqrt( x );
+            TEST_CHECK( fabs( fxRsqrt( x ) - rsqrt ) <= rsqrt / 8192 );
+        }
+    }
+
+    for( uint64_t x = 0xFFFFFF00ULL; x < ( 1ULL << 62 ); x += ( x >> 7 ) + 1 )
+    {
+        uint64_t root = fxSqrt64( x );
+        TEST_CHECK( root * root <= x && ( root + 1 ) * ( root + 1 ) > x );
+        TEST_CHECK( root == fxSqrt64( root * root ) && root - 1 == fxSqrt64( root * root - 1 ) );
+    }
+    TEST_CHECK( 0xFFFFFFFF == fxSqrt64( UINT64_MAX ) );
+    return true;
+}
+
+static bool testTextCache( void )
+{
+    static const struct
+    {
+        fonts font;
+        const font_t* fontData;
+    } fontList[] =
+    {
+        { TOM_THUMB,  &font_TomThumb },
+        { IBM_VGA_8,  &font_IbmVga8 },
+        { RADIOSTARS, &font_Radiostars },
+    };
+    static const color cols[] = { WHITE, BLACK, INVERSE, TRANSPARENT_COLOR };
+    static const int16_t pos[][2] = { { 0, 0 }, { 3, 5 }, { -7, -3 }, { 100, 60 }, { 17, 29 } };
+    // Lowercase, braces, a control character and DEL, and one too wide to cache
+    static const char* strs[] = { "Hello {World}~", "x\ty\x7f", "score: 1234",
+                                  "The quick brown fox jumps over the lazy dog, twice over. The quick brown fox jumps"
+                                };
+    static uint8_t background[FB_BYTES];
+    static uint8_t expect[FB_BYTES];
+
+    for( uint16_t i = 0; i < FB_BYTES; i++ )
+    {
+        background[i] = rand() & 0xFF;
+    }
+
+    textCacheClear();
+    for( uint8_t f = 0; f < ARRAY_LEN( fontList ); f++ )
+    {
+        for( uint8_t s = 0; s < ARRAY_LEN( strs ); s++ )
+        {
+            int16_t width = 0;
+            for( const char* c = strs[s]; *c; c++ )
+            {
+                width += plotChar( 0, 0, *c, fontList[f].fontData, TRANSPARENT_COLOR );
+            }
+            TEST_CHECK( width == textWidth( strs[s], fontList[f].font ) );
+
+            for( uint8_t c = 0; c < ARRAY_LEN( cols ); c++ )
+            {
+                for( uint8_t p = 0; p < ARRAY_LEN( pos ); p++ )
+                {
+                    int16_t x = pos[p][0];
+                    int16_t y = pos[p][1];
+
+                    memcpy( currentFb, background, FB_BYTES );
+                    int16_t endX = x;
+                    for( const char* ch = strs[s]; *ch; ch++ )
+                    {
+                        endX = plotChar( endX, y, *ch, fontList[f].fontData, cols[c] );
+                    }
+                    memcpy( expect, currentFb, FB_BYTES );
+
+                    // Twice, the first draw misses the cache and the second hits it
+                    for( uint8_t pass = 0; pass < 2; pass++ )
+                    {
+                        memcpy( currentFb, background, FB_BYTES );
+                        TEST_CHECK( endX == plotText( x, y, strs[s], fontList[f].font, cols[c] ) );
+                        TEST_CHECK( 0 == memcmp( expect, currentFb, FB_BYTES ) );
+                    }
+                }
+            }
+            TEST_CHECK( width == textWidth( strs[s], fontList[f].font ) );
+        }
+    }
+
+    // A buffer rewritten in place must not draw its old contents
+    char buf[8];
+    strcpy( buf, "111" );
+    plotText( 0, 0, buf, IBM_VGA_8, WHITE );
+    strcpy( buf, "222" );
+    clearDisplay();
+    plotText( 0, 0, buf, IBM_VGA_8, WHITE );
+    memcpy( expect, currentFb, FB_BYTES );
+    clearDisplay();
+    int16_t x = 0;
+    for( uint8_t i = 0; i < 3; i++ )
+    {
+        x = plotChar( x, 0, '2', &font_IbmVga8, WHITE );
+    }
+    TEST_CHECK( 0 == memcmp( expect, currentFb, FB_BYTES ) );
+
+    textCacheClear();
+    return true;
+}
+
+/**
+ * Make a menu like the games' title menus, with a scrolling row
+ */
+static menu_t* makeTestMenu( void )
+{
+    menu_t* menu = initMenu( "Title", NULL );
+    addRowToMenu( menu );
+    addItemToRow( menu, "Easy" );
+    addItemToRow( menu, "Medium" );
+    addItemToRow( menu, "Hard" );
+    addItemToRow( menu, "Very Easy" );
+    addRowToMenu( menu );
+    addItemToRow( menu, "High Scores" );
+    addRowToMenu( menu );
+    addItemToRow( menu, "Quit" );
+    return menu;
+}
+
+static bool testMenuAtRest( void )
+{
+    static uint8_t drawn[FB_BYTES];
+
+    menu_t* menu = makeTestMenu();
+    drawMenu( menu );
+    memcpy( drawn, currentFb, FB_BYTES );
+    TEST_CHECK( 0 != countWhite() );
+
+    // Drawing it again at rest leaves the display alone
+    fbChanges = false;
+    drawMenu( menu );
+    TEST_CHECK( !fbChanges );
+    TEST_CHECK( 0 == memcmp( drawn, currentFb, FB_BYTES ) );
+
+    // Something else drawing over the menu makes it draw again
+    fillDisplayArea( 0, 40, 60, 63, WHITE );
+    drawMenu( menu );
+    TEST_CHECK( 0 == memcmp( drawn, currentFb, FB_BYTES ) );
+
+    // So does renaming an item
+    linkedInfo_t* item = &menu->rows->d.row.items->d;
+    item->item.name = "EASY!!";
+    drawMenu( menu );
+    TEST_CHECK( 0 != memcmp( drawn, currentFb, FB_BYTES ) );
+    item->item.name = "Easy";
+    drawMenu( menu );
+    TEST_CHECK( 0 == memcmp( drawn, currentFb, FB_BYTES ) );
+
+    deinitMenu( menu );
+    return true;
+}
+
+static bool testP2pFraming( void )
+{
+    p2pTestBegin( p2pTestRecvCb );
+    TEST_CHECK( p2pTestConnect() );
+
+    // The header is packed, with no padding
+    TEST_CHECK( 16 == sizeof( p2pPktHdr_t ) );
+
+    TEST_CHECK( p2pTestSend( 0, "abc", "hi" ) );
+    TEST_CHECK( 1 == p2pAirLen() );
+    p2pTestPkt_t sent = *p2pAirPeek( 0 );
+    p2pPktHdr_t* hdr = ( p2pPktHdr_t* )sent.data;
+    uint8_t mac1[6];
+    p2pTestMac( 1, mac1 );
+    TEST_CHECK( sizeof( p2pPktHdr_t ) + 2 == sent.len );
+    TEST_CHECK( 0 == memcmp( hdr->msgId, "tst", 3 ) );
+    TEST_CHECK( P2P_PKT_MSG == hdr->type );
+    TEST_CHECK( 0 == memcmp( hdr->dstMac, mac1, 6 ) );
+    TEST_CHECK( 0 == memcmp( hdr->cmd, "abc", 3 ) );
+    TEST_CHECK( 2 == hdr->len );
+    TEST_CHECK( 0 == memcmp( &sent.data[sizeof( p2pPktHdr_t )], "hi", 2 ) );
+    p2pTestDeliver();
+    TEST_CHECK( 1 == p2pRxLogLen );
+    TEST_CHECK( 1 == p2pRxLog[0].node && 0 == strcmp( "abc", p2pRxLog[0].cmd ) );
+    TEST_CHECK( 2 == p2pRxLog[0].len && 0 == memcmp( "hi", p2pRxLog[0].payload, 2 ) );
+    TEST_CHECK( 1 == p2pNumAcked );
+
+    // Packets which are cut short, for another mode or for another swadge are
+    // dropped without an ACK
+    uint8_t mac0[6];
+    p2pTestMac( 0, mac0 );
+    hdr->seq++;
+    p2pCurNode = 1;
+    p2pRecvCb( &p2pNodes[1], mac0, sent.data, sent.len - 1, P2P_TEST_RSSI );
+    p2pRecvCb( &p2pNodes[1], mac0, sent.data, sizeof( p2pPktHdr_t ) - 1, P2P_TEST_RSSI );
+    hdr->msgId[2] = 'x';
+    p2pRecvCb( &p2pNodes[1], mac0, sent.data, sent.len, P2P_TEST_RSSI );
+    hdr->msgId[2] = 't';
+    hdr->dstMac[5] = 2;
+    p2pRecvCb( &p2pNodes[1], mac0, sent.data, sent.len, P2P_TEST_RSSI );
+    TEST_CHECK( 1 == p2pRxLogLen );
+    TEST_CHECK( 0 == p2pAirLen() );
+
+    // The same packet, intact, is received
+    hdr->dstMac[5] = 1;
+    p2pRecvCb( &p2pNodes[1], mac0, sent.data, sent.len, P2P_TEST_RSSI );
+    TEST_CHECK( 2 == p2pRxLogLen );
+
+    p2pTestEnd();
+    return true;
+}
+
+static bool testP2pWindow( void )
+{
+    p2pTestBegin( p2pTestRecvCb );
+    TEST_CHECK( p2pTestConnect() );
+    p2pInfo* tx = &p2pNodes[0];
+    p2pInfo* rx = &p2pNodes[1];
+
+    // Lose the first of a full window of messages
+    uint8_t first = tx->tx.nextSeq;
+    p2pDropSeq = first;
+    p2pDropArmed = true;
+    p2pDrop = p2pTestDropSeqOnce;
+    TEST_CHECK( p2pTestSend( 0, "m00", "0" ) );
+    TEST_CHECK( p2pTestSend( 0, "m01", "1" ) );
+    TEST_CHECK( p2pTestSend( 0, "m02", "2" ) );
+    TEST_CHECK( p2pTestSend( 0, "m03", "3" ) );
+
+    // A fifth is held until the window has room
+    TEST_CHECK( !p2pTestSend( 0, "m04", "4" ) );
+    TEST_CHECK( 1 == tx->agg.numMsgs );
+    TEST_CHECK( P2P_WINDOW_SIZE == p2pAirLen() );
+    p2pTestDeliver();
+
+    // The rest were buffered, not delivered out of order, and selectively ACKed
+    p2pPktHdr_t* ack = ( p2pPktHdr_t* )p2pLastAck;
+    TEST_CHECK( 0 == p2pRxLogLen );
+    TEST_CHECK( first == rx->rx.nextSeq );
+    TEST_CHECK( first == ack->seq );
+    TEST_CHECK( 0x07 == p2pLastAck[sizeof( p2pPktHdr_t )] );
+
+    // So only the lost one is waiting, and it still holds the window
+    for( uint8_t i = 0; i < P2P_WINDOW_SIZE; i++ )
+    {
+        TEST_CHECK( ( 0 == i ) == tx->tx.slots[( uint8_t )( first + i ) % P2P_WINDOW_SIZE].inUse );
+    }
+    TEST_CHECK( first == tx->tx.base );
+    TEST_CHECK( 1 == tx->agg.numMsgs );
+    TEST_CHECK( 3 == p2pNumAcked );
+
+    // Retrying resends only the lost message
+    p2pCurNode = 0;
+    p2pTxRetryTimeout( &tx->tx.slots[first % P2P_WINDOW_SIZE] );
+    TEST_CHECK( 1 == p2pAirLen() );
+    TEST_CHECK( first == ( ( p2pPktHdr_t* )p2pAirPeek( 0 )->data )->seq );
+    p2pTestPkt_t retry = *p2pAirPeek( 0 );
+    p2pTestDeliver();
+
+    // Then everything is delivered in order, including the held message
+    TEST_CHECK( 5 == p2pRxLogLen );
+    for( uint8_t i = 0; i < 5; i++ )
+    {
+        char cmd[4];
+        snprintf( cmd, sizeof( cmd ), "m%02d", i );
+        TEST_CHECK( 0 == strcmp( cmd, p2pRxLog[i].cmd ) );
+    }
+    TEST_CHECK( 5 == p2pNumAcked );
+    TEST_CHECK( tx->tx.base == tx->tx.nextSeq );
+    TEST_CHECK( ( uint8_t )( first + 5 ) == ack->seq );
+    TEST_CHECK( 0 == p2pLastAck[sizeof( p2pPktHdr_t )] );
+
+    // A duplicate is ACKed again but not delivered again
+    uint8_t mac0[6];
+    p2pTestMac( 0, mac0 );
+    p2pCurNode = 1;
+    p2pRecvCb( rx, mac0, retry.data, retry.len, P2P_TEST_RSSI );
+    TEST_CHECK( 5 == p2pRxLogLen );
+    TEST_CHECK( 1 == rx->stats.msgsDuplicate );
+    TEST_CHECK( 1 == p2pAirLen() );
+    TEST_CHECK( P2P_PKT_ACK == ( ( p2pPktHdr_t* )p2pAirPeek( 0 )->data )->type );
+    p2pTestDeliver();
+
+    // Sequence numbers wrap around
+    p2pDrop = NULL;
+    for( uint16_t i = 0; i < 300; i++ )
+    {
+        TEST_CHECK( p2pTestSend( 0, "wrp", "w" ) );
+        p2pTestDeliver();
+    }
+    TEST_CHECK( 305 == p2pRxLogLen );
+    TEST_CHECK( 305 == p2pNumAcked );
+
+    p2pTestEnd();
+    return true;
+}
+
+/**
+ * Lose every message, but not ACKs or connection packets
+ */
+static bool p2pTestDropMsgs( uint8_t from __attribute__( ( unused ) ), uint8_t to __attribute__( ( unused ) ),
+                             const uint8_t* data, uint8_t len __attribute__( ( unused ) ) )
+{
+    const p2pPktHdr_t* hdr = ( const p2pPktHdr_t* )data;
+    return P2P_PKT_MSG == hdr->type || P2P_PKT_AGG == hdr->type;
+}
+
+/**
+ * Lose every ACK
+ */
+static bool p2pTestDropAcks( uint8_t from __attribute__( ( unused ) ), uint8_t to __attribute__( ( unused ) ),
+                             const uint8_t* data, uint8_t len __attribute__( ( unused ) ) )
+{
+    const p2pPktHdr_t* hdr = ( const p2pPktHdr_t* )data;
+    return P2P_PKT_ACK == hdr->type;
+}
+
+static bool testP2pRtt( void )
+{
+    p2pTestBegin( p2pTestRecvCb );
+
+    // The estimator starts conservative, then follows RFC 6298
+    p2pInfo* p2p = &p2pNodes[0];
+    const p2pStats_t* stats = p2pGetStats( p2p );
+    p2pCurNode = 0;
+    p2pInitialize( p2p, "tst", NULL, NULL, 0 );
+    TEST_CHECK( 85 == stats->rtoMs );
+    p2pRttSample( p2p, 20000 );
+    TEST_CHECK( 20000 == stats->srttUs && 10000 == stats->rttvarUs && 60 == stats->rtoMs );
+    p2pRttSample( p2p, 20000 );
+    TEST_CHECK( 20000 == stats->srttUs && 7500 == stats->rttvarUs && 50 == stats->rtoMs );
+    p2pRttSample( p2p, 36000 );
+    TEST_CHECK( 22000 == stats->srttUs && 9625 == stats->rttvarUs && 61 == stats->rtoMs );
+
+    // It's kept between the minimum and maximum
+    for( uint8_t i = 0; i < 100; i++ )
+    {
+        p2pRttSample( p2p, 500 );
+    }
+    TEST_CHECK( 10 == stats->rtoMs );
+    p2pRttSample( p2p, 5000000 );
+    TEST_CHECK( 250 == stats->rtoMs );
+    p2pDeinit( p2p );
+
+    // A round trip over the air is measured with the clock
+    TEST_CHECK( p2pTestConnect() );
+    p2p = &p2pNodes[0];
+    stats = p2pGetStats( p2p );
+    uint32_t srttUs = stats->srttUs;
+    TEST_CHECK( p2pTestSend( 0, "rtt", "" ) );
+    hostClockAdvance( 30000 );
+    p2pTestDeliver();
+    TEST_CHECK( ( ( 7 * srttUs ) + 30000 ) / 8 == stats->srttUs );
+
+    // When an ACK is lost, the next one covers both messages, but only the
+    // round trip of the message it answers is measured
+    srttUs = stats->srttUs;
+    p2pDrop = p2pTestDropAcks;
+    TEST_CHECK( p2pTestSend( 0, "ac1", "" ) );
+    p2pTestDeliver();
+    hostClockAdvance( 20000 );
+    p2pDrop = NULL;
+    TEST_CHECK( p2pTestSend( 0, "ac2", "" ) );
+    hostClockAdvance( 10000 );
+    p2pTestDeliver();
+    TEST_CHECK( 3 == p2pNumAcked );
+    TEST_CHECK( ( ( 7 * srttUs ) + 10000 ) / 8 == stats->srttUs );
+
+    // Each retry waits twice as long, up to the maximum, plus up to 3ms so
+    // swadges don't retry in lockstep
+    p2pRttSample( p2p, 5000 );
+    uint32_t rtoMs = stats->rtoMs;
+    srttUs = stats->srttUs;
+    p2pDrop = p2pTestDropMsgs;
+    TEST_CHECK( p2pTestSend( 0, "bck", "" ) );
+    p2pTestDeliver();
+    p2pTxSlot_t* slot = &p2p->tx.slots[( uint8_t )( p2p->tx.nextSeq - 1 ) % P2P_WINDOW_SIZE];
+    uint32_t expectMs = rtoMs;
+    for( uint8_t i = 0; i < 10; i++ )
+    {
+        TEST_CHECK( slot->retry.isArmed );
+        TEST_CHECK( slot->retry.periodMs >= expectMs && slot->retry.periodMs <= expectMs + 3 );
+        expectMs = ( 2 * expectMs > 250 ) ? 250 : 2 * expectMs;
+        p2pCurNode = 0;
+        p2pTxRetryTimeout( slot );
+        p2pTestDeliver();
+    }
+    TEST_CHECK( 250 == expectMs );
+    TEST_CHECK( 10 == stats->retries );
+
+    // An ACK for a retried message isn't measured, it's not known which
+    // transmission it's for
+    p2pDrop = NULL;
+    p2pCurNode = 0;
+    p2pTxRetryTimeout( slot );
+    p2pTestDeliver();
+    TEST_CHECK( 4 == p2pNumAcked );
+    TEST_CHECK( srttUs == stats->srttUs );
+
+    // A message which is never ACKed is given up on after three seconds
+    p2pDrop = p2pTestDropMsgs;
+    TEST_CHECK( p2pTestSend( 0, "gup", "" ) );
+    p2pTestDeliver();
+    hostClockAdvance( 3000000 );
+    slot = &p2p->tx.slots[( uint8_t )( p2p->tx.nextSeq - 1 ) % P2P_WINDOW_SIZE];
+    p2pCurNode = 0;
+    p2pTxRetryTimeout( slot );
+    TEST_CHECK( 1 == p2pNumFailed );
+    TEST_CHECK( 1 == stats->msgsFailed );
+    TEST_CHECK( p2p->tx.base == p2p->tx.nextSeq );
+
+    p2pTestEnd();
+    return true;
+}
+
+static bool testP2pSession( void )
+{
+    static const char* const msgs[] = { "m00", "m01", "m02" };
+
+    p2pTestBegin( sesTestRecvCb );
+
+    // Three swadges find each other from their HELLOs
+    for( uint8_t n = 0; n < P2P_TEST_NODES; n++ )
+    {
+        p2pCurNode = n;
+        p2pSessionInit( &sesNodes[n], "ses", sesTestPeerCb, sesTestMsgRxCb, 0 );
+    }
+    sesTestTick( 0, 0x07 );
+    TEST_CHECK( 6 == sesNumJoined );
+    for( uint8_t n = 0; n < P2P_TEST_NODES; n++ )
+    {
+        TEST_CHECK( 2 == p2pSessionNumPeers( &sesNodes[n] ) );
+    }
+
+    // Swadge 1 misses the first of three messages, so it drops the other two
+    // rather than deliver them out of order. Swadge 2 gets them all
+    p2pDropArmed = true;
+    p2pDrop = sesTestDropFirstTo1;
+    p2pCurNode = 0;
+    for( uint8_t i = 0; i < ARRAY_LEN( msgs ); i++ )
+    {
+        TEST_CHECK( p2pSessionSend( &sesNodes[0], ( char* )msgs[i], NULL, 0, sesTestMsgTxCb ) );
+    }
+    p2pTestDeliver();
+    TEST_CHECK( sesTestReceived( 1, msgs, 0 ) );
+    TEST_CHECK( sesTestReceived( 2, msgs, 3 ) );
+
+    // Only swadge 2's ACK covers them
+    sesTestTick( 10000, 0x07 );
+    int8_t idx1 = sesTestPeerIdx( 0, 1 );
+    int8_t idx2 = sesTestPeerIdx( 0, 2 );
+    TEST_CHECK( idx1 >= 0 && idx2 >= 0 );
+    for( uint8_t i = 0; i < ARRAY_LEN( msgs ); i++ )
+    {
+        TEST_CHECK( sesNodes[0].tx.slots[i].ackedMask == ( 1 << idx2 ) );
+    }
+
+    // So all three go back out, and swadge 1 gets them in order
+    sesTestTick( 40000, 0x01 );
+    TEST_CHECK( sesTestReceived( 1, msgs, 3 ) );
+    TEST_CHECK( 3 == sesNodes[2].peers[sesTestPeerIdx( 2, 0 )].msgsDuplicate );
+    sesTestTick( 10000, 0x07 );
+    sesTestTick( 10000, 0x01 );
+    TEST_CHECK( 3 == p2pNumAcked && 0 == p2pNumFailed );
+
+    // Swadge 2 goes quiet. It's removed once it hasn't been heard from for
+    // three seconds, then messages don't wait for it
+    p2pDrop = sesTestDrop2;
+    p2pCurNode = 0;
+    TEST_CHECK( p2pSessionSend( &sesNodes[0], "m03", NULL, 0, sesTestMsgTxCb ) );
+    for( uint8_t i = 0; i < 29; i++ )
+    {
+        sesTestTick( 100000, 0x03 );
+    }
+    TEST_CHECK( 0 == sesNumLeft );
+    TEST_CHECK( 3 == p2pNumAcked );
+    sesTestTick( 100000, 0x03 );
+    TEST_CHECK( 2 == sesNumLeft );
+    TEST_CHECK( 1 == p2pSessionNumPeers( &sesNodes[0] ) && 1 == p2pSessionNumPeers( &sesNodes[1] ) );
+    TEST_CHECK( -1 == sesTestPeerIdx( 0, 2 ) && -1 == sesTestPeerIdx( 1, 2 ) );
+    TEST_CHECK( 4 == p2pNumAcked && 0 == p2pNumFailed );
+
+    p2pTestEnd();
+    return true;
+}
+
+/**
+ * Queue a message from a swadge's mode without flushing it
+ */
+static bool p2pTestHold( uint8_t node, char* cmd, const char* payload )
+{
+    p2pCurNode = node;
+    return p2pSendMsg( &p2pNodes[node], cmd, ( const uint8_t* )payload, strlen( payload ), p2pTestMsgTxCb );
+}
+
+static bool testP2pAggregation( void )
+{
+    p2pTestBegin( p2pTestRecvCb );
+    TEST_CHECK( p2pTestConnect() );
+    p2pInfo* p2p = &p2pNodes[0];
+    const p2pStats_t* stats = p2pGetStats( p2p );
+    uint32_t msgsSent = stats->msgsSent;
+
+    // Messages sent together are held, then share one packet
+    TEST_CHECK( p2pTestHold( 0, "ma0", "a" ) );
+    TEST_CHECK( p2pTestHold( 0, "ma1", "bb" ) );
+    TEST_CHECK( p2pTestHold( 0, "ma2", "ccc" ) );
+    TEST_CHECK( 0 == p2pAirLen() );
+    TEST_CHECK( 3 == p2p->agg.numMsgs );
+    TEST_CHECK( p2p->tmr.Aggregate.isArmed );
+    p2pAggTimeout( p2p );
+    TEST_CHECK( !p2p->tmr.Aggregate.isArmed );
+    TEST_CHECK( 1 == p2pAirLen() );
+    const p2pPktHdr_t* hdr = ( const p2pPktHdr_t* )p2pAirPeek( 0 )->data;
+    TEST_CHECK( P2P_PKT_AGG == hdr->type );
+    TEST_CHECK( ( 3 * sizeof( p2pAggRec_t ) ) + 6 == hdr->len );
+    TEST_CHECK( sizeof( p2pPktHdr_t ) + hdr->len == p2pAirPeek( 0 )->len );
+    const p2pAggRec_t* rec = ( const p2pAggRec_t* )&p2pAirPeek( 0 )->data[sizeof( p2pPktHdr_t )];
+    TEST_CHECK( 0 == memcmp( "ma0", rec->cmd, 3 ) && 1 == rec->len );
+
+    // They're unpacked in order, and one ACK covers them all
+    p2pTestDeliver();
+    TEST_CHECK( 3 == p2pRxLogLen );
+    for( uint8_t i = 0; i < 3; i++ )
+    {
+        char cmd[4];
+        snprintf( cmd, sizeof( cmd ), "ma%d", i );
+        TEST_CHECK( 0 == strcmp( cmd, p2pRxLog[i].cmd ) );
+        TEST_CHECK( i + 1 == p2pRxLog[i].len && 'a' + i == p2pRxLog[i].payload[i] );
+    }
+    TEST_CHECK( 3 == p2pNumAcked );
+    TEST_CHECK( msgsSent + 1 == stats->msgsSent );
+    TEST_CHECK( 0 == p2p->agg.numMsgs );
+
+    // A lone message is sent as it always was
+    TEST_CHECK( p2pTestHold( 0, "one", "1" ) );
+    p2pAggTimeout( p2p );
+    TEST_CHECK( 1 == p2pAirLen() );
+    TEST_CHECK( P2P_PKT_MSG == ( ( const p2pPktHdr_t* )p2pAirPeek( 0 )->data )->type );
+    p2pTestDeliver();
+    TEST_CHECK( 4 == p2pRxLogLen && 0 == strcmp( "one", p2pRxLog[3].cmd ) );
+    TEST_CHECK( 4 == p2pNumAcked );
+
+    // A message past the most one packet holds sends the others first
+    for( uint8_t i = 0; i < P2P_AGG_MAX_MSGS; i++ )
+    {
+        TEST_CHECK( p2pTestHold( 0, "cap", "" ) );
+    }
+    TEST_CHECK( 0 == p2pAirLen() );
+    TEST_CHECK( p2pTestHold( 0, "cap", "" ) );
+    TEST_CHECK( 1 == p2pAirLen() && 1 == p2p->agg.numMsgs );
+    TEST_CHECK( P2P_AGG_MAX_MSGS * sizeof( p2pAggRec_t ) == ( ( const p2pPktHdr_t* )p2pAirPeek( 0 )->data )->len );
+    p2pAggTimeout( p2p );
+    p2pTestDeliver();
+    TEST_CHECK( 4 + P2P_AGG_MAX_MSGS + 1 == p2pRxLogLen );
+    TEST_CHECK( 4 + P2P_AGG_MAX_MSGS + 1 == p2pNumAcked );
+
+    // So does one which doesn't fit in the space left. A lone message can
+    // still use the whole payload
+    char big[P2P_MAX_PAYLOAD_LEN + 1];
+    memset( big, 'x', sizeof( big ) );
+    big[P2P_MAX_PAYLOAD_LEN] = 0;
+    TEST_CHECK( p2pTestHold( 0, "sml", "s" ) );
+    TEST_CHECK( p2pTestHold( 0, "big", big ) );
+    TEST_CHECK( 1 == p2pAirLen() && 1 == p2p->agg.numMsgs );
+    p2pAggTimeout( p2p );
+    TEST_CHECK( 2 == p2pAirLen() );
+    TEST_CHECK( P2P_MAX_PACKET_LEN == p2pAirPeek( 1 )->len );
+    p2pTestDeliver();
+    TEST_CHECK( 4 + P2P_AGG_MAX_MSGS + 3 == p2pNumAcked );
+
+    // A record which runs past the end of the packet isn't delivered, but
+    // the ones before it are
+    uint16_t rxLen = p2pRxLogLen;
+    TEST_CHECK( p2pTestHold( 0, "ok0", "o" ) );
+    TEST_CHECK( p2pTestHold( 0, "bad", "b" ) );
+    p2pAggTimeout( p2p );
+    TEST_CHECK( 1 == p2pAirLen() );
+    p2pAirPeek( 0 )->data[sizeof( p2pPktHdr_t ) + sizeof( p2pAggRec_t ) + 1 + 3] = 2;
+    p2pTestDeliver();
+    TEST_CHECK( rxLen + 1 == p2pRxLogLen );
+
+    // Each message's callback hears when its packet is given up on
+    uint16_t numAcked = p2pNumAcked;
+    p2pDrop = p2pTestDropMsgs;
+    TEST_CHECK( p2pTestHold( 0, "gu0", "" ) );
+    TEST_CHECK( p2pTestHold( 0, "gu1", "" ) );
+    p2pAggTimeout( p2p );
+    p2pTestDeliver();
+    hostClockAdvance( 3000000 );
+    p2pCurNode = 0;
+    p2pTxRetryTimeout( &p2p->tx.slots[( uint8_t )( p2p->tx.nextSeq - 1 ) % P2P_WINDOW_SIZE] );
+    TEST_CHECK( 2 == p2pNumFailed && numAcked == p2pNumAcked );
+    TEST_CHECK( 1 == stats->msgsFailed );
+
+    p2pTestEnd();
+    return true;
+}
+
+static const testCase_t tests[] =
+{
+    { "plotLine",              testPlotLine },
+    { "speedyWhiteLine",       testSpeedyLine },
+    { "fillDisplayArea",       testFillDisplayArea },
+    { "drawPng",               testDrawPng },
+    { "fastlz_decompress",     testFastlz },
+    { "gif cache",             testGifCache },
+    { "linked_list order",     testListOrder },
+    { "linked_list remove",    testListRemoveEntry },
+    { "linked_list exhausted", testListPoolExhausted },
+    { "hsv",                   testHsv },
+    { "led compositor",        testLedCompositor },
+    { "colorchord note",       testColorchordNote },
+    { "colorchord frames",     testColorchordFrames },
+    { "goertzel tuner",        testGoertzelTuner },
+    { "fixed_math",            testFixedMath },
+    { "text cache",            testTextCache },
+    { "menu at rest",          testMenuAtRest },
+    { "p2p framing",           testP2pFraming },
+    { "p2p window",            testP2pWindow },
+    { "p2p rtt",               testP2pRtt },
+    { "p2p session",           testP2pSession },
+    { "p2p aggregation",       testP2pAggregation },
+};
+
+/*============================================================================
+ * Benchmarks
+ *==========================================================================*/
+
+static void benchPlotLine( void )
+{
+    static uint8_t i = 0;
+    int16_t* l = benchLines[i++ % NUM_BENCH_LINES];
+    plotLine( l[0], l[1], l[2], l[3], INVERSE );
+}
+
+static void benchSpeedyLine( void )
+{
+    static uint8_t i = 0;
+    int16_t* l = benchLines[i++ % NUM_BENCH_LINES];
+    speedyWhiteLine( l[0], l[1], l[2], l[3], false );
+}
+
+static void benchDrawPng( void )
+{
+    drawPng( &sprite, 40, 16, false, false, 0 );
+}
+
+static void benchDrawPngRotated( void )
+{
+    drawPng( &sprite, 40, 16, true, false, 90 );
+}
+
+static void benchFastlz( void )
+{
+    benchSink += fastlz_decompress( lzPacked, lzPackedLen, lzOut, sizeof( lzOut ) );
+}
+
+static void benchPushSamples( void )
+{
+    PushSamples32( audioBlock, ARRAY_LEN( audioBlock ) );
+}
+
+static void benchGtPushSamples( void )
+{
+    benchSink += gtPushSamples( &benchTuner, audioBlock, ARRAY_LEN( audioBlock ) );
+}
+
+static void benchHandleFrameInfo( void )
+{
+    HandleFrameInfo();
+}
+
+static void benchListHeap( void )
+{
+    list_t list = {0};
+    for( intptr_t i = 0; i < LIST_OPS; i++ )
+    {
+        push( &list, ( void* )i );
+    }
+    while( list.length )
+    {
+        benchSink += ( intptr_t )shift( &list );
+    }
+}
+
+static void benchListPool( void )
+{
+    list_t list = {0};
+    list.pool = &listPool;
+    for( intptr_t i = 0; i < LIST_OPS; i++ )
+    {
+        push( &list, ( void* )i );
+    }
+    while( list.length )
+    {
+        benchSink += ( intptr_t )shift( &list );
+    }
+}
+
+static void benchEHSVtoHEX( void )
+{
+    static uint8_t h = 0;
+    for( uint8_t i = 0; i < 6; i++ )
+    {
+        benchSink += EHSVtoHEX( h++, 255, 200 );
+    }
+}
+
+static void benchHsvToLeds( void )
+{
+    static uint8_t h = 0;
+    hsv_t hsv[6];
+    led_t leds[6];
+    for( uint8_t i = 0; i < 6; i++ )
+    {
+        hsv[i].h = h++;
+        hsv[i].s = 255;
+        hsv[i].v = 200;
+    }
+    hsvToLeds( hsv, leds, 6 );
+    benchSink += leds[0].r;
+}
+
+static void benchSinf( void )
+{
+    static uint16_t a = 0;
+    benchSink += 1000 * sinf( ( a += 997 ) * ( float )( 2 * M_PI / 65536 ) );
+}
+
+static void benchFxSin( void )
+{
+    static uint16_t a = 0;
+    benchSink += fxSin( a += 997 );
+}
+
+static void benchFxAtan2( void )
+{
+    static int32_t y = 0;
+    benchSink += fxAtan2( ( y += 7 ) & 0x3FF, 300 );
+}
+
+static void benchFxSqrt( void )
+{
+    static uint32_t x = 0;
+    benchSink += fxSqrt( x += 40503 );
+}
+
+static const char benchLabel[] = "Colorchord Settings";
+
+static void benchPlotChars( void )
+{
+    int16_t x = 0;
+    for( const char* c = benchLabel; *c; c++ )
+    {
+        x = plotChar( x, 20, *c, &font_IbmVga8, WHITE );
+    }
+    benchSink += x;
+}
+
+static void benchPlotText( void )
+{
+    benchSink += plotText( 0, 20, benchLabel, IBM_VGA_8, WHITE );
+}
+
+static void benchTextWidth( void )
+{
+    benchSink += textWidth( benchLabel, IBM_VGA_8 );
+}
+
+static void benchDrawMenu( void )
+{
+    static menu_t* menu = NULL;
+    if( NULL == menu )
+    {
+        menu = makeTestMenu();
+    }
+    // Forget it was drawn, to time drawing it
+    menu->drawnAtRest = false;
+    drawMenu( menu );
+}
+
+static void benchDrawMenuAtRest( void )
+{
+    static menu_t* menu = NULL;
+    if( NULL == menu )
+    {
+        menu = makeTestMenu();
+    }
+    drawMenu( menu );
+}
+
+static const benchCase_t benches[] =
+{
+    { "plotLine, random",              benchPlotLine },
+    { "speedyWhiteLine, random",       benchSpeedyLine },
+    { "drawPng 32x32",                 benchDrawPng },
+    { "drawPng 32x32, flip+rotate",    benchDrawPngRotated },
+    { "fastlz_decompress 4KB",         benchFastlz },
+    { "PushSamples32 x128",            benchPushSamples },
+    { "HandleFrameInfo",               benchHandleFrameInfo },
+    { "gtPushSamples x128, 6 notes",   benchGtPushSamples },
+    { "list push+shift x64, heap",     benchListHeap },
+    { "list push+shift x64, pool",     benchListPool },
+    { "EHSVtoHEX x6",                  benchEHSVtoHEX },
+    { "hsvToLeds x6",                  benchHsvToLeds },
+    { "sinf",                          benchSinf },
+    { "fxSin",                         benchFxSin },
+    { "fxAtan2",                       benchFxAtan2 },
+    { "fxSqrt",                        benchFxSqrt },
+    { "plotChar x19",                  benchPlotChars },
+    { "plotText x19, cached",          benchPlotText },
+    { "textWidth x19, cached",         benchTextWidth },
+    { "drawMenu",                      benchDrawMenu },
+    { "drawMenu, at rest",             benchDrawMenuAtRest },
+};
+
+/**
+ * Run a benchmark for at least BENCH_MIN_NS and print its time per call
+ *
+ * @param bench The benchmark to run
+ */
+static void benchRun( const benchCase_t* bench )
+{
+    uint64_t iters = 16;
+    double elapsed;
+    while( true )
+    {
+        double start = nowNs();
+        for( uint64_t i = 0; i < iters; i++ )
+        {
+            bench->fn();
+        }
+        elapsed = nowNs() - start;
+        if( elapsed >= BENCH_MIN_NS )
+        {
+            break;
+        }
+        iters *= 2;
+    }
+    printf( "%-32s %12.1f ns/op\n", bench->name, elapsed / iters );
+}
+
+/*============================================================================
+ * Main
+ *==========================================================================*/
+
+int main( int argc, char** argv )
+{
+    bool bench = ( argc > 1 && 0 == strcmp( argv[1], "--bench" ) );
+
+    setupFixtures();
+
+    uint32_t failed = 0;
+    for( uint8_t t = 0; t < ARRAY_LEN( tests ); t++ )
+    {
+        bool ok = tests[t].fn();
+        printf( "%-32s %s\n", tests[t].name, ok ? "ok" : "FAIL" );
+        if( !ok )
+        {
+            failed++;
+        }
+    }
+    printf( "%u of %u tests passed\n", ( uint32_t )( ARRAY_LEN( tests ) - failed ), ( uint32_t )ARRAY_LEN( tests ) );
+
+    if( bench && 0 == failed )
+    {
+        printf( "\n" );
+        for( uint8_t b = 0; b < ARRAY_LEN( benches ); b++ )
+        {
+            benchRun( &benches[b] );
+        }
+    }
+
+    free( sprite.data );
+    return failed ? 1 : 0;
+}
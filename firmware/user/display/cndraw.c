@@ -9,6 +9,9 @@
 #include "oled.h"
 #include "cndraw.h"
 
+extern uint8_t currentFb[(OLED_WIDTH * (OLED_HEIGHT / 8))];
+extern bool fbChanges;
+
 /**
  * Fill a rectangular display area with a single color
  *
@@ -883,3 +886,84 @@ void ICACHE_FLASH_ATTR outlineTriangle( int16_t v0x, int16_t v0y, int16_t v1x, i
         }
     }
 }
+
+/**
+ * Draw columns of pixels straight into the framebuffer, which stores each
+ * column as eight bytes of eight rows. Each byte is masked and written once,
+ * rather than each pixel being drawn on its own
+ *
+ * @param x       The X pixel of the first column
+ * @param y       The Y pixel of the top row, may be off screen
+ * @param cols    Each column's pixels, bit 0 at the top. Columns with
+ *                BLIT_COL_SKIP set are left untouched
+ * @param numCols The number of columns
+ * @param height  The number of rows in each column, at most 15
+ * @param col     WHITE draws set bits white and clear bits black, BLACK is the
+ *                opposite, INVERSE inverts set bits and TRANSPARENT_COLOR draws
+ *                nothing
+ */
+void ICACHE_FLASH_ATTR blitColumns(int16_t x, int16_t y, const uint16_t* cols,
+                                   uint16_t numCols, uint8_t height, color col)
+{
+    if(TRANSPARENT_COLOR == col || y >= OLED_HEIGHT || y + height <= 0)
+    {
+        return;
+    }
+
+    // Rows are shifted down into place, so each column spans up to three pages
+    int16_t firstPage = y >> 3;
+    uint8_t shift = y & 7;
+    uint32_t cover = ((1UL << height) - 1) << shift;
+
+    uint16_t c = (x < 0) ? -x : 0;
+    for(; c < numCols && x + c < OLED_WIDTH; c++)
+    {
+        if(cols[c] & BLIT_COL_SKIP)
+        {
+            continue;
+        }
+
+        uint32_t ink = (uint32_t)cols[c] << shift;
+        uint8_t* column = &currentFb[(x + c) * (OLED_HEIGHT / 8)];
+        uint8_t p;
+        for(p = 0; p < 3; p++)
+        {
+            int16_t page = firstPage + p;
+            uint8_t coverByte = cover >> (8 * p);
+            if(0 == coverByte || page >= (OLED_HEIGHT / 8))
+            {
+                break;
+            }
+            else if(page < 0)
+            {
+                continue;
+            }
+
+            uint8_t inkByte = ink >> (8 * p);
+            switch(col)
+            {
+                case WHITE:
+                {
+                    column[page] = (column[page] & ~coverByte) | inkByte;
+                    break;
+                }
+                case BLACK:
+                {
+                    column[page] = (column[page] | coverByte) & ~inkByte;
+                    break;
+                }
+                case INVERSE:
+                {
+                    column[page] ^= inkByte;
+                    break;
+                }
+                case TRANSPARENT_COLOR:
+                default:
+                {
+                    break;
+                }
+            }
+        }
+    }
+    fbChanges = true;
+}
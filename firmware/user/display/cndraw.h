@@ -15,4 +15,10 @@ void ICACHE_FLASH_ATTR outlineTriangle( int16_t v0x, int16_t v0y, int16_t v1x, i
 void ICACHE_FLASH_ATTR speedyWhiteLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool thicc );
 void ICACHE_FLASH_ATTR speedyBlackLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, bool thicc );
 
+// A column for blitColumns() which isn't drawn, i.e. the gap between glyphs
+#define BLIT_COL_SKIP 0x8000
+
+void ICACHE_FLASH_ATTR blitColumns(int16_t x, int16_t y, const uint16_t* cols,
+                                   uint16_t numCols, uint8_t height, color col);
+
 #endif
@@ -6,15 +6,108 @@
  */
 
 #include <osapi.h>
+#include <mem.h>
 
 #include "oled.h"
-#include "sprite.h"
+#include "cndraw.h"
 #include "font.h"
 
 #if defined(FEATURE_OLED)
 
-int16_t plotChar(int16_t x, int16_t y, char character, const sprite_t* table, color col);
-int16_t charWidth(char character, const sprite_t* table);
+// How many rendered strings are kept
+#define TEXT_CACHE_ENTRIES 8
+
+// Strings wider than this are drawn a character at a time instead of cached
+#define TEXT_CACHE_MAX_COLS 256
+
+/**
+ * A string rendered in a font, as the columns blitColumns() draws
+ */
+typedef struct
+{
+    uint16_t* cols;       // Each column, bit 0 at the top, BLIT_COL_SKIP between glyphs
+    char* text;           // A copy of the string, stored after cols
+    const char* textPtr;  // Where the string was last drawn from
+    uint32_t hash;
+    uint32_t lastUsed;
+    uint16_t len;
+    uint16_t numCols;     // Also how far plotText() moves x
+    uint16_t allocBytes;
+    fonts font;
+} textRun_t;
+
+static const font_t* const fontTable[] =
+{
+    [TOM_THUMB]  = &font_TomThumb,
+    [IBM_VGA_8]  = &font_IbmVga8,
+    [RADIOSTARS] = &font_Radiostars,
+};
+
+#define NUM_FONTS (sizeof(fontTable) / sizeof(fontTable[0]))
+
+static textRun_t textCache[TEXT_CACHE_ENTRIES] = {{0}};
+static uint32_t textCacheClock = 0;
+
+int16_t plotChar(int16_t x, int16_t y, char character, const font_t* font, color col);
+int16_t charWidth(char character, const font_t* font);
+static uint32_t ICACHE_FLASH_ATTR getGlyph(char character, const font_t* font);
+static void ICACHE_FLASH_ATTR readGlyph(const font_t* font, uint32_t glyph, uint16_t* cols);
+static textRun_t* ICACHE_FLASH_ATTR textCacheGet(const char* text, fonts font, bool render);
+static bool ICACHE_FLASH_ATTR textCacheRender(textRun_t* run, const char* text, fonts font,
+        uint32_t hash, uint16_t len);
+
+/**
+ * @brief Find a character's glyph
+ *
+ * @param character The character to find
+ * @param font The font to find it in
+ * @return The glyph's FONT_GLYPH(), or 0 for characters which aren't drawn
+ */
+static uint32_t ICACHE_FLASH_ATTR getGlyph(char character, const font_t* font)
+{
+    if(character < ' ' || character > '~')
+    {
+        return 0;
+    }
+    return font->glyphs[character - ' '];
+}
+
+/**
+ * @brief Unpack a glyph's columns from flash, which must be read a word at a
+ *        time
+ *
+ * @param font The font the glyph is in
+ * @param glyph The glyph's FONT_GLYPH()
+ * @param cols Where to write each column, top row in bit 0
+ */
+static void ICACHE_FLASH_ATTR readGlyph(const font_t* font, uint32_t glyph, uint16_t* cols)
+{
+    const uint32_t* words = (const uint32_t*)font->cols;
+    uint16_t start = GLYPH_OFFSET(glyph);
+    uint16_t end = start + (GLYPH_WIDTH(glyph) * font->pages);
+    uint32_t word = 0;
+    uint8_t page = 0;
+    uint16_t col = 0;
+    uint16_t idx;
+
+    for(idx = start; idx < end; idx++)
+    {
+        // Load a word, then use it a byte at a time
+        if(idx == start || 0 == (idx % 4))
+        {
+            word = words[idx / 4] >> (8 * (idx % 4));
+        }
+        col |= (uint16_t)(word & 0xFF) << (8 * page);
+        word >>= 8;
+
+        if(++page == font->pages)
+        {
+            *(cols++) = col;
+            col = 0;
+            page = 0;
+        }
+    }
+}
 
 /**
  * @brief Draw a single character to the OLED display
@@ -22,32 +115,30 @@ int16_t charWidth(char character, const sprite_t* table);
  * @param x The x position where to draw the character
  * @param y The y position where to draw the character
  * @param character The character to print
- * @param table A table of character sprites, in ASCII order
+ * @param font The font to draw the character in
  * @param col WHITE, BLACK or INVERSE
  * @return The x position of the end of the character drawn
  */
 int16_t ICACHE_FLASH_ATTR plotChar(int16_t x, int16_t y,
-                                   char character, const sprite_t* table, color col)
+                                   char character, const font_t* font, color col)
 {
-    if(character >= ' ')
+    uint32_t glyph = getGlyph(character, font);
+    if(0 != glyph)
     {
-        if ('a' <= character && character <= 'z')
-        {
-            character = (char) (character - 'a' + 'A');
-        }
-        else if(character >= '{')
-        {
-            // These usually come after lowercase, but lowercase doesn't exist
-            character = '`' + 1 + (character - '{');
-        }
-        return plotSprite(x, y, &table[character - ' '], col);
+        uint16_t cols[FONT_MAX_WIDTH];
+        readGlyph(font, glyph, cols);
+        blitColumns(x, y, cols, GLYPH_WIDTH(glyph), font->height, col);
     }
-    return x;
+    return x + GLYPH_ADVANCE(glyph);
 }
 
 /**
  * @brief Draw a string to the display
  *        Special characters (< ' ') skipped
+ *
+ * Strings are unpacked once into a small cache of columns, so labels which
+ * are drawn every frame skip looking up and unpacking each glyph
+ *
  * @param x The x position where to draw the string
  * @param y The y position where to draw the string
  * @param text The string to draw
@@ -57,98 +148,243 @@ int16_t ICACHE_FLASH_ATTR plotChar(int16_t x, int16_t y,
  */
 int16_t ICACHE_FLASH_ATTR plotText(int16_t x, int16_t y, const char* text, fonts font, color col)
 {
+    if(font >= NUM_FONTS)
+    {
+        return x;
+    }
+
+    textRun_t* run = textCacheGet(text, font, true);
+    if(NULL != run)
+    {
+        blitColumns(x, y, run->cols, run->numCols, fontTable[font]->height, col);
+        return x + run->numCols;
+    }
+
+    // The string couldn't be cached, so draw it a character at a time
+    const font_t* fontData = fontTable[font];
     while (0 != *text)
     {
-        switch (font)
-        {
-            case TOM_THUMB:
-            {
-                x = plotChar(x, y, *text, font_TomThumb, col);
-                break;
-            }
-            case IBM_VGA_8:
-            {
-                x = plotChar(x, y, *text, font_IbmVga8, col);
-                break;
-            }
-            case RADIOSTARS:
-            {
-                x = plotChar(x, y, *text, font_Radiostars, col);
-                break;
-            }
-            default:
-            {
-                break;
-            }
-        }
+        x = plotChar(x, y, *text, fontData, col);
         text++;
     }
     return x;
 }
 
 /**
- * @brief TODO
+ * @brief Get the width of a character, including the space after it
+ *
+ * @param character The character to measure
+ * @param font The font to measure the character in
+ * @return The width of the character
+ */
+int16_t ICACHE_FLASH_ATTR charWidth(char character, const font_t* font)
+{
+    return GLYPH_ADVANCE(getGlyph(character, font));
+}
+
+/**
+ * @brief Get the width of a string, which is how far plotText() moves x
+ *
+ * @param text The string to measure
+ * @param font The font to measure the string in
+ * @return The width of the string
+ */
+int16_t ICACHE_FLASH_ATTR textWidth(const char* text, fonts font)
+{
+    if(font >= NUM_FONTS)
+    {
+        return 0;
+    }
+
+    // If the string was drawn recently, its width is already known
+    textRun_t* run = textCacheGet(text, font, false);
+    if(NULL != run)
+    {
+        return run->numCols;
+    }
+
+    int16_t width = 0;
+    const font_t* fontData = fontTable[font];
+    while (0 != *text)
+    {
+        width += charWidth(*text, fontData);
+        text++;
+    }
+    return width;
+}
+
+/**
+ * @brief Free every cached string, i.e. when a mode exits
+ */
+void ICACHE_FLASH_ATTR textCacheClear(void)
+{
+    uint8_t i;
+    for(i = 0; i < TEXT_CACHE_ENTRIES; i++)
+    {
+        if(NULL != textCache[i].cols)
+        {
+            os_free(textCache[i].cols);
+        }
+    }
+    ets_memset(textCache, 0, sizeof(textCache));
+}
+
+/**
+ * @brief Look a string up in the cache, optionally rendering it on a miss.
  *
- * @param character
- * @param table
- * @return int16_t
+ * A miss replaces the entry last drawn from the same pointer in the same font,
+ * so a buffer which changes every frame, like a score, only uses one entry.
+ * Otherwise it replaces an empty entry, or the least recently used one
+ *
+ * @param text The string to find
+ * @param font The font to find it in
+ * @param render true to render the string if it isn't cached
+ * @return The cached string, or NULL if it isn't cached
  */
-int16_t ICACHE_FLASH_ATTR charWidth(char character, const sprite_t* table)
+static textRun_t* ICACHE_FLASH_ATTR textCacheGet(const char* text, fonts font, bool render)
 {
-    if(character >= ' ')
+    // Hash and measure the string in one pass, FNV-1a
+    uint32_t hash = 2166136261UL;
+    uint16_t len = 0;
+    const char* c;
+    for(c = text; 0 != *c; c++, len++)
+    {
+        hash = (hash ^ (uint8_t)(*c)) * 16777619UL;
+    }
+
+    textRun_t* sameSrc = NULL;
+    textRun_t* empty = NULL;
+    textRun_t* lru = NULL;
+    uint8_t i;
+    for(i = 0; i < TEXT_CACHE_ENTRIES; i++)
     {
-        if ('a' <= character && character <= 'z')
+        textRun_t* run = &textCache[i];
+        if(NULL == run->cols)
         {
-            character = (char) (character - 'a' + 'A');
+            empty = run;
         }
-#ifdef USE_ESP_GDB // If we use GDB, read these to RAM first to avoid SIGSEV
-        sprite_t sprite_ram;
-        ets_memcpy ( &sprite_ram, &(table[character - ' ']), sizeof(sprite_t) );
-        return sprite_ram.width + 1;
-#else
-        return table[character - ' '].width + 1;
-#endif
+        else if(run->hash == hash && run->len == len && run->font == font &&
+                0 == ets_memcmp(run->text, text, len))
+        {
+            run->textPtr = text;
+            run->lastUsed = ++textCacheClock;
+            return run;
+        }
+        else if(run->textPtr == text && run->font == font)
+        {
+            sameSrc = run;
+        }
+        else if(NULL == lru || run->lastUsed < lru->lastUsed)
+        {
+            lru = run;
+        }
+    }
+
+    if(!render)
+    {
+        return NULL;
     }
-    return 0;
+
+    textRun_t* run = sameSrc ? sameSrc : (empty ? empty : lru);
+    if(!textCacheRender(run, text, font, hash, len))
+    {
+        return NULL;
+    }
+    run->lastUsed = ++textCacheClock;
+    return run;
 }
 
 /**
- * @brief TODO
+ * @brief Render a string into a cache entry, replacing what was there
  *
- * @param text
- * @param font
- * @return int16_t
+ * @param run The entry to render into
+ * @param text The string to render
+ * @param font The font to render it in
+ * @param hash The string's hash
+ * @param len The string's length
+ * @return true if the string was rendered, false if it's too wide, empty, or
+ *         there's no memory for it
  */
-int16_t ICACHE_FLASH_ATTR textWidth(const char* text, fonts font)
+static bool ICACHE_FLASH_ATTR textCacheRender(textRun_t* run, const char* text, fonts font,
+        uint32_t hash, uint16_t len)
 {
-    int16_t width = 0;
+    const font_t* fontData = fontTable[font];
+
+    // Measure the string first, to know how much memory it needs
+    uint16_t numCols = 0;
+    uint16_t i;
+    for(i = 0; i < len; i++)
+    {
+        numCols += charWidth(text[i], fontData);
+    }
+    if(0 == numCols || numCols > TEXT_CACHE_MAX_COLS)
+    {
+        return false;
+    }
+
+    // The columns and a copy of the string share one allocation, which is
+    // reused if it's big enough
+    uint16_t needBytes = (numCols * sizeof(uint16_t)) + len + 1;
+    if(run->allocBytes < needBytes)
+    {
+        if(NULL != run->cols)
+        {
+            os_free(run->cols);
+        }
+        ets_memset(run, 0, sizeof(textRun_t));
+        run->cols = (uint16_t*)os_malloc(needBytes);
+        if(NULL == run->cols)
+        {
+            return false;
+        }
+        run->allocBytes = needBytes;
+    }
+
+    run->text = (char*)&run->cols[numCols];
+    ets_memcpy(run->text, text, len + 1);
+    run->textPtr = text;
+    run->hash = hash;
+    run->len = len;
+    run->font = font;
+    run->numCols = numCols;
+
+    textColumns(text, font, run->cols);
+    return true;
+}
+
+/**
+ * @brief Unpack a string into columns which blitColumns() can draw, the same
+ *        as plotText() would. The space after each glyph is BLIT_COL_SKIP
+ *
+ * @param text The string to unpack
+ * @param font The font to unpack it in
+ * @param cols Where to write the columns, which must have room for
+ *             textWidth() of them
+ * @return The number of columns written
+ */
+uint16_t ICACHE_FLASH_ATTR textColumns(const char* text, fonts font, uint16_t* cols)
+{
+    if(font >= NUM_FONTS)
+    {
+        return 0;
+    }
+
+    const font_t* fontData = fontTable[font];
+    uint16_t* out = cols;
     while (0 != *text)
     {
-        switch (font)
+        uint32_t glyph = getGlyph(*text, fontData);
+        readGlyph(fontData, glyph, out);
+        out += GLYPH_WIDTH(glyph);
+
+        uint8_t gap;
+        for(gap = GLYPH_WIDTH(glyph); gap < GLYPH_ADVANCE(glyph); gap++)
         {
-            case TOM_THUMB:
-            {
-                width += charWidth(*text, font_TomThumb);
-                break;
-            }
-            case IBM_VGA_8:
-            {
-                width += charWidth(*text, font_IbmVga8);
-                break;
-            }
-            case RADIOSTARS:
-            {
-                width += charWidth(*text, font_Radiostars);
-                break;
-            }
-            default:
-            {
-                break;
-            }
+            *(out++) = BLIT_COL_SKIP;
         }
         text++;
     }
-    return width;
+    return out - cols;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -9,7 +9,6 @@
 #define SRC_FONT_H_
 
 #include <osapi.h>
-#include "sprite.h"
 #include "oled.h"
 #include "user_main.h"
 #include "user_config.h"
@@ -23,17 +22,42 @@ typedef enum
     RADIOSTARS
 } fonts;
 
+/**
+ * A font's glyphs, stored as columns packed eight rows to a byte like the
+ * framebuffer, so text can be drawn a byte at a time
+ */
+typedef struct
+{
+    uint8_t height;         // Rows in every glyph, at most 15
+    uint8_t pages;          // Bytes in each column, (height + 7) / 8
+    const uint32_t* glyphs; // A FONT_GLYPH() for each character from ' ' to '~'
+    const uint8_t* cols;    // Every glyph's columns. Read this a word at a time
+} font_t;
+
+// The widest a glyph may be, in columns
+#define FONT_MAX_WIDTH 16
+
+// Where a glyph's columns start in font_t.cols, how many there are, and how
+// far the cursor moves past it, packed in a word so flash is read only once
+#define FONT_GLYPH(offset, width, advance) \
+    ((uint32_t)(offset) | ((uint32_t)(width) << 16) | ((uint32_t)(advance) << 24))
+#define GLYPH_OFFSET(glyph)  ((glyph) & 0xFFFF)
+#define GLYPH_WIDTH(glyph)   (((glyph) >> 16) & 0xFF)
+#define GLYPH_ADVANCE(glyph) ((glyph) >> 24)
+
 #define FONT_HEIGHT_RADIOSTARS 12
-extern const sprite_t font_Radiostars[] RODATA_ATTR;
+extern const font_t font_Radiostars;
 
 #define FONT_HEIGHT_IBMVGA8 10
-extern const sprite_t font_IbmVga8[] RODATA_ATTR;
+extern const font_t font_IbmVga8;
 
 #define FONT_HEIGHT_TOMTHUMB 5
-extern const sprite_t font_TomThumb[] RODATA_ATTR;
+extern const font_t font_TomThumb;
 
 int16_t plotText(int16_t x, int16_t y, const char* text, fonts font, color col);
 int16_t textWidth(const char* text, fonts font);
+uint16_t textColumns(const char* text, fonts font, uint16_t* cols);
+void textCacheClear(void);
 
 #endif
 #endif /* SRC_FONT_H_ */
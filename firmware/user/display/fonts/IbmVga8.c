@@ -2,1112 +2,317 @@
 
 #if defined(FEATURE_OLED)
 
-const sprite_t font_IbmVga8[] RODATA_ATTR =
+// Each glyph's columns, left to right. Columns are packed like the framebuffer,
+// 2 bytes of eight rows each, with the top row in bit 0
+// It's read a word at a time, so it's aligned and padded to a whole word on
+// every build, not just where RODATA_ATTR aligns it
+static const uint8_t font_IbmVga8_cols[] __attribute__((aligned(4))) RODATA_ATTR =
 {
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 4,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000110,
-            0b0000000000001111,
-            0b0000000000001111,
-            0b0000000000001111,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000000,
-            0b0000000000000110,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000010010,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000110110,
-            0b0000000000110110,
-            0b0000000001111111,
-            0b0000000000110110,
-            0b0000000000110110,
-            0b0000000000110110,
-            0b0000000001111111,
-            0b0000000000110110,
-            0b0000000000110110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000001100,
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000001100000,
-            0b0000000000111110,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000001100011,
-            0b0000000000111110,
-            0b0000000000001100,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000001100001,
-            0b0000000001100011,
-            0b0000000000000110,
-            0b0000000000001100,
-            0b0000000000011000,
-            0b0000000000110000,
-            0b0000000001100011,
-            0b0000000001000011,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000011100,
-            0b0000000000110110,
-            0b0000000000110110,
-            0b0000000000011100,
-            0b0000000000111011,
-            0b0000000001101110,
-            0b0000000001100110,
-            0b0000000001100110,
-            0b0000000001100110,
-            0b0000000000111011,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 4,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000000110,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 4,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000001100,
-            0b0000000000000110,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000001100,
-        },
-    },
-    {
-        .width = 8,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000001100110,
-            0b0000000000111100,
-            0b0000000011111111,
-            0b0000000000111100,
-            0b0000000001100110,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000111111,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000001111111,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 2,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000011,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000001,
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000001100,
-            0b0000000000011000,
-            0b0000000000110000,
-            0b0000000001100000,
-            0b0000000001000000,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000011100,
-            0b0000000000110110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001101011,
-            0b0000000001101011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000110110,
-            0b0000000000011100,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000001100,
-            0b0000000000011100,
-            0b0000000000111100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000111111,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000001100,
-            0b0000000000011000,
-            0b0000000000110000,
-            0b0000000001100000,
-            0b0000000001100011,
-            0b0000000001111111,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000011110,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000001100011,
-            0b0000000000111110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000110,
-            0b0000000000001110,
-            0b0000000000011110,
-            0b0000000000110110,
-            0b0000000001100110,
-            0b0000000001111111,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000001111,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001111111,
-            0b0000000001100000,
-            0b0000000001100000,
-            0b0000000001100000,
-            0b0000000001111110,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000001100011,
-            0b0000000000111110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000011100,
-            0b0000000000110000,
-            0b0000000001100000,
-            0b0000000001100000,
-            0b0000000001111110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000111110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001111111,
-            0b0000000001100011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000001100,
-            0b0000000000011000,
-            0b0000000000011000,
-            0b0000000000011000,
-            0b0000000000011000,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000111110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000111111,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000111100,
-        },
-    },
-    {
-        .width = 2,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000001100,
-            0b0000000000011000,
-            0b0000000000110000,
-            0b0000000000011000,
-            0b0000000000001100,
-            0b0000000000000110,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000111111,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000111111,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000110000,
-            0b0000000000011000,
-            0b0000000000001100,
-            0b0000000000000110,
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000001100,
-            0b0000000000011000,
-            0b0000000000110000,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000000110,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000000000,
-            0b0000000000001100,
-            0b0000000000001100,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001101111,
-            0b0000000001101111,
-            0b0000000001101111,
-            0b0000000001101110,
-            0b0000000001100000,
-            0b0000000000111110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000001000,
-            0b0000000000011100,
-            0b0000000000110110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001111111,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001111110,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000111110,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000001111110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000011110,
-            0b0000000000110011,
-            0b0000000001100001,
-            0b0000000001100000,
-            0b0000000001100000,
-            0b0000000001100000,
-            0b0000000001100000,
-            0b0000000001100001,
-            0b0000000000110011,
-            0b0000000000011110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001111100,
-            0b0000000000110110,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110110,
-            0b0000000001111100,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001111111,
-            0b0000000000110011,
-            0b0000000000110001,
-            0b0000000000110100,
-            0b0000000000111100,
-            0b0000000000110100,
-            0b0000000000110000,
-            0b0000000000110001,
-            0b0000000000110011,
-            0b0000000001111111,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001111111,
-            0b0000000000110011,
-            0b0000000000110001,
-            0b0000000000110100,
-            0b0000000000111100,
-            0b0000000000110100,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000001111000,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000011110,
-            0b0000000000110011,
-            0b0000000001100001,
-            0b0000000001100000,
-            0b0000000001100000,
-            0b0000000001101111,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000110011,
-            0b0000000000011101,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001111111,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-        },
-    },
-    {
-        .width = 4,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000001111,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000001111,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000011110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110110,
-            0b0000000000111100,
-            0b0000000000111100,
-            0b0000000000110110,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000001110011,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001111000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110001,
-            0b0000000000110011,
-            0b0000000001111111,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001100011,
-            0b0000000001110111,
-            0b0000000001111111,
-            0b0000000001111111,
-            0b0000000001101011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001100011,
-            0b0000000001110011,
-            0b0000000001111011,
-            0b0000000001111111,
-            0b0000000001101111,
-            0b0000000001100111,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000111110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001111110,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000111110,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000001111000,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001101011,
-            0b0000000001101111,
-            0b0000000000111110,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001111110,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000111110,
-            0b0000000000110110,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000001110011,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111110,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000110000,
-            0b0000000000011100,
-            0b0000000000000110,
-            0b0000000000000011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000111110,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111111,
-            0b0000000000111111,
-            0b0000000000101101,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000011110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000111110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000110110,
-            0b0000000000011100,
-            0b0000000000001000,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000001101011,
-            0b0000000001101011,
-            0b0000000001101011,
-            0b0000000001111111,
-            0b0000000001110111,
-            0b0000000000110110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001100011,
-            0b0000000001100011,
-            0b0000000000110110,
-            0b0000000000111110,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000111110,
-            0b0000000000110110,
-            0b0000000001100011,
-            0b0000000001100011,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000110011,
-            0b0000000000011110,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000011110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000001111111,
-            0b0000000001100011,
-            0b0000000001000011,
-            0b0000000000000110,
-            0b0000000000001100,
-            0b0000000000011000,
-            0b0000000000110000,
-            0b0000000001100001,
-            0b0000000001100011,
-            0b0000000001111111,
-        },
-    },
-    {
-        .width = 4,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000001111,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001111,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000001000000,
-            0b0000000001100000,
-            0b0000000001110000,
-            0b0000000000111000,
-            0b0000000000011100,
-            0b0000000000001110,
-            0b0000000000000111,
-            0b0000000000000011,
-            0b0000000000000001,
-        },
-    },
-    {
-        .width = 4,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000001111,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000001111,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000001000,
-            0b0000000000011100,
-            0b0000000000110110,
-            0b0000000001100011,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 8,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000011111111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000011,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000111,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000111000,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 2,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000000,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111000,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000000111,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000001100,
-            0b0000000000111000,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_IBMVGA8,
-        .data = {
-            0b0000000000111011,
-            0b0000000001101110,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
+    // ' '
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '!'
+    0x0E, 0x00, 0x7F, 0x03, 0x7F, 0x03, 0x0E, 0x00,
+    // '"'
+    0x07, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0F, 0x00, 0x07, 0x00,
+    // '#'
+    0x88, 0x00, 0xFE, 0x03, 0xFE, 0x03, 0x88, 0x00,
+    0xFE, 0x03, 0xFE, 0x03, 0x88, 0x00,
+    // '$'
+    0x8C, 0x00, 0x9E, 0x01, 0x12, 0x01, 0x13, 0x03,
+    0x13, 0x03, 0xF6, 0x01, 0xE4, 0x00,
+    // '%'
+    0x0C, 0x03, 0x8C, 0x01, 0xC0, 0x00, 0x60, 0x00,
+    0x30, 0x00, 0x18, 0x03, 0x0C, 0x03,
+    // '&'
+    0xE0, 0x01, 0xF6, 0x03, 0x1F, 0x02, 0x39, 0x02,
+    0xEF, 0x01, 0xF6, 0x03, 0x10, 0x02,
+    // '\''
+    0x08, 0x00, 0x0F, 0x00, 0x07, 0x00,
+    // '('
+    0xFC, 0x00, 0xFE, 0x01, 0x03, 0x03, 0x01, 0x02,
+    // ')'
+    0x01, 0x02, 0x03, 0x03, 0xFE, 0x01, 0xFC, 0x00,
+    // '*'
+    0x20, 0x00, 0xA8, 0x00, 0xF8, 0x00, 0x70, 0x00,
+    0x70, 0x00, 0xF8, 0x00, 0xA8, 0x00, 0x20, 0x00,
+    // '+'
+    0x20, 0x00, 0x20, 0x00, 0xF8, 0x00, 0xF8, 0x00,
+    0x20, 0x00, 0x20, 0x00,
+    // ','
+    0x00, 0x02, 0xC0, 0x03, 0xC0, 0x01,
+    // '-'
+    0x20, 0x00, 0x20, 0x00, 0x20, 0x00, 0x20, 0x00,
+    0x20, 0x00, 0x20, 0x00, 0x20, 0x00,
+    // '.'
+    0x00, 0x03, 0x00, 0x03,
+    // '/'
+    0x00, 0x03, 0x80, 0x01, 0xC0, 0x00, 0x60, 0x00,
+    0x30, 0x00, 0x18, 0x00, 0x0C, 0x00,
+    // '0'
+    0xFC, 0x00, 0xFE, 0x01, 0x03, 0x03, 0x31, 0x02,
+    0x03, 0x03, 0xFE, 0x01, 0xFC, 0x00,
+    // '1'
+    0x04, 0x02, 0x06, 0x02, 0xFF, 0x03, 0xFF, 0x03,
+    0x00, 0x02, 0x00, 0x02,
+    // '2'
+    0x82, 0x03, 0xC3, 0x03, 0x61, 0x02, 0x31, 0x02,
+    0x19, 0x02, 0x0F, 0x03, 0x06, 0x03,
+    // '3'
+    0x02, 0x01, 0x03, 0x03, 0x11, 0x02, 0x11, 0x02,
+    0x11, 0x02, 0xFF, 0x03, 0xEE, 0x01,
+    // '4'
+    0x30, 0x00, 0x38, 0x00, 0x2C, 0x00, 0x26, 0x02,
+    0xFF, 0x03, 0xFF, 0x03, 0x20, 0x02,
+    // '5'
+    0x1F, 0x01, 0x1F, 0x03, 0x11, 0x02, 0x11, 0x02,
+    0x11, 0x02, 0xF1, 0x03, 0xE1, 0x01,
+    // '6'
+    0xFC, 0x01, 0xFE, 0x03, 0x13, 0x02, 0x11, 0x02,
+    0x11, 0x02, 0xF0, 0x03, 0xE0, 0x01,
+    // '7'
+    0x03, 0x00, 0x03, 0x00, 0xC1, 0x03, 0xE1, 0x03,
+    0x31, 0x00, 0x1F, 0x00, 0x0F, 0x00,
+    // '8'
+    0xEE, 0x01, 0xFF, 0x03, 0x11, 0x02, 0x11, 0x02,
+    0x11, 0x02, 0xFF, 0x03, 0xEE, 0x01,
+    // '9'
+    0x0E, 0x00, 0x1F, 0x02, 0x11, 0x02, 0x11, 0x02,
+    0x11, 0x03, 0xFF, 0x01, 0xFE, 0x00,
+    // ':'
+    0x8C, 0x01, 0x8C, 0x01,
+    // ';'
+    0x00, 0x02, 0x8C, 0x03, 0x8C, 0x01,
+    // '<'
+    0x20, 0x00, 0x70, 0x00, 0xD8, 0x00, 0x8C, 0x01,
+    0x06, 0x03, 0x02, 0x02,
+    // '='
+    0x48, 0x00, 0x48, 0x00, 0x48, 0x00, 0x48, 0x00,
+    0x48, 0x00, 0x48, 0x00,
+    // '>'
+    0x02, 0x02, 0x06, 0x03, 0x8C, 0x01, 0xD8, 0x00,
+    0x70, 0x00, 0x20, 0x00,
+    // '?'
+    0x06, 0x00, 0x07, 0x00, 0x01, 0x00, 0x71, 0x03,
+    0x79, 0x03, 0x0F, 0x00, 0x06, 0x00,
+    // '@'
+    0xFC, 0x01, 0xFE, 0x03, 0x02, 0x02, 0xF2, 0x02,
+    0xF2, 0x02, 0xFE, 0x02, 0x7C, 0x00,
+    // 'A'
+    0xF8, 0x03, 0xFC, 0x03, 0x26, 0x00, 0x23, 0x00,
+    0x26, 0x00, 0xFC, 0x03, 0xF8, 0x03,
+    // 'B'
+    0x01, 0x02, 0xFF, 0x03, 0xFF, 0x03, 0x11, 0x02,
+    0x11, 0x02, 0xFF, 0x03, 0xEE, 0x01,
+    // 'C'
+    0xFC, 0x00, 0xFE, 0x01, 0x03, 0x03, 0x01, 0x02,
+    0x01, 0x02, 0x03, 0x03, 0x86, 0x01,
+    // 'D'
+    0x01, 0x02, 0xFF, 0x03, 0xFF, 0x03, 0x01, 0x02,
+    0x03, 0x03, 0xFE, 0x01, 0xFC, 0x00,
+    // 'E'
+    0x01, 0x02, 0xFF, 0x03, 0xFF, 0x03, 0x11, 0x02,
+    0x39, 0x02, 0x03, 0x03, 0x87, 0x03,
+    // 'F'
+    0x01, 0x02, 0xFF, 0x03, 0xFF, 0x03, 0x11, 0x02,
+    0x39, 0x00, 0x03, 0x00, 0x07, 0x00,
+    // 'G'
+    0xFC, 0x00, 0xFE, 0x01, 0x03, 0x03, 0x21, 0x02,
+    0x21, 0x02, 0xE3, 0x01, 0xE6, 0x03,
+    // 'H'
+    0xFF, 0x03, 0xFF, 0x03, 0x10, 0x00, 0x10, 0x00,
+    0x10, 0x00, 0xFF, 0x03, 0xFF, 0x03,
+    // 'I'
+    0x01, 0x02, 0xFF, 0x03, 0xFF, 0x03, 0x01, 0x02,
+    // 'J'
+    0xC0, 0x01, 0xC0, 0x03, 0x00, 0x02, 0x01, 0x02,
+    0xFF, 0x03, 0xFF, 0x01,
+    // 'K'
+    0x01, 0x02, 0xFF, 0x03, 0xFF, 0x03, 0x30, 0x00,
+    0x78, 0x00, 0xCF, 0x03, 0x87, 0x03,
+    // 'L'
+    0x01, 0x02, 0xFF, 0x03, 0xFF, 0x03, 0x01, 0x02,
+    0x00, 0x02, 0x00, 0x03, 0x80, 0x03,
+    // 'M'
+    0xFF, 0x03, 0xFF, 0x03, 0x0E, 0x00, 0x1C, 0x00,
+    0x0E, 0x00, 0xFF, 0x03, 0xFF, 0x03,
+    // 'N'
+    0xFF, 0x03, 0xFF, 0x03, 0x0E, 0x00, 0x1C, 0x00,
+    0x38, 0x00, 0xFF, 0x03, 0xFF, 0x03,
+    // 'O'
+    0xFE, 0x01, 0xFF, 0x03, 0x01, 0x02, 0x01, 0x02,
+    0x01, 0x02, 0xFF, 0x03, 0xFE, 0x01,
+    // 'P'
+    0x01, 0x02, 0xFF, 0x03, 0xFF, 0x03, 0x11, 0x02,
+    0x11, 0x00, 0x1F, 0x00, 0x0E, 0x00,
+    // 'Q'
+    0xFE, 0x00, 0xFF, 0x01, 0x01, 0x01, 0xC1, 0x01,
+    0x81, 0x03, 0xFF, 0x03, 0xFE, 0x02,
+    // 'R'
+    0x01, 0x02, 0xFF, 0x03, 0xFF, 0x03, 0x11, 0x00,
+    0x31, 0x00, 0xFF, 0x03, 0xCE, 0x03,
+    // 'S'
+    0x86, 0x01, 0x8F, 0x03, 0x19, 0x02, 0x11, 0x02,
+    0x31, 0x02, 0xE7, 0x03, 0xC6, 0x01,
+    // 'T'
+    0x07, 0x00, 0x03, 0x02, 0xFF, 0x03, 0xFF, 0x03,
+    0x03, 0x02, 0x07, 0x00,
+    // 'U'
+    0xFF, 0x01, 0xFF, 0x03, 0x00, 0x02, 0x00, 0x02,
+    0x00, 0x02, 0xFF, 0x03, 0xFF, 0x01,
+    // 'V'
+    0x7F, 0x00, 0xFF, 0x00, 0x80, 0x01, 0x00, 0x03,
+    0x80, 0x01, 0xFF, 0x00, 0x7F, 0x00,
+    // 'W'
+    0xFF, 0x01, 0xFF, 0x03, 0x80, 0x03, 0xF0, 0x00,
+    0x80, 0x03, 0xFF, 0x03, 0xFF, 0x01,
+    // 'X'
+    0x03, 0x03, 0xCF, 0x03, 0xFC, 0x00, 0x78, 0x00,
+    0xFC, 0x00, 0xCF, 0x03, 0x03, 0x03,
+    // 'Y'
+    0x0F, 0x00, 0x1F, 0x02, 0xF0, 0x03, 0xF0, 0x03,
+    0x1F, 0x02, 0x0F, 0x00,
+    // 'Z'
+    0x87, 0x03, 0xC3, 0x03, 0x61, 0x02, 0x31, 0x02,
+    0x19, 0x02, 0x0F, 0x03, 0x87, 0x03,
+    // '['
+    0xFF, 0x03, 0xFF, 0x03, 0x01, 0x02, 0x01, 0x02,
+    // '\\'
+    0x0E, 0x00, 0x1C, 0x00, 0x38, 0x00, 0x70, 0x00,
+    0xE0, 0x00, 0xC0, 0x01, 0x80, 0x03,
+    // ']'
+    0x01, 0x02, 0x01, 0x02, 0xFF, 0x03, 0xFF, 0x03,
+    // '^'
+    0x08, 0x00, 0x0C, 0x00, 0x06, 0x00, 0x03, 0x00,
+    0x06, 0x00, 0x0C, 0x00, 0x08, 0x00,
+    // '_'
+    0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02,
+    0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02,
+    // '`'
+    0x03, 0x00, 0x07, 0x00, 0x04, 0x00,
+    // '{'
+    0x10, 0x00, 0x10, 0x00, 0xFE, 0x01, 0xEF, 0x03,
+    0x01, 0x02, 0x01, 0x02,
+    // '|'
+    0xEF, 0x03, 0xEF, 0x03,
+    // '}'
+    0x01, 0x02, 0x01, 0x02, 0xEF, 0x03, 0xFE, 0x01,
+    0x10, 0x00, 0x10, 0x00,
+    // '~'
+    0x02, 0x00, 0x03, 0x00, 0x01, 0x00, 0x03, 0x00,
+    0x02, 0x00, 0x03, 0x00, 0x01, 0x00,
+    // Padding to a whole word
+    0x00, 0x00,
 };
 
-#endif
\ No newline at end of file
+// Where each character's columns start, how wide it is, and how far it moves
+// the cursor, from ' ' to '~'
+static const uint32_t font_IbmVga8_glyphs[] RODATA_ATTR =
+{
+    FONT_GLYPH(0, 7, 8), // ' '
+    FONT_GLYPH(14, 4, 5), // '!'
+    FONT_GLYPH(22, 6, 7), // '"'
+    FONT_GLYPH(34, 7, 8), // '#'
+    FONT_GLYPH(48, 7, 8), // '$'
+    FONT_GLYPH(62, 7, 8), // '%'
+    FONT_GLYPH(76, 7, 8), // '&'
+    FONT_GLYPH(90, 3, 4), // '\''
+    FONT_GLYPH(96, 4, 5), // '('
+    FONT_GLYPH(104, 4, 5), // ')'
+    FONT_GLYPH(112, 8, 9), // '*'
+    FONT_GLYPH(128, 6, 7), // '+'
+    FONT_GLYPH(140, 3, 4), // ','
+    FONT_GLYPH(146, 7, 8), // '-'
+    FONT_GLYPH(160, 2, 3), // '.'
+    FONT_GLYPH(164, 7, 8), // '/'
+    FONT_GLYPH(178, 7, 8), // '0'
+    FONT_GLYPH(192, 6, 7), // '1'
+    FONT_GLYPH(204, 7, 8), // '2'
+    FONT_GLYPH(218, 7, 8), // '3'
+    FONT_GLYPH(232, 7, 8), // '4'
+    FONT_GLYPH(246, 7, 8), // '5'
+    FONT_GLYPH(260, 7, 8), // '6'
+    FONT_GLYPH(274, 7, 8), // '7'
+    FONT_GLYPH(288, 7, 8), // '8'
+    FONT_GLYPH(302, 7, 8), // '9'
+    FONT_GLYPH(316, 2, 3), // ':'
+    FONT_GLYPH(320, 3, 4), // ';'
+    FONT_GLYPH(326, 6, 7), // '<'
+    FONT_GLYPH(338, 6, 7), // '='
+    FONT_GLYPH(350, 6, 7), // '>'
+    FONT_GLYPH(362, 7, 8), // '?'
+    FONT_GLYPH(376, 7, 8), // '@'
+    FONT_GLYPH(390, 7, 8), // 'A'
+    FONT_GLYPH(404, 7, 8), // 'B'
+    FONT_GLYPH(418, 7, 8), // 'C'
+    FONT_GLYPH(432, 7, 8), // 'D'
+    FONT_GLYPH(446, 7, 8), // 'E'
+    FONT_GLYPH(460, 7, 8), // 'F'
+    FONT_GLYPH(474, 7, 8), // 'G'
+    FONT_GLYPH(488, 7, 8), // 'H'
+    FONT_GLYPH(502, 4, 5), // 'I'
+    FONT_GLYPH(510, 6, 7), // 'J'
+    FONT_GLYPH(522, 7, 8), // 'K'
+    FONT_GLYPH(536, 7, 8), // 'L'
+    FONT_GLYPH(550, 7, 8), // 'M'
+    FONT_GLYPH(564, 7, 8), // 'N'
+    FONT_GLYPH(578, 7, 8), // 'O'
+    FONT_GLYPH(592, 7, 8), // 'P'
+    FONT_GLYPH(606, 7, 8), // 'Q'
+    FONT_GLYPH(620, 7, 8), // 'R'
+    FONT_GLYPH(634, 7, 8), // 'S'
+    FONT_GLYPH(648, 6, 7), // 'T'
+    FONT_GLYPH(660, 7, 8), // 'U'
+    FONT_GLYPH(674, 7, 8), // 'V'
+    FONT_GLYPH(688, 7, 8), // 'W'
+    FONT_GLYPH(702, 7, 8), // 'X'
+    FONT_GLYPH(716, 6, 7), // 'Y'
+    FONT_GLYPH(728, 7, 8), // 'Z'
+    FONT_GLYPH(742, 4, 5), // '['
+    FONT_GLYPH(750, 7, 8), // '\\'
+    FONT_GLYPH(764, 4, 5), // ']'
+    FONT_GLYPH(772, 7, 8), // '^'
+    FONT_GLYPH(786, 8, 9), // '_'
+    FONT_GLYPH(802, 3, 4), // '`'
+    FONT_GLYPH(390, 7, 8), // 'a'
+    FONT_GLYPH(404, 7, 8), // 'b'
+    FONT_GLYPH(418, 7, 8), // 'c'
+    FONT_GLYPH(432, 7, 8), // 'd'
+    FONT_GLYPH(446, 7, 8), // 'e'
+    FONT_GLYPH(460, 7, 8), // 'f'
+    FONT_GLYPH(474, 7, 8), // 'g'
+    FONT_GLYPH(488, 7, 8), // 'h'
+    FONT_GLYPH(502, 4, 5), // 'i'
+    FONT_GLYPH(510, 6, 7), // 'j'
+    FONT_GLYPH(522, 7, 8), // 'k'
+    FONT_GLYPH(536, 7, 8), // 'l'
+    FONT_GLYPH(550, 7, 8), // 'm'
+    FONT_GLYPH(564, 7, 8), // 'n'
+    FONT_GLYPH(578, 7, 8), // 'o'
+    FONT_GLYPH(592, 7, 8), // 'p'
+    FONT_GLYPH(606, 7, 8), // 'q'
+    FONT_GLYPH(620, 7, 8), // 'r'
+    FONT_GLYPH(634, 7, 8), // 's'
+    FONT_GLYPH(648, 6, 7), // 't'
+    FONT_GLYPH(660, 7, 8), // 'u'
+    FONT_GLYPH(674, 7, 8), // 'v'
+    FONT_GLYPH(688, 7, 8), // 'w'
+    FONT_GLYPH(702, 7, 8), // 'x'
+    FONT_GLYPH(716, 6, 7), // 'y'
+    FONT_GLYPH(728, 7, 8), // 'z'
+    FONT_GLYPH(808, 6, 7), // '{'
+    FONT_GLYPH(820, 2, 3), // '|'
+    FONT_GLYPH(824, 6, 7), // '}'
+    FONT_GLYPH(836, 7, 8), // '~'
+};
+
+const font_t font_IbmVga8 =
+{
+    .height = FONT_HEIGHT_IBMVGA8,
+    .pages = 2,
+    .glyphs = font_IbmVga8_glyphs,
+    .cols = font_IbmVga8_cols,
+};
+
+#endif
@@ -2,1250 +2,363 @@
 
 #if defined(FEATURE_OLED)
 
-const sprite_t font_Radiostars[] RODATA_ATTR =
+// Each glyph's columns, left to right. Columns are packed like the framebuffer,
+// 2 bytes of eight rows each, with the top row in bit 0
+// It's read a word at a time, so it's aligned and padded to a whole word on
+// every build, not just where RODATA_ATTR aligns it
+static const uint8_t font_Radiostars_cols[] __attribute__((aligned(4))) RODATA_ATTR =
 {
-    {
-        .width = 8,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000000,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000001110111,
-            0b0000000001110111,
-            0b0000000001110111,
-            0b0000000001110111,
-            0b0000000001110111,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000110011,
-            0b0000000001100110,
-            0b0000001111111111,
-            0b0000001111111111,
-            0b0000000011001100,
-            0b0000000110011000,
-            0b0000011111111110,
-            0b0000011111111110,
-            0b0000001100110000,
-            0b0000011001100000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000011011000,
-            0b0000000011011000,
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000011111111110,
-            0b0000001111111111,
-            0b0000000000000111,
-            0b0000011111111111,
-            0b0000001111111110,
-            0b0000000011011000,
-            0b0000000011011000,
-        },
-    },
-    {
-        .width = 10,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001110110000,
-            0b0000001010110000,
-            0b0000001110110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110000,
-            0b0000000000110111,
-            0b0000000000110101,
-            0b0000000000110111,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000001110000000,
-            0b0000000111000000,
-            0b0000000011100011,
-            0b0000011001110111,
-            0b0000011000111110,
-            0b0000011000011100,
-            0b0000011100111110,
-            0b0000001111110111,
-            0b0000001111100011,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 5,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000001111,
-            0b0000000000011111,
-            0b0000000000011110,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011110,
-            0b0000000000011111,
-            0b0000000000001111,
-        },
-    },
-    {
-        .width = 5,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000011110,
-            0b0000000000011111,
-            0b0000000000001111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000001111,
-            0b0000000000011111,
-            0b0000000000011110,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000110110,
-            0b0000000000011100,
-            0b0000000001111111,
-            0b0000000001111111,
-            0b0000000000011100,
-            0b0000000000110110,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 8,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000011000,
-            0b0000000000011000,
-            0b0000000000011000,
-            0b0000000011111111,
-            0b0000000011111111,
-            0b0000000000011000,
-            0b0000000000011000,
-            0b0000000000011000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 8,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000011111111,
-            0b0000000011111111,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000011,
-            0b0000000000000111,
-            0b0000000000001110,
-            0b0000000000011100,
-            0b0000000000111000,
-            0b0000000001110000,
-            0b0000000011100000,
-            0b0000000111000000,
-            0b0000001110000000,
-            0b0000011100000000,
-            0b0000011000000000,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 5,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000111,
-            0b0000000000001111,
-            0b0000000000011111,
-            0b0000000000011111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000001111111111,
-            0b0000011111111110,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000011111111110,
-            0b0000011111111110,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001100000110,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000011111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011111111110,
-            0b0000011111111111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011111111110,
-            0b0000011111111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000000000001110,
-            0b0000000000011100,
-            0b0000000000111000,
-            0b0000000001110000,
-            0b0000000011100000,
-            0b0000000111000000,
-            0b0000001110000000,
-            0b0000011100000000,
-            0b0000011000000000,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000001111111110,
-            0b0000001111111110,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000001111111111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000111,
-            0b0000000000001111,
-            0b0000000000011110,
-            0b0000000000111100,
-            0b0000000001111000,
-            0b0000000001111000,
-            0b0000000000111100,
-            0b0000000000011110,
-            0b0000000000001111,
-            0b0000000000000111,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 8,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000011111111,
-            0b0000000011111111,
-            0b0000000011111111,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000011111111,
-            0b0000000011111111,
-            0b0000000011111111,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 7,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000001100000,
-            0b0000000001110000,
-            0b0000000001111000,
-            0b0000000000111100,
-            0b0000000000011110,
-            0b0000000000001111,
-            0b0000000000001111,
-            0b0000000000011110,
-            0b0000000000111100,
-            0b0000000001111000,
-            0b0000000001110000,
-            0b0000000001100000,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000111111,
-            0b0000000001111111,
-            0b0000000001111110,
-            0b0000000000000000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-        },
-    },
-    {
-        .width = 12,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000011111111110,
-            0b0000111111111111,
-            0b0000110000000011,
-            0b0000110011110011,
-            0b0000110111111011,
-            0b0000110110011011,
-            0b0000110110011011,
-            0b0000110111111011,
-            0b0000110011110011,
-            0b0000110000111011,
-            0b0000111000111111,
-            0b0000011000011110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000100000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000011111000,
-            0b0000000011011000,
-            0b0000000011011000,
-            0b0000000110001100,
-            0b0000000111111100,
-            0b0000001111111110,
-            0b0000001110001110,
-            0b0000011100000111,
-            0b0000011100000111,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000011111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111110,
-            0b0000011111111110,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000011110000000,
-            0b0000011111100000,
-            0b0000011111111000,
-            0b0000011101111100,
-            0b0000011100011110,
-            0b0000011100001110,
-            0b0000011100001110,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000001100000000,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100111111,
-            0b0000011100111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001100000110,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000001100000110,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000110,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001100000111,
-            0b0000011100001110,
-            0b0000011100011100,
-            0b0000011100111000,
-            0b0000011101110000,
-            0b0000011111111110,
-            0b0000011111111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000001100000110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001000000010,
-            0b0000011100000111,
-            0b0000011110001111,
-            0b0000011110001111,
-            0b0000011011011011,
-            0b0000011011011011,
-            0b0000011011011011,
-            0b0000011001110011,
-            0b0000011001110011,
-            0b0000011001110011,
-            0b0000011000100011,
-            0b0000001000100010,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001100000110,
-            0b0000011110000111,
-            0b0000011111000111,
-            0b0000011111000111,
-            0b0000011101100111,
-            0b0000011101100111,
-            0b0000011100110111,
-            0b0000011100110111,
-            0b0000011100011111,
-            0b0000011100011111,
-            0b0000011100001111,
-            0b0000001100000110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000011111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111110,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000001100000000,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111000,
-            0b0000011111111100,
-            0b0000011111111100,
-            0b0000011100011100,
-            0b0000011100011100,
-            0b0000011100011100,
-            0b0000011100011100,
-            0b0000011100011100,
-            0b0000011100011100,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111110,
-            0b0000011101110000,
-            0b0000011100111000,
-            0b0000011100011100,
-            0b0000011100001110,
-            0b0000001100000111,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000011100000000,
-            0b0000011100000000,
-            0b0000011111111110,
-            0b0000001111111111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001111111110,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001100000110,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000011111111111,
-            0b0000011111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000011100000111,
-            0b0000011100000111,
-            0b0000001110001110,
-            0b0000001110001110,
-            0b0000000111011100,
-            0b0000000111011100,
-            0b0000000011011000,
-            0b0000000011111000,
-            0b0000000011111000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000000100000,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000001000100010,
-            0b0000011000100011,
-            0b0000011001110011,
-            0b0000011001110011,
-            0b0000011001110011,
-            0b0000011011011011,
-            0b0000011011011011,
-            0b0000011011011011,
-            0b0000011110001111,
-            0b0000011110001111,
-            0b0000011100000111,
-            0b0000001000000010,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000011000000011,
-            0b0000011100000111,
-            0b0000001110001110,
-            0b0000000111011100,
-            0b0000000011111000,
-            0b0000000001110000,
-            0b0000000011111000,
-            0b0000000111011100,
-            0b0000001110001110,
-            0b0000011100000111,
-            0b0000011000000011,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000011000000011,
-            0b0000011100000111,
-            0b0000001110001110,
-            0b0000000111011100,
-            0b0000000011111000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-            0b0000000001110000,
-        },
-    },
-    {
-        .width = 10,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000111111111,
-            0b0000001111111111,
-            0b0000001111111111,
-            0b0000000000001110,
-            0b0000000000011100,
-            0b0000000000111000,
-            0b0000000001110000,
-            0b0000000011100000,
-            0b0000000111000000,
-            0b0000001111111111,
-            0b0000001111111111,
-            0b0000001111111110,
-        },
-    },
-    {
-        .width = 5,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000011111,
-            0b0000000000011111,
-            0b0000000000011111,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011111,
-            0b0000000000011111,
-            0b0000000000011111,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000011000000000,
-            0b0000011100000000,
-            0b0000001110000000,
-            0b0000000111000000,
-            0b0000000011100000,
-            0b0000000001110000,
-            0b0000000000111000,
-            0b0000000000011100,
-            0b0000000000001110,
-            0b0000000000000111,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 5,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000011111,
-            0b0000000000011111,
-            0b0000000000011111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000011111,
-            0b0000000000011111,
-            0b0000000000011111,
-        },
-    },
-    {
-        .width = 11,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000100000,
-            0b0000000001110000,
-            0b0000000011111000,
-            0b0000000111111100,
-            0b0000001111011110,
-            0b0000011110001111,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 8,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000011111111,
-            0b0000000011111111,
-            0b0000000011111111,
-        },
-    },
-    {
-        .width = 2,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000010,
-            0b0000000000000011,
-            0b0000000000000001,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000001111,
-            0b0000000000011111,
-            0b0000000000011110,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000111000,
-            0b0000000000111000,
-            0b0000000000011100,
-            0b0000000000011100,
-            0b0000000000011110,
-            0b0000000000011111,
-            0b0000000000001111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 6,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000111100,
-            0b0000000000111110,
-            0b0000000000011110,
-            0b0000000000001110,
-            0b0000000000001110,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000001110,
-            0b0000000000001110,
-            0b0000000000011110,
-            0b0000000000111110,
-            0b0000000000111100,
-        },
-    },
-    {
-        .width = 9,
-        .height = FONT_HEIGHT_RADIOSTARS,
-        .data = {
-            0b0000000000000000,
-            0b0000000000100011,
-            0b0000000001110110,
-            0b0000000011011100,
-            0b0000000110001000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
+    // ' '
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '!'
+    0xFF, 0x0E, 0xFF, 0x0E, 0xFF, 0x0E,
+    // '"'
+    0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00,
+    0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00,
+    // '#'
+    0x80, 0x05, 0x98, 0x07, 0xD8, 0x03, 0xF8, 0x01,
+    0xBC, 0x05, 0x9E, 0x07, 0xDA, 0x03, 0xF8, 0x01,
+    0xBC, 0x01, 0x9E, 0x01, 0x1A, 0x00,
+    // '$'
+    0x38, 0x01, 0x7C, 0x03, 0x7C, 0x03, 0x6F, 0x0F,
+    0x6F, 0x0F, 0x6C, 0x03, 0x6F, 0x0F, 0x6F, 0x0F,
+    0xEC, 0x03, 0xEC, 0x03, 0xC8, 0x01,
+    // '%'
+    0x07, 0x00, 0x05, 0x00, 0x07, 0x00, 0x00, 0x00,
+    0xFF, 0x0F, 0xFF, 0x0F, 0x00, 0x00, 0x00, 0x0E,
+    0x00, 0x0A, 0x00, 0x0E,
+    // '&'
+    0xC6, 0x03, 0xCF, 0x0F, 0x1F, 0x0E, 0x3B, 0x0C,
+    0x73, 0x0C, 0xE3, 0x0E, 0xC3, 0x07, 0x83, 0x03,
+    0xC3, 0x07, 0xE3, 0x0E, 0x62, 0x0C,
+    // '\''
+    0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00,
+    // '('
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x07, 0x0E,
+    0x03, 0x0C,
+    // ')'
+    0x03, 0x0C, 0x07, 0x0E, 0xFF, 0x0F, 0xFF, 0x0F,
+    0xFE, 0x07,
+    // '*'
+    0x60, 0x00, 0x68, 0x01, 0xF8, 0x01, 0xF0, 0x00,
+    0xF8, 0x01, 0x68, 0x01, 0x60, 0x00,
+    // '+'
+    0x60, 0x00, 0x60, 0x00, 0x60, 0x00, 0xFC, 0x03,
+    0xFC, 0x03, 0x60, 0x00, 0x60, 0x00, 0x60, 0x00,
+    // ','
+    0x80, 0x0F, 0x80, 0x0F, 0x80, 0x0F,
+    // '-'
+    0x60, 0x00, 0x60, 0x00, 0x60, 0x00, 0x60, 0x00,
+    0x60, 0x00, 0x60, 0x00, 0x60, 0x00, 0x60, 0x00,
+    // '.'
+    0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E,
+    // '/'
+    0x00, 0x0C, 0x00, 0x0E, 0x00, 0x07, 0x80, 0x03,
+    0xC0, 0x01, 0xE0, 0x00, 0x70, 0x00, 0x38, 0x00,
+    0x1C, 0x00, 0x0E, 0x00, 0x06, 0x00,
+    // '0'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x07, 0x0E,
+    0x07, 0x0E, 0x07, 0x0E, 0x07, 0x0E, 0x07, 0x0E,
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFE, 0x07,
+    // '1'
+    0x18, 0x00, 0x1C, 0x00, 0xFE, 0x0F, 0xFF, 0x0F,
+    0xFF, 0x0F,
+    // '2'
+    0xC6, 0x0F, 0xE7, 0x0F, 0xE7, 0x0F, 0x67, 0x0E,
+    0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0x7F, 0x0E, 0x7F, 0x0E, 0x3E, 0x06,
+    // '3'
+    0x66, 0x06, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0xFF, 0x0F, 0xFF, 0x0F, 0x9E, 0x07,
+    // '4'
+    0x7E, 0x00, 0x7F, 0x00, 0x7F, 0x00, 0x60, 0x00,
+    0x60, 0x00, 0x60, 0x00, 0x60, 0x00, 0x60, 0x00,
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFE, 0x07,
+    // '5'
+    0x7F, 0x06, 0x7F, 0x0E, 0x7F, 0x0E, 0x67, 0x0E,
+    0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0xE7, 0x0F, 0xE7, 0x0F, 0xC6, 0x07,
+    // '6'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x67, 0x0E,
+    0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0xE7, 0x0F, 0xE7, 0x0F, 0xC6, 0x07,
+    // '7'
+    0x06, 0x0C, 0x07, 0x0E, 0x07, 0x07, 0x87, 0x03,
+    0xC7, 0x01, 0xE7, 0x00, 0x77, 0x00, 0x3F, 0x00,
+    0x1F, 0x00, 0x0F, 0x00, 0x06, 0x00,
+    // '8'
+    0x9E, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x67, 0x0E,
+    0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0xFF, 0x0F, 0xFF, 0x0F, 0x9E, 0x07,
+    // '9'
+    0x3E, 0x06, 0x7F, 0x0E, 0x7F, 0x0E, 0x67, 0x0E,
+    0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFE, 0x07,
+    // ':'
+    0x9C, 0x03, 0x9C, 0x03, 0x9C, 0x03,
+    // ';'
+    0x9C, 0x0F, 0x9C, 0x0F, 0x9C, 0x0F,
+    // '<'
+    0x60, 0x00, 0xF0, 0x00, 0xF8, 0x01, 0xFC, 0x03,
+    0x9E, 0x07, 0x0F, 0x0F, 0x07, 0x0E,
+    // '='
+    0x9C, 0x03, 0x9C, 0x03, 0x9C, 0x03, 0x9C, 0x03,
+    0x9C, 0x03, 0x9C, 0x03, 0x9C, 0x03, 0x9C, 0x03,
+    // '>'
+    0x07, 0x0E, 0x0F, 0x0F, 0x9E, 0x07, 0xFC, 0x03,
+    0xF8, 0x01, 0xF0, 0x00, 0x60, 0x00,
+    // '?'
+    0x06, 0x00, 0x07, 0x00, 0x07, 0x00, 0x07, 0x00,
+    0xC7, 0x0E, 0xE7, 0x0E, 0xE7, 0x0E, 0xE7, 0x00,
+    0xFF, 0x00, 0xFF, 0x00, 0x7E, 0x00,
+    // '@'
+    0xFE, 0x07, 0xFF, 0x0F, 0x03, 0x0C, 0xF3, 0x00,
+    0xFB, 0x01, 0x9B, 0x01, 0x9B, 0x07, 0xFB, 0x0F,
+    0xF3, 0x0E, 0x03, 0x0C, 0xFF, 0x0F, 0xFE, 0x07,
+    // 'A'
+    0x00, 0x0C, 0x00, 0x0F, 0xC0, 0x0F, 0xF8, 0x03,
+    0xBE, 0x01, 0x8F, 0x01, 0xBE, 0x01, 0xF8, 0x03,
+    0xC0, 0x0F, 0x00, 0x0F, 0x00, 0x0C,
+    // 'B'
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0x67, 0x0E,
+    0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0xFF, 0x0F, 0xFF, 0x0F, 0x9E, 0x07,
+    // 'C'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x07, 0x0E,
+    0x07, 0x0E, 0x07, 0x0E, 0x07, 0x0E, 0x07, 0x0E,
+    0x07, 0x0E, 0x07, 0x0E, 0x06, 0x06,
+    // 'D'
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0x07, 0x0E,
+    0x0E, 0x0E, 0x0E, 0x0E, 0x1C, 0x0E, 0x7C, 0x0E,
+    0xF8, 0x0F, 0xF0, 0x0F, 0x80, 0x07,
+    // 'E'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x67, 0x0E,
+    0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0x67, 0x0E, 0x67, 0x0E, 0x66, 0x06,
+    // 'F'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x67, 0x00,
+    0x67, 0x00, 0x67, 0x00, 0x67, 0x00, 0x67, 0x00,
+    0x67, 0x00, 0x67, 0x00, 0x66, 0x00,
+    // 'G'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x07, 0x0E,
+    0x07, 0x0E, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0xE7, 0x0F, 0xE7, 0x0F, 0xE6, 0x07,
+    // 'H'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x60, 0x00,
+    0x60, 0x00, 0x60, 0x00, 0x60, 0x00, 0x60, 0x00,
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFE, 0x07,
+    // 'I'
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F,
+    // 'J'
+    0x00, 0x06, 0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E,
+    0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E,
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFE, 0x07,
+    // 'K'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x60, 0x00,
+    0x70, 0x00, 0x78, 0x00, 0x7C, 0x00, 0x6E, 0x00,
+    0xE7, 0x0F, 0xE3, 0x0F, 0xC1, 0x07,
+    // 'L'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x00, 0x0E,
+    0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E,
+    0x00, 0x0E, 0x00, 0x0E, 0x00, 0x06,
+    // 'M'
+    0xFE, 0x07, 0xFF, 0x0F, 0x0E, 0x00, 0x7C, 0x00,
+    0xF0, 0x03, 0x80, 0x0F, 0xF0, 0x03, 0x7C, 0x00,
+    0x0E, 0x00, 0xFF, 0x0F, 0xFE, 0x07,
+    // 'N'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x0E, 0x00,
+    0x3C, 0x00, 0xF0, 0x00, 0xC0, 0x03, 0x00, 0x07,
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFE, 0x07,
+    // 'O'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x07, 0x0E,
+    0x07, 0x0E, 0x07, 0x0E, 0x07, 0x0E, 0x07, 0x0E,
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFE, 0x07,
+    // 'P'
+    0xFF, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x67, 0x00,
+    0x67, 0x00, 0x67, 0x00, 0x67, 0x00, 0x67, 0x00,
+    0x7F, 0x00, 0x7F, 0x00, 0x3E, 0x00,
+    // 'Q'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x07, 0x0E,
+    0x07, 0x0E, 0x07, 0x0E, 0xFF, 0x0F, 0xFF, 0x0F,
+    0xFE, 0x0F, 0x00, 0x0E, 0x00, 0x06,
+    // 'R'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x67, 0x00,
+    0xE7, 0x00, 0xE7, 0x01, 0xE7, 0x03, 0x67, 0x07,
+    0x7F, 0x0E, 0x7F, 0x0C, 0x3E, 0x08,
+    // 'S'
+    0x3E, 0x06, 0x7F, 0x0E, 0x7F, 0x0E, 0x67, 0x0E,
+    0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E, 0x67, 0x0E,
+    0xE7, 0x0F, 0xE7, 0x0F, 0xC6, 0x07,
+    // 'T'
+    0x06, 0x00, 0x07, 0x00, 0x07, 0x00, 0x07, 0x00,
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0x07, 0x00,
+    0x07, 0x00, 0x07, 0x00, 0x06, 0x00,
+    // 'U'
+    0xFE, 0x07, 0xFF, 0x0F, 0xFF, 0x0F, 0x00, 0x0E,
+    0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E,
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFE, 0x07,
+    // 'V'
+    0x03, 0x00, 0x0F, 0x00, 0x3F, 0x00, 0xFC, 0x01,
+    0xF0, 0x07, 0x80, 0x0F, 0xF0, 0x07, 0xFC, 0x01,
+    0x3F, 0x00, 0x0F, 0x00, 0x03, 0x00,
+    // 'W'
+    0xFE, 0x07, 0xFF, 0x0F, 0x00, 0x07, 0xE0, 0x03,
+    0xFC, 0x00, 0x1F, 0x00, 0xFC, 0x00, 0xE0, 0x03,
+    0x00, 0x07, 0xFF, 0x0F, 0xFE, 0x07,
+    // 'X'
+    0x06, 0x0C, 0x0E, 0x0E, 0x1C, 0x07, 0xB8, 0x03,
+    0xF0, 0x01, 0xE0, 0x00, 0xF0, 0x01, 0xB8, 0x03,
+    0x1C, 0x07, 0x0E, 0x0E, 0x06, 0x0C,
+    // 'Y'
+    0x03, 0x00, 0x07, 0x00, 0x0E, 0x00, 0x1C, 0x00,
+    0xF8, 0x0F, 0xF0, 0x0F, 0xF8, 0x0F, 0x1C, 0x00,
+    0x0E, 0x00, 0x07, 0x00, 0x03, 0x00,
+    // 'Z'
+    0x06, 0x0E, 0x07, 0x0F, 0x87, 0x0F, 0xC7, 0x0F,
+    0xE7, 0x0E, 0x77, 0x0E, 0x3F, 0x0E, 0x1F, 0x0E,
+    0x0F, 0x0E, 0x07, 0x06,
+    // '['
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0x07, 0x0E,
+    0x07, 0x0E,
+    // '\\'
+    0x06, 0x00, 0x0E, 0x00, 0x1C, 0x00, 0x38, 0x00,
+    0x70, 0x00, 0xE0, 0x00, 0xC0, 0x01, 0x80, 0x03,
+    0x00, 0x07, 0x00, 0x0E, 0x00, 0x0C,
+    // ']'
+    0x07, 0x0E, 0x07, 0x0E, 0xFF, 0x0F, 0xFF, 0x0F,
+    0xFF, 0x0F,
+    // '^'
+    0x20, 0x00, 0x30, 0x00, 0x38, 0x00, 0x3C, 0x00,
+    0x1E, 0x00, 0x0F, 0x00, 0x1E, 0x00, 0x3C, 0x00,
+    0x38, 0x00, 0x30, 0x00, 0x20, 0x00,
+    // '_'
+    0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E,
+    0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E, 0x00, 0x0E,
+    // '`'
+    0x06, 0x00, 0x0C, 0x00,
+    // '{'
+    0x60, 0x00, 0xFE, 0x07, 0xFF, 0x0F, 0x9F, 0x0F,
+    0x07, 0x0E, 0x03, 0x0C,
+    // '|'
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F,
+    // '}'
+    0x03, 0x0C, 0x07, 0x0E, 0x9F, 0x0F, 0xFF, 0x0F,
+    0xFE, 0x07, 0x60, 0x00,
+    // '~'
+    0x10, 0x00, 0x18, 0x00, 0x0C, 0x00, 0x06, 0x00,
+    0x0C, 0x00, 0x18, 0x00, 0x0C, 0x00, 0x06, 0x00,
+    0x02, 0x00,
 };
 
-#endif
\ No newline at end of file
+// Where each character's columns start, how wide it is, and how far it moves
+// the cursor, from ' ' to '~'
+static const uint32_t font_Radiostars_glyphs[] RODATA_ATTR =
+{
+    FONT_GLYPH(0, 8, 9), // ' '
+    FONT_GLYPH(16, 3, 4), // '!'
+    FONT_GLYPH(22, 7, 8), // '"'
+    FONT_GLYPH(36, 11, 12), // '#'
+    FONT_GLYPH(58, 11, 12), // '$'
+    FONT_GLYPH(80, 10, 11), // '%'
+    FONT_GLYPH(100, 11, 12), // '&'
+    FONT_GLYPH(122, 3, 4), // '\''
+    FONT_GLYPH(128, 5, 6), // '('
+    FONT_GLYPH(138, 5, 6), // ')'
+    FONT_GLYPH(148, 7, 8), // '*'
+    FONT_GLYPH(162, 8, 9), // '+'
+    FONT_GLYPH(178, 3, 4), // ','
+    FONT_GLYPH(184, 8, 9), // '-'
+    FONT_GLYPH(200, 3, 4), // '.'
+    FONT_GLYPH(206, 11, 12), // '/'
+    FONT_GLYPH(228, 11, 12), // '0'
+    FONT_GLYPH(250, 5, 6), // '1'
+    FONT_GLYPH(260, 11, 12), // '2'
+    FONT_GLYPH(282, 11, 12), // '3'
+    FONT_GLYPH(304, 11, 12), // '4'
+    FONT_GLYPH(326, 11, 12), // '5'
+    FONT_GLYPH(348, 11, 12), // '6'
+    FONT_GLYPH(370, 11, 12), // '7'
+    FONT_GLYPH(392, 11, 12), // '8'
+    FONT_GLYPH(414, 11, 12), // '9'
+    FONT_GLYPH(436, 3, 4), // ':'
+    FONT_GLYPH(442, 3, 4), // ';'
+    FONT_GLYPH(448, 7, 8), // '<'
+    FONT_GLYPH(462, 8, 9), // '='
+    FONT_GLYPH(478, 7, 8), // '>'
+    FONT_GLYPH(492, 11, 12), // '?'
+    FONT_GLYPH(514, 12, 13), // '@'
+    FONT_GLYPH(538, 11, 12), // 'A'
+    FONT_GLYPH(560, 11, 12), // 'B'
+    FONT_GLYPH(582, 11, 12), // 'C'
+    FONT_GLYPH(604, 11, 12), // 'D'
+    FONT_GLYPH(626, 11, 12), // 'E'
+    FONT_GLYPH(648, 11, 12), // 'F'
+    FONT_GLYPH(670, 11, 12), // 'G'
+    FONT_GLYPH(692, 11, 12), // 'H'
+    FONT_GLYPH(714, 3, 4), // 'I'
+    FONT_GLYPH(720, 11, 12), // 'J'
+    FONT_GLYPH(742, 11, 12), // 'K'
+    FONT_GLYPH(764, 11, 12), // 'L'
+    FONT_GLYPH(786, 11, 12), // 'M'
+    FONT_GLYPH(808, 11, 12), // 'N'
+    FONT_GLYPH(830, 11, 12), // 'O'
+    FONT_GLYPH(852, 11, 12), // 'P'
+    FONT_GLYPH(874, 11, 12), // 'Q'
+    FONT_GLYPH(896, 11, 12), // 'R'
+    FONT_GLYPH(918, 11, 12), // 'S'
+    FONT_GLYPH(940, 11, 12), // 'T'
+    FONT_GLYPH(962, 11, 12), // 'U'
+    FONT_GLYPH(984, 11, 12), // 'V'
+    FONT_GLYPH(1006, 11, 12), // 'W'
+    FONT_GLYPH(1028, 11, 12), // 'X'
+    FONT_GLYPH(1050, 11, 12), // 'Y'
+    FONT_GLYPH(1072, 10, 11), // 'Z'
+    FONT_GLYPH(1092, 5, 6), // '['
+    FONT_GLYPH(1102, 11, 12), // '\\'
+    FONT_GLYPH(1124, 5, 6), // ']'
+    FONT_GLYPH(1134, 11, 12), // '^'
+    FONT_GLYPH(1156, 8, 9), // '_'
+    FONT_GLYPH(1172, 2, 3), // '`'
+    FONT_GLYPH(538, 11, 12), // 'a'
+    FONT_GLYPH(560, 11, 12), // 'b'
+    FONT_GLYPH(582, 11, 12), // 'c'
+    FONT_GLYPH(604, 11, 12), // 'd'
+    FONT_GLYPH(626, 11, 12), // 'e'
+    FONT_GLYPH(648, 11, 12), // 'f'
+    FONT_GLYPH(670, 11, 12), // 'g'
+    FONT_GLYPH(692, 11, 12), // 'h'
+    FONT_GLYPH(714, 3, 4), // 'i'
+    FONT_GLYPH(720, 11, 12), // 'j'
+    FONT_GLYPH(742, 11, 12), // 'k'
+    FONT_GLYPH(764, 11, 12), // 'l'
+    FONT_GLYPH(786, 11, 12), // 'm'
+    FONT_GLYPH(808, 11, 12), // 'n'
+    FONT_GLYPH(830, 11, 12), // 'o'
+    FONT_GLYPH(852, 11, 12), // 'p'
+    FONT_GLYPH(874, 11, 12), // 'q'
+    FONT_GLYPH(896, 11, 12), // 'r'
+    FONT_GLYPH(918, 11, 12), // 's'
+    FONT_GLYPH(940, 11, 12), // 't'
+    FONT_GLYPH(962, 11, 12), // 'u'
+    FONT_GLYPH(984, 11, 12), // 'v'
+    FONT_GLYPH(1006, 11, 12), // 'w'
+    FONT_GLYPH(1028, 11, 12), // 'x'
+    FONT_GLYPH(1050, 11, 12), // 'y'
+    FONT_GLYPH(1072, 10, 11), // 'z'
+    FONT_GLYPH(1176, 6, 7), // '{'
+    FONT_GLYPH(1188, 3, 4), // '|'
+    FONT_GLYPH(1194, 6, 7), // '}'
+    FONT_GLYPH(1206, 9, 10), // '~'
+};
+
+const font_t font_Radiostars =
+{
+    .height = FONT_HEIGHT_RADIOSTARS,
+    .pages = 2,
+    .glyphs = font_Radiostars_glyphs,
+    .cols = font_Radiostars_cols,
+};
+
+#endif
@@ -2,767 +2,261 @@
 
 #if defined(FEATURE_OLED)
 
-const sprite_t font_TomThumb[] RODATA_ATTR =
+// Each glyph's columns, left to right. Columns are packed like the framebuffer,
+// 1 byte of eight rows each, with the top row in bit 0
+// It's read a word at a time, so it's aligned and padded to a whole word on
+// every build, not just where RODATA_ATTR aligns it
+static const uint8_t font_TomThumb_cols[] __attribute__((aligned(4))) RODATA_ATTR =
 {
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 1,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000000,
-            0b0000000000000001,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000101,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000000010,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000100,
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000100,
-            0b0000000000000001,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000110,
-            0b0000000000000110,
-            0b0000000000000111,
-            0b0000000000000101,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 1,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 2,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000010,
-            0b0000000000000010,
-            0b0000000000000001,
-        },
-    },
-    {
-        .width = 2,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000010,
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000010,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000010,
-            0b0000000000000101,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000010,
-            0b0000000000000111,
-            0b0000000000000010,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 2,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000001,
-            0b0000000000000010,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000111,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 1,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000001,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000100,
-            0b0000000000000100,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 2,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000001,
-            0b0000000000000011,
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000001,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000110,
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000100,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000110,
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000001,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000001,
-            0b0000000000000001,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000100,
-            0b0000000000000110,
-            0b0000000000000001,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000100,
-            0b0000000000000111,
-            0b0000000000000101,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000100,
-            0b0000000000000100,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000101,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000001,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 1,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000001,
-            0b0000000000000000,
-            0b0000000000000001,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 2,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000001,
-            0b0000000000000000,
-            0b0000000000000001,
-            0b0000000000000010,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000100,
-            0b0000000000000010,
-            0b0000000000000001,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000111,
-            0b0000000000000000,
-            0b0000000000000111,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000100,
-            0b0000000000000010,
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000100,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000000,
-            0b0000000000000010,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000010,
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000100,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000010,
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000101,
-            0b0000000000000101,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000110,
-            0b0000000000000101,
-            0b0000000000000110,
-            0b0000000000000101,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000100,
-            0b0000000000000100,
-            0b0000000000000100,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000110,
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000100,
-            0b0000000000000111,
-            0b0000000000000100,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000100,
-            0b0000000000000111,
-            0b0000000000000100,
-            0b0000000000000100,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000100,
-            0b0000000000000111,
-            0b0000000000000101,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000101,
-            0b0000000000000101,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000010,
-            0b0000000000000010,
-            0b0000000000000010,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000101,
-            0b0000000000000010,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000110,
-            0b0000000000000101,
-            0b0000000000000101,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000100,
-            0b0000000000000100,
-            0b0000000000000100,
-            0b0000000000000100,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000101,
-            0b0000000000000101,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000101,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000010,
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000010,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000110,
-            0b0000000000000101,
-            0b0000000000000110,
-            0b0000000000000100,
-            0b0000000000000100,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000010,
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000110,
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000110,
-            0b0000000000000101,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000100,
-            0b0000000000000010,
-            0b0000000000000001,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000010,
-            0b0000000000000010,
-            0b0000000000000010,
-            0b0000000000000010,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000010,
-            0b0000000000000010,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000111,
-            0b0000000000000111,
-            0b0000000000000101,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000010,
-            0b0000000000000101,
-            0b0000000000000101,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000101,
-            0b0000000000000101,
-            0b0000000000000010,
-            0b0000000000000010,
-            0b0000000000000010,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000100,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000100,
-            0b0000000000000100,
-            0b0000000000000100,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000100,
-            0b0000000000000010,
-            0b0000000000000001,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000111,
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000010,
-            0b0000000000000101,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000111,
-        },
-    },
-    {
-        .width = 2,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000010,
-            0b0000000000000001,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000010,
-            0b0000000000000100,
-            0b0000000000000010,
-            0b0000000000000011,
-        },
-    },
-    {
-        .width = 1,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000001,
-            0b0000000000000001,
-            0b0000000000000000,
-            0b0000000000000001,
-            0b0000000000000001,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000110,
-            0b0000000000000010,
-            0b0000000000000001,
-            0b0000000000000010,
-            0b0000000000000110,
-        },
-    },
-    {
-        .width = 3,
-        .height = FONT_HEIGHT_TOMTHUMB,
-        .data = {
-            0b0000000000000011,
-            0b0000000000000110,
-            0b0000000000000000,
-            0b0000000000000000,
-            0b0000000000000000,
-        },
-    },
+    // ' '
+    0x00, 0x00, 0x00,
+    // '!'
+    0x17,
+    // '"'
+    0x03, 0x00, 0x03,
+    // '#'
+    0x1F, 0x0A, 0x1F,
+    // '$'
+    0x0A, 0x1F, 0x05,
+    // '%'
+    0x09, 0x04, 0x12,
+    // '&'
+    0x0F, 0x17, 0x1C,
+    // '\''
+    0x03,
+    // '('
+    0x0E, 0x11,
+    // ')'
+    0x11, 0x0E,
+    // '*'
+    0x05, 0x02, 0x05,
+    // '+'
+    0x04, 0x0E, 0x04,
+    // ','
+    0x10, 0x08,
+    // '-'
+    0x04, 0x04, 0x04,
+    // '.'
+    0x10,
+    // '/'
+    0x18, 0x04, 0x03,
+    // '0'
+    0x1E, 0x11, 0x0F,
+    // '1'
+    0x02, 0x1F,
+    // '2'
+    0x19, 0x15, 0x12,
+    // '3'
+    0x11, 0x15, 0x0A,
+    // '4'
+    0x07, 0x04, 0x1F,
+    // '5'
+    0x17, 0x15, 0x09,
+    // '6'
+    0x1E, 0x15, 0x1D,
+    // '7'
+    0x19, 0x05, 0x03,
+    // '8'
+    0x1F, 0x15, 0x1F,
+    // '9'
+    0x17, 0x15, 0x0F,
+    // ':'
+    0x0A,
+    // ';'
+    0x10, 0x0A,
+    // '<'
+    0x04, 0x0A, 0x11,
+    // '='
+    0x0A, 0x0A, 0x0A,
+    // '>'
+    0x11, 0x0A, 0x04,
+    // '?'
+    0x01, 0x15, 0x03,
+    // '@'
+    0x0E, 0x15, 0x16,
+    // 'A'
+    0x1E, 0x05, 0x1E,
+    // 'B'
+    0x1F, 0x15, 0x0A,
+    // 'C'
+    0x0E, 0x11, 0x11,
+    // 'D'
+    0x1F, 0x11, 0x0E,
+    // 'E'
+    0x1F, 0x15, 0x15,
+    // 'F'
+    0x1F, 0x05, 0x05,
+    // 'G'
+    0x0E, 0x15, 0x1D,
+    // 'H'
+    0x1F, 0x04, 0x1F,
+    // 'I'
+    0x11, 0x1F, 0x11,
+    // 'J'
+    0x08, 0x10, 0x0F,
+    // 'K'
+    0x1F, 0x04, 0x1B,
+    // 'L'
+    0x1F, 0x10, 0x10,
+    // 'M'
+    0x1F, 0x06, 0x1F,
+    // 'N'
+    0x1F, 0x0E, 0x1F,
+    // 'O'
+    0x0E, 0x11, 0x0E,
+    // 'P'
+    0x1F, 0x05, 0x02,
+    // 'Q'
+    0x0E, 0x19, 0x1E,
+    // 'R'
+    0x1F, 0x0D, 0x16,
+    // 'S'
+    0x12, 0x15, 0x09,
+    // 'T'
+    0x01, 0x1F, 0x01,
+    // 'U'
+    0x0F, 0x10, 0x1F,
+    // 'V'
+    0x07, 0x18, 0x07,
+    // 'W'
+    0x1F, 0x0C, 0x1F,
+    // 'X'
+    0x1B, 0x04, 0x1B,
+    // 'Y'
+    0x03, 0x1C, 0x03,
+    // 'Z'
+    0x19, 0x15, 0x13,
+    // '['
+    0x1F, 0x11, 0x11,
+    // '\\'
+    0x02, 0x04, 0x08,
+    // ']'
+    0x11, 0x11, 0x1F,
+    // '^'
+    0x02, 0x01, 0x02,
+    // '_'
+    0x10, 0x10, 0x10,
+    // '`'
+    0x01, 0x02,
+    // '{'
+    0x04, 0x1B, 0x11,
+    // '|'
+    0x1B,
+    // '}'
+    0x11, 0x1B, 0x04,
+    // '~'
+    0x02, 0x03, 0x01,
+    // Padding to a whole word
+    0x00,
 };
 
-#endif
\ No newline at end of file
+// Where each character's columns start, how wide it is, and how far it moves
+// the cursor, from ' ' to '~'
+static const uint32_t font_TomThumb_glyphs[] RODATA_ATTR =
+{
+    FONT_GLYPH(0, 3, 4), // ' '
+    FONT_GLYPH(3, 1, 2), // '!'
+    FONT_GLYPH(4, 3, 4), // '"'
+    FONT_GLYPH(7, 3, 4), // '#'
+    FONT_GLYPH(10, 3, 4), // '$'
+    FONT_GLYPH(13, 3, 4), // '%'
+    FONT_GLYPH(16, 3, 4), // '&'
+    FONT_GLYPH(19, 1, 2), // '\''
+    FONT_GLYPH(20, 2, 3), // '('
+    FONT_GLYPH(22, 2, 3), // ')'
+    FONT_GLYPH(24, 3, 4), // '*'
+    FONT_GLYPH(27, 3, 4), // '+'
+    FONT_GLYPH(30, 2, 3), // ','
+    FONT_GLYPH(32, 3, 4), // '-'
+    FONT_GLYPH(35, 1, 2), // '.'
+    FONT_GLYPH(36, 3, 4), // '/'
+    FONT_GLYPH(39, 3, 4), // '0'
+    FONT_GLYPH(42, 2, 3), // '1'
+    FONT_GLYPH(44, 3, 4), // '2'
+    FONT_GLYPH(47, 3, 4), // '3'
+    FONT_GLYPH(50, 3, 4), // '4'
+    FONT_GLYPH(53, 3, 4), // '5'
+    FONT_GLYPH(56, 3, 4), // '6'
+    FONT_GLYPH(59, 3, 4), // '7'
+    FONT_GLYPH(62, 3, 4), // '8'
+    FONT_GLYPH(65, 3, 4), // '9'
+    FONT_GLYPH(68, 1, 2), // ':'
+    FONT_GLYPH(69, 2, 3), // ';'
+    FONT_GLYPH(71, 3, 4), // '<'
+    FONT_GLYPH(74, 3, 4), // '='
+    FONT_GLYPH(77, 3, 4), // '>'
+    FONT_GLYPH(80, 3, 4), // '?'
+    FONT_GLYPH(83, 3, 4), // '@'
+    FONT_GLYPH(86, 3, 4), // 'A'
+    FONT_GLYPH(89, 3, 4), // 'B'
+    FONT_GLYPH(92, 3, 4), // 'C'
+    FONT_GLYPH(95, 3, 4), // 'D'
+    FONT_GLYPH(98, 3, 4), // 'E'
+    FONT_GLYPH(101, 3, 4), // 'F'
+    FONT_GLYPH(104, 3, 4), // 'G'
+    FONT_GLYPH(107, 3, 4), // 'H'
+    FONT_GLYPH(110, 3, 4), // 'I'
+    FONT_GLYPH(113, 3, 4), // 'J'
+    FONT_GLYPH(116, 3, 4), // 'K'
+    FONT_GLYPH(119, 3, 4), // 'L'
+    FONT_GLYPH(122, 3, 4), // 'M'
+    FONT_GLYPH(125, 3, 4), // 'N'
+    FONT_GLYPH(128, 3, 4), // 'O'
+    FONT_GLYPH(131, 3, 4), // 'P'
+    FONT_GLYPH(134, 3, 4), // 'Q'
+    FONT_GLYPH(137, 3, 4), // 'R'
+    FONT_GLYPH(140, 3, 4), // 'S'
+    FONT_GLYPH(143, 3, 4), // 'T'
+    FONT_GLYPH(146, 3, 4), // 'U'
+    FONT_GLYPH(149, 3, 4), // 'V'
+    FONT_GLYPH(152, 3, 4), // 'W'
+    FONT_GLYPH(155, 3, 4), // 'X'
+    FONT_GLYPH(158, 3, 4), // 'Y'
+    FONT_GLYPH(161, 3, 4), // 'Z'
+    FONT_GLYPH(164, 3, 4), // '['
+    FONT_GLYPH(167, 3, 4), // '\\'
+    FONT_GLYPH(170, 3, 4), // ']'
+    FONT_GLYPH(173, 3, 4), // '^'
+    FONT_GLYPH(176, 3, 4), // '_'
+    FONT_GLYPH(179, 2, 3), // '`'
+    FONT_GLYPH(86, 3, 4), // 'a'
+    FONT_GLYPH(89, 3, 4), // 'b'
+    FONT_GLYPH(92, 3, 4), // 'c'
+    FONT_GLYPH(95, 3, 4), // 'd'
+    FONT_GLYPH(98, 3, 4), // 'e'
+    FONT_GLYPH(101, 3, 4), // 'f'
+    FONT_GLYPH(104, 3, 4), // 'g'
+    FONT_GLYPH(107, 3, 4), // 'h'
+    FONT_GLYPH(110, 3, 4), // 'i'
+    FONT_GLYPH(113, 3, 4), // 'j'
+    FONT_GLYPH(116, 3, 4), // 'k'
+    FONT_GLYPH(119, 3, 4), // 'l'
+    FONT_GLYPH(122, 3, 4), // 'm'
+    FONT_GLYPH(125, 3, 4), // 'n'
+    FONT_GLYPH(128, 3, 4), // 'o'
+    FONT_GLYPH(131, 3, 4), // 'p'
+    FONT_GLYPH(134, 3, 4), // 'q'
+    FONT_GLYPH(137, 3, 4), // 'r'
+    FONT_GLYPH(140, 3, 4), // 's'
+    FONT_GLYPH(143, 3, 4), // 't'
+    FONT_GLYPH(146, 3, 4), // 'u'
+    FONT_GLYPH(149, 3, 4), // 'v'
+    FONT_GLYPH(152, 3, 4), // 'w'
+    FONT_GLYPH(155, 3, 4), // 'x'
+    FONT_GLYPH(158, 3, 4), // 'y'
+    FONT_GLYPH(161, 3, 4), // 'z'
+    FONT_GLYPH(181, 3, 4), // '{'
+    FONT_GLYPH(184, 1, 2), // '|'
+    FONT_GLYPH(185, 3, 4), // '}'
+    FONT_GLYPH(188, 3, 4), // '~'
+};
+
+const font_t font_TomThumb =
+{
+    .height = FONT_HEIGHT_TOMTHUMB,
+    .pages = 1,
+    .glyphs = font_TomThumb_glyphs,
+    .cols = font_TomThumb_cols,
+};
+
+#endif
@@ -15,6 +15,7 @@
 #include "cnlohr_i2c.h"
 #include "gpio_user.h"
 #include "user_main.h"
+#include "trace.h"
 
 #if defined(FEATURE_OLED)
 
@@ -610,6 +611,8 @@ int ICACHE_FLASH_ATTR updateOLEDScreenRange( uint8_t minX, uint8_t maxX, uint8_t
  */
 oledResult_t ICACHE_FLASH_ATTR updateOLED(bool drawDifference)
 {
+    TRACE_SCOPE("updateOLED");
+
     //Before sending the actual data, we do housekeeping. This can take between 57 and 200 uS
     //But ensures the visual data stays consistent.
     {
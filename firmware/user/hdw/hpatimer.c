@@ -240,25 +240,26 @@ void ICACHE_FLASH_ATTR initMic(void)
 }
 
 /**
- * @return true if a sample has been read from the ADC and is queued for
- * processing
- */
-bool ICACHE_FLASH_ATTR sampleAvailable(void)
-{
-    return mic.soundhead != mic.soundtail;
-}
-
-/**
- * Get a sample from the ADC in the queue, return it, and increment the queue so
- * the next sample is returned the next time this is called
+ * Copy samples which have been read from the ADC out of the queue, oldest
+ * first, and remove them from the queue
  *
- * @return the sample which was read from the ADC
+ * @param samples    Where to copy the samples
+ * @param maxSamples The most samples to copy
+ * @return the number of samples copied, 0 if none are queued
  */
-uint8_t ICACHE_FLASH_ATTR getSample(void)
+uint16_t ICACHE_FLASH_ATTR getSamples(uint8_t* samples, uint16_t maxSamples)
 {
-    uint8_t samp = mic.sounddata[mic.soundtail];
-    mic.soundtail = (mic.soundtail + 1) % (HPABUFFSIZE);
-    return samp;
+    // The ADC interrupt only moves the head, so read it once
+    uint16_t head = mic.soundhead;
+    uint16_t tail = mic.soundtail;
+    uint16_t numSamples = 0;
+    while(tail != head && numSamples < maxSamples)
+    {
+        samples[numSamples++] = mic.sounddata[tail];
+        tail = (tail + 1) & (HPABUFFSIZE - 1);
+    }
+    mic.soundtail = tail;
+    return numSamples;
 }
 
 #endif
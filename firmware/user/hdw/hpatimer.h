@@ -24,8 +24,7 @@ bool ICACHE_FLASH_ATTR isHpaRunning(void);
 
 #if defined(FEATURE_MIC)
     void ICACHE_FLASH_ATTR initMic(void);
-    uint8_t ICACHE_FLASH_ATTR getSample(void);
-    bool ICACHE_FLASH_ATTR sampleAvailable(void);
+    uint16_t ICACHE_FLASH_ATTR getSamples(uint8_t* samples, uint16_t maxSamples);
 #endif
 
 #endif
@@ -1,6 +1,7 @@
 //Copyright 2015 <>< Charles Lohr under the ColorChord License.
 
 #include "DFT32.h"
+#include "fixed_math.h"
 #include <string.h>
 
 #ifndef CCEMBEDDED
@@ -21,73 +22,11 @@ uint16_t embeddedbins32[FIXBINS];
 
 static uint8_t Sdonefirstrun;
 
-//A table of precomputed sin() values.  Ranging -1500 to +1500
+//A table of sin() values, ranging -1500 to +1500, filled in from the shared
+//fixed point sine by SetupDFTProgressive32().
 //If we increase this, it may cause overflows elsewhere in code.
-const int16_t Ssinonlytable[256] =
-{
-    0,    36,    73,   110,   147,   183,   220,   256,
-    292,   328,   364,   400,   435,   470,   505,   539,
-    574,   607,   641,   674,   707,   739,   771,   802,
-    833,   863,   893,   922,   951,   979,  1007,  1034,
-    1060,  1086,  1111,  1135,  1159,  1182,  1204,  1226,
-    1247,  1267,  1286,  1305,  1322,  1339,  1355,  1371,
-    1385,  1399,  1412,  1424,  1435,  1445,  1455,  1463,
-    1471,  1477,  1483,  1488,  1492,  1495,  1498,  1499,
-    1500,  1499,  1498,  1495,  1492,  1488,  1483,  1477,
-    1471,  1463,  1455,  1445,  1435,  1424,  1412,  1399,
-    1385,  1371,  1356,  1339,  1322,  1305,  1286,  1267,
-    1247,  1226,  1204,  1182,  1159,  1135,  1111,  1086,
-    1060,  1034,  1007,   979,   951,   922,   893,   863,
-    833,   802,   771,   739,   707,   674,   641,   607,
-    574,   539,   505,   470,   435,   400,   364,   328,
-    292,   256,   220,   183,   147,   110,    73,    36,
-    0,   -36,   -73,  -110,  -146,  -183,  -219,  -256,
-    -292,  -328,  -364,  -399,  -435,  -470,  -505,  -539,
-    -573,  -607,  -641,  -674,  -706,  -739,  -771,  -802,
-    -833,  -863,  -893,  -922,  -951,  -979, -1007, -1034,
-    -1060, -1086, -1111, -1135, -1159, -1182, -1204, -1226,
-    -1247, -1267, -1286, -1305, -1322, -1339, -1355, -1371,
-    -1385, -1399, -1412, -1424, -1435, -1445, -1454, -1463,
-    -1471, -1477, -1483, -1488, -1492, -1495, -1498, -1499,
-    -1500, -1499, -1498, -1495, -1492, -1488, -1483, -1477,
-    -1471, -1463, -1455, -1445, -1435, -1424, -1412, -1399,
-    -1385, -1371, -1356, -1339, -1322, -1305, -1286, -1267,
-    -1247, -1226, -1204, -1182, -1159, -1135, -1111, -1086,
-    -1060, -1034, -1007,  -979,  -951,  -923,  -893,  -863,
-    -833,  -802,  -771,  -739,  -707,  -674,  -641,  -608,
-    -574,  -540,  -505,  -470,  -435,  -400,  -364,  -328,
-    -292,  -256,  -220,  -183,  -147,  -110,   -73,   -37,
-};
-
-
-/** The above table was created using the following code:
-#include <math.h>
-#include <stdio.h>
-#include <stdint.h>
-
-int16_t Ssintable[256]; //Actually, just [sin].
-
-int main()
-{
-    int i;
-    for( i = 0; i < 256; i++ )
-    {
-        Ssintable[i] = (int16_t)((sinf( i / 256.0 * 6.283 ) * 1500.0));
-    }
-
-    printf( "const int16_t Ssinonlytable[256] = {" );
-    for( i = 0; i < 256; i++ )
-    {
-        if( !(i & 0x7 ) )
-        {
-            printf( "\n\t" );
-        }
-        printf( "%6d," ,Ssintable[i] );
-    }
-    printf( "};\n" );
-} */
-
-
+#define SSIN_AMPLITUDE 1500
+static int16_t Ssinonlytable[256];
 
 uint16_t Sdatspace32A[FIXBINS * 2]; //(advances,places) full revolution is 256. 8bits integer part 8bit fractional
 int32_t Sdatspace32B[FIXBINS * 2]; //(isses,icses)
@@ -108,62 +47,6 @@ static uint8_t Swhichoctaveplace;
 //
 uint16_t embeddedbins[FIXBINS];
 
-//From: http://stackoverflow.com/questions/1100090/looking-for-an-efficient-integer-square-root-algorithm-for-arm-thumb2
-//  for sqrt approx but also suggestion for quick norm approximation that would work in this DFT
-
-#if APPROXNORM != 1
-/**
- * \brief    Fast Square root algorithm, with rounding
- *
- * This does arithmetic rounding of the result. That is, if the real answer
- * would have a fractional part of 0.5 or greater, the result is rounded up to
- * the next integer.
- *      - SquareRootRounded(2) --> 1
- *      - SquareRootRounded(3) --> 2
- *      - SquareRootRounded(4) --> 2
- *      - SquareRootRounded(6) --> 2
- *      - SquareRootRounded(7) --> 3
- *      - SquareRootRounded(8) --> 3
- *      - SquareRootRounded(9) --> 3
- *
- * \param[in] a_nInput - unsigned integer for which to find the square root
- *
- * \return Integer square root of the input value.
- */
-static uint16_t SquareRootRounded(uint32_t a_nInput)
-{
-    uint32_t op  = a_nInput;
-    uint32_t res = 0;
-    uint32_t one = 1uL << 30; // The second-to-top bit is set: use 1u << 14 for uint16_t type; use 1uL<<30 for uint32_t type
-
-
-    // "one" starts at the highest power of four <= than the argument.
-    while (one > op)
-    {
-        one >>= 2;
-    }
-
-    while (one != 0)
-    {
-        if (op >= res + one)
-        {
-            op = op - (res + one);
-            res = res +  2 * one;
-        }
-        res >>= 1;
-        one >>= 2;
-    }
-
-    /* Do arithmetic rounding to nearest integer */
-    if (op > res)
-    {
-        res++;
-    }
-
-    return res;
-}
-#endif
-
 void ICACHE_FLASH_ATTR UpdateOutputBins32(void)
 {
     int i;
@@ -196,7 +79,7 @@ void ICACHE_FLASH_ATTR UpdateOutputBins32(void)
         // use the most significant 16 bits of isps and ispc when squaring
         // since isps and ispc are non-negative right bit shifing is well defined
         uint32_t rmux = ( (isps >> 16) * (isps >> 16)) + ((ispc > 16) * (ispc >> 16));
-        rmux = SquareRootRounded( rmux );
+        rmux = fxSqrtRounded( rmux );
 #endif
 
         //bump up all outputs here, so when we nerf it by bit shifting by
@@ -273,6 +156,13 @@ int ICACHE_FLASH_ATTR SetupDFTProgressive32(void)
     int j;
 
     Sdonefirstrun = 1;
+
+    //A full turn is 256 entries, so each is 256 binary angle units apart
+    for( i = 0; i < 256; i++ )
+    {
+        Ssinonlytable[i] = ( fxSin( i << 8 ) * SSIN_AMPLITUDE + ( FX_ONE / 2 ) ) >> 14;
+    }
+
     Sdo_this_octave[0] = 0xff;
     for( i = 0; i < BINCYCLE - 1; i++ )
     {
@@ -324,6 +214,45 @@ void ICACHE_FLASH_ATTR PushSample32( int16_t dat )
     HandleInt( dat );
 }
 
+void ICACHE_FLASH_ATTR PushSamples32( const int16_t* dat, int n )
+{
+    const int16_t* end = dat + n;
+    while( dat != end )
+    {
+        HandleInt( *dat );
+        HandleInt( *dat );
+        dat++;
+    }
+}
+
+void ICACHE_FLASH_ATTR PushSamplesFramed32( const int16_t* dat, int n, int frameLen, int* framePos,
+        void (*onFrame)(void) )
+{
+    while( n > 0 )
+    {
+        //Push samples up to the end of this frame, at least one
+        int toPush = frameLen - *framePos;
+        if( toPush < 1 )
+        {
+            toPush = 1;
+        }
+        if( toPush > n )
+        {
+            toPush = n;
+        }
+        PushSamples32( dat, toPush );
+        dat += toPush;
+        n -= toPush;
+        *framePos += toPush;
+
+        if( *framePos >= frameLen )
+        {
+            *framePos = 0;
+            onFrame();
+        }
+    }
+}
+
 
 #ifndef CCEMBEDDED
 
@@ -66,6 +66,15 @@ void UpdateBins32( const uint16_t* frequencies );
 //Any more and you will exceed the accumulators and it will cause an overflow.
 void PushSample32( int16_t dat );
 
+//The same as calling PushSample32() on each of n samples, without a call per sample.
+void PushSamples32( const int16_t* dat, int n );
+
+//Push n samples in frames of frameLen samples. *framePos counts the samples
+//pushed toward the current frame. Each time it reaches frameLen, it's reset
+//and onFrame() is called, i.e. to call HandleFrameInfo(). Start *framePos at 0
+//and keep it between calls.
+void PushSamplesFramed32( const int16_t* dat, int n, int frameLen, int* framePos, void (*onFrame)(void) );
+
 #ifndef CCEMBEDDED
     //ColorChord regular uses this to pass in floats.
     void UpdateBinsForDFT32( const float* frequencies );  //Update the frequencies
@@ -3,6 +3,7 @@
 #include "embeddednf.h"
 #include "osapi.h"
 #include "DFT32.h"
+#include "trace.h"
 
 uint16_t folded_bins[FIXBPERO];
 uint16_t fuzzed_bins[FIXBINS];
@@ -116,6 +117,8 @@ void ICACHE_FLASH_ATTR InitColorChord(void)
 
 void ICACHE_FLASH_ATTR HandleFrameInfo(void)
 {
+    TRACE_SCOPE("HandleFrameInfo");
+
     int i, j, k;
     uint8_t hitnotes[MAXNOTES];
     ets_memset( hitnotes, 0, sizeof( hitnotes ) );
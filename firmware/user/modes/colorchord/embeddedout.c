@@ -196,6 +196,7 @@ void ICACHE_FLASH_ATTR UpdateLinearLEDs(void)
     ledSpin = 0;
 #endif
 
+    hsv_t hsv[NUM_LIN_LEDS];
     j = ledSpin;
     for( l = 0; l < NUM_LIN_LEDS; l++, j++ )
     {
@@ -210,10 +211,19 @@ void ICACHE_FLASH_ATTR UpdateLinearLEDs(void)
         {
             amp = 255;
         }
-        uint32_t color = ECCtoHEX( (ledFreqOut[j] + RootNoteOffset) % NOTERANGE, 255, amp );
-        ledOut[l * 3 + 0] = ( color >> 0 ) & 0xff;
-        ledOut[l * 3 + 1] = ( color >> 8 ) & 0xff;
-        ledOut[l * 3 + 2] = ( color >> 16 ) & 0xff;
+        hsv[l].h = ECCtoHue( (ledFreqOut[j] + RootNoteOffset) % NOTERANGE );
+        hsv[l].s = 255;
+        hsv[l].v = amp;
+    }
+
+    //Convert every LED at once. ledOut keeps ECCtoHEX()'s byte order, R first
+    led_t colors[NUM_LIN_LEDS];
+    hsvToLeds( hsv, colors, NUM_LIN_LEDS );
+    for( l = 0; l < NUM_LIN_LEDS; l++ )
+    {
+        ledOut[l * 3 + 0] = colors[l].r;
+        ledOut[l * 3 + 1] = colors[l].g;
+        ledOut[l * 3 + 2] = colors[l].b;
     }
     /*    j = ledSpin;
         for( i = 0; i < sorted_map_count; i++ )
@@ -294,6 +304,11 @@ void ICACHE_FLASH_ATTR UpdateAllSameLEDs(void)
 
 
 uint32_t ICACHE_FLASH_ATTR ECCtoHEX( uint8_t note, uint8_t sat, uint8_t val )
+{
+    return EHSVtoHEX( ECCtoHue( note ), sat, val );
+}
+
+uint8_t ICACHE_FLASH_ATTR ECCtoHue( uint8_t note )
 {
     uint16_t hue = 0;
     uint16_t third = 65535 / 3;
@@ -321,5 +336,5 @@ uint32_t ICACHE_FLASH_ATTR ECCtoHEX( uint8_t note, uint8_t sat, uint8_t val )
     }
     hue >>= 8;
 
-    return EHSVtoHEX( hue, sat, val );
+    return hue;
 }
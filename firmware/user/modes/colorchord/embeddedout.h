@@ -42,6 +42,7 @@ void ICACHE_FLASH_ATTR UpdateLinearLEDs(void);
 void ICACHE_FLASH_ATTR UpdateAllSameLEDs(void);
 
 uint32_t ICACHE_FLASH_ATTR ECCtoHEX( uint8_t note, uint8_t sat, uint8_t val );
+uint8_t ICACHE_FLASH_ATTR ECCtoHue( uint8_t note );
 
 
 #endif
@@ -40,7 +40,8 @@
 
 void ICACHE_FLASH_ATTR colorchordEnterMode(void);
 void ICACHE_FLASH_ATTR colorchordExitMode(void);
-void ICACHE_FLASH_ATTR colorchordSampleHandler(int32_t samp);
+void ICACHE_FLASH_ATTR colorchordSampleHandler(const int16_t* samples, int numSamples);
+void ICACHE_FLASH_ATTR ccHandleFrame(void);
 void ICACHE_FLASH_ATTR colorchordButtonCallback(uint8_t state, int button, int down);
 bool ICACHE_FLASH_ATTR ccRenderTask(void);
 void ICACHE_FLASH_ATTR ccExitTimerFn(void* arg);
@@ -55,7 +56,7 @@ swadgeMode colorchordMode =
     .fnEnterMode = colorchordEnterMode,
     .fnExitMode = colorchordExitMode,
     .fnButtonCallback = colorchordButtonCallback,
-    .fnAudioCallback = colorchordSampleHandler,
+    .fnAudioBlockCallback = colorchordSampleHandler,
     .fnRenderTask = ccRenderTask,
     .wifiMode = NO_WIFI,
     .fnEspNowRecvCb = NULL,
@@ -202,51 +203,51 @@ void ICACHE_FLASH_ATTR colorchordExitMode(void)
 }
 
 /**
- * This is called every time an audio sample is read from the ADC
- * This processes the sample and will display update the LEDs every
+ * This is called with each block of audio samples read from the ADC
+ * This processes the samples and will display update the LEDs every
  * 128 samples
  *
- * @param samp A 32 bit audio sample read from the ADC (microphone)
+ * @param samples    Filtered audio samples read from the ADC (microphone)
+ * @param numSamples The number of samples
  */
-void ICACHE_FLASH_ATTR colorchordSampleHandler(int32_t samp)
+void ICACHE_FLASH_ATTR colorchordSampleHandler(const int16_t* samples, int numSamples)
 {
-    PushSample32( samp );
-    cc.samplesProcessed++;
+    PushSamplesFramed32(samples, numSamples, 128, &cc.samplesProcessed, ccHandleFrame);
+}
 
-    // If at least 128 samples have been processed
-    if( cc.samplesProcessed >= 128 )
+/**
+ * This is called after every 128 samples. It processes them and updates the
+ * LEDs if colorchord is active
+ */
+void ICACHE_FLASH_ATTR ccHandleFrame(void)
+{
+    // Don't bother if colorchord is inactive
+    if( !COLORCHORD_ACTIVE )
     {
-        // Don't bother if colorchord is inactive
-        if( !COLORCHORD_ACTIVE )
-        {
-            return;
-        }
+        return;
+    }
 
-        // Colorchord magic
-        HandleFrameInfo();
+    // Colorchord magic
+    HandleFrameInfo();
 
-        // Update the LEDs as necessary
-        switch( COLORCHORD_OUTPUT_DRIVER )
+    // Update the LEDs as necessary
+    switch( COLORCHORD_OUTPUT_DRIVER )
+    {
+        default:
+        case 0:
         {
-            default:
-            case 0:
-            {
-                UpdateLinearLEDs();
-                break;
-            }
-            case 1:
-            {
-                UpdateAllSameLEDs();
-                break;
-            }
-        };
-
-        // Push out the LED data
-        setLeds( (led_t*)ledOut, NUM_LIN_LEDS * 3 );
+            UpdateLinearLEDs();
+            break;
+        }
+        case 1:
+        {
+            UpdateAllSameLEDs();
+            break;
+        }
+    };
 
-        // Reset the sample count
-        cc.samplesProcessed = 0;
-    }
+    // Push out the LED data
+    setLeds( (led_t*)ledOut, NUM_LIN_LEDS * 3 );
 }
 
 /**
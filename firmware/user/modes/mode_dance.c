@@ -476,16 +476,15 @@ void ICACHE_FLASH_ATTR danceSmoothRainbow(uint32_t tElapsedUs, uint32_t arg __at
 
         ledCount--;
 
+        hsv_t hsv[NUM_LIN_LEDS];
         uint8_t i;
         for(i = 0; i < NUM_LIN_LEDS; i++)
         {
-            int16_t angle = ((((i * 256) / NUM_LIN_LEDS)) + ledCount) % 256;
-            uint32_t color = EHSVtoHEX(angle, 0xFF, 0xFF);
-
-            leds[i].r = (color >>  0) & 0xFF;
-            leds[i].g = (color >>  8) & 0xFF;
-            leds[i].b = (color >> 16) & 0xFF;
+            hsv[i].h = ((((i * 256) / NUM_LIN_LEDS)) + ledCount) % 256;
+            hsv[i].s = 0xFF;
+            hsv[i].v = 0xFF;
         }
+        hsvToLeds(hsv, leds, NUM_LIN_LEDS);
     }
     // Output the LED data, actually turning them on
     if(ledsUpdated)
@@ -527,16 +526,15 @@ void ICACHE_FLASH_ATTR danceSharpRainbow(uint32_t tElapsedUs, uint32_t arg __att
             ledCount = 0;
         }
 
+        hsv_t hsv[NUM_LIN_LEDS];
         uint8_t i;
         for(i = 0; i < NUM_LIN_LEDS; i++)
         {
-            int16_t angle = (((i * 256) / NUM_LIN_LEDS)) % 256;
-            uint32_t color = EHSVtoHEX(angle, 0xFF, 0xFF);
-
-            leds[(i + ledCount) % NUM_LIN_LEDS].r = (color >>  0) & 0xFF;
-            leds[(i + ledCount) % NUM_LIN_LEDS].g = (color >>  8) & 0xFF;
-            leds[(i + ledCount) % NUM_LIN_LEDS].b = (color >> 16) & 0xFF;
+            hsv[(i + ledCount) % NUM_LIN_LEDS].h = (((i * 256) / NUM_LIN_LEDS)) % 256;
+            hsv[(i + ledCount) % NUM_LIN_LEDS].s = 0xFF;
+            hsv[(i + ledCount) % NUM_LIN_LEDS].v = 0xFF;
         }
+        hsvToLeds(hsv, leds, NUM_LIN_LEDS);
     }
     // Output the LED data, actually turning them on
     if(ledsUpdated)
@@ -1088,12 +1086,14 @@ void ICACHE_FLASH_ATTR danceChristmas(uint32_t tElapsedUs, uint32_t arg, bool re
         }
 
         // Calculate actual LED values
+        hsv_t hsv[NUM_LIN_LEDS];
         for(i = 0; i < NUM_LIN_LEDS; i++)
         {
-            leds[i].r = (EHSVtoHEX(current_color_hue[i], current_color_saturation[i], current_value[i]) >>  0) & 0xFF;
-            leds[i].g = (EHSVtoHEX(current_color_hue[i], current_color_saturation[i], current_value[i]) >>  8) & 0xFF;
-            leds[i].b = (EHSVtoHEX(current_color_hue[i], current_color_saturation[i], current_value[i]) >> 16) & 0xFF;
+            hsv[i].h = current_color_hue[i];
+            hsv[i].s = current_color_saturation[i];
+            hsv[i].v = current_value[i];
         }
+        hsvToLeds(hsv, leds, NUM_LIN_LEDS);
         ledsUpdated = true;
     }
     // Output the LED data, actually turning them on
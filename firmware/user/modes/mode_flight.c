@@ -40,6 +40,7 @@
 #include "gpio.h"
 #include "esp_niceness.h"
 #include "hsv_utils.h"
+#include "fixed_math.h"
 
 #include "embeddednf.h"
 #include "embeddedout.h"
@@ -180,7 +181,7 @@ swadgeMode flightMode =
     .fnEspNowSendCb = NULL,
     .fnRenderTask = flightRender,
     .fnAccelerometerCallback = NULL,
-    .fnAudioCallback = NULL,
+    .fnAudioBlockCallback = NULL,
     .menuImg = "flight-menu.gif"
 };
 
@@ -534,9 +535,7 @@ static void ICACHE_FLASH_ATTR flightUpdate(void* arg __attribute__((unused)))
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-int16_t ICACHE_FLASH_ATTR tdCOS( uint8_t iv );
 void ICACHE_FLASH_ATTR tdIdentity( int16_t * matrix );
-static int16_t ICACHE_FLASH_ATTR tdSIN( uint8_t iv );
 void ICACHE_FLASH_ATTR Perspective( int fovx, int aspect, int zNear, int zFar, int16_t * out );
 int ICACHE_FLASH_ATTR LocalToScreenspace( const int16_t * coords_3v, int16_t * o1, int16_t * o2 );
 void ICACHE_FLASH_ATTR SetupMatrix( void );
@@ -546,62 +545,24 @@ void ICACHE_FLASH_ATTR tdScale( int16_t * f, int16_t x, int16_t y, int16_t z );
 void ICACHE_FLASH_ATTR td4Transform( int16_t * pin, int16_t * f, int16_t * pout );
 void ICACHE_FLASH_ATTR tdTranslate( int16_t * f, int16_t x, int16_t y, int16_t z );
 void ICACHE_FLASH_ATTR Draw3DSegment( const int16_t * c1, const int16_t * c2 );
-uint16_t ICACHE_FLASH_ATTR tdSQRT( uint32_t inval );
 int16_t ICACHE_FLASH_ATTR tdDist( int16_t * a, int16_t * b );
 
 
 //From https://github.com/cnlohr/channel3/blob/master/user/3d.c
 
-static const uint8_t sintable[128] = { 0, 6, 12, 18, 25, 31, 37, 43, 49, 55, 62, 68, 74, 80, 86, 91, 97, 103, 109, 114, 120, 125, 131, 136, 141, 147, 152, 157, 162, 166, 171, 176, 180, 185, 189, 193, 197, 201, 205, 208, 212, 215, 219, 222, 225, 228, 230, 233, 236, 238, 240, 242, 244, 246, 247, 249, 250, 251, 252, 253, 254, 254, 255, 255, 255, 255, 255, 254, 254, 253, 252, 251, 250, 249, 247, 246, 244, 242, 240, 238, 236, 233, 230, 228, 225, 222, 219, 215, 212, 208, 205, 201, 197, 193, 189, 185, 180, 176, 171, 166, 162, 157, 152, 147, 141, 136, 131, 125, 120, 114, 109, 103, 97, 91, 86, 80, 74, 68, 62, 55, 49, 43, 37, 31, 25, 18, 12, 6, };
+// Sine and cosine of an 8 bit angle, in the 8.8 fixed point the matrices use
+#define tdSIN( iv ) ( fxSin( (uint8_t)(iv) << 8 ) >> 6 )
+#define tdCOS( iv ) ( fxCos( (uint8_t)(iv) << 8 ) >> 6 )
 
 int16_t ModelviewMatrix[16];
 int16_t ProjectionMatrix[16];
 
-static int16_t ICACHE_FLASH_ATTR tdSIN( uint8_t iv )
-{
-    if( iv > 127 )
-    {
-        return -sintable[iv-128];
-    }
-    else
-    {
-        return sintable[iv];
-    }
-}
-
-int16_t ICACHE_FLASH_ATTR tdCOS( uint8_t iv )
-{
-    return tdSIN( iv + 64 );
-}
-
-uint16_t ICACHE_FLASH_ATTR tdSQRT( uint32_t inval )
-{
-    uint32_t res = 0;
-    uint32_t one = 1UL << 30;
-    while (one > inval)
-    {
-        one >>= 2;
-    }
-
-    while (one != 0)
-    {
-        if (inval >= res + one)
-        {
-            inval = inval - (res + one);
-            res = res +  (one<<1);
-        }
-        res >>= 1;
-        one >>= 2;
-    }
-    return res;
-}
-
 int16_t ICACHE_FLASH_ATTR tdDist( int16_t * a, int16_t * b )
 {
     int32_t dx = a[0] - b[0];
     int32_t dy = a[1] - b[1];
     int32_t dz = a[2] - b[2];
-    return tdSQRT( dx*dx+dy*dy+dz*dz );
+    return fxSqrt( dx*dx+dy*dy+dz*dz );
 }
 
 void ICACHE_FLASH_ATTR tdIdentity( int16_t * matrix )
@@ -852,7 +813,7 @@ static tdModel * ICACHE_FLASH_ATTR tdAllocateModel( int nrfaces, const uint16_t
         }
         if( difftot > dSq ) dSq = difftot;
     }
-    ret->radius = tdSQRT( dSq );
+    ret->radius = fxSqrt( dSq );
 
     return ret;
 }
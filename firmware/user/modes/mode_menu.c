@@ -6,6 +6,7 @@
 #include "osapi.h"
 #include "user_main.h"
 #include "assets.h"
+#include "gif_cache.h"
 #include "nvm_interface.h"
 #include "oled.h"
 #include "bresenham.h"
@@ -28,6 +29,14 @@
 
 #define MNU_BUTTON_HIST_SIZE 8
 
+// Decoded preview frames are kept for the modes on either side of the selected
+// one, so panning doesn't wait on the asset index or fastlz. A full screen
+// frame is 1025 bytes, so this fits the current mode and its two neighbors
+#define MENU_PREVIEW_BUDGET   3200
+
+// How many neighbors menuPrefetchPreviews() loads, right then left
+#define MENU_PREFETCH_NEIGHBORS 2
+
 /*============================================================================
  * Enums
  *==========================================================================*/
@@ -60,6 +69,11 @@ void ICACHE_FLASH_ATTR startPanning(bool pLeft);
 static void ICACHE_FLASH_ATTR menuPanImages(void* arg __attribute__((unused)));
 void ICACHE_FLASH_ATTR mnuDrawArrows(void);
 
+static gifHandle* ICACHE_FLASH_ATTR menuGetPreview(uint8_t modeIdx);
+static void ICACHE_FLASH_ATTR menuFreePreviews(void);
+static void ICACHE_FLASH_ATTR menuPrefetchPreviews(void* arg __attribute__((unused)));
+static void ICACHE_FLASH_ATTR menuDrawPreview(gifHandle* img, int16_t x);
+
 /*============================================================================
  * Variables
  *==========================================================================*/
@@ -79,8 +93,9 @@ typedef struct
     int16_t squareWaveScrollSpeed;
     bool drawOLEDScreensaver;
 
-    gifHandle img1;
-    gifHandle img2;
+    gifCache_t previews;
+    timer_t timerPrefetch;
+    uint8_t prefetchIdx; // The next neighbor menuPrefetchPreviews() tries
     gifHandle* curImg;
     gifHandle* nextImg;
 
@@ -128,10 +143,6 @@ void ICACHE_FLASH_ATTR menuInit(void)
     // expressed as pixels per frame.
     mnu->squareWaveScrollSpeed = -1;
 
-    // Assign pointers
-    mnu->curImg = &mnu->img1;
-    mnu->nextImg = &mnu->img2;
-
     // Get the list of mnu->modes
     mnu->numModes = getSwadgeModes(&mnu->modes);
     // Don't count the menu as a mode
@@ -141,8 +152,9 @@ void ICACHE_FLASH_ATTR menuInit(void)
     mnu->selectedMode = getMenuPos();
 
     // Load and draw the first image
-    loadGifFromAsset(mnu->modes[1 + mnu->selectedMode]->menuImg, mnu->curImg);
-    drawGifFromAsset(mnu->curImg, 0, 0, false, false, 0, false);
+    gifCacheInit(&mnu->previews, MENU_PREVIEW_BUDGET);
+    mnu->curImg = menuGetPreview(mnu->selectedMode);
+    menuDrawPreview(mnu->curImg, 0);
     mnuDrawArrows();
 
     // Timer for starting a screensaver
@@ -165,6 +177,12 @@ void ICACHE_FLASH_ATTR menuInit(void)
     timerDisarm(&mnu->timerPanning);
     timerSetFn(&mnu->timerPanning, (os_timer_func_t*)menuPanImages, NULL);
 
+    // Timer for loading the neighboring previews after the first is drawn
+    timerDisarm(&mnu->timerPrefetch);
+    timerSetFn(&mnu->timerPrefetch, (os_timer_func_t*)menuPrefetchPreviews, NULL);
+    mnu->prefetchIdx = 0;
+    timerArm(&mnu->timerPrefetch, MENU_PAN_PERIOD_MS, false);
+
     // This starts the screensaver timer
     stopScreensaver();
 
@@ -183,9 +201,9 @@ void ICACHE_FLASH_ATTR menuExit(void)
     timerDisarm(&mnu->timerScreensaverLEDAnimation);
     timerDisarm(&mnu->timerScreensaverOLEDAnimation);
     timerDisarm(&mnu->timerPanning);
+    timerDisarm(&mnu->timerPrefetch);
     timerFlush();
-    freeGifAsset(mnu->curImg);
-    freeGifAsset(mnu->nextImg);
+    menuFreePreviews();
     os_free(mnu);
 }
 
@@ -214,7 +232,7 @@ void ICACHE_FLASH_ATTR menuButtonCallback(uint8_t state __attribute__((unused)),
         if((button != UP) && (button != DOWN) && stopScreensaver())
         {
             // Draw what's under the screensaver
-            drawGifFromAsset(mnu->curImg, 0, 0, false, false, 0, false);
+            menuDrawPreview(mnu->curImg, 0);
             mnuDrawArrows();
             // But don't process the button otherwise
             return;
@@ -312,9 +330,10 @@ void ICACHE_FLASH_ATTR startPanning(bool pLeft)
     // Block button input until it's done
     mnu->menuIsPanning = true;
 
-    // Load the next image
-    freeGifAsset(mnu->nextImg);
-    loadGifFromAsset(mnu->modes[1 + mnu->selectedMode]->menuImg, mnu->nextImg);
+    // Get the next image, which was usually prefetched. Don't prefetch while
+    // panning, it would make the pan stutter
+    timerDisarm(&mnu->timerPrefetch);
+    mnu->nextImg = menuGetPreview(mnu->selectedMode);
 
     // Start the timer to pan
     mnu->panningLeft = pLeft;
@@ -338,8 +357,8 @@ static void ICACHE_FLASH_ATTR menuPanImages(void* arg __attribute__((unused)))
         {
             mnu->panIdx = -OLED_WIDTH;
         }
-        drawGifFromAsset(mnu->curImg, mnu->panIdx, 0, false, false, 0, false);
-        drawGifFromAsset(mnu->nextImg, mnu->panIdx + OLED_WIDTH, 0, false, false, 0, false);
+        menuDrawPreview(mnu->curImg, mnu->panIdx);
+        menuDrawPreview(mnu->nextImg, mnu->panIdx + OLED_WIDTH);
     }
     else
     {
@@ -348,23 +367,101 @@ static void ICACHE_FLASH_ATTR menuPanImages(void* arg __attribute__((unused)))
         {
             mnu->panIdx = OLED_WIDTH;
         }
-        drawGifFromAsset(mnu->curImg, mnu->panIdx, 0, false, false, 0, false);
-        drawGifFromAsset(mnu->nextImg, mnu->panIdx - OLED_WIDTH, 0, false, false, 0, false);
+        menuDrawPreview(mnu->curImg, mnu->panIdx);
+        menuDrawPreview(mnu->nextImg, mnu->panIdx - OLED_WIDTH);
     }
     mnuDrawArrows();
 
     // Check if it's all done
     if(mnu->panIdx == -OLED_WIDTH || mnu->panIdx == OLED_WIDTH)
     {
-        // Swap mnu->curImg and mnu->nextImg
-        gifHandle* tmp;
-        tmp = mnu->curImg;
+        // The next image is the current one now. The old one stays cached,
+        // in case the menu pans back
         mnu->curImg = mnu->nextImg;
-        mnu->nextImg = tmp;
+        mnu->nextImg = NULL;
 
         // stop the timer
         timerDisarm(&mnu->timerPanning);
         mnu->menuIsPanning = false;
+
+        // Load the new neighbors' previews before the next pan
+        mnu->prefetchIdx = 0;
+        timerArm(&mnu->timerPrefetch, MENU_PAN_PERIOD_MS, false);
+    }
+}
+
+/**
+ * Draw a mode's preview image, if it could be loaded
+ *
+ * @param img The preview to draw, may be NULL
+ * @param x   The X position to draw it at
+ */
+static void ICACHE_FLASH_ATTR menuDrawPreview(gifHandle* img, int16_t x)
+{
+    if(NULL != img)
+    {
+        drawGifFromAsset(img, x, 0, false, false, 0, false);
+    }
+}
+
+/*==============================================================================
+ * Preview cache functions
+ *============================================================================*/
+
+/**
+ * Get a mode's preview image, with its first frame decoded. If it isn't
+ * cached, it's loaded. The previews being drawn are never evicted
+ *
+ * @param modeIdx The index of the mode to get the preview for
+ * @return The preview, or NULL if it couldn't be loaded
+ */
+static gifHandle* ICACHE_FLASH_ATTR menuGetPreview(uint8_t modeIdx)
+{
+    gifHandle* drawing[] = {mnu->curImg, mnu->nextImg};
+    return gifCacheGet(&mnu->previews, modeIdx, mnu->modes[1 + modeIdx]->menuImg, drawing, 2);
+}
+
+/**
+ * Free every cached preview
+ */
+static void ICACHE_FLASH_ATTR menuFreePreviews(void)
+{
+    gifCacheFree(&mnu->previews);
+    mnu->curImg = NULL;
+    mnu->nextImg = NULL;
+}
+
+/**
+ * Called on a timer while the menu is idle to load the previews for the modes
+ * on either side of the selected one. Only one is loaded per call, so no
+ * single call takes too long. Each neighbor is only tried once per selection,
+ * so a preview which can't be loaded isn't retried forever
+ *
+ * @param arg unused
+ */
+static void ICACHE_FLASH_ATTR menuPrefetchPreviews(void* arg __attribute__((unused)))
+{
+    if(mnu->menuIsPanning)
+    {
+        return;
+    }
+
+    while(mnu->prefetchIdx < MENU_PREFETCH_NEIGHBORS)
+    {
+        uint8_t neighbor = (0 == mnu->prefetchIdx) ?
+                           (mnu->selectedMode + 1) % mnu->numModes :
+                           (mnu->selectedMode + mnu->numModes - 1) % mnu->numModes;
+        mnu->prefetchIdx++;
+        if(!gifCacheHas(&mnu->previews, neighbor))
+        {
+            menuGetPreview(neighbor);
+            // Come back for the next one
+            if(mnu->prefetchIdx < MENU_PREFETCH_NEIGHBORS)
+            {
+                timerArm(&mnu->timerPrefetch, MENU_PAN_PERIOD_MS, false);
+            }
+            return;
+        }
     }
 }
 
@@ -26,6 +26,7 @@
 #include "menu2d.h"
 #include "linked_list.h"
 #include "font.h"
+#include "fixed_math.h"
 
 #include "embeddednf.h"
 #include "embeddedout.h"
@@ -122,6 +123,7 @@ Attempt rising / lowering sun BG fx
 #define ENEMY_SNAKE_SHOT_COOLDOWN (3.5 * S_TO_MS_FACTOR * MS_TO_US_FACTOR)
 #define ENEMY_BOMBER_SHOT_COOLDOWN (0.5 * S_TO_MS_FACTOR * MS_TO_US_FACTOR)
 #define ENEMY_WALKER_SHOT_COOLDOWN (2 * S_TO_MS_FACTOR * MS_TO_US_FACTOR)
+#define SNAKE_BOB_ANGLE_PER_FRAME 26702 // snakes bob with sin(frames / 25), which is 65536 / (2 * pi * 25) binary angle units per frame, in 10.6 fixed point.
 
 // score vars.
 #define ENEMY_KILL 10
@@ -315,7 +317,7 @@ swadgeMode mTypeMode =
     .fnEspNowRecvCb = NULL,
     .fnEspNowSendCb = NULL,
     .fnAccelerometerCallback = NULL,
-    .fnAudioCallback = NULL,
+    .fnAudioBlockCallback = NULL,
     .menuImg = "mtype-menu.gif" 
 };
 
@@ -758,7 +760,8 @@ void ICACHE_FLASH_ATTR mtGameLogic(void)
                     mType->enemies[i].frameOffset = mType->stateFrames;
                     mType->enemies[i].position.x = OLED_WIDTH + mType->enemies[i].bbHalf.x;
                 }
-                mType->enemies[i].position.y = mType->enemies[i].spawn.y + (7 * sin(((mType->stateFrames + mType->enemies[i].frameOffset) / 25.0)));
+                uint16_t bobAngle = ((uint32_t)(mType->stateFrames + mType->enemies[i].frameOffset) * SNAKE_BOB_ANGLE_PER_FRAME) >> 6;
+                mType->enemies[i].position.y = mType->enemies[i].spawn.y + ((7 * fxSin(bobAngle)) >> 14);
 
                 // update enemy shot cooldown.
                 mType->enemies[i].shotCooldown += mType->deltaTime;
@@ -1376,10 +1379,15 @@ bool ICACHE_FLASH_ATTR AABBCollision (int ax0, int ay0, int ax1, int ay1, int bx
 
 void ICACHE_FLASH_ATTR normalize (vecdouble_t * vec)
 {
-    if (vec->x != 0 || vec->y != 0) {
-        double mag = sqrt(pow(vec->x, 2) + pow(vec->y, 2));
-        vec->x /= mag;
-        vec->y /= mag;
+    // find 1 / magnitude with an integer reciprocal square root.
+    // the components are Q8, so their squares are Q16 and the result is Q22.
+    int32_t x = vec->x * 256;
+    int32_t y = vec->y * 256;
+    uint32_t magSqr = (uint32_t)(x * x) + (uint32_t)(y * y);
+    if (magSqr != 0) {
+        double invMag = fxRsqrt(magSqr) / (double)(1 << 22);
+        vec->x *= invMag;
+        vec->y *= invMag;
     }
 }
 
@@ -20,6 +20,8 @@
 #include "buttons.h"
 
 #include "menu2d.h"
+#include "trace.h"
+#include "fixed_math.h"
 
 /*==============================================================================
  * Defines
@@ -201,7 +203,6 @@ void ICACHE_FLASH_ATTR drawHUD(void);
 
 void ICACHE_FLASH_ATTR raycasterInitGame(raycasterDifficulty_t difficulty);
 void ICACHE_FLASH_ATTR sortSprites(int32_t* order, float* dist, int32_t amount);
-float ICACHE_FLASH_ATTR Q_rsqrt( float number );
 bool ICACHE_FLASH_ATTR checkLineToPlayer(raySprite_t* sprite, float pX, float pY);
 void ICACHE_FLASH_ATTR setSpriteState(raySprite_t* sprite, enemyState_t state);
 
@@ -220,7 +221,7 @@ swadgeMode raycasterMode =
     .fnEspNowRecvCb = NULL,
     .fnEspNowSendCb = NULL,
     .fnAccelerometerCallback = NULL,
-    .fnAudioCallback = NULL,
+    .fnAudioBlockCallback = NULL,
     .menuImg = "ray-menu.gif"
 };
 
@@ -743,6 +744,8 @@ void ICACHE_FLASH_ATTR raycasterGameRenderer(uint32_t tElapsedUs)
  */
 void ICACHE_FLASH_ATTR castRays(rayResult_t* rayResult)
 {
+    TRACE_SCOPE("castRays");
+
     for(int32_t x = 0; x < OLED_WIDTH; x++)
     {
         // calculate ray position and direction
@@ -1328,29 +1331,6 @@ void ICACHE_FLASH_ATTR handleRayInput(uint32_t tElapsedUs)
     }
 }
 
-/**
- * Fast inverse square root. Works like magic. Ignore the warning
- *
- * See: https://en.wikipedia.org/wiki/Fast_inverse_square_root
- *
- * @param number The number to find 1/sqrt(x) for
- * @return 1/sqrt(x), or close enough
- */
-float ICACHE_FLASH_ATTR Q_rsqrt( float number )
-{
-    const float x2 = number * 0.5F;
-    const float threehalfs = 1.5F;
-
-    union
-    {
-        float f;
-        unsigned long i;
-    } conv  = { .f = number };
-    conv.i  = 0x5f3759df - ( conv.i >> 1 );
-    conv.f  *= ( threehalfs - ( x2 * conv.f * conv.f ) );
-    return conv.f;
-}
-
 /**
  * Move all sprites around and govern enemy behavior
  *
@@ -1431,9 +1411,11 @@ void ICACHE_FLASH_ATTR moveEnemies(uint32_t tElapsedUs)
             case E_PICK_DIR_RAND:
             {
                 // Walking randomly is good if the sprite can't make a valid move
-                // Get a random unit vector in the first quadrant
-                rc->sprites[i].dirX = (os_random() % 90) / 90.0f;
-                rc->sprites[i].dirY = 1 / Q_rsqrt(1 - (rc->sprites[i].dirX * rc->sprites[i].dirX));
+                // Get a random unit vector in the first quadrant, in Q14 so the
+                // square root is an integer one
+                uint32_t randX = ((os_random() % 90) * FX_ONE) / 90;
+                rc->sprites[i].dirX = randX / (float)FX_ONE;
+                rc->sprites[i].dirY = fxSqrt((FX_ONE * FX_ONE) - (randX * randX)) / (float)FX_ONE;
 
                 // Randomize the unit vector quadrant
                 switch(os_random() % 4)
@@ -1484,8 +1466,9 @@ void ICACHE_FLASH_ATTR moveEnemies(uint32_t tElapsedUs)
                 }
                 else // Pick a direction to walk in
                 {
-                    // Normalize the vector
-                    float invSqr = Q_rsqrt(magSqr);
+                    // Normalize the vector. magSqr is passed as Q8, so the
+                    // reciprocal root comes back as Q26
+                    float invSqr = fxRsqrt((uint32_t)(magSqr * 256)) * (1.0f / (1 << 26));
                     toPlayerX *= invSqr;
                     toPlayerY *= invSqr;
 
@@ -1706,18 +1689,15 @@ void ICACHE_FLASH_ATTR moveEnemies(uint32_t tElapsedUs)
         float xClosest = (rc->sprites[closestIdx].posX - rc->posX);
         float yClosest = (rc->sprites[closestIdx].posY - rc->posY);
 
-        // Find the angle between the two vectors
-        rc->closestAngle = acosf(
-                               ((rc->dirX * xClosest) + (rc->dirY * yClosest)) *        // Dot Product
-                               Q_rsqrt((xClosest * xClosest) + (yClosest * yClosest))); // (1 / distance to sprite)
-        // The magnitude of the 'straight ahead' vector is always 1, so it's left out of the denominator
+        // The dot product is the cosine of the angle between the two vectors and
+        // the cross product is the sine, both scaled by the distance to the
+        // sprite. The magnitude of the 'straight ahead' vector is always 1
+        float dot = (rc->dirX * xClosest) + (rc->dirY * yClosest);
+        float cross = (rc->dirX * yClosest) - (rc->dirY * xClosest);
 
-        // Check if the sprite is to the left or right of us
-        if(((rc->dirX) * (yClosest) - (rc->dirY) * (xClosest)) > 0)
-        {
-            // If it's to the left, rotate the angle to the pi->2*pi range
-            rc->closestAngle = (2 * M_PI) - rc->closestAngle;
-        }
+        // Find the angle between the two vectors. Sprites to the left are in the
+        // pi->2*pi range. The vectors are scaled up for the integer atan2
+        rc->closestAngle = FX_ANGLE_TO_RAD(fxAtan2((int32_t)(-cross * 256), (int32_t)(dot * 256)));
     }
 }
 
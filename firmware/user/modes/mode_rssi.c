@@ -161,7 +161,7 @@ swadgeMode rssiMode =
     .fnEspNowRecvCb = NULL,
     .fnEspNowSendCb = NULL,
     .fnAccelerometerCallback = NULL,
-    .fnAudioCallback = NULL,
+    .fnAudioBlockCallback = NULL,
     .menuImg = "rssi-menu.gif"
 };
 
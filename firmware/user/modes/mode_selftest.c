@@ -41,7 +41,7 @@ typedef enum
 void ICACHE_FLASH_ATTR selfTestInit(void);
 void ICACHE_FLASH_ATTR selfTestExit(void);
 void ICACHE_FLASH_ATTR selfTestButtonCallback(uint8_t state, int button, int down);
-void ICACHE_FLASH_ATTR selfTestAudioCallback(int32_t samp);
+void ICACHE_FLASH_ATTR selfTestAudioCallback(const int16_t* samples, int numSamples);
 bool ICACHE_FLASH_ATTR selfTestRenderTask(void);
 void ICACHE_FLASH_ATTR selfTestLedFunc(void*);
 
@@ -51,7 +51,7 @@ void ICACHE_FLASH_ATTR selfTestLedFunc(void*);
 
 typedef struct
 {
-    int16_t samplesProcessed;
+    int samplesProcessed;
     timer_t ledTimer;
     buttonState_t buttonStates[NUM_BUTTONS];
     pngSequenceHandle burger;
@@ -67,7 +67,7 @@ swadgeMode selfTestMode =
     .fnEnterMode = selfTestInit,
     .fnExitMode = selfTestExit,
     .fnButtonCallback = selfTestButtonCallback,
-    .fnAudioCallback = selfTestAudioCallback,
+    .fnAudioBlockCallback = selfTestAudioCallback,
     .fnRenderTask = selfTestRenderTask,
     .wifiMode = NO_WIFI,
     .fnEspNowRecvCb = NULL,
@@ -144,22 +144,12 @@ void ICACHE_FLASH_ATTR selfTestButtonCallback(uint8_t state __attribute__((unuse
 /**
  * Pass microphone samples to colorchord
  *
- * @param samp The sample read from the microphone
+ * @param samples    The samples read from the microphone
+ * @param numSamples The number of samples
  */
-void ICACHE_FLASH_ATTR selfTestAudioCallback(int32_t samp)
+void ICACHE_FLASH_ATTR selfTestAudioCallback(const int16_t* samples, int numSamples)
 {
-    PushSample32( samp );
-    st->samplesProcessed++;
-
-    // If at least 128 samples have been processed
-    if( st->samplesProcessed >= 128 )
-    {
-        // Colorchord magic
-        HandleFrameInfo();
-
-        // Reset the sample count
-        st->samplesProcessed = 0;
-    }
+    PushSamplesFramed32(samples, numSamples, 128, &st->samplesProcessed, HandleFrameInfo);
 }
 
 /**
@@ -276,6 +266,7 @@ bool ICACHE_FLASH_ATTR selfTestRenderTask(void)
         {
             // Write that the self test passed
             setSelfTestPass(true);
+            flushSettingsNow();
         }
     }
 
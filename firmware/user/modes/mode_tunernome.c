@@ -19,7 +19,6 @@
 
 #include "buttons.h"
 #include "user_main.h"
-#include "embeddednf.h"
 #include "oled.h"
 #include "bresenham.h"
 #include "cndraw.h"
@@ -28,9 +27,7 @@
 #include "linked_list.h"
 #include "font.h"
 #include "mode_colorchord.h"
-
-#include "embeddednf.h"
-#include "embeddedout.h"
+#include "goertzel_tuner.h"
 
 /*============================================================================
  * Defines, Structs, Enums
@@ -43,10 +40,11 @@
 #define NUM_GUITAR_STRINGS    6
 #define NUM_VIOLIN_STRINGS    4
 #define NUM_UKELELE_STRINGS   4
-#define GUITAR_OFFSET         0
-#define CHROMATIC_OFFSET      6 // adjust start point by quartertones
-#define SENSITIVITY           5
-#define TONAL_DIFF_IN_TUNE_DEVIATION 10
+#define NUM_SEMITONE_OCTAVES  4
+#define SEMITONE_0_OCTAVE_2   -33 // C2, in semitones from A4
+#define IN_TUNE_CENTS         5
+#define CENTS_COLOR_SCALE     12 // How quickly LEDs go from white to red or blue
+#define TUNER_NOISE_FLOOR     40 // Notes quieter than this amplitude are ignored
 
 #define METRONOME_CENTER_X    OLED_WIDTH / 2
 #define METRONOME_CENTER_Y    OLED_HEIGHT - 10
@@ -106,9 +104,7 @@ typedef struct
     int lastBpmButton;
     uint32_t bpmButtonTimerUs;
 
-    int audioSamplesProcessed;
-    uint32_t intensities_filt[NUM_LIN_LEDS];
-    int32_t diffs_filt[NUM_LIN_LEDS];
+    goertzelTuner_t gt;
 
     bool pause;
     int bpm;
@@ -117,9 +113,8 @@ typedef struct
     bool isClockwise;
     int32_t usPerBeat;
 
-    uint32_t semitone_intensitiy_filt;
-    int32_t semitone_diff_filt;
-    int16_t tonalDiff;
+    int16_t semitoneCents;
+    uint16_t semitoneAmplitude;
 
     pngHandle upArrowPng;
     pngHandle flatPng;
@@ -140,21 +135,18 @@ void ICACHE_FLASH_ATTR switchToSubmode(tnMode);
 void ICACHE_FLASH_ATTR tunernomeButtonCallback(uint8_t state __attribute__((unused)),
         int button, int down);
 void ICACHE_FLASH_ATTR modifyBpm(int16_t bpmMod);
-void ICACHE_FLASH_ATTR tunernomeSampleHandler(int32_t samp);
+void ICACHE_FLASH_ATTR tunernomeSampleHandler(const int16_t* samples, int numSamples);
 void ICACHE_FLASH_ATTR recalcMetronome(void);
 void ICACHE_FLASH_ATTR plotInstrumentNameAndNotes(const char* instrumentName, const char** instrumentNotes,
         uint16_t numNotes);
 void ICACHE_FLASH_ATTR plotTopSemiCircle(int xm, int ym, int r, color col);
-void ICACHE_FLASH_ATTR instrumentTunerMagic(const uint16_t freqBinIdxs[], uint16_t numStrings, led_t colors[],
-        const uint16_t stringIdxToLedIdx[]);
+void ICACHE_FLASH_ATTR setTunerNotes(void);
+led_t ICACHE_FLASH_ATTR tunerLedColor(int16_t cents, uint16_t amplitude);
+void ICACHE_FLASH_ATTR instrumentTunerMagic(uint16_t numStrings, led_t colors[], const uint16_t stringIdxToLedIdx[]);
 bool ICACHE_FLASH_ATTR tunernomeRenderTask(void);
 void ICACHE_FLASH_ATTR ledReset(void* timer_arg __attribute__((unused)));
 void ICACHE_FLASH_ATTR fasterBpmChange(void* timer_arg __attribute__((unused)));
 
-static inline int16_t getMagnitude(uint16_t idx);
-static inline int16_t getDiffAround(uint16_t idx);
-static inline int16_t getSemiMagnitude(int16_t idx);
-static inline int16_t getSemiDiffAround(uint16_t idx);
 void ICACHE_FLASH_ATTR tnExitTimerFn(void* arg);
 
 /*============================================================================
@@ -172,7 +164,7 @@ swadgeMode tunernomeMode =
     .fnEspNowRecvCb = NULL,
     .fnEspNowSendCb = NULL,
     .fnAccelerometerCallback = NULL,
-    .fnAudioCallback = tunernomeSampleHandler,
+    .fnAudioBlockCallback = tunernomeSampleHandler,
     .menuImg = "tn-menu.gif"
 };
 
@@ -183,41 +175,38 @@ tunernome_t* tunernome;
  *==========================================================================*/
 
 /**
- * Indicies into fuzzed_bins[], a realtime DFT of sorts
- * fuzzed_bins[0] = A ... 1/2 steps are every 2.
+ * The notes of each string, in semitones from A4 (440Hz)
  */
-const uint16_t freqBinIdxsGuitar[NUM_GUITAR_STRINGS] =
+const int8_t stringNotesGuitar[NUM_GUITAR_STRINGS] =
 {
-    38, // E string needs to skip an octave... Can't read sounds this low.
-    24, // A string is exactly at note #24
-    34, // D = A + 5 half steps = 34
-    44, // G
-    52, // B
-    62  // e
+    -29, // E2
+    -24, // A2
+    -19, // D3
+    -14, // G3
+    -10, // B3
+    -5   // E4
 };
 
 /**
- * Indicies into fuzzed_bins[], a realtime DFT of sorts
- * fuzzed_bins[0] = A ... 1/2 steps are every 2.
+ * The notes of each string, in semitones from A4 (440Hz)
  */
-const uint16_t freqBinIdxsViolin[NUM_VIOLIN_STRINGS] =
+const int8_t stringNotesViolin[NUM_VIOLIN_STRINGS] =
 {
-    44, // G
-    58, // D
-    72, // A
-    86  // E
+    -14, // G3
+    -7,  // D4
+    0,   // A4
+    7    // E5
 };
 
 /**
- * Indicies into fuzzed_bins[], a realtime DFT of sorts
- * fuzzed_bins[0] = A ... 1/2 steps are every 2.
+ * The notes of each string, in semitones from A4 (440Hz)
  */
-const uint16_t freqBinIdxsUkelele[NUM_UKELELE_STRINGS] =
+const int8_t stringNotesUkelele[NUM_UKELELE_STRINGS] =
 {
-    68, // G
-    54, // C
-    62, // E
-    72  // A
+    -2, // G4
+    -9, // C4
+    -5, // E4
+    0   // A4
 };
 
 const uint16_t fourNoteStringIdxToLedIdx[4] =
@@ -293,11 +282,12 @@ static int TUNER_THRES_Y;
  */
 void ICACHE_FLASH_ATTR tunernomeEnterMode(void)
 {
-    float intermedX = cosf(TONAL_DIFF_IN_TUNE_DEVIATION * M_PI / 17 );
-    float intermedY = sinf(TONAL_DIFF_IN_TUNE_DEVIATION * M_PI / 17 );
-    TUNER_SHARP_THRES_X = round(METRONOME_CENTER_X - (intermedX * METRONOME_RADIUS));
-    TUNER_FLAT_THRES_X = round(METRONOME_CENTER_X + (intermedX * METRONOME_RADIUS));
-    TUNER_THRES_Y = round(METRONOME_CENTER_Y - (ABS(intermedY) * METRONOME_RADIUS));
+    // The needle is vertical when in tune and horizontal at GT_MAX_CENTS
+    float intermedX = sinf(IN_TUNE_CENTS * M_PI / (2 * GT_MAX_CENTS));
+    float intermedY = cosf(IN_TUNE_CENTS * M_PI / (2 * GT_MAX_CENTS));
+    TUNER_SHARP_THRES_X = round(METRONOME_CENTER_X + (intermedX * METRONOME_RADIUS));
+    TUNER_FLAT_THRES_X = round(METRONOME_CENTER_X - (intermedX * METRONOME_RADIUS));
+    TUNER_THRES_Y = round(METRONOME_CENTER_Y - (intermedY * METRONOME_RADIUS));
 
     // Alloc and clear everything
     tunernome = os_malloc(sizeof(tunernome_t));
@@ -309,6 +299,7 @@ void ICACHE_FLASH_ATTR tunernomeEnterMode(void)
     tunernome->pause = false;
     tunernome->bpm = INITIAL_BPM;
     tunernome->curTunerMode = GUITAR_TUNER;
+    setTunerNotes();
 
     switchToSubmode(TN_TUNER);
 
@@ -320,8 +311,6 @@ void ICACHE_FLASH_ATTR tunernomeEnterMode(void)
 
     enableDebounce(true);
 
-    InitColorChord();
-
     tunernome->exitTimeAccumulatedUs = 0;
     tunernome->tLastCallUs = 0;
     tunernome->shouldExit = false;
@@ -393,57 +382,57 @@ void ICACHE_FLASH_ATTR tunernomeExitMode(void)
 }
 
 /**
- * Inline helper function to get the magnitude of a frequency bin from fuzzed_bins[]
- *
- * @param idx The index to get a magnitude from
- * @return A signed magnitude, even though fuzzed_bins[] is unsigned
- */
-static inline int16_t getMagnitude(uint16_t idx)
-{
-    return fuzzed_bins[idx];
-}
-
-/**
- * Inline helper function to get the difference in magnitudes around a given
- * frequency bin from fuzzed_bins[]
- *
- * @param idx The index to get a difference in magnitudes around
- * @return The difference in magnitudes of the bins before and after the given index
- */
-static inline int16_t getDiffAround(uint16_t idx)
-{
-    return getMagnitude(idx + 1) - getMagnitude(idx - 1);
-}
-
-/**
- * Inline helper function to get the magnitude of a frequency bin from folded_bins[]
- *
- * @param idx The index to get a magnitude from
- * @return A signed magnitude, even though folded_bins[] is unsigned
+ * Set up the tuner's filters for the notes of the current instrument or
+ * semitone. Call this whenever curTunerMode changes
  */
-static inline int16_t getSemiMagnitude(int16_t idx)
+void ICACHE_FLASH_ATTR setTunerNotes(void)
 {
-    if(idx < 0)
-    {
-        idx += FIXBPERO;
-    }
-    if(idx > FIXBPERO - 1)
+    switch(tunernome->curTunerMode)
     {
-        idx -= FIXBPERO;
+        case GUITAR_TUNER:
+        {
+            gtInit(&(tunernome->gt), stringNotesGuitar, NUM_GUITAR_STRINGS);
+            break;
+        }
+        case VIOLIN_TUNER:
+        {
+            gtInit(&(tunernome->gt), stringNotesViolin, NUM_VIOLIN_STRINGS);
+            break;
+        }
+        case UKELELE_TUNER:
+        {
+            gtInit(&(tunernome->gt), stringNotesUkelele, NUM_UKELELE_STRINGS);
+            break;
+        }
+        case MAX_GUITAR_MODES:
+            break;
+        case SEMITONE_0:
+        case SEMITONE_1:
+        case SEMITONE_2:
+        case SEMITONE_3:
+        case SEMITONE_4:
+        case SEMITONE_5:
+        case SEMITONE_6:
+        case SEMITONE_7:
+        case SEMITONE_8:
+        case SEMITONE_9:
+        case SEMITONE_10:
+        case SEMITONE_11:
+        default:
+        {
+            // Listen for this semitone in a few octaves
+            int8_t notes[NUM_SEMITONE_OCTAVES];
+            uint8_t i;
+            for(i = 0; i < NUM_SEMITONE_OCTAVES; i++)
+            {
+                notes[i] = SEMITONE_0_OCTAVE_2 + (tunernome->curTunerMode - SEMITONE_0) + (12 * i);
+            }
+            gtInit(&(tunernome->gt), notes, NUM_SEMITONE_OCTAVES);
+            break;
+        }
     }
-    return folded_bins[idx];
-}
-
-/**
- * Inline helper function to get the difference in magnitudes around a given
- * frequency bin from folded_bins[]
- *
- * @param idx The index to get a difference in magnitudes around
- * @return The difference in magnitudes of the bins before and after the given index
- */
-static inline int16_t getSemiDiffAround(uint16_t idx)
-{
-    return getSemiMagnitude(idx + 1) - getSemiMagnitude(idx - 1);
+    tunernome->semitoneCents = 0;
+    tunernome->semitoneAmplitude = 0;
 }
 
 /**
@@ -530,73 +519,63 @@ void ICACHE_FLASH_ATTR plotTopSemiCircle(int xm, int ym, int r, color col)
 }
 
 /**
- * Instrument-agnostic tuner magic. Updates LEDs
- * @param freqBinIdxs An array of the indices of notes for the instrument's strings. See freqBinIdxsGuitar for an example.
- * @param numStrings The number of strings on the instrument, also the number of elements in freqBinIdxs and stringIdxToLedIdx, if applicable
+ * Pick an LED color for a note. It is white when in tune, redder the sharper it
+ * is and bluer the flatter it is, and brighter the louder it is
+ *
+ * @param cents     How far the note is from its pitch, negative is flat
+ * @param amplitude How loud the note is
+ * @return The LED color
+ */
+led_t ICACHE_FLASH_ATTR tunerLedColor(int16_t cents, uint16_t amplitude)
+{
+    // Drop the noise floor and scale the rest to a brightness
+    int32_t intensity = ((int32_t)amplitude - TUNER_NOISE_FLOOR) / 4;
+    intensity = CLAMP(intensity, 0, 255);
+
+    int32_t red, grn, blu;
+    // Is the note in tune?
+    if( ABS(cents) < IN_TUNE_CENTS )
+    {
+        // Note is in tune, make it white
+        red = 255;
+        grn = 255;
+        blu = 255;
+    }
+    else if( cents > 0 )
+    {
+        // Note too sharp, make it red
+        red = 255;
+        grn = blu = 255 - (cents - IN_TUNE_CENTS) * CENTS_COLOR_SCALE;
+    }
+    else
+    {
+        // Note too flat, make it blue
+        blu = 255;
+        grn = red = 255 - (-cents - IN_TUNE_CENTS) * CENTS_COLOR_SCALE;
+    }
+
+    // Scale each LED's brightness by the intensity, ensure each channel is between 0 and 255
+    led_t ledColor;
+    ledColor.r = (CLAMP(red, 0, 255) >> 3) * (intensity >> 3);
+    ledColor.g = (CLAMP(grn, 0, 255) >> 3) * (intensity >> 3);
+    ledColor.b = (CLAMP(blu, 0, 255) >> 3) * (intensity >> 3);
+    return ledColor;
+}
+
+/**
+ * Instrument-agnostic tuner magic. Updates LEDs from the last measurement of
+ * each string
+ * @param numStrings The number of strings on the instrument, also the number of elements in stringIdxToLedIdx, if applicable
  * @param colors The RGB colors of the LEDs to set
- * @param stringIdxToLedIdx A remapping from each index into freqBinIdxs (same index into stringIdxToLedIdx), to the index of an LED to map that string/freqBinIdx to. Set to NULL to skip remapping.
+ * @param stringIdxToLedIdx A remapping from each string index to the index of an LED to map that string to. Set to NULL to skip remapping.
  */
-void ICACHE_FLASH_ATTR instrumentTunerMagic(const uint16_t freqBinIdxs[], uint16_t numStrings, led_t colors[],
-        const uint16_t stringIdxToLedIdx[])
+void ICACHE_FLASH_ATTR instrumentTunerMagic(uint16_t numStrings, led_t colors[], const uint16_t stringIdxToLedIdx[])
 {
     uint32_t i;
     for( i = 0; i < numStrings; i++ )
     {
-        // Pick out the current magnitude and filter it
-        tunernome->intensities_filt[i] = (getMagnitude(freqBinIdxs[i] + GUITAR_OFFSET)  + tunernome->intensities_filt[i]) -
-                                         (tunernome->intensities_filt[i] >> 5);
-
-        // Pick out the difference around current magnitude and filter it too
-        tunernome->diffs_filt[i] =       (getDiffAround(freqBinIdxs[i] + GUITAR_OFFSET) + tunernome->diffs_filt[i]) -
-                                         (tunernome->diffs_filt[i] >> 5);
-
-        // This is the magnitude of the target frequency bin, cleaned up
-        int16_t intensity = (tunernome->intensities_filt[i] >> SENSITIVITY) - 40; // drop a baseline.
-        intensity = CLAMP(intensity, 0, 255);
-
-        // This is the tonal difference.  You "calibrate" out the intensity.
-        int16_t tonalDiff = (tunernome->diffs_filt[i] >> SENSITIVITY) * 200 / (intensity + 1);
-
-        int32_t red, grn, blu;
-        // Is the note in tune, i.e. is the magnitude difference in surrounding bins small?
-        if( (ABS(tonalDiff) < TONAL_DIFF_IN_TUNE_DEVIATION) )
-        {
-            // Note is in tune, make it white
-            red = 255;
-            grn = 255;
-            blu = 255;
-        }
-        else
-        {
-            // Check if the note is sharp or flat
-            if( tonalDiff > 0 )
-            {
-                // Note too sharp, make it red
-                red = 255;
-                grn = blu = 255 - (tonalDiff) * 15;
-            }
-            else
-            {
-                // Note too flat, make it blue
-                blu = 255;
-                grn = red = 255 - (-tonalDiff) * 15;
-            }
-
-            // Make sure LED output isn't more than 255
-            red = CLAMP(red, INT_MIN, 255);
-            grn = CLAMP(grn, INT_MIN, 255);
-            blu = CLAMP(blu, INT_MIN, 255);
-        }
-
-        // Scale each LED's brightness by the filtered intensity for that bin
-        red = (red >> 3 ) * ( intensity >> 3);
-        grn = (grn >> 3 ) * ( intensity >> 3);
-        blu = (blu >> 3 ) * ( intensity >> 3);
-
-        // Set the LED, ensure each channel is between 0 and 255
-        colors[(stringIdxToLedIdx != NULL) ? stringIdxToLedIdx[i] : i].r = CLAMP(red, 0, 255);
-        colors[(stringIdxToLedIdx != NULL) ? stringIdxToLedIdx[i] : i].g = CLAMP(grn, 0, 255);
-        colors[(stringIdxToLedIdx != NULL) ? stringIdxToLedIdx[i] : i].b = CLAMP(blu, 0, 255);
+        colors[(stringIdxToLedIdx != NULL) ? stringIdxToLedIdx[i] : i] =
+            tunerLedColor(tunernome->gt.notes[i].cents, tunernome->gt.notes[i].amplitude);
     }
 }
 
@@ -675,19 +654,18 @@ bool ICACHE_FLASH_ATTR tunernomeRenderTask(void)
                 case SEMITONE_11:
                 default:
                 {
-                    // Draw tuner needle based on the value of tonalDiff, which is at most -32768 to 32767
-                    // clamp it to the range -180 -> 180
-                    int16_t clampedTonalDiff = CLAMP(tunernome->tonalDiff / 2, -180, 180);
+                    // Draw tuner needle based on the deviation in cents, vertical when in tune
+                    int16_t needleCents = tunernome->semitoneCents;
 
                     // If the signal isn't intense enough, don't move the needle
-                    if(tunernome->semitone_intensitiy_filt < 1000)
+                    if(tunernome->semitoneAmplitude <= TUNER_NOISE_FLOOR)
                     {
-                        clampedTonalDiff = -180;
+                        needleCents = -GT_MAX_CENTS;
                     }
 
                     // Find the end point of the unit-length needle
-                    float intermedX = sinf(clampedTonalDiff * M_PI / 360.0f );
-                    float intermedY = cosf(clampedTonalDiff * M_PI / 360.0f );
+                    float intermedX = sinf(needleCents * M_PI / (2 * GT_MAX_CENTS));
+                    float intermedY = cosf(needleCents * M_PI / (2 * GT_MAX_CENTS));
 
                     // Find the actual end point of the full-length needle
                     int x = round(METRONOME_CENTER_X + (intermedX * METRONOME_RADIUS));
@@ -885,6 +863,7 @@ void ICACHE_FLASH_ATTR tunernomeButtonCallback( uint8_t state __attribute__((unu
                     case UP:
                     {
                         tunernome->curTunerMode = (tunernome->curTunerMode + 1) % MAX_GUITAR_MODES;
+                        setTunerNotes();
                         break;
                     }
                     case DOWN:
@@ -897,6 +876,7 @@ void ICACHE_FLASH_ATTR tunernomeButtonCallback( uint8_t state __attribute__((unu
                         {
                             tunernome->curTunerMode--;
                         }
+                        setTunerNotes();
                         break;
                     }
                     case ACTION:
@@ -1030,143 +1010,80 @@ void ICACHE_FLASH_ATTR modifyBpm(int16_t bpmMod)
 }
 
 /**
- * This is called every time an audio sample is read from the ADC
- * This processes the sample and will display update the LEDs every
- * 128 samples
+ * This is called with each block of audio samples read from the ADC
+ * This runs the samples through the tuner's filters and updates the LEDs
+ * whenever a note is measured
  *
- * @param samp A 32 bit audio sample read from the ADC (microphone)
+ * @param samples    Filtered audio samples read from the ADC (microphone)
+ * @param numSamples The number of samples
  */
-void ICACHE_FLASH_ATTR tunernomeSampleHandler(int32_t samp)
+void ICACHE_FLASH_ATTR tunernomeSampleHandler(const int16_t* samples, int numSamples)
 {
-    if(tunernome->mode == TN_TUNER)
+    if(tunernome->mode != TN_TUNER || !gtPushSamples(&(tunernome->gt), samples, numSamples))
     {
-        PushSample32( samp );
-        tunernome->audioSamplesProcessed++;
-
-        // If at least 128 samples have been processed
-        if( tunernome->audioSamplesProcessed >= 128 )
-        {
-            // Don't bother if colorchord is inactive
-            if( !COLORCHORD_ACTIVE )
-            {
-                return;
-            }
-
-            // Colorchord magic
-            HandleFrameInfo();
+        return;
+    }
 
-            led_t colors[NUM_LIN_LEDS] = {{0}};
+    led_t colors[NUM_LIN_LEDS] = {{0}};
 
-            switch(tunernome->curTunerMode)
+    switch(tunernome->curTunerMode)
+    {
+        case GUITAR_TUNER:
+        {
+            instrumentTunerMagic(NUM_GUITAR_STRINGS, colors, NULL);
+            break;
+        }
+        case VIOLIN_TUNER:
+        {
+            instrumentTunerMagic(NUM_VIOLIN_STRINGS, colors, fourNoteStringIdxToLedIdx);
+            break;
+        }
+        case UKELELE_TUNER:
+        {
+            instrumentTunerMagic(NUM_UKELELE_STRINGS, colors, fourNoteStringIdxToLedIdx);
+            break;
+        }
+        case MAX_GUITAR_MODES:
+            break;
+        case SEMITONE_0:
+        case SEMITONE_1:
+        case SEMITONE_2:
+        case SEMITONE_3:
+        case SEMITONE_4:
+        case SEMITONE_5:
+        case SEMITONE_6:
+        case SEMITONE_7:
+        case SEMITONE_8:
+        case SEMITONE_9:
+        case SEMITONE_10:
+        case SEMITONE_11:
+        default:
+        {
+            // Follow whichever octave of the semitone is loudest
+            uint8_t loudest = 0;
+            uint8_t i;
+            for(i = 1; i < tunernome->gt.numNotes; i++)
             {
-                case GUITAR_TUNER:
+                if(tunernome->gt.notes[i].amplitude > tunernome->gt.notes[loudest].amplitude)
                 {
-                    instrumentTunerMagic(freqBinIdxsGuitar, NUM_GUITAR_STRINGS, colors, NULL);
-                    break;
+                    loudest = i;
                 }
-                case VIOLIN_TUNER:
-                {
-                    instrumentTunerMagic(freqBinIdxsViolin, NUM_VIOLIN_STRINGS, colors, fourNoteStringIdxToLedIdx);
-                    break;
-                }
-                case UKELELE_TUNER:
-                {
-                    instrumentTunerMagic(freqBinIdxsUkelele, NUM_UKELELE_STRINGS, colors, fourNoteStringIdxToLedIdx);
-                    break;
-                }
-                case MAX_GUITAR_MODES:
-                    break;
-                case SEMITONE_0:
-                case SEMITONE_1:
-                case SEMITONE_2:
-                case SEMITONE_3:
-                case SEMITONE_4:
-                case SEMITONE_5:
-                case SEMITONE_6:
-                case SEMITONE_7:
-                case SEMITONE_8:
-                case SEMITONE_9:
-                case SEMITONE_10:
-                case SEMITONE_11:
-                default:
-                {
-                    uint8_t semitoneIdx = (tunernome->curTunerMode - SEMITONE_0) * 2;
-                    // Pick out the current magnitude and filter it
-                    tunernome->semitone_intensitiy_filt = (getSemiMagnitude(semitoneIdx + CHROMATIC_OFFSET)  +
-                                                           tunernome->semitone_intensitiy_filt) -
-                                                          (tunernome->semitone_intensitiy_filt >> 5);
-
-                    // Pick out the difference around current magnitude and filter it too
-                    tunernome->semitone_diff_filt =       (getSemiDiffAround(semitoneIdx + CHROMATIC_OFFSET) +
-                                                           tunernome->semitone_diff_filt)       -
-                                                          (tunernome->semitone_diff_filt >> 5);
-
-                    // This is the magnitude of the target frequency bin, cleaned up
-                    int16_t intensity = (tunernome->semitone_intensitiy_filt >> SENSITIVITY) - 40; // drop a baseline.
-                    intensity = CLAMP(intensity, 0, 255);
-
-                    //This is the tonal difference.  You "calibrate" out the intensity.
-                    tunernome->tonalDiff = (tunernome->semitone_diff_filt >> SENSITIVITY) * 200 / (intensity + 1);
-
-                    // tonal diff is -32768 to 32767. if its within -10 to 10 (now defined as TONAL_DIFF_IN_TUNE_DEVIATION), it's in tune.
-                    // positive means too sharp, negative means too flat
-                    // intensity is how 'loud' that frequency is, 0 to 255. you'll have to play around with values
-                    int32_t red, grn, blu;
-                    // Is the note in tune, i.e. is the magnitude difference in surrounding bins small?
-                    if( (ABS(tunernome->tonalDiff) < TONAL_DIFF_IN_TUNE_DEVIATION) )
-                    {
-                        // Note is in tune, make it white
-                        red = 255;
-                        grn = 255;
-                        blu = 255;
-                    }
-                    else
-                    {
-                        // Check if the note is sharp or flat
-                        if( tunernome->tonalDiff > 0 )
-                        {
-                            // Note too sharp, make it red
-                            red = 255;
-                            grn = blu = 255 - (tunernome->tonalDiff - TONAL_DIFF_IN_TUNE_DEVIATION) * 15;
-                        }
-                        else
-                        {
-                            // Note too flat, make it blue
-                            blu = 255;
-                            grn = red = 255 - (-(tunernome->tonalDiff + TONAL_DIFF_IN_TUNE_DEVIATION)) * 15;
-                        }
-
-                        // Make sure LED output isn't more than 255
-                        red = CLAMP(red, INT_MIN, 255);
-                        grn = CLAMP(grn, INT_MIN, 255);
-                        blu = CLAMP(blu, INT_MIN, 255);
-                    }
-
-                    // Scale each LED's brightness by the filtered intensity for that bin
-                    red = (red >> 3 ) * ( intensity >> 3);
-                    grn = (grn >> 3 ) * ( intensity >> 3);
-                    blu = (blu >> 3 ) * ( intensity >> 3);
-
-                    // Set the LED, ensure each channel is between 0 and 255
-                    uint32_t i;
-                    for (i = 0; i < NUM_GUITAR_STRINGS; i++)
-                    {
-                        colors[i].r = CLAMP(red, 0, 255);
-                        colors[i].g = CLAMP(grn, 0, 255);
-                        colors[i].b = CLAMP(blu, 0, 255);
-                    }
-
-                    break;
-                } // default:
-            } // switch(tunernome->curTunerMode)
+            }
+            tunernome->semitoneCents = tunernome->gt.notes[loudest].cents;
+            tunernome->semitoneAmplitude = tunernome->gt.notes[loudest].amplitude;
 
-            // Draw the LEDs
-            setLeds( colors, sizeof(colors) );
+            // Set the LEDs
+            led_t ledColor = tunerLedColor(tunernome->semitoneCents, tunernome->semitoneAmplitude);
+            for (i = 0; i < NUM_GUITAR_STRINGS; i++)
+            {
+                colors[i] = ledColor;
+            }
+            break;
+        } // default:
+    } // switch(tunernome->curTunerMode)
 
-            // Reset the sample count
-            tunernome->audioSamplesProcessed = 0;
-        }
-    } // if(tunernome-> mode == TN_TUNER)
+    // Draw the LEDs
+    setLeds( colors, sizeof(colors) );
 }
 
 /**
@@ -22,6 +22,8 @@
 
 #define ACT_STRLEN 128
 #define MAX_BOUNCES 2
+// Nodes shared by the animation and marquee queues, enough for a busy turn
+#define PD_QUEUE_NODES 24
 #define CLAMP(x,min,max) ( (x) < (min) ? (min) : ((x) > (max) ? (max) : (x)) )
 
 typedef struct
@@ -121,6 +123,10 @@ typedef struct
 
     list_t marqueeTextQueue;
 
+    // Both queues take their nodes from here so they don't fragment the heap
+    node_t queueNodes[PD_QUEUE_NODES];
+    nodePool_t queuePool;
+
     menu_t* menu;
 
     bool isDisplayingRecords;
@@ -209,7 +215,7 @@ swadgeMode personalDemonMode =
     .fnEspNowRecvCb = NULL,
     .fnEspNowSendCb = NULL,
     .fnAccelerometerCallback = NULL,
-    .fnAudioCallback = NULL,
+    .fnAudioBlockCallback = NULL,
     .menuImg = "demon-menu.gif"
 };
 
@@ -270,6 +276,11 @@ void ICACHE_FLASH_ATTR personalDemonEnterMode(void)
     pd = (pd_data*)os_malloc(sizeof(pd_data));
     ets_memset(pd, 0, sizeof(pd_data));
 
+    // Set up the queues to use the mode's node pool
+    initNodePool(&pd->queuePool, pd->queueNodes, PD_QUEUE_NODES);
+    pd->animationQueue.pool = &pd->queuePool;
+    pd->marqueeTextQueue.pool = &pd->queuePool;
+
     // Try loading the demon from NVM
     getSavedDemon(&pd->demon);
 
@@ -1931,6 +1942,7 @@ void ICACHE_FLASH_ATTR initAnimDeath(void)
     pd->demonRot = 0;
     // Save demon record
     addDemonMemorial(pd->demon.name, pd->demon.actionsTaken);
+    flushSettingsNow();
 }
 
 /**
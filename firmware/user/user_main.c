@@ -25,12 +25,16 @@
 #include "nvm_interface.h"
 #include "user_main.h"
 #include "espNowUtils.h"
+#include "espNowRxQueue.h"
 #include "cnlohr_i2c.h"
 #include "oled.h"
+#include "font.h"
 #include "PartitionMap.h"
 #include "QMA6981.h"
 #include "synced_timer.h"
 #include "printControl.h"
+#include "trace.h"
+#include "led_compositor.h"
 
 #include "mode_menu.h"
 #include "mode_ddr.h"
@@ -100,6 +104,7 @@ void ICACHE_FLASH_ATTR user_pre_init(void);
 void ICACHE_FLASH_ATTR user_init(void);
 
 static void ICACHE_FLASH_ATTR procTask(os_event_t* events);
+static void ICACHE_FLASH_ATTR teardownSwadgeMode(void);
 #if defined(FEATURE_ACCEL)
     static void ICACHE_FLASH_ATTR pollAccel(void* arg);
     void ICACHE_FLASH_ATTR initializeAccelerometer(void);
@@ -173,6 +178,7 @@ void ICACHE_FLASH_ATTR user_init(void)
         // If there's a difference, reset the self-test bool
         INIT_PRINTF("New flash to %s\n", GIT_HASH);
         setGitHash(GIT_HASH);
+        flushSettingsNow();
         // Don't require a new self test every flash, but if you wanted to, uncomment this
         // setSelfTestPass(false);
     }
@@ -226,6 +232,7 @@ void ICACHE_FLASH_ATTR user_init(void)
         // Turn LEDs off
         led_t leds[NUM_LIN_LEDS] = {{0}};
         setLeds(leds, sizeof(leds));
+        ledCompFlush();
         INIT_PRINTF("LEDs initialized\n");
 #endif
 
@@ -262,7 +269,7 @@ void ICACHE_FLASH_ATTR user_init(void)
 
 #if defined(FEATURE_MIC)
         // Initialize either the buzzer or the mic
-        if(NULL != swadgeModes[rtcMem.currentSwadgeMode]->fnAudioCallback)
+        if(NULL != swadgeModes[rtcMem.currentSwadgeMode]->fnAudioBlockCallback)
         {
             initMic();
         }
@@ -315,23 +322,33 @@ static void ICACHE_FLASH_ATTR procTask(os_event_t* events __attribute__((unused)
     // Process queued button presses synchronously
     HandleButtonEventSynchronous();
 
+    // Deliver queued ESP-NOW frames synchronously
+    espNowRxProcess();
+
 #if defined(FEATURE_MIC)
-    // While there are samples available from the ADC
-    while( sampleAvailable() )
+    // While there are samples available from the ADC, take them in blocks
+    static uint32_t samp_iir = 0;
+    uint8_t rawSamples[AUDIO_BLOCK_LEN];
+    int16_t samples[AUDIO_BLOCK_LEN];
+    uint16_t numSamples;
+    while(0 < (numSamples = getSamples(rawSamples, AUDIO_BLOCK_LEN)))
     {
-        // Get the sample
-        int32_t samp = getSample();
-        // Run the sample through an IIR filter
-        static uint32_t samp_iir = 0;
-        samp_iir = samp_iir - (samp_iir >> 10) + samp;
-        samp = (samp - (samp_iir >> 10)) * 16;
-        // Amplify the sample
-        samp = (samp * CCS.gINITIAL_AMP) >> 4;
-
-        // Pass the sample to the mode
-        if(swadgeModeInit && NULL != swadgeModes[rtcMem.currentSwadgeMode]->fnAudioCallback)
+        int32_t amp = CCS.gINITIAL_AMP;
+        uint16_t i;
+        for(i = 0; i < numSamples; i++)
         {
-            swadgeModes[rtcMem.currentSwadgeMode]->fnAudioCallback(samp);
+            int32_t samp = rawSamples[i];
+            // Run the sample through an IIR filter
+            samp_iir = samp_iir - (samp_iir >> 10) + samp;
+            samp = (samp - (samp_iir >> 10)) * 16;
+            // Amplify the sample
+            samples[i] = (samp * amp) >> 4;
+        }
+
+        // Pass the block to the mode
+        if(swadgeModeInit && NULL != swadgeModes[rtcMem.currentSwadgeMode]->fnAudioBlockCallback)
+        {
+            swadgeModes[rtcMem.currentSwadgeMode]->fnAudioBlockCallback(samples, numSamples);
         }
     }
 #endif
@@ -345,6 +362,9 @@ static void ICACHE_FLASH_ATTR procTask(os_event_t* events __attribute__((unused)
         swadgeModes[rtcMem.currentSwadgeMode]->fnProcTask();
     }
 
+    // Push the LEDs if they changed, or if they're being dithered
+    ledCompUpdate();
+
 #if defined(FEATURE_OLED)
     // Track if the full frame, or difference should be drawn
     static bool shouldDrawDifference = true;
@@ -359,7 +379,9 @@ static void ICACHE_FLASH_ATTR procTask(os_event_t* events __attribute__((unused)
 
         if(swadgeModeInit && NULL != swadgeModes[rtcMem.currentSwadgeMode]->fnRenderTask)
         {
+            traceBegin("fnRenderTask");
             forceFullUpdate = swadgeModes[rtcMem.currentSwadgeMode]->fnRenderTask();
+            traceEnd("fnRenderTask");
         }
 
         // If we should draw the whole frame, reinit the OLED first
@@ -390,6 +412,11 @@ static void ICACHE_FLASH_ATTR procTask(os_event_t* events __attribute__((unused)
                 break;
             }
         }
+
+#if defined(EMU)
+        // Let the emulator's mode test check this frame
+        emuModeTestFrame();
+#endif
     }
 #endif
 }
@@ -463,16 +490,10 @@ void ExitCritical(void)
  *==========================================================================*/
 
 /**
- * This deinitializes the current mode if it is initialized, displays the next
- * mode's LED pattern, and starts a timer to reboot into the next mode.
- * If the reboot timer is running, it will be reset
- *
+ * Deinitialize the current mode if it is initialized. Its LEDs are turned off,
+ * its settings are written, and its wifi is shut down
  */
-#if defined(FEATURE_OLED)
-    void ICACHE_FLASH_ATTR switchToSwadgeMode(uint8_t newMode)
-#else
-    void ICACHE_FLASH_ATTR incrementSwadgeMode(void)
-#endif
+static void ICACHE_FLASH_ATTR teardownSwadgeMode(void)
 {
     // If the mode is initialized, tear it down
     if(swadgeModeInit)
@@ -480,11 +501,18 @@ void ExitCritical(void)
         // Turn LEDs off
         led_t leds[NUM_LIN_LEDS] = {{0}};
         setLeds(leds, sizeof(leds));
+        ledCompFlush();
         // Call the exit callback for the current mode
         if(NULL != swadgeModes[rtcMem.currentSwadgeMode]->fnExitMode)
         {
             swadgeModes[rtcMem.currentSwadgeMode]->fnExitMode();
         }
+#if defined(FEATURE_OLED)
+        // The mode's strings are gone, so is the text it drew
+        textCacheClear();
+#endif
+        // Write anything the mode saved before it's lost to the reboot
+        flushSettingsNow();
 
         // Clean up ESP NOW if that's where we were at
         switch(swadgeModes[rtcMem.currentSwadgeMode]->wifiMode)
@@ -508,6 +536,21 @@ void ExitCritical(void)
         }
         swadgeModeInit = false;
     }
+}
+
+/**
+ * This deinitializes the current mode if it is initialized, displays the next
+ * mode's LED pattern, and starts a timer to reboot into the next mode.
+ * If the reboot timer is running, it will be reset
+ *
+ */
+#if defined(FEATURE_OLED)
+    void ICACHE_FLASH_ATTR switchToSwadgeMode(uint8_t newMode)
+#else
+    void ICACHE_FLASH_ATTR incrementSwadgeMode(void)
+#endif
+{
+    teardownSwadgeMode();
 
     // Switch to the next mode, or start from the beginning if we're at the end
 #if defined(FEATURE_OLED)
@@ -522,6 +565,8 @@ void ExitCritical(void)
     system_rtc_mem_write(RTC_MEM_ADDR, &rtcMem, sizeof(rtcMem));
     user_init();
 #else
+    // Dump the last mode's timeline before it's lost to deep sleep
+    traceDumpUart();
     enterDeepSleep(swadgeModes[rtcMem.currentSwadgeMode]->wifiMode, 1000);
 #endif
 }
@@ -532,10 +577,7 @@ void ExitCritical(void)
  */
 void ICACHE_FLASH_ATTR exitCurrentSwadgeMode(void)
 {
-    if(NULL != swadgeModes[rtcMem.currentSwadgeMode]->fnExitMode)
-    {
-        swadgeModes[rtcMem.currentSwadgeMode]->fnExitMode();
-    }
+    teardownSwadgeMode();
 #if defined(FEATURE_ACCEL)
     timerDisarm(&timerHandlePollAccel);
 #endif
@@ -552,6 +594,9 @@ void ICACHE_FLASH_ATTR exitCurrentSwadgeMode(void)
  */
 void ICACHE_FLASH_ATTR enterDeepSleep(wifiMode_t wifiMode, uint32_t timeUs)
 {
+    // Write any changed settings, RAM is lost in deep sleep
+    flushSettingsNow();
+
     // Write the RTC memory so it knows what mode to be in when waking up
     system_rtc_mem_write(RTC_MEM_ADDR, &rtcMem, sizeof(rtcMem));
 
@@ -666,7 +711,7 @@ void ICACHE_FLASH_ATTR swadgeModeButtonCallback(uint8_t state, int button, int d
 }
 
 /**
- * Callback from ESP NOW to the current Swadge mode whenever a packet is received
+ * Called from procTask() with each queued ESP NOW packet, see espNowRxProcess()
  * It routes through user_main.c, which knows what the current mode is
  */
 void ICACHE_FLASH_ATTR swadgeModeEspNowRecvCb(uint8_t* mac_addr, uint8_t* data, uint8_t len, uint8_t rssi)
@@ -696,8 +741,8 @@ void ICACHE_FLASH_ATTR swadgeModeEspNowSendCb(uint8_t* mac_addr, mt_tx_status st
  *==========================================================================*/
 
 /**
- * Set the state of the six GRB LEDs, but don't overwrite if the LEDs were
- * set via UDP for at least TICKER_TIMEOUT increments of 100ms
+ * Set the state of the six GRB LEDs. This sets the mode's layer of the LED
+ * compositor, and the LEDs are updated from procTask() if the frame changed
  *
  * @param ledData Array of LED color data. Every three bytes corresponds to
  * one LED in GRB order. So index 0 is LED1_G, index 1 is
@@ -706,7 +751,7 @@ void ICACHE_FLASH_ATTR swadgeModeEspNowSendCb(uint8_t* mac_addr, mt_tx_status st
  */
 void ICACHE_FLASH_ATTR setLeds(led_t* ledData, uint16_t ledDataLen)
 {
-    ws2812_push( (uint8_t*) ledData, ledDataLen );
+    ledCompSetLayer(LED_LAYER_MODE, ledData, ledDataLen);
 }
 
 /**
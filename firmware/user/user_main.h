@@ -27,6 +27,9 @@
     #define ROMSTR_ATTR
 #endif
 
+// The most audio samples passed to a mode's fnAudioBlockCallback() at once
+#define AUDIO_BLOCK_LEN 64
+
 /*============================================================================
  * Includes
  *==========================================================================*/
@@ -121,12 +124,15 @@ typedef struct _swadgeMode
      */
     void (*fnButtonCallback)(uint8_t state, int button, int down);
     /**
-     * This function is called whenever an audio sample is read from the
-     * microphone (ADC), is filtered, and is ready for processing
+     * This function is called from procTask() with the audio samples read
+     * from the microphone (ADC) since the last call, once they are filtered
+     * and ready for processing. Samples come in blocks of up to
+     * AUDIO_BLOCK_LEN, oldest first
      *
-     * @param audoSample A 32 bit audio sample
+     * @param samples    The filtered audio samples
+     * @param numSamples The number of samples, at least 1
      */
-    void (*fnAudioCallback)(int32_t audoSample);
+    void (*fnAudioBlockCallback)(const int16_t* samples, int numSamples);
     /**
      * This is a setting, not a function pointer. Set it to one of these
      * values to have the system configure the swadge's WiFi
@@ -203,6 +209,8 @@ uint8_t ICACHE_FLASH_ATTR getSwadgeModes(swadgeMode***  modePtr);
 void ICACHE_FLASH_ATTR switchToSwadgeMode(uint8_t newMode);
 #if defined(EMU)
     void ICACHE_FLASH_ATTR exitCurrentSwadgeMode(void);
+    // Implemented by the emulator's mode test
+    void emuModeTestFrame(void);
 #endif
 
 #if defined(FEATURE_ACCEL)
@@ -6,6 +6,8 @@
 #include "fastlz.h"
 #include "user_main.h"
 #include "printControl.h"
+#include "trace.h"
+#include "fixed_math.h"
 #if defined(EMU)
     #include <stdio.h>
     #ifdef ANDROID
@@ -19,70 +21,8 @@
 
 #if defined(FEATURE_OLED)
 
-const uint32_t sin1024[] RODATA_ATTR =
-{
-    0, 18, 36, 54, 71, 89, 107, 125, 143, 160, 178, 195, 213,
-    230, 248, 265, 282, 299, 316, 333, 350, 367, 384, 400, 416, 433, 449, 465, 481,
-    496, 512, 527, 543, 558, 573, 587, 602, 616, 630, 644, 658, 672, 685, 698, 711,
-    724, 737, 749, 761, 773, 784, 796, 807, 818, 828, 839, 849, 859, 868, 878, 887,
-    896, 904, 912, 920, 928, 935, 943, 949, 956, 962, 968, 974, 979, 984, 989, 994,
-    998, 1002, 1005, 1008, 1011, 1014, 1016, 1018, 1020, 1022, 1023, 1023, 1024,
-    1024, 1024, 1023, 1023, 1022, 1020, 1018, 1016, 1014, 1011, 1008, 1005, 1002, 998,
-    994, 989, 984, 979, 974, 968, 962, 956, 949, 943, 935, 928, 920, 912, 904, 896,
-    887, 878, 868, 859, 849, 839, 828, 818, 807, 796, 784, 773, 761, 749, 737, 724,
-    711, 698, 685, 672, 658, 644, 630, 616, 602, 587, 573, 558, 543, 527, 512, 496,
-    481, 465, 449, 433, 416, 400, 384, 367, 350, 333, 316, 299, 282, 265, 248, 230,
-    213, 195, 178, 160, 143, 125, 107, 89, 71, 54, 36, 18, 0, -18, -36, -54, -71,
-    -89, -107, -125, -143, -160, -178, -195, -213, -230, -248, -265, -282, -299, -316,
-    -333, -350, -367, -384, -400, -416, -433, -449, -465, -481, -496, -512, -527,
-    -543, -558, -573, -587, -602, -616, -630, -644, -658, -672, -685, -698, -711,
-    -724, -737, -749, -761, -773, -784, -796, -807, -818, -828, -839, -849, -859, -868,
-    -878, -887, -896, -904, -912, -920, -928, -935, -943, -949, -956, -962, -968,
-    -974, -979, -984, -989, -994, -998, -1002, -1005, -1008, -1011, -1014, -1016,
-    -1018, -1020, -1022, -1023, -1023, -1024, -1024, -1024, -1023, -1023, -1022, -1020,
-    -1018, -1016, -1014, -1011, -1008, -1005, -1002, -998, -994, -989, -984, -979,
-    -974, -968, -962, -956, -949, -943, -935, -928, -920, -912, -904, -896, -887,
-    -878, -868, -859, -849, -839, -828, -818, -807, -796, -784, -773, -761, -749,
-    -737, -724, -711, -698, -685, -672, -658, -644, -630, -616, -602, -587, -573, -558,
-    -543, -527, -512, -496, -481, -465, -449, -433, -416, -400, -384, -367, -350,
-    -333, -316, -299, -282, -265, -248, -230, -213, -195, -178, -160, -143, -125,
-    -107, -89, -71, -54, -36, -18
-};
-
-const uint32_t tan1024[] RODATA_ATTR =
-{
-    0, 18, 36, 54, 72, 90, 108, 126, 144, 162, 181, 199, 218, 236, 255, 274, 294,
-    313, 333, 353, 373, 393, 414, 435, 456, 477, 499, 522, 544, 568, 591, 615,
-    640, 665, 691, 717, 744, 772, 800, 829, 859, 890, 922, 955, 989, 1024, 1060,
-    1098, 1137, 1178, 1220, 1265, 1311, 1359, 1409, 1462, 1518, 1577, 1639, 1704,
-    1774, 1847, 1926, 2010, 2100, 2196, 2300, 2412, 2534, 2668, 2813, 2974,
-    3152, 3349, 3571, 3822, 4107, 4435, 4818, 5268, 5807, 6465, 7286, 8340, 9743,
-    11704, 14644, 19539, 29324, 58665, 67108863, -58665, -29324, -19539, -14644,
-    -11704, -9743, -8340, -7286, -6465, -5807, -5268, -4818, -4435, -4107, -3822,
-    -3571, -3349, -3152, -2974, -2813, -2668, -2534, -2412, -2300, -2196, -2100,
-    -2010, -1926, -1847, -1774, -1704, -1639, -1577, -1518, -1462, -1409,
-    -1359, -1311, -1265, -1220, -1178, -1137, -1098, -1060, -1024, -989, -955,
-    -922, -890, -859, -829, -800, -772, -744, -717, -691, -665, -640, -615, -591,
-    -568, -544, -522, -499, -477, -456, -435, -414, -393, -373, -353, -333, -313,
-    -294, -274, -255, -236, -218, -199, -181, -162, -144, -126, -108, -90, -72,
-    -54, -36, -18, 0, 18, 36, 54, 72, 90, 108, 126, 144, 162, 181, 199, 218,
-    236, 255, 274, 294, 313, 333, 353, 373, 393, 414, 435, 456, 477, 499, 522,
-    544, 568, 591, 615, 640, 665, 691, 717, 744, 772, 800, 829, 859, 890, 922, 955,
-    989, 1024, 1060, 1098, 1137, 1178, 1220, 1265, 1311, 1359, 1409, 1462,
-    1518, 1577, 1639, 1704, 1774, 1847, 1926, 2010, 2100, 2196, 2300, 2412, 2534,
-    2668, 2813, 2974, 3152, 3349, 3571, 3822, 4107, 4435, 4818, 5268, 5807, 6465,
-    7286, 8340, 9743, 11704, 14644, 19539, 29324, 58665, 67108863, -58665, -29324,
-    -19539, -14644, -11704, -9743, -8340, -7286, -6465, -5807, -5268, -4818,
-    -4435, -4107, -3822, -3571, -3349, -3152, -2974, -2813, -2668, -2534, -2412,
-    -2300, -2196, -2100, -2010, -1926, -1847, -1774, -1704, -1639, -1577, -1518,
-    -1462, -1409, -1359, -1311, -1265, -1220, -1178, -1137, -1098, -1060, -1024,
-    -989, -955, -922, -890, -859, -829, -800, -772, -744, -717, -691, -665,
-    -640, -615, -591, -568, -544, -522, -499, -477, -456, -435, -414, -393, -373,
-    -353, -333, -313, -294, -274, -255, -236, -218, -199, -181, -162, -144, -126,
-    -108, -90, -72, -54, -36, -18
-};
-
 void ICACHE_FLASH_ATTR gifTimerFn(void* arg);
+static void ICACHE_FLASH_ATTR decodeGifFrame(gifHandle* handle, bool drawNext);
 void ICACHE_FLASH_ATTR transformPixel(int16_t* x, int16_t* y, int16_t transX,
                                       int16_t transY, bool flipLR, bool flipUD,
                                       int16_t rotateDeg, int16_t width, int16_t height);
@@ -243,12 +183,29 @@ void transformPixel(int16_t* x, int16_t* y, int16_t transX,
         // if(rotateDeg > 1 && rotateDeg < 89)
         if(rotateDeg > 0)
         {
+            // The shears are tan(angle / 2) and sin(angle), scaled by 1024. They
+            // only change with the angle, so they're found once per angle, not
+            // once per pixel
+            static int16_t shearDeg = 0;
+            static int32_t shearTan = 0;
+            static int32_t shearSin = 0;
+            if(rotateDeg != shearDeg)
+            {
+                uint16_t angle = fxDegToAngle(rotateDeg);
+                int32_t halfCos = fxCos(angle / 2);
+                shearTan = ((fxSin(angle / 2) << 10) + (halfCos / 2)) / halfCos;
+                shearSin = (fxSin(angle) + 8) >> 4;
+                shearDeg = rotateDeg;
+            }
+
+            // Shift rather than divide, so negative coordinates round down
+            // like positive ones instead of towards zero
             // 1st shear
-            (*x) = (*x) - (((*y) * tan1024[rotateDeg / 2]) + 512) / 1024;
+            (*x) = (*x) - ((((*y) * shearTan) + 512) >> 10);
             // 2nd shear
-            (*y) = (((*x) * sin1024[rotateDeg]) + 512) / 1024 + (*y);
+            (*y) = ((((*x) * shearSin) + 512) >> 10) + (*y);
             // 3rd shear
-            (*x) = (*x) - (((*y) * tan1024[rotateDeg / 2]) + 512) / 1024;
+            (*x) = (*x) - ((((*y) * shearTan) + 512) >> 10);
         }
 
         // Return pixel to original position
@@ -349,6 +306,8 @@ void ICACHE_FLASH_ATTR freePngAsset(pngHandle* handle)
 void ICACHE_FLASH_ATTR drawPng(pngHandle* handle, int16_t xp,
                                int16_t yp, bool flipLR, bool flipUD, int16_t rotateDeg)
 {
+    TRACE_SCOPE("drawPng");
+
     uint32_t idx = 0;
 
     // Read 32 bits at a time
@@ -610,6 +569,35 @@ void ICACHE_FLASH_ATTR loadGifFromAsset(const char* name, gifHandle* handle)
     }
 }
 
+/**
+ * Load a gif from assets and decompress its first frame, without drawing it.
+ * Only the frame is kept, so the handle takes about a third of the memory, but
+ * it can only be drawn with drawNext false
+ *
+ * @param name The name of the asset to load
+ * @param handle A handle to load the gif to, which must be uninitialized
+ * @return true if the frame was loaded, false if the asset wasn't found or
+ *         there wasn't memory for it
+ */
+bool ICACHE_FLASH_ATTR loadGifFirstFrame(const char* name, gifHandle* handle)
+{
+    loadGifFromAsset(name, handle);
+    if(NULL == handle->compressed || NULL == handle->decompressed || NULL == handle->frame)
+    {
+        freeGifAsset(handle);
+        return false;
+    }
+
+    decodeGifFrame(handle, false);
+
+    // The first frame is decompressed straight to the frame, so these are done
+    os_free(handle->compressed);
+    os_free(handle->decompressed);
+    handle->compressed = NULL;
+    handle->decompressed = NULL;
+    return true;
+}
+
 /**
  * Free all the memory allocated for a gif
  *
@@ -626,19 +614,13 @@ void ICACHE_FLASH_ATTR freeGifAsset(gifHandle* handle)
 }
 
 /**
- * Draw a frame of a gif to the screen
+ * Decompress a gif's next frame into handle->frame, if it needs to be
  *
- * @param handle A handle to the gif to draw
- * @param xp The x coordinate to draw the asset at
- * @param yp The y coordinate to draw the asset at
- * @param flipLR true to flip over the Y axis, false to do nothing
- * @param flipUD true to flip over the X axis, false to do nothing
- * @param rotateDeg The number of degrees to rotate clockwise, must be 0-359
- * @param drawNext true to draw the next frame, false to draw the same frame again
+ * @param handle A handle to the gif to decompress
+ * @param drawNext true to move to the next frame, false to only decompress
+ *                 the first frame if it hasn't been yet
  */
-void ICACHE_FLASH_ATTR drawGifFromAsset(gifHandle* handle, int16_t xp, int16_t yp,
-                                        bool flipLR, bool flipUD, int16_t rotateDeg,
-                                        bool drawNext)
+static void ICACHE_FLASH_ATTR decodeGifFrame(gifHandle* handle, bool drawNext)
 {
     if(drawNext || false == handle->firstFrameLoaded)
     {
@@ -690,6 +672,24 @@ void ICACHE_FLASH_ATTR drawGifFromAsset(gifHandle* handle, int16_t xp, int16_t y
         }
         handle->firstFrameLoaded = true;
     }
+}
+
+/**
+ * Draw a frame of a gif to the screen
+ *
+ * @param handle A handle to the gif to draw
+ * @param xp The x coordinate to draw the asset at
+ * @param yp The y coordinate to draw the asset at
+ * @param flipLR true to flip over the Y axis, false to do nothing
+ * @param flipUD true to flip over the X axis, false to do nothing
+ * @param rotateDeg The number of degrees to rotate clockwise, must be 0-359
+ * @param drawNext true to draw the next frame, false to draw the same frame again
+ */
+void ICACHE_FLASH_ATTR drawGifFromAsset(gifHandle* handle, int16_t xp, int16_t yp,
+                                        bool flipLR, bool flipUD, int16_t rotateDeg,
+                                        bool drawNext)
+{
+    decodeGifFrame(handle, drawNext);
 
     // Draw the current frame to the OLED
     int16_t h, w;
@@ -60,6 +60,7 @@ typedef struct
 } gifHandle;
 
 void loadGifFromAsset(const char* name, gifHandle* handle);
+bool loadGifFirstFrame(const char* name, gifHandle* handle);
 void drawGifFromAsset(gifHandle* handle, int16_t xp, int16_t yp,
                       bool flipLR, bool flipUD, int16_t rotateDeg, bool drawNext);
 void freeGifAsset(gifHandle* handle);
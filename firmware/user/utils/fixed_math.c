@@ -0,0 +1,317 @@
+/*
+ * fixed_math.c
+ *
+ * See fixed_math.h
+ */
+
+/*============================================================================
+ * Includes
+ *==========================================================================*/
+
+#include <osapi.h>
+
+#include "user_main.h"
+#include "fixed_math.h"
+
+/*============================================================================
+ * Variables
+ *==========================================================================*/
+
+// The tables are read 32 bits at a time from flash, so each word holds two
+// 16 bit entries, lowest first. They were generated by the program below
+
+// sin() in Q14 for a quarter turn in 256 steps, both ends included
+static const uint32_t sinQuarter[129] RODATA_ATTR =
+{
+    0x00650000, 0x012E00C9, 0x01F70192, 0x02C0025B, 0x03880324, 0x045103ED, 0x051A04B5, 0x05E2057E,
+    0x06AA0646, 0x0772070E, 0x083907D6, 0x0901089D, 0x09C70964, 0x0A8E0A2B, 0x0B540AF1, 0x0C1A0BB7,
+    0x0CDF0C7C, 0x0DA40D41, 0x0E680E06, 0x0F2B0ECA, 0x0FEE0F8D, 0x10B11050, 0x11731112, 0x123411D3,
+    0x12F41294, 0x13B41354, 0x14731413, 0x153114D2, 0x15EE1590, 0x16AB164C, 0x17661709, 0x182117C4,
+    0x18DB187E, 0x19931937, 0x1A4B19EF, 0x1B021AA7, 0x1BB81B5D, 0x1C6C1C12, 0x1D201CC6, 0x1DD31D79,
+    0x1E841E2B, 0x1F341EDC, 0x1FE31F8C, 0x2091203A, 0x213D20E7, 0x21E82193, 0x2292223D, 0x233B22E7,
+    0x23E2238E, 0x24882435, 0x252C24DA, 0x25CF257E, 0x26712620, 0x271126C1, 0x27AF2760, 0x284C27FE,
+    0x28E7289A, 0x29812935, 0x2A1A29CE, 0x2AB02A65, 0x2B452AFB, 0x2BD82B8F, 0x2C6A2C21, 0x2CFA2CB2,
+    0x2D882D41, 0x2E152DCF, 0x2E9F2E5A, 0x2F282EE4, 0x2FAF2F6C, 0x30342FF2, 0x30B83076, 0x313930F9,
+    0x31B93179, 0x323631F8, 0x32B23274, 0x332C32EF, 0x33A33368, 0x341933DF, 0x348D3453, 0x34FF34C6,
+    0x356E3537, 0x35DC35A5, 0x36483612, 0x36B1367D, 0x371836E5, 0x377E374B, 0x37E137B0, 0x38423812,
+    0x38A13871, 0x38FD38CF, 0x3958392B, 0x39B03984, 0x3A0639DB, 0x3A593A30, 0x3AAB3A82, 0x3AFA3AD3,
+    0x3B473B21, 0x3B923B6D, 0x3BDA3BB6, 0x3C203BFD, 0x3C643C42, 0x3CA53C85, 0x3CE43CC5, 0x3D213D03,
+    0x3D5B3D3F, 0x3D933D78, 0x3DC93DAF, 0x3DFC3DE3, 0x3E2D3E15, 0x3E5C3E45, 0x3E883E72, 0x3EB13E9D,
+    0x3ED83EC5, 0x3EFD3EEB, 0x3F203F0F, 0x3F403F30, 0x3F5D3F4F, 0x3F783F6B, 0x3F913F85, 0x3FA73F9C,
+    0x3FBB3FB1, 0x3FCC3FC4, 0x3FDB3FD4, 0x3FE73FE1, 0x3FF13FEC, 0x3FF83FF5, 0x3FFD3FFB, 0x40003FFF,
+    0x00004000,
+};
+
+// atan() for ratios from 0 to 1 in 64 steps, as binary angles
+static const uint32_t atanOctant[33] RODATA_ATTR =
+{
+    0x00A30000, 0x01E90146, 0x032D028B, 0x047003CF, 0x05B10511, 0x06EF0651, 0x082A078D, 0x096108C6,
+    0x0A9409FB, 0x0BC20B2C, 0x0CEB0C57, 0x0E0F0D7D, 0x0F2C0E9E, 0x10440FB9, 0x115610CE, 0x126111DC,
+    0x136612E4, 0x146413E6, 0x155B14E0, 0x164C15D5, 0x173716C2, 0x181B17AA, 0x18F8188A, 0x19CF1964,
+    0x1A9F1A38, 0x1B6A1B05, 0x1C2E1BCD, 0x1CED1C8E, 0x1DA51D4A, 0x1E581DFF, 0x1F061EB0, 0x1FAE1F5A,
+    0x00002000,
+};
+
+/** The above tables were created using the following code:
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+
+void printPacked(const char* name, int32_t* vals, int n)
+{
+    int i;
+    printf("static const uint32_t %s[%d] RODATA_ATTR =\n{", name, (n + 1) / 2);
+    for(i = 0; i < n; i += 2)
+    {
+        if(!(i & 0xF))
+        {
+            printf("\n    ");
+        }
+        uint32_t hi = (i + 1 < n) ? (uint16_t)vals[i + 1] : 0;
+        printf("0x%08X,%s", (hi << 16) | (uint16_t)vals[i], ((i + 2) & 0xF) && (i + 2 < n) ? " " : "");
+    }
+    printf("\n};\n\n");
+}
+
+int main()
+{
+    int32_t sinQ14[257];
+    int32_t atanTbl[65];
+    int i;
+    for(i = 0; i <= 256; i++)
+    {
+        sinQ14[i] = lround(sin(i * M_PI / 512) * 16384);
+    }
+    for(i = 0; i <= 64; i++)
+    {
+        atanTbl[i] = lround(atan(i / 64.0) * 65536 / (2 * M_PI));
+    }
+    printPacked("sinQuarter", sinQ14, 257);
+    printPacked("atanOctant", atanTbl, 65);
+    return 0;
+} */
+
+/*============================================================================
+ * Prototypes
+ *==========================================================================*/
+
+static uint16_t ICACHE_FLASH_ATTR packedEntry(const uint32_t* table, uint16_t idx);
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * @param table A table with two 16 bit entries per word
+ * @param idx   The entry to read
+ * @return The entry
+ */
+static uint16_t ICACHE_FLASH_ATTR packedEntry(const uint32_t* table, uint16_t idx)
+{
+    return (table[idx >> 1] >> ((idx & 1) * 16)) & 0xFFFF;
+}
+
+/**
+ * Interpolated sine, accurate to about one Q14 LSB
+ *
+ * @param angle The angle, 65536 to a full turn
+ * @return sin(angle), from -FX_ONE to FX_ONE
+ */
+int16_t ICACHE_FLASH_ATTR fxSin(uint16_t angle)
+{
+    // Fold the angle into the first quarter turn, mirrored for the second and
+    // fourth quarters
+    uint16_t pos = angle & (FX_ANGLE_90 - 1);
+    if(angle & FX_ANGLE_90)
+    {
+        pos = FX_ANGLE_90 - pos;
+    }
+
+    uint16_t idx = pos >> 6;
+    uint8_t frac = pos & 0x3F;
+    int32_t val = packedEntry(sinQuarter, idx);
+    if(frac)
+    {
+        val += ((packedEntry(sinQuarter, idx + 1) - val) * frac + 32) >> 6;
+    }
+    return (angle & FX_ANGLE_180) ? -val : val;
+}
+
+/**
+ * @param angle The angle, 65536 to a full turn
+ * @return cos(angle), from -FX_ONE to FX_ONE
+ */
+int16_t ICACHE_FLASH_ATTR fxCos(uint16_t angle)
+{
+    return fxSin(angle + FX_ANGLE_90);
+}
+
+/**
+ * @param deg An angle in degrees, any value
+ * @return The same angle, 65536 to a full turn
+ */
+uint16_t ICACHE_FLASH_ATTR fxDegToAngle(int32_t deg)
+{
+    deg %= 360;
+    if(deg < 0)
+    {
+        deg += 360;
+    }
+    // Multiply by 2^32 / 360, then round to 16 bits
+    return ((uint32_t)deg * 11930465 + 0x8000) >> 16;
+}
+
+/**
+ * The angle of the vector (x, y), counterclockwise from the positive x axis.
+ * Only the ratio of x and y matters, so they may be in any fixed point format.
+ * This takes one division
+ *
+ * @param y The y component of the vector
+ * @param x The x component of the vector
+ * @return The angle, 65536 to a full turn, or 0 for (0, 0)
+ */
+uint16_t ICACHE_FLASH_ATTR fxAtan2(int32_t y, int32_t x)
+{
+    uint32_t ax = (x < 0) ? 0 - (uint32_t)x : (uint32_t)x;
+    uint32_t ay = (y < 0) ? 0 - (uint32_t)y : (uint32_t)y;
+    if(0 == ax && 0 == ay)
+    {
+        return 0;
+    }
+
+    // Keep the ratio below from overflowing
+    while((ax | ay) > 0xFFFF)
+    {
+        ax >>= 1;
+        ay >>= 1;
+    }
+
+    // Find the angle in the first octant from the smaller component over the
+    // larger one, a ratio from 0 to 1 in 0.16 fixed point
+    uint32_t ratio = (ay <= ax) ? (ay << 16) / ax : (ax << 16) / ay;
+    uint16_t idx = ratio >> 10;
+    uint16_t frac = ratio & 0x3FF;
+    int32_t angle = packedEntry(atanOctant, idx);
+    if(frac)
+    {
+        angle += ((packedEntry(atanOctant, idx + 1) - angle) * frac + 512) >> 10;
+    }
+
+    // Then unfold it into the right octant and quadrant
+    if(ay > ax)
+    {
+        angle = FX_ANGLE_90 - angle;
+    }
+    if(x < 0)
+    {
+        angle = FX_ANGLE_180 - angle;
+    }
+    if(y < 0)
+    {
+        angle = -angle;
+    }
+    return (uint16_t)angle;
+}
+
+/**
+ * Integer square root, rounded down. Two bits of the root are found each
+ * iteration, starting from the highest set bit
+ *
+ * @param x The number to find the root of
+ * @return floor(sqrt(x))
+ */
+uint16_t ICACHE_FLASH_ATTR fxSqrt(uint32_t x)
+{
+    if(0 == x)
+    {
+        return 0;
+    }
+
+    // Start from the highest power of four at or below x
+    uint32_t one = 1UL << ((31 - __builtin_clz(x)) & ~1);
+    uint32_t res = 0;
+    while(one != 0)
+    {
+        if(x >= res + one)
+        {
+            x -= res + one;
+            res += one << 1;
+        }
+        res >>= 1;
+        one >>= 2;
+    }
+    return res;
+}
+
+/**
+ * Integer square root, rounded to the nearest integer
+ *
+ * @param x The number to find the root of
+ * @return sqrt(x), rounded, at most 0xFFFF
+ */
+uint16_t ICACHE_FLASH_ATTR fxSqrtRounded(uint32_t x)
+{
+    uint32_t res = fxSqrt(x);
+    // The root is past the halfway point when x > (res + 0.5)^2
+    if(x - res * res > res && res < 0xFFFF)
+    {
+        res++;
+    }
+    return res;
+}
+
+/**
+ * Integer square root of a 64 bit number, rounded down. 64 bit math is slow
+ * on the ESP8266, so anything which fits in 32 bits is passed to fxSqrt()
+ *
+ * @param x The number to find the root of
+ * @return floor(sqrt(x))
+ */
+uint32_t ICACHE_FLASH_ATTR fxSqrt64(uint64_t x)
+{
+    if(x <= 0xFFFFFFFF)
+    {
+        return fxSqrt(x);
+    }
+
+    // The same as fxSqrt(), with 64 bit arithmetic
+    uint64_t one = 1ULL << ((63 - __builtin_clzll(x)) & ~1);
+    uint64_t res = 0;
+    while(one != 0)
+    {
+        if(x >= res + one)
+        {
+            x -= res + one;
+            res += one << 1;
+        }
+        res >>= 1;
+        one >>= 2;
+    }
+    return res;
+}
+
+/**
+ * Reciprocal square root. For a Q2n input, the output is Q(30 - n), i.e. a
+ * Q16 input gives a Q22 output
+ *
+ * @param x The number to find the reciprocal root of, not zero
+ * @return (1 << 30) / sqrt(x), or 0xFFFFFFFF for 0
+ */
+uint32_t ICACHE_FLASH_ATTR fxRsqrt(uint32_t x)
+{
+    if(0 == x)
+    {
+        return 0xFFFFFFFF;
+    }
+
+    // Normalize x by an even shift, so its root is scaled by a whole power of
+    // two and has the full 16 bits of precision
+    uint8_t shift = __builtin_clz(x) & ~1;
+    uint32_t root = fxSqrt(x << shift);
+
+    // sqrt(x) is root / 2^(shift / 2), so 2^30 / sqrt(x) is
+    // (2^31 / root) * 2^(shift / 2 - 1)
+    uint32_t rsqrt = 0x80000000UL / root;
+    shift /= 2;
+    return shift ? rsqrt << (shift - 1) : rsqrt >> 1;
+}
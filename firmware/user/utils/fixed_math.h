@@ -0,0 +1,45 @@
+/*
+ * fixed_math.h
+ *
+ * Integer trig and square roots, for code which would otherwise call soft
+ * float functions like sinf(), acosf() or sqrtf().
+ *
+ * Angles are uint16_t binary angles, 65536 to a full turn, so they wrap around
+ * for free. Sines and cosines are Q14, so FX_ONE is 1.0 and a product of two
+ * still fits in an int32_t.
+ */
+
+#ifndef _FIXED_MATH_H_
+#define _FIXED_MATH_H_
+
+#include <osapi.h>
+#include <c_types.h>
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+// 1.0 in Q14, what fxSin() returns for FX_ANGLE_90
+#define FX_ONE 16384
+
+#define FX_ANGLE_90  0x4000
+#define FX_ANGLE_180 0x8000
+#define FX_ANGLE_270 0xC000
+
+// Convert a binary angle to radians, for code which still works in float
+#define FX_ANGLE_TO_RAD(a) ((a) * (float)(6.283185307179586 / 65536))
+
+/*============================================================================
+ * Prototypes
+ *==========================================================================*/
+
+int16_t ICACHE_FLASH_ATTR fxSin(uint16_t angle);
+int16_t ICACHE_FLASH_ATTR fxCos(uint16_t angle);
+uint16_t ICACHE_FLASH_ATTR fxDegToAngle(int32_t deg);
+uint16_t ICACHE_FLASH_ATTR fxAtan2(int32_t y, int32_t x);
+uint16_t ICACHE_FLASH_ATTR fxSqrt(uint32_t x);
+uint16_t ICACHE_FLASH_ATTR fxSqrtRounded(uint32_t x);
+uint32_t ICACHE_FLASH_ATTR fxSqrt64(uint64_t x);
+uint32_t ICACHE_FLASH_ATTR fxRsqrt(uint32_t x);
+
+#endif
@@ -0,0 +1,198 @@
+/*
+ * gif_cache.c
+ *
+ * See gif_cache.h
+ */
+
+/*============================================================================
+ * Includes
+ *==========================================================================*/
+
+#include <osapi.h>
+
+#include "assets.h"
+#include "gif_cache.h"
+
+/*============================================================================
+ * Prototypes
+ *==========================================================================*/
+
+static bool ICACHE_FLASH_ATTR gifCacheIsDrawing(gifCacheEntry_t* entry, gifHandle* const* drawing,
+        uint8_t numDrawing);
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * Set up an empty cache
+ *
+ * @param cache  The cache to set up
+ * @param budget The bytes of frames to keep
+ */
+void ICACHE_FLASH_ATTR gifCacheInit(gifCache_t* cache, uint32_t budget)
+{
+    ets_memset(cache, 0, sizeof(gifCache_t));
+    cache->budget = budget;
+}
+
+/**
+ * Get a gif with its first frame decoded. If it isn't cached, load it and
+ * evict the least recently used gifs to stay within the budget. The gifs being
+ * drawn are never evicted, so if they're over the budget, the cache is too
+ *
+ * @param cache      The cache
+ * @param key        The key to look the gif up by
+ * @param name       The name of the gif's asset, to load it if it isn't cached
+ * @param drawing    The gifs from this cache which are still being drawn
+ * @param numDrawing The number of gifs in drawing
+ * @return The gif, or NULL if it couldn't be loaded
+ */
+gifHandle* ICACHE_FLASH_ATTR gifCacheGet(gifCache_t* cache, uint8_t key, const char* name,
+        gifHandle* const* drawing, uint8_t numDrawing)
+{
+    gifCacheEntry_t* slot = NULL;
+    uint8_t i;
+    for(i = 0; i < GIF_CACHE_SLOTS; i++)
+    {
+        gifCacheEntry_t* e = &cache->entries[i];
+        if(NULL == e->gif.frame)
+        {
+            slot = e;
+        }
+        else if(e->key == key)
+        {
+            e->lastUsed = ++cache->clock;
+            return &e->gif;
+        }
+    }
+
+    while(true)
+    {
+        // Find the least recently used gif which isn't being drawn, and add up
+        // how much memory the gifs use
+        gifCacheEntry_t* lru = NULL;
+        uint32_t usedBytes = 0;
+        for(i = 0; i < GIF_CACHE_SLOTS; i++)
+        {
+            gifCacheEntry_t* e = &cache->entries[i];
+            if(NULL == e->gif.frame)
+            {
+                continue;
+            }
+            usedBytes += e->gif.allocedSize;
+
+            if(e != slot && !gifCacheIsDrawing(e, drawing, numDrawing) &&
+                    (NULL == lru || e->lastUsed < lru->lastUsed))
+            {
+                lru = e;
+            }
+        }
+
+        // If nothing can be evicted, go over budget rather than not draw
+        // anything
+        bool overBudget = (usedBytes > cache->budget) && (NULL != lru);
+
+        if(NULL != slot && !overBudget)
+        {
+            if(NULL != slot->gif.frame)
+            {
+                return &slot->gif;
+            }
+
+            // Load the gif into the slot, then check the budget again
+            slot->key = key;
+            slot->lastUsed = ++cache->clock;
+            if(!loadGifFirstFrame(name, &slot->gif))
+            {
+                return NULL;
+            }
+            continue;
+        }
+
+        // Every slot is in use and being drawn
+        if(NULL == lru)
+        {
+            return NULL;
+        }
+
+        // Evict the least recently used gif
+        freeGifAsset(&lru->gif);
+        ets_memset(lru, 0, sizeof(gifCacheEntry_t));
+        if(NULL == slot)
+        {
+            slot = lru;
+        }
+    }
+}
+
+/**
+ * @param cache The cache
+ * @param key   The key to check
+ * @return true if the gif is cached, false if it isn't
+ */
+bool ICACHE_FLASH_ATTR gifCacheHas(gifCache_t* cache, uint8_t key)
+{
+    uint8_t i;
+    for(i = 0; i < GIF_CACHE_SLOTS; i++)
+    {
+        if(NULL != cache->entries[i].gif.frame && key == cache->entries[i].key)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @param cache The cache
+ * @return The bytes of frames in the cache
+ */
+uint32_t ICACHE_FLASH_ATTR gifCacheUsedBytes(gifCache_t* cache)
+{
+    uint32_t usedBytes = 0;
+    uint8_t i;
+    for(i = 0; i < GIF_CACHE_SLOTS; i++)
+    {
+        if(NULL != cache->entries[i].gif.frame)
+        {
+            usedBytes += cache->entries[i].gif.allocedSize;
+        }
+    }
+    return usedBytes;
+}
+
+/**
+ * Free every cached gif
+ *
+ * @param cache The cache
+ */
+void ICACHE_FLASH_ATTR gifCacheFree(gifCache_t* cache)
+{
+    uint8_t i;
+    for(i = 0; i < GIF_CACHE_SLOTS; i++)
+    {
+        freeGifAsset(&cache->entries[i].gif);
+    }
+    gifCacheInit(cache, cache->budget);
+}
+
+/**
+ * @param entry      A cache entry
+ * @param drawing    The gifs which are still being drawn
+ * @param numDrawing The number of gifs in drawing
+ * @return true if the entry's gif is being drawn, false if it isn't
+ */
+static bool ICACHE_FLASH_ATTR gifCacheIsDrawing(gifCacheEntry_t* entry, gifHandle* const* drawing,
+        uint8_t numDrawing)
+{
+    uint8_t i;
+    for(i = 0; i < numDrawing; i++)
+    {
+        if(&entry->gif == drawing[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
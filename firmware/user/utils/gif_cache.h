@@ -0,0 +1,52 @@
+/*
+ * gif_cache.h
+ *
+ * A small cache of gifs with only their first frame loaded, i.e. the menu's
+ * mode previews. Each gif is looked up by a key the caller picks. Loading one
+ * frees the least recently used gifs until the cache is back within its byte
+ * budget, except for any the caller is still drawing.
+ */
+
+#ifndef _GIF_CACHE_H_
+#define _GIF_CACHE_H_
+
+#include <osapi.h>
+#include <c_types.h>
+#include "assets.h"
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+#define GIF_CACHE_SLOTS 4
+
+/*============================================================================
+ * Structs
+ *==========================================================================*/
+
+typedef struct
+{
+    gifHandle gif;     // Loaded if gif.frame isn't NULL
+    uint8_t key;
+    uint32_t lastUsed;
+} gifCacheEntry_t;
+
+typedef struct
+{
+    gifCacheEntry_t entries[GIF_CACHE_SLOTS];
+    uint32_t clock;  // Counts up with every use, for lastUsed
+    uint32_t budget; // The bytes of frames to keep, if nothing being drawn is over it
+} gifCache_t;
+
+/*============================================================================
+ * Prototypes
+ *==========================================================================*/
+
+void ICACHE_FLASH_ATTR gifCacheInit(gifCache_t* cache, uint32_t budget);
+gifHandle* ICACHE_FLASH_ATTR gifCacheGet(gifCache_t* cache, uint8_t key, const char* name,
+        gifHandle* const* drawing, uint8_t numDrawing);
+bool ICACHE_FLASH_ATTR gifCacheHas(gifCache_t* cache, uint8_t key);
+uint32_t ICACHE_FLASH_ATTR gifCacheUsedBytes(gifCache_t* cache);
+void ICACHE_FLASH_ATTR gifCacheFree(gifCache_t* cache);
+
+#endif
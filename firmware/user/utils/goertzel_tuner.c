@@ -0,0 +1,189 @@
+/*
+ * goertzel_tuner.c
+ *
+ * See goertzel_tuner.h
+ */
+
+/*============================================================================
+ * Includes
+ *==========================================================================*/
+
+#include <osapi.h>
+#include <math.h>
+
+#include "user_main.h"
+#include "ccconfig.h"
+#include "fixed_math.h"
+#include "goertzel_tuner.h"
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+#define GT_COEFF_SHIFT 29
+
+// Samples are scaled down so the filter state can't overflow for a full scale
+// sample at the lowest note, about 65Hz
+#define GT_INPUT_SHIFT 2
+
+#ifndef M_PI
+    #define M_PI 3.14159265358979323846
+#endif
+
+/*============================================================================
+ * Prototypes
+ *==========================================================================*/
+
+static void ICACHE_FLASH_ATTR gtFinishMeasurement(gtNote_t* note);
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * Set up a filter bank for some notes. Measurements start immediately
+ *
+ * @param gt        The tuner to set up
+ * @param semitones Each note to measure, in semitones from A4 (440Hz)
+ * @param numNotes  The number of notes, at most GT_MAX_NOTES
+ */
+void ICACHE_FLASH_ATTR gtInit(goertzelTuner_t* gt, const int8_t* semitones, uint8_t numNotes)
+{
+    ets_memset(gt, 0, sizeof(goertzelTuner_t));
+    if(numNotes > GT_MAX_NOTES)
+    {
+        numNotes = GT_MAX_NOTES;
+    }
+    gt->numNotes = numNotes;
+
+    uint8_t i;
+    for(i = 0; i < numNotes; i++)
+    {
+        gtNote_t* note = &gt->notes[i];
+        float freq = 440.0f * powf(2.0f, semitones[i] / 12.0f);
+        note->blockLen = (uint16_t)((GT_CYCLES * DFREQ) / freq + 0.5f);
+
+        uint8_t f;
+        for(f = 0; f < GT_NUM_FILTERS; f++)
+        {
+            int16_t detune = ((int16_t)f - GT_CENTER) * GT_DETUNE_CENTS;
+            float w = 2 * M_PI * freq * powf(2.0f, detune / 1200.0f) / DFREQ;
+            note->coeff[f] = (int32_t)(2 * cosf(w) * (1 << GT_COEFF_SHIFT));
+        }
+    }
+}
+
+/**
+ * Run a block of samples through every note's filters
+ *
+ * @param gt         The tuner
+ * @param samples    The samples, oldest first
+ * @param numSamples The number of samples
+ * @return true if any note finished a measurement, i.e. cents and amplitude
+ *         were updated
+ */
+bool ICACHE_FLASH_ATTR gtPushSamples(goertzelTuner_t* gt, const int16_t* samples, int numSamples)
+{
+    bool updated = false;
+    uint8_t i;
+    for(i = 0; i < gt->numNotes; i++)
+    {
+        gtNote_t* note = &gt->notes[i];
+        const int16_t* samp = samples;
+        int remaining = numSamples;
+        while(remaining > 0)
+        {
+            // Run samples up to the end of this note's measurement
+            int toRun = note->blockLen - note->numSamples;
+            if(toRun > remaining)
+            {
+                toRun = remaining;
+            }
+
+            int32_t cF = note->coeff[GT_FLAT],   s1F = note->s1[GT_FLAT],   s2F = note->s2[GT_FLAT];
+            int32_t cC = note->coeff[GT_CENTER], s1C = note->s1[GT_CENTER], s2C = note->s2[GT_CENTER];
+            int32_t cS = note->coeff[GT_SHARP],  s1S = note->s1[GT_SHARP],  s2S = note->s2[GT_SHARP];
+            const int16_t* end = samp + toRun;
+            while(samp != end)
+            {
+                int32_t x = *samp++ >> GT_INPUT_SHIFT;
+                int32_t s;
+                s = x + (int32_t)(((int64_t)cF * s1F) >> GT_COEFF_SHIFT) - s2F;
+                s2F = s1F;
+                s1F = s;
+                s = x + (int32_t)(((int64_t)cC * s1C) >> GT_COEFF_SHIFT) - s2C;
+                s2C = s1C;
+                s1C = s;
+                s = x + (int32_t)(((int64_t)cS * s1S) >> GT_COEFF_SHIFT) - s2S;
+                s2S = s1S;
+                s1S = s;
+            }
+            note->s1[GT_FLAT] = s1F;
+            note->s2[GT_FLAT] = s2F;
+            note->s1[GT_CENTER] = s1C;
+            note->s2[GT_CENTER] = s2C;
+            note->s1[GT_SHARP] = s1S;
+            note->s2[GT_SHARP] = s2S;
+
+            remaining -= toRun;
+            note->numSamples += toRun;
+            if(note->numSamples >= note->blockLen)
+            {
+                gtFinishMeasurement(note);
+                updated = true;
+            }
+        }
+    }
+    return updated;
+}
+
+/**
+ * Turn a note's filter states into a deviation and amplitude, then reset the
+ * filters for the next measurement
+ *
+ * @param note The note which has run for blockLen samples
+ */
+static void ICACHE_FLASH_ATTR gtFinishMeasurement(gtNote_t* note)
+{
+    uint32_t mag[GT_NUM_FILTERS];
+    uint8_t f;
+    for(f = 0; f < GT_NUM_FILTERS; f++)
+    {
+        // |X|^2 = s1^2 + s2^2 - coeff * s1 * s2
+        int64_t s1 = note->s1[f];
+        int64_t s2 = note->s2[f];
+        int64_t power = (s1 * s1) + (s2 * s2) - (((note->coeff[f] * s1) >> GT_COEFF_SHIFT) * s2);
+        mag[f] = fxSqrt64(power > 0 ? power : 0);
+
+        note->s1[f] = 0;
+        note->s2[f] = 0;
+    }
+    note->numSamples = 0;
+
+    // The peak of a parabola through the three magnitudes
+    int64_t curve = 2 * (2 * (int64_t)mag[GT_CENTER] - mag[GT_FLAT] - mag[GT_SHARP]);
+    int64_t slope = (int64_t)mag[GT_SHARP] - mag[GT_FLAT];
+    int32_t cents;
+    if(curve <= 0)
+    {
+        // The center isn't the peak, so the note is far off
+        cents = (slope >= 0) ? GT_MAX_CENTS : -GT_MAX_CENTS;
+    }
+    else
+    {
+        cents = (GT_DETUNE_CENTS * slope) / curve;
+        if(cents > GT_MAX_CENTS)
+        {
+            cents = GT_MAX_CENTS;
+        }
+        else if(cents < -GT_MAX_CENTS)
+        {
+            cents = -GT_MAX_CENTS;
+        }
+    }
+    note->cents = cents;
+
+    // A sine wave of amplitude A has |X| = A * N / 2
+    uint32_t amplitude = (((uint64_t)mag[GT_CENTER] * 2) << GT_INPUT_SHIFT) / note->blockLen;
+    note->amplitude = (amplitude > 0xFFFF) ? 0xFFFF : amplitude;
+}
@@ -0,0 +1,71 @@
+/*
+ * goertzel_tuner.h
+ *
+ * A tuner which measures how far a few notes are from their exact pitch. Each
+ * note has three Goertzel filters: one centered on the note, and one each
+ * detuned GT_DETUNE_CENTS flat and sharp. The deviation in cents comes from
+ * fitting a parabola through the three filters' magnitudes.
+ *
+ * Each note is measured over GT_CYCLES of its own periods, so low notes take
+ * longer to measure than high ones, but every note has the same resolution in
+ * cents.
+ */
+
+#ifndef _GOERTZEL_TUNER_H_
+#define _GOERTZEL_TUNER_H_
+
+#include <osapi.h>
+#include <c_types.h>
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+#define GT_MAX_NOTES 6
+
+// How many periods of each note are in one measurement
+#define GT_CYCLES 16
+
+// How far the flat and sharp filters are from each note, in cents
+#define GT_DETUNE_CENTS 25
+
+// The largest reported deviation. Past this, it is a different semitone
+#define GT_MAX_CENTS 50
+
+/*============================================================================
+ * Enums & Structs
+ *==========================================================================*/
+
+typedef enum
+{
+    GT_FLAT,
+    GT_CENTER,
+    GT_SHARP,
+    GT_NUM_FILTERS
+} gtFilter_t;
+
+typedef struct
+{
+    int32_t coeff[GT_NUM_FILTERS]; // 2 * cos(w), Q29
+    int32_t s1[GT_NUM_FILTERS];
+    int32_t s2[GT_NUM_FILTERS];
+    uint16_t blockLen;   // The number of samples in one measurement
+    uint16_t numSamples; // The number of samples in the current measurement
+    int16_t cents;       // The last measured deviation, negative is flat
+    uint16_t amplitude;  // The last measured amplitude, in input sample units
+} gtNote_t;
+
+typedef struct
+{
+    gtNote_t notes[GT_MAX_NOTES];
+    uint8_t numNotes;
+} goertzelTuner_t;
+
+/*============================================================================
+ * Prototypes
+ *==========================================================================*/
+
+void ICACHE_FLASH_ATTR gtInit(goertzelTuner_t* gt, const int8_t* semitones, uint8_t numNotes);
+bool ICACHE_FLASH_ATTR gtPushSamples(goertzelTuner_t* gt, const int16_t* samples, int numSamples);
+
+#endif
@@ -3,115 +3,137 @@
 #include "hsv_utils.h"
 #include "user_main.h"
 
-uint8_t ICACHE_FLASH_ATTR GAMMA_CORRECT(uint8_t val)
+// The fully saturated, full value color for each hue, 0xBBGGRR. This is the
+// rainbow RYGCBM ramp, split into sixths at 43, 85, 128, 171 and 213
+static const uint32_t hueRamp[256]
+#ifndef USE_ESP_GDB // GDB catches SIGSEV b/c this is read out of ROM and not 32 bit aligned
+    RODATA_ATTR
+#endif
+    =
 {
-    // using gamma = 2.2
-    static const uint32_t gamma_correction_table[256]
+        0x0000FF, 0x0005FF, 0x000BFF, 0x0011FF, 0x0017FF, 0x001DFF, 0x0023FF, 0x0029FF,
+        0x002FFF, 0x0035FF, 0x003BFF, 0x0041FF, 0x0047FF, 0x004DFF, 0x0053FF, 0x0058FF,
+        0x005EFF, 0x0064FF, 0x006AFF, 0x0070FF, 0x0076FF, 0x007CFF, 0x0082FF, 0x0088FF,
+        0x008EFF, 0x0094FF, 0x009AFF, 0x00A0FF, 0x00A6FF, 0x00ABFF, 0x00B1FF, 0x00B7FF,
+        0x00BDFF, 0x00C3FF, 0x00C9FF, 0x00CFFF, 0x00D5FF, 0x00DBFF, 0x00E1FF, 0x00E7FF,
+        0x00EDFF, 0x00F3FF, 0x00F9FF, 0x00FFFF, 0x00FFFA, 0x00FFF4, 0x00FFEE, 0x00FFE8,
+        0x00FFE2, 0x00FFDC, 0x00FFD6, 0x00FFD0, 0x00FFCA, 0x00FFC4, 0x00FFBE, 0x00FFB8,
+        0x00FFB2, 0x00FFAC, 0x00FFA7, 0x00FFA1, 0x00FF9B, 0x00FF95, 0x00FF8F, 0x00FF89,
+        0x00FF83, 0x00FF7D, 0x00FF77, 0x00FF71, 0x00FF6B, 0x00FF65, 0x00FF5F, 0x00FF59,
+        0x00FF54, 0x00FF4E, 0x00FF48, 0x00FF42, 0x00FF3C, 0x00FF36, 0x00FF30, 0x00FF2A,
+        0x00FF24, 0x00FF1E, 0x00FF18, 0x00FF12, 0x00FF0C, 0x00FF00, 0x05FF00, 0x0BFF00,
+        0x11FF00, 0x17FF00, 0x1DFF00, 0x23FF00, 0x29FF00, 0x2FFF00, 0x35FF00, 0x3BFF00,
+        0x41FF00, 0x47FF00, 0x4DFF00, 0x53FF00, 0x58FF00, 0x5EFF00, 0x64FF00, 0x6AFF00,
+        0x70FF00, 0x76FF00, 0x7CFF00, 0x82FF00, 0x88FF00, 0x8EFF00, 0x94FF00, 0x9AFF00,
+        0xA0FF00, 0xA6FF00, 0xABFF00, 0xB1FF00, 0xB7FF00, 0xBDFF00, 0xC3FF00, 0xC9FF00,
+        0xCFFF00, 0xD5FF00, 0xDBFF00, 0xE1FF00, 0xE7FF00, 0xEDFF00, 0xF3FF00, 0xF9FF00,
+        0xFFFF00, 0xFFFA00, 0xFFF400, 0xFFEE00, 0xFFE800, 0xFFE200, 0xFFDC00, 0xFFD600,
+        0xFFD000, 0xFFCA00, 0xFFC400, 0xFFBE00, 0xFFB800, 0xFFB200, 0xFFAC00, 0xFFA700,
+        0xFFA100, 0xFF9B00, 0xFF9500, 0xFF8F00, 0xFF8900, 0xFF8300, 0xFF7D00, 0xFF7700,
+        0xFF7100, 0xFF6B00, 0xFF6500, 0xFF5F00, 0xFF5900, 0xFF5400, 0xFF4E00, 0xFF4800,
+        0xFF4200, 0xFF3C00, 0xFF3600, 0xFF3000, 0xFF2A00, 0xFF2400, 0xFF1E00, 0xFF1800,
+        0xFF1200, 0xFF0C00, 0xFF0600, 0xFF0000, 0xFF0005, 0xFF000B, 0xFF0011, 0xFF0017,
+        0xFF001D, 0xFF0023, 0xFF0029, 0xFF002F, 0xFF0035, 0xFF003B, 0xFF0041, 0xFF0047,
+        0xFF004D, 0xFF0053, 0xFF0058, 0xFF005E, 0xFF0064, 0xFF006A, 0xFF0070, 0xFF0076,
+        0xFF007C, 0xFF0082, 0xFF0088, 0xFF008E, 0xFF0094, 0xFF009A, 0xFF00A0, 0xFF00A6,
+        0xFF00AB, 0xFF00B1, 0xFF00B7, 0xFF00BD, 0xFF00C3, 0xFF00C9, 0xFF00CF, 0xFF00D5,
+        0xFF00DB, 0xFF00E1, 0xFF00E7, 0xFF00ED, 0xFF00F3, 0xFF00FF, 0xFA00FF, 0xF400FF,
+        0xEE00FF, 0xE800FF, 0xE200FF, 0xDC00FF, 0xD600FF, 0xD000FF, 0xCA00FF, 0xC400FF,
+        0xBE00FF, 0xB800FF, 0xB200FF, 0xAC00FF, 0xA700FF, 0xA100FF, 0x9B00FF, 0x9500FF,
+        0x8F00FF, 0x8900FF, 0x8300FF, 0x7D00FF, 0x7700FF, 0x7100FF, 0x6B00FF, 0x6500FF,
+        0x5F00FF, 0x5900FF, 0x5400FF, 0x4E00FF, 0x4800FF, 0x4200FF, 0x3C00FF, 0x3600FF,
+        0x3000FF, 0x2A00FF, 0x2400FF, 0x1E00FF, 0x1800FF, 0x1200FF, 0x0C00FF, 0x0600FF
+};
+
+// gamma = 2.2, four 8 bit entries packed into each word, lowest byte first.
+// Flash must be read 32 bits at a time, so this is a quarter of the size of a
+// table with one entry per word
+static const uint32_t gammaPacked[64]
 #ifndef USE_ESP_GDB // GDB catches SIGSEV b/c this is read out of ROM and not 32 bit aligned
     RODATA_ATTR
 #endif
     =
-    {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2,
-        3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6,
-        6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 11, 11, 11, 12,
-        12, 13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19,
-        20, 20, 21, 22, 22, 23, 23, 24, 25, 25, 26, 26, 27, 28, 28, 29,
-        30, 30, 31, 32, 33, 33, 34, 35, 35, 36, 37, 38, 39, 39, 40, 41,
-        42, 43, 43, 44, 45, 46, 47, 48, 49, 49, 50, 51, 52, 53, 54, 55,
-        56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
-        73, 74, 75, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87, 88, 89, 90,
-        91, 93, 94, 95, 97, 98, 99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
-        113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
-        137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
-        163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
-        192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
-        223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
-    };
-    return gamma_correction_table[val];
+{
+        0x00000000, 0x00000000, 0x00000000, 0x01000000, 0x01010101, 0x01010101, 0x02020201, 0x02020202,
+        0x03030303, 0x04040403, 0x05050504, 0x06060605, 0x07070706, 0x09080808, 0x0A0A0909, 0x0C0B0B0B,
+        0x0D0D0D0C, 0x0F0F0E0E, 0x11111010, 0x13131212, 0x16151414, 0x18171716, 0x1A1A1919, 0x1D1C1C1B,
+        0x201F1E1E, 0x23222121, 0x26252423, 0x29282727, 0x2C2B2B2A, 0x302F2E2D, 0x33323131, 0x37363534,
+        0x3B3A3938, 0x3F3E3D3C, 0x43424140, 0x47464544, 0x4C4B4A49, 0x514F4E4D, 0x55545352, 0x5A595857,
+        0x5F5E5D5B, 0x64636261, 0x6A696766, 0x6F6E6D6B, 0x75747271, 0x7B797877, 0x817F7E7C, 0x87858482,
+        0x8D8C8A89, 0x9492918F, 0x9A999795, 0xA19F9E9C, 0xA8A6A5A3, 0xAFADACAA, 0xB6B5B3B1, 0xBEBCBAB8,
+        0xC5C4C2C0, 0xCDCBC9C7, 0xD5D3D1CF, 0xDDDBD9D7, 0xE5E3E1DF, 0xEEECEAE7, 0xF6F4F2F0, 0xFFFDFBF8
+};
+
+static uint32_t ICACHE_FLASH_ATTR hsvConvert( uint8_t hue, uint8_t sat, uint8_t val, bool applyGamma );
+
+uint8_t ICACHE_FLASH_ATTR GAMMA_CORRECT(uint8_t val)
+{
+    return (gammaPacked[val >> 2] >> ((val & 0x03) * 8)) & 0xFF;
 }
 
 uint32_t ICACHE_FLASH_ATTR EHSVtoHEX( uint8_t hue, uint8_t sat, uint8_t val)
 {
-    return EHSVtoHEXhelper(hue, sat, val, true );
+    return hsvConvert(hue, sat, val, true );
 }
 
 uint32_t ICACHE_FLASH_ATTR EHSVtoHEXhelper( uint8_t hue, uint8_t sat, uint8_t val, bool applyGamma)
 {
-#define SIXTH1 43
-#define SIXTH2 85
-#define SIXTH3 128
-#define SIXTH4 171
-#define SIXTH5 213
-    uint16_t or = 0, og = 0, ob = 0;
-
-    // move in rainbow order RYGCBM as hue from 0 to 255
+    return hsvConvert(hue, sat, val, applyGamma );
+}
 
-    if( hue < SIXTH1 ) //Ok: Red->Yellow
-    {
-        or = 255;
-        og = (hue * 255) / (SIXTH1);
-    }
-    else if( hue < SIXTH2 ) //Ok: Yellow->Green
-    {
-        og = 255;
-        or = 255 - (hue - SIXTH1) * 255 / SIXTH1;
-    }
-    else if( hue < SIXTH3 )  //Ok: Green->Cyan
-    {
-        og = 255;
-        ob = (hue - SIXTH2) * 255 / (SIXTH1);
-    }
-    else if( hue < SIXTH4 ) //Ok: Cyan->Blue
-    {
-        ob = 255;
-        og = 255 - (hue - SIXTH3) * 255 / SIXTH1;
-    }
-    else if( hue < SIXTH5 ) //Ok: Blue->Magenta
-    {
-        ob = 255;
-        or = (hue - SIXTH4) * 255 / SIXTH1;
-    }
-    else //Magenta->Red
+/**
+ * Convert a batch of HSV colors to gamma corrected LED colors. This is the same
+ * as calling EHSVtoHEX() for each LED, without the call and repacking overhead
+ *
+ * @param hsv  The colors to convert
+ * @param leds The LEDs to write, may not overlap hsv
+ * @param n    The number of colors to convert
+ */
+void ICACHE_FLASH_ATTR hsvToLeds( const hsv_t* hsv, led_t* leds, uint16_t n )
+{
+    uint16_t i;
+    for( i = 0; i < n; i++ )
     {
-        or = 255;
-        ob = 255 - (hue - SIXTH5) * 255 / SIXTH1;
+        uint32_t color = hsvConvert( hsv[i].h, hsv[i].s, hsv[i].v, true );
+        leds[i].r = (color >> 0) & 0xFF;
+        leds[i].g = (color >> 8) & 0xFF;
+        leds[i].b = (color >> 16) & 0xFF;
     }
+}
+
+/**
+ * Look up the hue's ramp color, then apply saturation, value and optionally
+ * gamma. There are no divisions, just a multiply per channel for each of
+ * saturation and value
+ *
+ * @return The color, 0xBBGGRR
+ */
+static uint32_t ICACHE_FLASH_ATTR hsvConvert( uint8_t hue, uint8_t sat, uint8_t val, bool applyGamma )
+{
+    uint32_t ramp = hueRamp[hue];
 
-    uint16_t rv = val;
-    if( rv > 128 )
-    {
-        rv++;
-    }
     uint16_t rs = sat;
     if( rs > 128 )
     {
         rs++;
     }
+    uint16_t desat = 255 * (256 - rs);
 
-    //or, og, ob range from 0...255 now.
-    //Apply saturation giving OR..OB == 0..65025
-    or = or * rs + 255 * (256 - rs);
-    og = og * rs + 255 * (256 - rs);
-    ob = ob * rs + 255 * (256 - rs);
-    or >>= 8;
-    og >>= 8;
-    ob >>= 8;
-    //back to or, og, ob range 0...255 now.
-    //Need to apply saturation and value.
-    or = ( or * val) >> 8;
-    og = (og * val) >> 8;
-    ob = (ob * val) >> 8;
-    //  printf( "  hue = %d r=%d g=%d b=%d rs=%d rv=%d\n", hue, or, og, ob, rs, rv );
-    if (applyGamma)
+    uint32_t ret = 0;
+    uint8_t shift;
+    for( shift = 0; shift < 24; shift += 8 )
     {
-        or = GAMMA_CORRECT( or );
-        og = GAMMA_CORRECT(og);
-        ob = GAMMA_CORRECT(ob);
+        //Apply saturation giving 0..65025, then value, back to 0..255
+        uint16_t c = (ramp >> shift) & 0xFF;
+        c = (c * rs + desat) >> 8;
+        c = (c * val) >> 8;
+        if( applyGamma )
+        {
+            c = GAMMA_CORRECT( c );
+        }
+        ret |= (uint32_t)c << shift;
     }
-    return or | (og << 8) | ((uint32_t)ob << 16);
-    //return og | ( or << 8) | ((uint32_t)ob << 16); //grb
+    return ret;
 }
 
 led_t ICACHE_FLASH_ATTR SafeEHSVtoHEXhelper( int16_t hue, int16_t sat, int16_t val, bool applyGamma )
@@ -5,10 +5,20 @@
 
 #include "user_main.h"
 
+typedef struct
+{
+    uint8_t h;
+    uint8_t s;
+    uint8_t v;
+} hsv_t;
+
 uint32_t ICACHE_FLASH_ATTR EHSVtoHEXhelper( uint8_t hue, uint8_t sat, uint8_t val, bool applyGamma );
 uint32_t EHSVtoHEX( uint8_t hue, uint8_t sat, uint8_t val ); //hue = 0..255 // TODO: TEST ME!!!
 uint8_t ICACHE_FLASH_ATTR GAMMA_CORRECT(uint8_t val);
 
+//Converts n colors at once, with gamma correction
+void ICACHE_FLASH_ATTR hsvToLeds( const hsv_t* hsv, led_t* leds, uint16_t n );
+
 //Clamps values
 led_t ICACHE_FLASH_ATTR SafeEHSVtoHEXhelper( int16_t hue, int16_t sat, int16_t val, bool applyGamma );
 
@@ -0,0 +1,216 @@
+/*
+ * led_compositor.c
+ *
+ * See led_compositor.h
+ */
+
+/*============================================================================
+ * Includes
+ *==========================================================================*/
+
+#include <osapi.h>
+#include <user_interface.h>
+
+#include "user_main.h"
+#include "hsv_utils.h"
+#include "ws2812_i2s.h"
+#include "led_compositor.h"
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+#define LED_NUM_CHANNELS (NUM_LIN_LEDS * sizeof(led_t))
+
+/*============================================================================
+ * Structs
+ *==========================================================================*/
+
+typedef struct
+{
+    uint8_t chans[LED_NUM_CHANNELS];
+    uint8_t alpha;    // 0 hides the layer, 255 covers the layers below
+    bool applyGamma;  // If the layer's values go through GAMMA_CORRECT()
+} ledLayerData_t;
+
+/*============================================================================
+ * Variables
+ *==========================================================================*/
+
+static struct
+{
+    ledLayerData_t layers[LED_NUM_LAYERS];
+    uint8_t brightness;
+    bool dirty;
+
+    // The fractional part carried from each channel to the next frame
+    uint8_t ditherErr[LED_NUM_CHANNELS];
+    bool dithering;
+    // When the last frame was composed, even if it wasn't pushed. Each
+    // compose advances the dither, so it has to be paced by this
+    uint32_t lastComposeUs;
+
+    // The last frame sent to the LEDs
+    uint8_t pushed[LED_NUM_CHANNELS];
+    bool anyPushed;
+} ledComp =
+{
+    .layers =
+    {
+        [LED_LAYER_MODE] = {.alpha = 255},
+    },
+    .brightness = 255,
+};
+
+/*============================================================================
+ * Prototypes
+ *==========================================================================*/
+
+static void ICACHE_FLASH_ATTR ledCompCompose(void);
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * Set the colors of one layer. They are shown on the next ledCompUpdate()
+ *
+ * @param layer   The layer to set
+ * @param leds    The colors, one per LED
+ * @param ledsLen The length of leds in bytes, at most NUM_LIN_LEDS * 3
+ */
+void ICACHE_FLASH_ATTR ledCompSetLayer(ledLayer_t layer, const led_t* leds, uint16_t ledsLen)
+{
+    if(ledsLen > LED_NUM_CHANNELS)
+    {
+        ledsLen = LED_NUM_CHANNELS;
+    }
+    ets_memcpy(ledComp.layers[layer].chans, leds, ledsLen);
+    ets_memset(&ledComp.layers[layer].chans[ledsLen], 0, LED_NUM_CHANNELS - ledsLen);
+    ledComp.dirty = true;
+}
+
+/**
+ * Set how much a layer covers the layers below it. The mode's layer starts at
+ * 255 and every other layer starts hidden, at 0
+ *
+ * @param layer The layer to set
+ * @param alpha 0 to hide the layer, 255 to cover the layers below it
+ */
+void ICACHE_FLASH_ATTR ledCompSetLayerAlpha(ledLayer_t layer, uint8_t alpha)
+{
+    ledComp.layers[layer].alpha = alpha;
+    ledComp.dirty = true;
+}
+
+/**
+ * Set if a layer's values are gamma corrected. Colors from EHSVtoHEX() already
+ * are, so layers start without it
+ *
+ * @param layer      The layer to set
+ * @param applyGamma true to pass the layer through GAMMA_CORRECT()
+ */
+void ICACHE_FLASH_ATTR ledCompSetLayerGamma(ledLayer_t layer, bool applyGamma)
+{
+    ledComp.layers[layer].applyGamma = applyGamma;
+    ledComp.dirty = true;
+}
+
+/**
+ * Scale every LED, after the layers are composed
+ *
+ * @param brightness 255 for full brightness, 0 for off
+ */
+void ICACHE_FLASH_ATTR ledCompSetBrightness(uint8_t brightness)
+{
+    ledComp.brightness = brightness;
+    ledComp.dirty = true;
+}
+
+/**
+ * Push a new frame to the LEDs if any layer changed, or if the frame is being
+ * dithered and it's time for the next one. Called from procTask()
+ */
+void ICACHE_FLASH_ATTR ledCompUpdate(void)
+{
+    if(ledComp.dirty ||
+            (ledComp.dithering && system_get_time() - ledComp.lastComposeUs >= LED_DITHER_PERIOD_US))
+    {
+        ledCompCompose();
+    }
+}
+
+/**
+ * Push the current layers to the LEDs right away, i.e. before a restart when
+ * procTask() won't run again
+ */
+void ICACHE_FLASH_ATTR ledCompFlush(void)
+{
+    ledCompCompose();
+}
+
+/**
+ * Compose every layer into a frame, then send it to the LEDs if it's
+ * different from the last one
+ */
+static void ICACHE_FLASH_ATTR ledCompCompose(void)
+{
+    uint8_t frame[LED_NUM_CHANNELS];
+    uint16_t scale = ledComp.brightness + 1;
+    bool dithering = false;
+
+    uint8_t c;
+    for(c = 0; c < LED_NUM_CHANNELS; c++)
+    {
+        // Each channel is 8.8 fixed point until it's dithered
+        uint16_t val = 0;
+        uint8_t l;
+        for(l = 0; l < LED_NUM_LAYERS; l++)
+        {
+            ledLayerData_t* layer = &ledComp.layers[l];
+            if(0 == layer->alpha)
+            {
+                continue;
+            }
+
+            uint16_t layerVal = layer->chans[c] * scale;
+            if(layer->applyGamma)
+            {
+                // Interpolate between gamma table entries to keep the fraction
+                uint8_t idx = layerVal >> 8;
+                uint8_t lo = GAMMA_CORRECT(idx);
+                uint8_t hi = (idx < 255) ? GAMMA_CORRECT(idx + 1) : lo;
+                layerVal = (lo << 8) + (hi - lo) * (layerVal & 0xFF);
+            }
+
+            uint16_t a = layer->alpha + (layer->alpha >> 7);
+            val = ((uint32_t)val * (256 - a) + (uint32_t)layerVal * a) >> 8;
+        }
+
+        // Temporal dithering, carry what's rounded off to the next frame
+        uint16_t dithered = val + ledComp.ditherErr[c];
+        if(dithered > 0xFFFF - 0xFF)
+        {
+            dithered = 0xFF00;
+        }
+        frame[c] = dithered >> 8;
+        ledComp.ditherErr[c] = dithered & 0xFF;
+        if(val & 0xFF)
+        {
+            dithering = true;
+        }
+    }
+
+    ledComp.dirty = false;
+    ledComp.dithering = dithering;
+    ledComp.lastComposeUs = system_get_time();
+
+    // Don't restart the LED DMA for the same frame
+    if(ledComp.anyPushed && 0 == ets_memcmp(frame, ledComp.pushed, sizeof(frame)))
+    {
+        return;
+    }
+    ws2812_push(frame, sizeof(frame));
+    ets_memcpy(ledComp.pushed, frame, sizeof(frame));
+    ledComp.anyPushed = true;
+}
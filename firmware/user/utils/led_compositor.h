@@ -0,0 +1,49 @@
+/*
+ * led_compositor.h
+ *
+ * Combines LED layers into the frame which is sent to the LEDs. setLeds()
+ * writes the mode's layer, and other layers can be drawn over it. The frame is
+ * composed and pushed from procTask() by ledCompUpdate(), and only if it changed,
+ * so setting the same colors from a fast timer doesn't restart the LED DMA.
+ *
+ * Global brightness and gamma correction are applied while composing, with 8
+ * extra bits of precision. The extra bits are temporally dithered, so dim
+ * colors and slow fades get in-between levels instead of visible steps.
+ */
+
+#ifndef _LED_COMPOSITOR_H_
+#define _LED_COMPOSITOR_H_
+
+#include "user_main.h"
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+// While dithering, the LEDs are refreshed this often
+#define LED_DITHER_PERIOD_US 2500
+
+/*============================================================================
+ * Enums
+ *==========================================================================*/
+
+// Layers are composed in this order, each over the ones before it
+typedef enum
+{
+    LED_LAYER_MODE,    // The Swadge mode's LEDs, set with setLeds()
+    LED_LAYER_OVERLAY, // Drawn over the mode, i.e. for notifications
+    LED_NUM_LAYERS
+} ledLayer_t;
+
+/*============================================================================
+ * Prototypes
+ *==========================================================================*/
+
+void ICACHE_FLASH_ATTR ledCompSetLayer(ledLayer_t layer, const led_t* leds, uint16_t ledsLen);
+void ICACHE_FLASH_ATTR ledCompSetLayerAlpha(ledLayer_t layer, uint8_t alpha);
+void ICACHE_FLASH_ATTR ledCompSetLayerGamma(ledLayer_t layer, bool applyGamma);
+void ICACHE_FLASH_ATTR ledCompSetBrightness(uint8_t brightness);
+void ICACHE_FLASH_ATTR ledCompUpdate(void);
+void ICACHE_FLASH_ATTR ledCompFlush(void);
+
+#endif
@@ -26,11 +26,88 @@
 */
 #define dbgList(l)
 
+static node_t* ICACHE_FLASH_ATTR allocNode(list_t* list);
+static void ICACHE_FLASH_ATTR freeNode(list_t* list, node_t* node);
+
+/**
+ * Set up a pool of nodes for lists to use instead of the heap. Point a list's
+ * pool at it before adding anything to the list
+ *
+ * @param pool     The pool to set up
+ * @param nodes    Storage for the nodes, which must outlive every list using it
+ * @param numNodes The number of nodes in the storage
+ */
+void ICACHE_FLASH_ATTR initNodePool(nodePool_t* pool, node_t* nodes, uint16_t numNodes)
+{
+    pool->nodes = nodes;
+    pool->numNodes = numNodes;
+    pool->inUse = 0;
+    pool->maxInUse = 0;
+    pool->exhausted = 0;
+
+    // Thread every node onto the free list
+    pool->freeList = NULL;
+    for(int i = numNodes - 1; i >= 0; i--)
+    {
+        nodes[i].next = pool->freeList;
+        pool->freeList = &nodes[i];
+    }
+}
+
+/**
+ * Get a node for a list, from its pool if it has one with a free node,
+ * otherwise from the heap
+ *
+ * @param list The list the node is for
+ * @return The node
+ */
+static node_t* ICACHE_FLASH_ATTR allocNode(list_t* list)
+{
+    nodePool_t* pool = list->pool;
+    if(NULL != pool)
+    {
+        if(NULL != pool->freeList)
+        {
+            node_t* node = pool->freeList;
+            pool->freeList = node->next;
+            pool->inUse++;
+            if(pool->inUse > pool->maxInUse)
+            {
+                pool->maxInUse = pool->inUse;
+            }
+            return node;
+        }
+        pool->exhausted++;
+    }
+    return os_malloc(sizeof(node_t));
+}
+
+/**
+ * Return a node to wherever it came from
+ *
+ * @param list The list the node was in
+ * @param node The node to free
+ */
+static void ICACHE_FLASH_ATTR freeNode(list_t* list, node_t* node)
+{
+    nodePool_t* pool = list->pool;
+    if(NULL != pool && node >= pool->nodes && node < &pool->nodes[pool->numNodes])
+    {
+        node->next = pool->freeList;
+        pool->freeList = node;
+        pool->inUse--;
+    }
+    else
+    {
+        os_free(node);
+    }
+}
+
 // Add to the end of the list.
 void ICACHE_FLASH_ATTR push(list_t* list, void* val)
 {
     dbgList(list);
-    node_t* newLast = os_malloc(sizeof(node_t));
+    node_t* newLast = allocNode(list);
     newLast->val = val;
     newLast->next = NULL;
     newLast->prev = list->last;
@@ -77,7 +154,7 @@ void* ICACHE_FLASH_ATTR pop(list_t* list)
 
         // Get the last node val, then free it and update length.
         retval = target->val;
-        os_free(target);
+        freeNode(list, target);
         list->length--;
     }
 
@@ -89,7 +166,7 @@ void* ICACHE_FLASH_ATTR pop(list_t* list)
 void ICACHE_FLASH_ATTR unshift(list_t* list, void* val)
 {
     dbgList(list);
-    node_t* newFirst = os_malloc(sizeof(node_t));
+    node_t* newFirst = allocNode(list);
     newFirst->val = val;
     newFirst->next = list->first;
     newFirst->prev = NULL;
@@ -136,7 +213,7 @@ void* ICACHE_FLASH_ATTR shift(list_t* list)
 
         // Get the first node val, then free it and update length.
         retval = target->val;
-        os_free(target);
+        freeNode(list, target);
         list->length--;
     }
 
@@ -157,7 +234,7 @@ void ICACHE_FLASH_ATTR add(list_t* list, void* val, int index)
     // Else if the index we're trying to add to is before the end of the list.
     else if (index < list->length - 1)
     {
-        node_t* newNode = os_malloc(sizeof(node_t));
+        node_t* newNode = allocNode(list);
         newNode->val = val;
         newNode->next = NULL;
         newNode->prev = NULL;
@@ -223,7 +300,7 @@ void* ICACHE_FLASH_ATTR removeIdx(list_t* list, int index)
         current->next = target->next;
         current->next->prev = current;
 
-        os_free(target);
+        freeNode(list, target);
         target = NULL;
 
         list->length--;
@@ -271,9 +348,9 @@ void* ICACHE_FLASH_ATTR removeEntry(list_t* list, node_t* entry)
     // Otherwise it's somewhere in the middle, or doesn't exist
     else
     {
-        // Start at list->first->next because we know the entry isn't at the head
-        node_t* prev = list->first;
-        node_t* curr = prev->next;
+        // Start at list->first because we know the entry isn't at the head,
+        // but it may be the node after it
+        node_t* curr = list->first;
         // Iterate!
         while (curr != NULL)
         {
@@ -289,7 +366,7 @@ void* ICACHE_FLASH_ATTR removeEntry(list_t* list, node_t* entry)
                 curr->next = target->next;
                 curr->next->prev = curr;
 
-                os_free(target);
+                freeNode(list, target);
                 target = NULL;
 
                 list->length--;
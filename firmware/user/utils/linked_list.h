@@ -8,6 +8,8 @@
 #ifndef _LINKED_LIST_H
 #define _LINKED_LIST_H
 
+#include <osapi.h>
+
 // Doubly-linked list.
 typedef struct node
 {
@@ -16,11 +18,25 @@ typedef struct node
     struct node* prev;
 } node_t;
 
+// A fixed set of nodes which lists can take from instead of the heap.
+// Freed nodes go back on the pool's free list to be reused.
+typedef struct
+{
+    node_t* nodes;
+    node_t* freeList;
+    uint16_t numNodes;
+    uint16_t inUse;
+    uint16_t maxInUse;
+    // How many times the pool was empty and a node came from the heap instead
+    uint32_t exhausted;
+} nodePool_t;
+
 typedef struct
 {
     node_t* first;
     node_t* last;
     int length;
+    nodePool_t* pool; // NULL to allocate nodes from the heap
 } list_t;
 
 // Creating an empty list example.
@@ -29,6 +45,16 @@ typedef struct
     myList->first = NULL;
     myList->last = NULL;
     myList->length = 0;
+    myList->pool = NULL;
+*/
+
+// Creating an empty list which takes nodes from a pool example.
+// Many lists can share one pool.
+/*
+    static node_t myNodes[16];
+    static nodePool_t myPool;
+    initNodePool(&myPool, myNodes, 16);
+    myList->pool = &myPool;
 */
 
 // Iterating through the list example.
@@ -41,6 +67,9 @@ typedef struct
     }
 */
 
+// Set up a pool with caller supplied storage for numNodes nodes.
+void ICACHE_FLASH_ATTR initNodePool(nodePool_t* pool, node_t* nodes, uint16_t numNodes);
+
 // Add to the end of the list.
 void ICACHE_FLASH_ATTR push(list_t* list, void* val);
 
@@ -3,6 +3,7 @@
 #include <user_interface.h>
 #include <stdlib.h>
 #include "printControl.h"
+#include "trace.h"
 
 // maxtime.c
 //
@@ -10,6 +11,7 @@
 
 void ICACHE_FLASH_ATTR maxTimeBegin( struct maxtime_t* mymaxtime )
 {
+    traceBegin(mymaxtime->name);
     uint32_t time_now_us = system_get_time();
     mymaxtime->period_us = time_now_us - mymaxtime->start_us ;
     mymaxtime->start_us  = time_now_us;
@@ -18,6 +20,7 @@ void ICACHE_FLASH_ATTR maxTimeBegin( struct maxtime_t* mymaxtime )
 void ICACHE_FLASH_ATTR maxTimeEnd  ( struct maxtime_t* mymaxtime )
 {
     uint32_t time_now_us = system_get_time();
+    traceEnd(mymaxtime->name);
     if ( ( time_now_us - mymaxtime->start_us ) > mymaxtime->max_us  )
     {
         mymaxtime->max_us = time_now_us - mymaxtime->start_us;
@@ -33,12 +33,26 @@
 #define US_PER_PIXEL_X  5000
 #define US_PER_PIXEL_Y 10000
 
+// A one row menu only draws over the bottom of the display
+#define SINGLE_ROW_Y (OLED_HEIGHT - FONT_HEIGHT_IBMVGA8 - 4)
+
+/*==============================================================================
+ * Variables
+ *============================================================================*/
+
+extern uint8_t currentFb[(OLED_WIDTH * (OLED_HEIGHT / 8))];
+
 /*==============================================================================
  * Prototypes
  *============================================================================*/
 
 linkedInfo_t* linkNewNode(cLinkedNode_t** root, uint8_t len, linkedInfo_t info);
-void drawRow(cLinkedNode_t* row, int16_t yPos, bool shouldDrawBox, uint32_t tElapsedUs);
+void drawRow(cLinkedNode_t* row, int16_t yPos, bool shouldDrawBox);
+static bool ICACHE_FLASH_ATTR layOutRow(cLinkedNode_t* row);
+static void ICACHE_FLASH_ATTR freeRowStrip(cLinkedNode_t* row);
+static int16_t ICACHE_FLASH_ATTR plotItem(cLinkedNode_t* row, cLinkedNode_t* item, int16_t xPos, int16_t yPos);
+static void ICACHE_FLASH_ATTR moveRowToCenter(cLinkedNode_t* row, uint32_t tElapsedUs);
+static uint32_t ICACHE_FLASH_ATTR hashMenuArea(menu_t* menu);
 
 /*==============================================================================
  * Functions
@@ -65,6 +79,10 @@ menu_t* ICACHE_FLASH_ATTR initMenu(const char* title, menuCb cbFunc)
     menu->yOffset = 0;
     menu->tLastCallUs = system_get_time();
     menu->tAccumulatedUs = 0;
+    menu->drawnAtRest = false;
+    menu->drawnRow = NULL;
+    menu->drawnItem = NULL;
+    menu->drawnHash = 0;
 
     // Return the pointer
     return menu;
@@ -90,6 +108,7 @@ void ICACHE_FLASH_ATTR deinitMenu(menu_t* menu)
             menu->rows->d.row.items = next;
         }
         // Then free the row and iterate to the next
+        freeRowStrip(menu->rows);
         cLinkedNode_t* next = menu->rows->next;
         os_free(menu->rows);
         menu->rows = next;
@@ -169,6 +188,7 @@ void ICACHE_FLASH_ATTR addRowToMenu(menu_t* menu)
     newRow.row.numItems = 0;
     newRow.row.xOffset = 0;
     newRow.row.tAccumulatedUs = 0;
+    newRow.row.strip = NULL;
 
     // Link the new row
     linkNewNode(&(menu->rows), menu->numRows, newRow);
@@ -197,6 +217,9 @@ linkedInfo_t* ICACHE_FLASH_ATTR addItemToRow(menu_t* menu, const char* name)
     // Make a new item
     linkedInfo_t newItem;
     newItem.item.name = name;
+    newItem.item.laidOutName = NULL;
+    newItem.item.width = 0;
+    newItem.item.stripX = 0;
 
     // Link the new item and return a pointer to it
     linkedInfo_t* linkedItem = linkNewNode(&(row->d.row.items), row->d.row.numItems, newItem);
@@ -205,14 +228,96 @@ linkedInfo_t* ICACHE_FLASH_ATTR addItemToRow(menu_t* menu, const char* name)
 }
 
 /**
- * Draw a single row of the menu to the OLED
+ * Measure each item in a row and unpack their names into the row's strip of
+ * columns. This only does work the first time a row is drawn, after its strip
+ * was freed, or after an item's name was changed
+ *
+ * @param row The row to lay out
+ * @return true if the row was laid out again, false if nothing changed
+ */
+static bool ICACHE_FLASH_ATTR layOutRow(cLinkedNode_t* row)
+{
+    bool changed = (NULL == row->d.row.strip);
+    uint16_t stripCols = 0;
+    cLinkedNode_t* item = row->d.row.items;
+    uint8_t i;
+    for(i = 0; i < row->d.row.numItems; i++)
+    {
+        if(item->d.item.laidOutName != item->d.item.name)
+        {
+            item->d.item.laidOutName = item->d.item.name;
+            item->d.item.width = textWidth(item->d.item.name, IBM_VGA_8);
+            changed = true;
+        }
+        stripCols += item->d.item.width;
+        item = item->next;
+    }
+
+    if(!changed)
+    {
+        return false;
+    }
+
+    // Unpack every name once, rather than every frame
+    freeRowStrip(row);
+    row->d.row.strip = (uint16_t*)os_malloc(stripCols * sizeof(uint16_t));
+    if(NULL != row->d.row.strip)
+    {
+        stripCols = 0;
+        for(i = 0; i < row->d.row.numItems; i++)
+        {
+            item->d.item.stripX = stripCols;
+            stripCols += textColumns(item->d.item.name, IBM_VGA_8, &row->d.row.strip[stripCols]);
+            item = item->next;
+        }
+    }
+    return true;
+}
+
+/**
+ * Free a row's strip of columns. It'll be unpacked again if the row is drawn
+ *
+ * @param row The row to free the strip for
+ */
+static void ICACHE_FLASH_ATTR freeRowStrip(cLinkedNode_t* row)
+{
+    if(NULL != row->d.row.strip)
+    {
+        os_free(row->d.row.strip);
+        row->d.row.strip = NULL;
+    }
+}
+
+/**
+ * Draw an item's name from its row's strip of columns
+ *
+ * @param row  The row the item is in
+ * @param item The item to draw
+ * @param xPos The X position of the item to draw
+ * @param yPos The Y position of the item to draw
+ * @return The X position of the end of the item
+ */
+static int16_t ICACHE_FLASH_ATTR plotItem(cLinkedNode_t* row, cLinkedNode_t* item, int16_t xPos, int16_t yPos)
+{
+    if(NULL == row->d.row.strip)
+    {
+        // There wasn't memory for the strip, so draw the text instead
+        return plotText(xPos, yPos, item->d.item.name, IBM_VGA_8, WHITE);
+    }
+
+    blitColumns(xPos, yPos, &row->d.row.strip[item->d.item.stripX], item->d.item.width,
+                FONT_HEIGHT_IBMVGA8, WHITE);
+    return xPos + item->d.item.width;
+}
+
+/**
+ * Draw a single row of the menu to the OLED. The row must be laid out first
  *
  * @param row The row to draw
  * @param yPos The Y position of the row to draw
  * @param shouldDrawBox True if this is the selected row, false otherwise
- * @param tElapsedUs The time elapsed since this row was last drawn
  */
-void ICACHE_FLASH_ATTR drawRow(cLinkedNode_t* row, int16_t yPos, bool shouldDrawBox, uint32_t tElapsedUs)
+void ICACHE_FLASH_ATTR drawRow(cLinkedNode_t* row, int16_t yPos, bool shouldDrawBox)
 {
     // Get a pointer to the items for this row
     cLinkedNode_t* items = row->d.row.items;
@@ -220,9 +325,8 @@ void ICACHE_FLASH_ATTR drawRow(cLinkedNode_t* row, int16_t yPos, bool shouldDraw
     // If there are multiple items
     if(row->d.row.numItems > 1)
     {
-        row->d.row.tAccumulatedUs += tElapsedUs;
         // Get the X position for the selected item, centering it
-        int16_t xPos = row->d.row.xOffset + ((OLED_WIDTH - textWidth((char*)items->d.item.name, IBM_VGA_8)) / 2);
+        int16_t xPos = row->d.row.xOffset + ((OLED_WIDTH - items->d.item.width) / 2);
 
         // Then work backwards to make sure the entire row is drawn
         while(xPos > 0)
@@ -230,7 +334,7 @@ void ICACHE_FLASH_ATTR drawRow(cLinkedNode_t* row, int16_t yPos, bool shouldDraw
             // Iterate backwards
             items = items->prev;
             // Adjust the x pos
-            xPos -= (textWidth((char*)items->d.item.name, IBM_VGA_8) + ITEM_SPACING);
+            xPos -= (items->d.item.width + ITEM_SPACING);
         }
 
         // Then draw items until we're off the OLED
@@ -239,10 +343,7 @@ void ICACHE_FLASH_ATTR drawRow(cLinkedNode_t* row, int16_t yPos, bool shouldDraw
         {
             // Plot the text
             int16_t xPosS = xPos;
-            xPos = plotText(
-                       xPos, yPos,
-                       (char*)items->d.item.name,
-                       IBM_VGA_8, WHITE);
+            xPos = plotItem(row, items, xPos, yPos);
 
             // If this is the selected item, draw a box around it
             if(shouldDrawBox && !drawnBox && row->d.row.items == items)
@@ -257,28 +358,12 @@ void ICACHE_FLASH_ATTR drawRow(cLinkedNode_t* row, int16_t yPos, bool shouldDraw
             // Iterate to the next item
             items = items->next;
         }
-
-        // If the offset is nonzero, move it towards zero
-        while(row->d.row.tAccumulatedUs > US_PER_PIXEL_X)
-        {
-            row->d.row.tAccumulatedUs -= US_PER_PIXEL_X;
-            if(row->d.row.xOffset < 0)
-            {
-                row->d.row.xOffset++;
-            }
-            else if(row->d.row.xOffset > 0)
-            {
-                row->d.row.xOffset--;
-            }
-        }
     }
     else
     {
         // If there's only one item, just plot it
-        int16_t xPosS = (OLED_WIDTH - textWidth((char*)items->d.item.name, IBM_VGA_8)) / 2;
-        int16_t xPosF = plotText(xPosS, yPos,
-                                 (char*)items->d.item.name,
-                                 IBM_VGA_8, WHITE);
+        int16_t xPosS = (OLED_WIDTH - items->d.item.width) / 2;
+        int16_t xPosF = plotItem(row, items, xPosS, yPos);
 
         // If this is the selected item, draw a box around it
         if(shouldDrawBox)
@@ -288,10 +373,67 @@ void ICACHE_FLASH_ATTR drawRow(cLinkedNode_t* row, int16_t yPos, bool shouldDraw
     }
 }
 
+/**
+ * Move a row with multiple items towards its centered item, after it's drawn
+ *
+ * @param row The row to move
+ * @param tElapsedUs The time elapsed since this row was last drawn
+ */
+static void ICACHE_FLASH_ATTR moveRowToCenter(cLinkedNode_t* row, uint32_t tElapsedUs)
+{
+    if(row->d.row.numItems <= 1)
+    {
+        return;
+    }
+
+    row->d.row.tAccumulatedUs += tElapsedUs;
+
+    // If the offset is nonzero, move it towards zero
+    while(row->d.row.tAccumulatedUs > US_PER_PIXEL_X)
+    {
+        row->d.row.tAccumulatedUs -= US_PER_PIXEL_X;
+        if(row->d.row.xOffset < 0)
+        {
+            row->d.row.xOffset++;
+        }
+        else if(row->d.row.xOffset > 0)
+        {
+            row->d.row.xOffset--;
+        }
+    }
+}
+
+/**
+ * Hash the part of the display a menu draws over, to tell if anything else
+ * drew there since the menu was drawn
+ *
+ * @param menu The menu to hash the display area of
+ * @return A hash of the display area
+ */
+static uint32_t ICACHE_FLASH_ATTR hashMenuArea(menu_t* menu)
+{
+    uint8_t firstPage = (1 == menu->numRows) ? (SINGLE_ROW_Y / 8) : 0;
+    uint32_t hash = 2166136261UL;
+    uint16_t x;
+    for(x = 0; x < OLED_WIDTH; x++)
+    {
+        uint8_t* column = &currentFb[x * (OLED_HEIGHT / 8)];
+        uint8_t page;
+        for(page = firstPage; page < (OLED_HEIGHT / 8); page++)
+        {
+            hash = (hash ^ column[page]) * 16777619UL;
+        }
+    }
+    return hash;
+}
+
 /**
  * Draw the menu to the OLED. The menu has animations for smooth scrolling,
  * so it is recommended this function be called at least every 20ms
  *
+ * While the menu is at rest and nothing else has drawn over it, it isn't drawn
+ * again, so idle frames leave the display untouched
+ *
  * @param menu The menu to draw
  */
 void ICACHE_FLASH_ATTR drawMenu(menu_t* menu)
@@ -301,16 +443,6 @@ void ICACHE_FLASH_ATTR drawMenu(menu_t* menu)
     menu->tLastCallUs = tNowUs;
     menu->tAccumulatedUs += tElapsedUs;
 
-    // First clear the OLED
-    if(1 == menu->numRows)
-    {
-        fillDisplayArea(0, OLED_HEIGHT - FONT_HEIGHT_IBMVGA8 - 4, OLED_WIDTH, OLED_HEIGHT, BLACK);
-    }
-    else
-    {
-        clearDisplay();
-    }
-
     // Start with the seleted row to be drawn
     int16_t yPos = menu->yOffset + SELECTED_ROW_Y;
     cLinkedNode_t* row = menu->rows;
@@ -328,18 +460,85 @@ void ICACHE_FLASH_ATTR drawMenu(menu_t* menu)
             yPos -= (FONT_HEIGHT_IBMVGA8 + ROW_SPACING);
         }
     }
+    cLinkedNode_t* firstRow = row;
+    int16_t firstYPos = yPos;
+
+    // The menu only has to be drawn if it's moving, if it changed since it was
+    // last drawn, or if something else drew over it
+    bool atRest = (0 == menu->yOffset) && (0 == menu->rows->d.row.xOffset);
+    bool redraw = !(atRest && menu->drawnAtRest &&
+                    menu->drawnRow == menu->rows &&
+                    menu->drawnItem == menu->rows->d.row.items);
+
+    // Lay out every row which will be drawn, to find out if any changed
+    uint8_t rowsOnScreen = 0;
+    for(; yPos < OLED_HEIGHT; yPos += FONT_HEIGHT_IBMVGA8 + ROW_SPACING)
+    {
+        if(layOutRow(row))
+        {
+            redraw = true;
+        }
+        row = row->next;
+        rowsOnScreen++;
+    }
+    cLinkedNode_t* lastRow = row->prev;
 
-    // Draw rows until you run out of space on the OLED
-    while(yPos < OLED_HEIGHT)
+    if(redraw || menu->drawnHash != hashMenuArea(menu))
     {
-        // Draw the row
-        drawRow(row, yPos,
-                (row == menu->rows) && (menu->yOffset == 0) && (row->d.row.xOffset == 0),
-                tElapsedUs);
+        // First clear the OLED
+        if(1 == menu->numRows)
+        {
+            fillDisplayArea(0, SINGLE_ROW_Y, OLED_WIDTH, OLED_HEIGHT, BLACK);
+        }
+        else
+        {
+            clearDisplay();
+        }
 
-        // Move to the next row
+        // Draw rows until you run out of space on the OLED
+        row = firstRow;
+        for(yPos = firstYPos; yPos < OLED_HEIGHT; yPos += FONT_HEIGHT_IBMVGA8 + ROW_SPACING)
+        {
+            // Draw the row
+            drawRow(row, yPos,
+                    (row == menu->rows) && (menu->yOffset == 0) && (row->d.row.xOffset == 0));
+
+            // Move to the next row
+            row = row->next;
+        }
+
+        if(1 != menu->numRows)
+        {
+            // Clear the top 37 pixels of the OLED
+            fillDisplayArea(0, 0, OLED_WIDTH, BLANK_SPACE_Y, BLACK);
+
+            // Draw the title, centered
+            int16_t titleOffset = (OLED_WIDTH - textWidth((char*)menu->title, RADIOSTARS)) / 2;
+            plotText(titleOffset, 8, (char*)menu->title, RADIOSTARS, WHITE);
+        }
+
+        // Remember what was drawn, to skip drawing it again while it's at rest
+        menu->drawnAtRest = atRest;
+        menu->drawnRow = menu->rows;
+        menu->drawnItem = menu->rows->d.row.items;
+        menu->drawnHash = hashMenuArea(menu);
+
+        // Rows which scrolled off the display don't need their strips. The
+        // menu only scrolls a row at a time, so they're just past either end
+        if(menu->numRows > rowsOnScreen)
+        {
+            freeRowStrip(firstRow->prev);
+            freeRowStrip(lastRow->next);
+        }
+    }
+
+    // Move the rows which were drawn towards their centered items
+    row = firstRow;
+    uint8_t i;
+    for(i = 0; i < rowsOnScreen; i++)
+    {
+        moveRowToCenter(row, tElapsedUs);
         row = row->next;
-        yPos += FONT_HEIGHT_IBMVGA8 + ROW_SPACING;
     }
 
     if(1 != menu->numRows)
@@ -357,13 +556,6 @@ void ICACHE_FLASH_ATTR drawMenu(menu_t* menu)
                 menu->yOffset--;
             }
         }
-
-        // Clear the top 37 pixels of the OLED
-        fillDisplayArea(0, 0, OLED_WIDTH, BLANK_SPACE_Y, BLACK);
-
-        // Draw the title, centered
-        int16_t titleOffset = (OLED_WIDTH - textWidth((char*)menu->title, RADIOSTARS)) / 2;
-        plotText(titleOffset, 8, (char*)menu->title, RADIOSTARS, WHITE);
     }
 }
 
@@ -412,10 +604,11 @@ void ICACHE_FLASH_ATTR menuButton(menu_t* menu, int btn)
             if(menu->rows->d.row.numItems > 1)
             {
                 // To properly center the word, measure both old and new centered words
-                uint8_t oldWordWidth = textWidth((char*)menu->rows->d.row.items->d.item.name, IBM_VGA_8);
+                layOutRow(menu->rows);
+                int16_t oldWordWidth = menu->rows->d.row.items->d.item.width;
                 // Move to the previous item
                 menu->rows->d.row.items = menu->rows->d.row.items->prev;
-                uint8_t newWordWidth = textWidth((char*)menu->rows->d.row.items->d.item.name, IBM_VGA_8);
+                int16_t newWordWidth = menu->rows->d.row.items->d.item.width;
                 // Set the offset to smootly animate from the old, centered word to the new centered word
                 menu->rows->d.row.xOffset = -(newWordWidth + ITEM_SPACING + ((oldWordWidth - newWordWidth - 1) / 2));
             }
@@ -427,10 +620,11 @@ void ICACHE_FLASH_ATTR menuButton(menu_t* menu, int btn)
             if(menu->rows->d.row.numItems > 1)
             {
                 // To properly center the word, measure both old and new centered words
-                uint8_t oldWordWidth = textWidth((char*)menu->rows->d.row.items->d.item.name, IBM_VGA_8);
+                layOutRow(menu->rows);
+                int16_t oldWordWidth = menu->rows->d.row.items->d.item.width;
                 // Move to the next item
                 menu->rows->d.row.items = menu->rows->d.row.items->next;
-                uint8_t newWordWidth = textWidth((char*)menu->rows->d.row.items->d.item.name, IBM_VGA_8);
+                int16_t newWordWidth = menu->rows->d.row.items->d.item.width;
                 // Set the offset to smootly animate from the old, centered word to the new centered word
                 menu->rows->d.row.xOffset = oldWordWidth + ITEM_SPACING + ((newWordWidth - oldWordWidth - 1) / 2);
             }
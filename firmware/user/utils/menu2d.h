@@ -31,11 +31,15 @@ typedef struct
     uint8_t numItems;
     int8_t xOffset;
     uint32_t tAccumulatedUs;
+    uint16_t* strip; // Every item's text as columns, NULL when the row isn't on screen
 } rowInfo_t;
 
 typedef struct
 {
     const char* name;
+    const char* laidOutName; // The name width and stripX are for
+    int16_t width;           // textWidth() of the name
+    uint16_t stripX;         // Where the name's columns start in the row's strip
 } itemInfo_t;
 
 typedef union
@@ -60,6 +64,12 @@ typedef struct
     int8_t yOffset;
     uint32_t tLastCallUs;
     uint32_t tAccumulatedUs;
+    // What was on the display the last time the menu was drawn at rest, so
+    // drawing it again can be skipped
+    bool drawnAtRest;
+    cLinkedNode_t* drawnRow;
+    cLinkedNode_t* drawnItem;
+    uint32_t drawnHash;
 } menu_t;
 
 /*==============================================================================
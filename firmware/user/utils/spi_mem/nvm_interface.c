@@ -2,6 +2,7 @@
  * Includes
  *==========================================================================*/
 
+#include <stddef.h>
 #include <osapi.h>
 #include <spi_flash.h>
 #include <gpio.h>
@@ -12,13 +13,40 @@
 #include "nvm_interface.h"
 #include "user_main.h"
 #include "printControl.h"
+#include "synced_timer.h"
 
 /*============================================================================
  * Defines
  *==========================================================================*/
 
+// The key at the start of settings saved by the old whole-struct format
 #define SAVE_LOAD_KEY 0xC0
 
+/*
+ * Settings are saved as an append-only log of records across the sectors of
+ * the settings partition. Each record holds the current value of one field of
+ * settings_t, so changing a menu position writes a few bytes rather than
+ * erasing and rewriting everything. When a field is saved more than once, the
+ * last valid record wins.
+ *
+ * Only one sector is active at a time. When a record doesn't fit in it, the
+ * next sector is erased and compacted into by writing one record for every
+ * field, followed by the sector header. The header is written last so an
+ * interrupted compaction is ignored on the next boot. The sectors are used
+ * round robin, which spreads the erases across all of them.
+ */
+#define NUM_SETTINGS_SECTORS (USER_SETTINGS_SIZE / SPI_FLASH_SEC_SIZE)
+#define SETTINGS_SECTOR_MAGIC 0x54535753 // "SWST"
+
+// Flash reads and writes must be aligned to, and a multiple of, four bytes
+#define ALIGN4(x) (((x) + 3) & ~3)
+
+// Payloads are moved between flash and settings in chunks this large
+#define SETTINGS_CHUNK_SIZE 64
+
+// Changed settings are written once they've been left alone this long
+#define SETTINGS_FLUSH_IDLE_MS 3000
+
 /*============================================================================
  * Structs
  *==========================================================================*/
@@ -26,7 +54,7 @@
 // Should be no larger than USER_SETTINGS_SIZE
 typedef struct __attribute__((aligned(4)))
 {
-    uint8_t SaveLoadKey; //Must be SAVE_LOAD_KEY to be valid.
+    uint8_t SaveLoadKey; //Must be SAVE_LOAD_KEY to be valid. Only used by the old format
     bool isMuted;
     uint8_t menuPos;
     demon_t savedDemon;
@@ -48,6 +76,44 @@ typedef struct
     uint8_t* val;
 } configurable_t;
 
+// The fields of settings_t which are saved, each as its own record
+typedef enum
+{
+    SET_IS_MUTED,
+    SET_MENU_POS,
+    SET_SAVED_DEMON,
+    SET_DDR_HIGH_SCORES,
+    SET_DEMON_MEMORIALS,
+    SET_FLIGHT_SAVE_DATA,
+    SET_GIT_HASH,
+    SET_SELF_TEST_PASSED,
+    SET_RAYCASTER_SCORES,
+    SET_SSID,
+    SET_SSID_PW,
+    NUM_SETTINGS_KEYS
+} settingsKey_t;
+
+typedef struct
+{
+    uint16_t offset;
+    uint16_t size;
+    uint8_t version; // Bump this when the field's type changes so old records are ignored
+} settingsField_t;
+
+typedef struct __attribute__((aligned(4)))
+{
+    uint32_t magic; // SETTINGS_SECTOR_MAGIC
+    uint32_t seq;   // Incremented every compaction, the highest is the active sector
+} settingsSectorHdr_t;
+
+typedef struct __attribute__((aligned(4)))
+{
+    uint8_t key;     // A settingsKey_t, or 0xFF if this is erased flash
+    uint8_t version; // The settingsField_t version when this was written
+    uint16_t len;    // The length of the payload, which is padded to four bytes
+    uint32_t crc;    // The CRC32 of key, version, len and the payload
+} settingsRecordHdr_t;
+
 /*============================================================================
  * Variables
  *==========================================================================*/
@@ -66,11 +132,53 @@ settings_t settings =
 
 bool muteOverride = false;
 
+#define SETTINGS_FIELD(field, ver) { offsetof(settings_t, field), sizeof(((settings_t*)0)->field), ver }
+
+static const settingsField_t settingsFields[NUM_SETTINGS_KEYS] =
+{
+    [SET_IS_MUTED]         = SETTINGS_FIELD(isMuted, 1),
+    [SET_MENU_POS]         = SETTINGS_FIELD(menuPos, 1),
+    [SET_SAVED_DEMON]      = SETTINGS_FIELD(savedDemon, 1),
+    [SET_DDR_HIGH_SCORES]  = SETTINGS_FIELD(ddrHighScores, 1),
+    [SET_DEMON_MEMORIALS]  = SETTINGS_FIELD(demonMemorials, 1),
+    [SET_FLIGHT_SAVE_DATA] = SETTINGS_FIELD(flightSaveData, 1),
+    [SET_GIT_HASH]         = SETTINGS_FIELD(gitHash, 1),
+    [SET_SELF_TEST_PASSED] = SETTINGS_FIELD(selfTestPassed, 1),
+    [SET_RAYCASTER_SCORES] = SETTINGS_FIELD(raycasterScores, 1),
+    [SET_SSID]             = SETTINGS_FIELD(ssid, 1),
+    [SET_SSID_PW]          = SETTINGS_FIELD(ssidPw, 1),
+};
+
+// A compaction writes every field, which must fit in one sector
+_Static_assert(sizeof(settingsSectorHdr_t) + sizeof(settings_t) +
+               NUM_SETTINGS_KEYS * (sizeof(settingsRecordHdr_t) + 3) <= SPI_FLASH_SEC_SIZE,
+               "settings_t is too large to compact into one sector");
+// Each key has a bit in dirtySettings
+_Static_assert(NUM_SETTINGS_KEYS <= 32, "Too many settings keys");
+
+static uint8_t activeSector = 0;
+static uint32_t activeSeq = 0;
+// The offset in the active sector where the next record is written
+static uint32_t writeOffset = SPI_FLASH_SEC_SIZE;
+
+// Flash reads and writes go through this because they must be aligned
+static uint32_t settingsChunk[SETTINGS_CHUNK_SIZE / sizeof(uint32_t)];
+
+// A bit for each settingsKey_t which has changed since the last flush
+static uint32_t dirtySettings = 0;
+static timer_t settingsFlushTimer;
+
 /*============================================================================
  * Prototypes
  *==========================================================================*/
 
-void ICACHE_FLASH_ATTR SaveSettings(void);
+static uint32_t ICACHE_FLASH_ATTR settingsCrc(uint32_t crc, const uint8_t* data, uint32_t len);
+static uint32_t ICACHE_FLASH_ATTR settingsSectorAddr(uint8_t sector);
+static bool ICACHE_FLASH_ATTR readSettingsRecord(uint32_t addr, settingsRecordHdr_t* hdr, bool apply);
+static bool ICACHE_FLASH_ATTR writeSettingsRecord(uint32_t addr, settingsKey_t key);
+static bool ICACHE_FLASH_ATTR compactSettings(void);
+static void ICACHE_FLASH_ATTR saveSetting(settingsKey_t key);
+static void ICACHE_FLASH_ATTR settingsFlushTimerFunc(void* arg);
 //void ICACHE_FLASH_ATTR RevertAndSaveAllSettingsExceptLEDs(void);
 
 /*============================================================================
@@ -78,42 +186,325 @@ void ICACHE_FLASH_ATTR SaveSettings(void);
  *==========================================================================*/
 
 /**
- * Initialization for settings, called by user_init().
- * Reads settings from SPI flash into gConfigs.
- * This will load defaults if a key value isn't present in SPI flash.
+ * Update a CRC32 (IEEE 802.3) with more data, four bits at a time
+ *
+ * @param crc The CRC so far, start with 0
+ * @param data The data to add to the CRC
+ * @param len The length of the data
+ * @return The updated CRC
  */
-void ICACHE_FLASH_ATTR LoadSettings(void)
+static uint32_t ICACHE_FLASH_ATTR settingsCrc(uint32_t crc, const uint8_t* data, uint32_t len)
+{
+    static const uint32_t crcTable[16] =
+    {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    crc = ~crc;
+    while(len--)
+    {
+        crc ^= *(data++);
+        crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+        crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+/**
+ * @param sector A sector index within the settings partition
+ * @return The flash address of that sector
+ */
+static uint32_t ICACHE_FLASH_ATTR settingsSectorAddr(uint8_t sector)
 {
-    spi_flash_read( USER_SETTINGS_ADDR, (uint32*)&settings, sizeof( settings ) );
-    if( settings.SaveLoadKey == SAVE_LOAD_KEY )
+    return USER_SETTINGS_ADDR + (sector * SPI_FLASH_SEC_SIZE);
+}
+
+/**
+ * Read a record's payload from flash and check its CRC
+ *
+ * @param addr The flash address of the record's header
+ * @param hdr The record's header, already read
+ * @param apply true to copy the payload into settings if the CRC matches,
+ *              false to only check it
+ * @return true if the CRC matches, false if it doesn't
+ */
+static bool ICACHE_FLASH_ATTR readSettingsRecord(uint32_t addr, settingsRecordHdr_t* hdr, bool apply)
+{
+    uint8_t* dest = ((uint8_t*)&settings) + settingsFields[hdr->key].offset;
+    uint32_t crc = settingsCrc(0, (uint8_t*)hdr, offsetof(settingsRecordHdr_t, crc));
+
+    addr += sizeof(settingsRecordHdr_t);
+    for(uint16_t done = 0; done < hdr->len; done += SETTINGS_CHUNK_SIZE)
     {
-        INIT_PRINTF("Settings found\r\n");
+        uint16_t chunkLen = (hdr->len - done < SETTINGS_CHUNK_SIZE) ? (hdr->len - done) : SETTINGS_CHUNK_SIZE;
+        if(SPI_FLASH_RESULT_OK != spi_flash_read(addr + done, settingsChunk, ALIGN4(chunkLen)))
+        {
+            return false;
+        }
+        crc = settingsCrc(crc, (uint8_t*)settingsChunk, chunkLen);
+        if(apply)
+        {
+            ets_memcpy(&dest[done], settingsChunk, chunkLen);
+        }
     }
-    else
+    return crc == hdr->crc;
+}
+
+/**
+ * Write a record holding the current value of one field to flash. The header
+ * is written first, so a record torn by a reset fails its CRC and is ignored
+ *
+ * @param addr The flash address to write the record to, which must be erased
+ * @param key The field to write
+ * @return true if it was written, false if flash reported an error
+ */
+static bool ICACHE_FLASH_ATTR writeSettingsRecord(uint32_t addr, settingsKey_t key)
+{
+    const uint8_t* src = ((uint8_t*)&settings) + settingsFields[key].offset;
+    settingsRecordHdr_t hdr =
+    {
+        .key = key,
+        .version = settingsFields[key].version,
+        .len = settingsFields[key].size,
+    };
+    hdr.crc = settingsCrc(0, (uint8_t*)&hdr, offsetof(settingsRecordHdr_t, crc));
+    hdr.crc = settingsCrc(hdr.crc, src, hdr.len);
+
+    bool ok = true;
+    EnterCritical();
+    ok = ok && (SPI_FLASH_RESULT_OK == spi_flash_write(addr, (uint32*)&hdr, sizeof(hdr)));
+    addr += sizeof(hdr);
+    for(uint16_t done = 0; ok && done < hdr.len; done += SETTINGS_CHUNK_SIZE)
     {
-        INIT_PRINTF("Settings not found\r\n");
-        // Zero everything
-        ets_memset(&settings, 0, sizeof(settings));
-        // Set the key
-        settings.SaveLoadKey = SAVE_LOAD_KEY;
-        // Load in default values
-        settings.isMuted = false;
-        ets_memset(&(settings.savedDemon), 0, sizeof(demon_t));
-        settings.selfTestPassed = false;
-        // Save the values
-        SaveSettings();
+        uint16_t chunkLen = (hdr.len - done < SETTINGS_CHUNK_SIZE) ? (hdr.len - done) : SETTINGS_CHUNK_SIZE;
+        // Pad with erased bytes so the padding can be written later if need be
+        ets_memset(settingsChunk, 0xFF, sizeof(settingsChunk));
+        ets_memcpy(settingsChunk, &src[done], chunkLen);
+        ok = (SPI_FLASH_RESULT_OK == spi_flash_write(addr + done, settingsChunk, ALIGN4(chunkLen)));
     }
+    ExitCritical();
+    return ok;
 }
 
 /**
- * Save all settings from gConfigs[] to SPI flash
+ * Erase the next sector and write every field to it, then make it the active
+ * sector. This is only done when the active sector is full, or there is no
+ * valid sector at all
+ *
+ * @return true if the sector was compacted, false if flash reported an error
  */
-void ICACHE_FLASH_ATTR SaveSettings(void)
+static bool ICACHE_FLASH_ATTR compactSettings(void)
 {
+    uint8_t nextSector = (activeSector + 1) % NUM_SETTINGS_SECTORS;
+    uint32_t sectorAddr = settingsSectorAddr(nextSector);
+    INIT_PRINTF("Compacting settings into sector %d\r\n", nextSector);
+
+    EnterCritical();
+    spi_flash_erase_sector(sectorAddr / SPI_FLASH_SEC_SIZE);
+    ExitCritical();
+
+    uint32_t offset = sizeof(settingsSectorHdr_t);
+    for(settingsKey_t key = 0; key < NUM_SETTINGS_KEYS; key++)
+    {
+        if(!writeSettingsRecord(sectorAddr + offset, key))
+        {
+            // Leave the header unwritten so this sector is never loaded
+            return false;
+        }
+        offset += sizeof(settingsRecordHdr_t) + ALIGN4(settingsFields[key].size);
+    }
+
+    // Writing the header commits the compaction
+    settingsSectorHdr_t hdr =
+    {
+        .magic = SETTINGS_SECTOR_MAGIC,
+        .seq = activeSeq + 1,
+    };
     EnterCritical();
-    spi_flash_erase_sector( USER_SETTINGS_ADDR / SPI_FLASH_SEC_SIZE );
-    spi_flash_write( USER_SETTINGS_ADDR, (uint32*)&settings, ((sizeof( settings ) - 1) & (~0xf)) + 0x10 );
+    bool ok = (SPI_FLASH_RESULT_OK == spi_flash_write(sectorAddr, (uint32*)&hdr, sizeof(hdr)));
     ExitCritical();
+
+    if(ok)
+    {
+        activeSector = nextSector;
+        activeSeq = hdr.seq;
+        writeOffset = offset;
+    }
+    return ok;
+}
+
+/**
+ * Initialization for settings, called by user_init().
+ * Finds the active sector and replays its log of records into settings. Fields
+ * without a valid record keep their default values. Settings saved in the old
+ * whole-struct format are converted to the log.
+ */
+void ICACHE_FLASH_ATTR LoadSettings(void)
+{
+    timerSetFn(&settingsFlushTimer, settingsFlushTimerFunc, NULL);
+    dirtySettings = 0;
+
+    // Zero everything and load in default values
+    ets_memset(&settings, 0, sizeof(settings));
+    settings.isMuted = false;
+    settings.selfTestPassed = false;
+
+    // Find the sector with the highest sequence number
+    bool sectorFound = false;
+    for(uint8_t sector = 0; sector < NUM_SETTINGS_SECTORS; sector++)
+    {
+        settingsSectorHdr_t hdr;
+        if(SPI_FLASH_RESULT_OK == spi_flash_read(settingsSectorAddr(sector), (uint32*)&hdr, sizeof(hdr)) &&
+                SETTINGS_SECTOR_MAGIC == hdr.magic &&
+                (!sectorFound || (int32_t)(hdr.seq - activeSeq) > 0))
+        {
+            sectorFound = true;
+            activeSector = sector;
+            activeSeq = hdr.seq;
+        }
+    }
+
+    if(!sectorFound)
+    {
+        spi_flash_read(USER_SETTINGS_ADDR, (uint32*)&settings, sizeof(settings));
+        if(settings.SaveLoadKey == SAVE_LOAD_KEY)
+        {
+            INIT_PRINTF("Old settings found\r\n");
+        }
+        else
+        {
+            INIT_PRINTF("Settings not found\r\n");
+            ets_memset(&settings, 0, sizeof(settings));
+            settings.isMuted = false;
+            settings.selfTestPassed = false;
+        }
+        // Compact into sector 1, so old settings in sector 0 survive until the
+        // new ones are committed
+        activeSector = 0;
+        activeSeq = 0;
+        compactSettings();
+        return;
+    }
+
+    // Find the last valid record for each field
+    uint32_t sectorAddr = settingsSectorAddr(activeSector);
+    uint32_t latest[NUM_SETTINGS_KEYS] = {0};
+    writeOffset = sizeof(settingsSectorHdr_t);
+    while(writeOffset + sizeof(settingsRecordHdr_t) <= SPI_FLASH_SEC_SIZE)
+    {
+        settingsRecordHdr_t hdr;
+        if(SPI_FLASH_RESULT_OK != spi_flash_read(sectorAddr + writeOffset, (uint32*)&hdr, sizeof(hdr)))
+        {
+            writeOffset = SPI_FLASH_SEC_SIZE;
+            break;
+        }
+        if(0xFF == hdr.key && 0xFF == hdr.version && 0xFFFF == hdr.len && 0xFFFFFFFF == hdr.crc)
+        {
+            // Erased flash, the end of the log
+            break;
+        }
+        uint32_t recordLen = sizeof(settingsRecordHdr_t) + ALIGN4(hdr.len);
+        if(hdr.key >= NUM_SETTINGS_KEYS || writeOffset + recordLen > SPI_FLASH_SEC_SIZE)
+        {
+            // A garbled header means the rest can't be trusted, so treat the
+            // sector as full. The next save compacts
+            writeOffset = SPI_FLASH_SEC_SIZE;
+            break;
+        }
+        // Records from an older version of a field, or torn by a reset, are skipped
+        if(hdr.version == settingsFields[hdr.key].version &&
+                hdr.len == settingsFields[hdr.key].size &&
+                readSettingsRecord(sectorAddr + writeOffset, &hdr, false))
+        {
+            latest[hdr.key] = writeOffset;
+        }
+        writeOffset += recordLen;
+    }
+
+    for(settingsKey_t key = 0; key < NUM_SETTINGS_KEYS; key++)
+    {
+        settingsRecordHdr_t hdr;
+        if(latest[key] &&
+                SPI_FLASH_RESULT_OK == spi_flash_read(sectorAddr + latest[key], (uint32*)&hdr, sizeof(hdr)))
+        {
+            readSettingsRecord(sectorAddr + latest[key], &hdr, true);
+        }
+    }
+    INIT_PRINTF("Settings found in sector %d, %d bytes used\r\n", activeSector, writeOffset);
+}
+
+/**
+ * Mark a field of settings as changed. Changed fields are written together
+ * once settings have been left alone for SETTINGS_FLUSH_IDLE_MS, when the mode
+ * exits, before deep sleep, or when flushSettingsNow() is called
+ *
+ * @param key The field to save
+ */
+static void ICACHE_FLASH_ATTR saveSetting(settingsKey_t key)
+{
+    dirtySettings |= (1 << key);
+    // Rearming pushes the flush back, so a burst of changes is written once
+    timerArm(&settingsFlushTimer, SETTINGS_FLUSH_IDLE_MS, false);
+}
+
+/**
+ * Flush changed settings once they've been left alone for a while
+ *
+ * @param arg unused
+ */
+static void ICACHE_FLASH_ATTR settingsFlushTimerFunc(void* arg __attribute__((unused)))
+{
+    flushSettingsNow();
+}
+
+/**
+ * Append a record for every changed field of settings to the log, compacting
+ * instead if they don't all fit in the active sector. Call this after saving
+ * anything which must survive the Swadge being switched off right away
+ */
+void ICACHE_FLASH_ATTR flushSettingsNow(void)
+{
+    timerDisarm(&settingsFlushTimer);
+    if(0 == dirtySettings)
+    {
+        return;
+    }
+
+    uint32_t batchLen = 0;
+    for(settingsKey_t key = 0; key < NUM_SETTINGS_KEYS; key++)
+    {
+        if(dirtySettings & (1 << key))
+        {
+            batchLen += sizeof(settingsRecordHdr_t) + ALIGN4(settingsFields[key].size);
+        }
+    }
+
+    if(writeOffset + batchLen > SPI_FLASH_SEC_SIZE)
+    {
+        // Compaction writes every field, including the changed ones
+        if(compactSettings())
+        {
+            dirtySettings = 0;
+        }
+        return;
+    }
+
+    for(settingsKey_t key = 0; key < NUM_SETTINGS_KEYS; key++)
+    {
+        if(dirtySettings & (1 << key))
+        {
+            if(!writeSettingsRecord(settingsSectorAddr(activeSector) + writeOffset, key))
+            {
+                // The record may be partially written, so don't append after
+                // it. The next flush compacts instead
+                writeOffset = SPI_FLASH_SEC_SIZE;
+                return;
+            }
+            writeOffset += sizeof(settingsRecordHdr_t) + ALIGN4(settingsFields[key].size);
+            dirtySettings &= ~(1 << key);
+        }
+    }
 }
 
 uint8_t ICACHE_FLASH_ATTR getMenuPos(void)
@@ -124,7 +515,7 @@ uint8_t ICACHE_FLASH_ATTR getMenuPos(void)
 void ICACHE_FLASH_ATTR setMenuPos(uint8_t pos)
 {
     settings.menuPos = pos;
-    SaveSettings();
+    saveSetting(SET_MENU_POS);
 }
 
 #if defined(FEATURE_BZR)
@@ -146,7 +537,7 @@ bool ICACHE_FLASH_ATTR getIsMutedOption(void)
 void ICACHE_FLASH_ATTR setIsMutedOption(bool mute)
 {
     settings.isMuted = mute;
-    SaveSettings();
+    saveSetting(SET_IS_MUTED);
 }
 #endif
 
@@ -158,7 +549,7 @@ void ICACHE_FLASH_ATTR getSavedDemon(demon_t* demon)
 void ICACHE_FLASH_ATTR setSavedDemon(demon_t* demon)
 {
     ets_memcpy(&(settings.savedDemon), demon, sizeof(demon_t));
-    SaveSettings();
+    saveSetting(SET_SAVED_DEMON);
 }
 
 void ICACHE_FLASH_ATTR getDDRScores(ddrHighScores_t* highScores)
@@ -169,7 +560,7 @@ void ICACHE_FLASH_ATTR getDDRScores(ddrHighScores_t* highScores)
 void ICACHE_FLASH_ATTR setDDRScores(ddrHighScores_t* highScores)
 {
     ets_memcpy(&(settings.ddrHighScores), highScores, sizeof(ddrHighScores_t));
-    SaveSettings();
+    saveSetting(SET_DDR_HIGH_SCORES);
 }
 
 void ICACHE_FLASH_ATTR addDemonMemorial(char* name, int32_t actionsTaken)
@@ -205,7 +596,7 @@ void ICACHE_FLASH_ATTR addDemonMemorial(char* name, int32_t actionsTaken)
     settings.demonMemorials[insertionIdx].actionsTaken = actionsTaken;
 
     // Save the settings
-    SaveSettings();
+    saveSetting(SET_DEMON_MEMORIALS);
 }
 
 demonMemorial_t* ICACHE_FLASH_ATTR getDemonMemorials(void)
@@ -238,7 +629,7 @@ void ICACHE_FLASH_ATTR setGitHash(char* hash)
         hash[sizeof(settings.gitHash) - 1] = 0;
     }
     ets_memcpy(&(settings.gitHash), hash, len + 1);
-    SaveSettings();
+    saveSetting(SET_GIT_HASH);
 }
 
 bool ICACHE_FLASH_ATTR getSelfTestPass(void)
@@ -249,7 +640,7 @@ bool ICACHE_FLASH_ATTR getSelfTestPass(void)
 void ICACHE_FLASH_ATTR setSelfTestPass(bool pass)
 {
     settings.selfTestPassed = pass;
-    SaveSettings();
+    saveSetting(SET_SELF_TEST_PASSED);
 }
 
 
@@ -279,7 +670,7 @@ void ICACHE_FLASH_ATTR addRaycasterScore(raycasterDifficulty_t difficulty, uint1
             settings.raycasterScores.scores[difficulty][i].tElapsedUs = tElapsed;
 
             // Save the settings
-            SaveSettings();
+            saveSetting(SET_RAYCASTER_SCORES);
 
             return;
         }
@@ -297,7 +688,7 @@ void ICACHE_FLASH_ATTR setFlightSaveData( flightSimSaveData_t* t )
     {
         memcpy( t, &settings.flightSaveData, sizeof( *t ) );
     }
-    SaveSettings();
+    saveSetting(SET_FLIGHT_SAVE_DATA);
 }
 
 void ICACHE_FLASH_ATTR getSsidPw(char* ssid, char* pw)
@@ -310,7 +701,8 @@ void ICACHE_FLASH_ATTR setSsidPw(char* ssid, char* pw)
 {
     memcpy(settings.ssid, ssid, SSID_NAME_LEN);
     memcpy(settings.ssidPw, pw, SSID_NAME_LEN);
-    SaveSettings();
+    saveSetting(SET_SSID);
+    saveSetting(SET_SSID_PW);
 }
 
 
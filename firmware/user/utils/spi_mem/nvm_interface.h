@@ -40,6 +40,7 @@ typedef struct __attribute__((aligned(4)))
 flightSimSaveData_t;
 
 void ICACHE_FLASH_ATTR LoadSettings( void );
+void ICACHE_FLASH_ATTR flushSettingsNow( void );
 
 #if defined(FEATURE_BZR)
     void ICACHE_FLASH_ATTR setMuteOverride(bool opt);
@@ -2,51 +2,124 @@
  * Includes
  *----------------------------------------------------------------------------*/
 
+#include <user_interface.h>
+
 #include "synced_timer.h"
-#include "linked_list.h"
+#include "trace.h"
 
 #ifdef SYNCED_TIMER
 
-// #define debugTmr(t) os_printf("%s::%d -- %p: armed %s, repeat %s, src %d\n", __func__, __LINE__, t, t->isArmed?"true":"false", t->isRepeat?"true":"false", t->shouldRunCnt)
+// #define debugTmr(t) os_printf("%s::%d -- %p: armed %s, repeat %s, expire %d\n", __func__, __LINE__, t, t->isArmed?"true":"false", t->isRepeat?"true":"false", t->expireMs)
 #define debugTmr(t)
 
+#define WHEEL_MASK (SYNCED_TIMER_WHEEL_SLOTS - 1)
+
 /*------------------------------------------------------------------------------
  * Function Prototypes
  *----------------------------------------------------------------------------*/
 
-static void ICACHE_FLASH_ATTR incShouldRun(void* arg);
+static uint32_t ICACHE_FLASH_ATTR syncedTimerNowMs(void);
+static void ICACHE_FLASH_ATTR syncedTimerLink(syncedTimer_t* timer);
+static void ICACHE_FLASH_ATTR syncedTimerUnlink(syncedTimer_t* timer);
+static bool ICACHE_FLASH_ATTR syncedTimerIsLinked(syncedTimer_t* timer);
 
 /*------------------------------------------------------------------------------
  * Variables
  *----------------------------------------------------------------------------*/
 
-static list_t syncedTimerList = {0};
+// A hashed timing wheel. Each armed timer is linked into the bucket for its
+// expiration millisecond, modulo the number of buckets
+static syncedTimer_t* syncedTimerWheel[SYNCED_TIMER_WHEEL_SLOTS] = {NULL};
+
+// The last millisecond which was checked, and the microseconds past it
+static uint32_t wheelMs = 0;
+static uint32_t wheelLastUs = 0;
+static uint32_t wheelRemainderUs = 0;
+static bool wheelStarted = false;
+
+// The next timer to check in the bucket being run. Unlinking it moves this on
+static syncedTimer_t* wheelCursor = NULL;
 
 /*------------------------------------------------------------------------------
  * Functions
  *----------------------------------------------------------------------------*/
 
 /**
- * Internal function which is used as the actual timer function for os_timer.
- * All this does is is increment a count to run the actual timer function, which
- * is done in syncedTimersCheck().
+ * @return The current time in milliseconds, on the wheel's timeline
+ */
+static uint32_t ICACHE_FLASH_ATTR syncedTimerNowMs(void)
+{
+    if(!wheelStarted)
+    {
+        wheelLastUs = system_get_time();
+        wheelStarted = true;
+    }
+    return wheelMs + (system_get_time() - wheelLastUs + wheelRemainderUs) / 1000;
+}
+
+/**
+ * Link a timer into the bucket for its expiration time
+ *
+ * @param timer The timer to link, which must not be linked already
+ */
+static void ICACHE_FLASH_ATTR syncedTimerLink(syncedTimer_t* timer)
+{
+    syncedTimer_t** bucket = &syncedTimerWheel[timer->expireMs & WHEEL_MASK];
+    timer->next = *bucket;
+    if(NULL != timer->next)
+    {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = bucket;
+    *bucket = timer;
+}
+
+/**
+ * Unlink a timer from its bucket
  *
- * os_timers should be quick, so this allows us to register slow functions to
- * timers
+ * @param timer The timer to unlink, which must be linked
+ */
+static void ICACHE_FLASH_ATTR syncedTimerUnlink(syncedTimer_t* timer)
+{
+    if(wheelCursor == timer)
+    {
+        wheelCursor = timer->next;
+    }
+    *(timer->pprev) = timer->next;
+    if(NULL != timer->next)
+    {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/**
+ * Check if a timer is linked into the wheel, without trusting any of its
+ * fields. Only the one bucket it could be in is searched
  *
- * @param arg A pointer to the syncedTimer
+ * @param timer The timer to look for
+ * @return true if the timer is linked, false otherwise
  */
-static void ICACHE_FLASH_ATTR incShouldRun(void* arg)
+static bool ICACHE_FLASH_ATTR syncedTimerIsLinked(syncedTimer_t* timer)
 {
-    debugTmr(((syncedTimer_t*)arg));
-    ((syncedTimer_t*)arg)->shouldRunCnt++;
+    syncedTimer_t* node = syncedTimerWheel[timer->expireMs & WHEEL_MASK];
+    while(NULL != node)
+    {
+        if(node == timer)
+        {
+            return true;
+        }
+        node = node->next;
+    }
+    return false;
 }
 
 /**
  * Set timer callback function. The timer callback function must be set before
  * arming a timer.
  *
- * This is a wrapper for os_timer_setfn().
+ * This replaces os_timer_setfn().
  *
  * @param timer     The timer struct
  * @param timerFunc The timer callback function
@@ -55,27 +128,29 @@ static void ICACHE_FLASH_ATTR incShouldRun(void* arg)
 void ICACHE_FLASH_ATTR syncedTimerSetFn(syncedTimer_t* timer,
                                         os_timer_func_t* timerFunc, void* arg)
 {
-    // os_timer_setfn() can only be invoked when the timer is not enabled, i.e.,
-    // after os_timer_disarm() or before os_timer_arm(), so call os_timer_disarm
-    os_timer_disarm(&(timer->osTimer));
+    // The timer may be new and uninitialized, or already armed. Only unlink it
+    // if it is really in the wheel
+    if(syncedTimerIsLinked(timer))
+    {
+        syncedTimerUnlink(timer);
+    }
 
     // Save the function parameters
     timer->timerFunc = timerFunc;
     timer->arg = arg;
 
     // Zero out the variables
-    timer->shouldRunCnt = 0;
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expireMs = 0;
+    timer->periodMs = 0;
     timer->isArmed = false;
     timer->isRepeat = false;
-    ets_memset(&(timer->osTimer), 0, sizeof(os_timer_t));
-
-    // Set the timer function
-    os_timer_setfn(&(timer->osTimer), incShouldRun, timer);
 }
 
 /**
  * Arm a timer callback function to be called at some time or interval.
- * This is a wrapper for os_timer_arm();
+ * This replaces os_timer_arm(). Arming an armed timer restarts it
  *
  * @param timer       The timer struct
  * @param time        The number of milliseconds to call this timer in
@@ -84,120 +159,112 @@ void ICACHE_FLASH_ATTR syncedTimerSetFn(syncedTimer_t* timer,
 void ICACHE_FLASH_ATTR syncedTimerArm(syncedTimer_t* timer, uint32_t time,
                                       bool repeat_flag)
 {
-    // For the same timer, os_timer_arm() cannot be invoked repeatedly.
-    // os_timer_disarm() should be invoked first, so call os_timer_disarm()
-    os_timer_disarm(&(timer->osTimer));
+    if(timer->isArmed)
+    {
+        syncedTimerUnlink(timer);
+    }
 
-    // Then arm it with the parameters
-    os_timer_arm(&(timer->osTimer), time, repeat_flag);
+    // A timer can't fire in the millisecond it was armed in
+    if(0 == time)
+    {
+        time = 1;
+    }
+
+    timer->periodMs = time;
+    timer->expireMs = syncedTimerNowMs() + time;
     timer->isArmed = true;
     timer->isRepeat = repeat_flag;
+    syncedTimerLink(timer);
 
     debugTmr(timer);
-
-    // Check to see if this timer is in the list already
-    node_t* currentNode = syncedTimerList.first;
-    while (currentNode != NULL)
-    {
-        if(currentNode->val == timer)
-        {
-            // Already in the list, so return
-            return;
-        }
-        currentNode = currentNode->next;
-    }
-
-    // If it isn't in the list, push it into the list
-    push(&syncedTimerList, (void*)timer);
 }
 
 /**
  * Disarm a timer.
  *
- * This is a wrapper for os_timer_disarm()
+ * This replaces os_timer_disarm()
  *
  * @param timer The timer struct
  */
 void ICACHE_FLASH_ATTR syncedTimerDisarm(syncedTimer_t* timer)
 {
-    // Disarm the timer
-    os_timer_disarm(&(timer->osTimer));
+    if(timer->isArmed)
+    {
+        syncedTimerUnlink(timer);
+    }
     timer->isArmed = false;
     timer->isRepeat = false;
-    // And make sure the function isn't called again
-    timer->shouldRunCnt = 0;
-    // This will get removed from the list in syncedTimersCheck()
     debugTmr(timer);
 }
 
 /**
- * Check each synced timer and call it's respective function as many times as
- * necessary.
+ * Advance the timing wheel to the current time, calling each timer that
+ * expired. Only the bucket for each elapsed millisecond is visited. A repeating
+ * timer which fell behind is called once for each period it missed, in order.
+ * Timers armed from a callback are timed from when that callback was due.
  *
  * This must be called from procTask(), where functions can run for long times
  * without disrupting the system.
  */
 void ICACHE_FLASH_ATTR syncedTimersCheck(void)
 {
-    // For each timer, call the function if it's time
-    node_t* currentNode = syncedTimerList.first;
-    while (currentNode != NULL)
+    if(!wheelStarted)
     {
-        syncedTimer_t* timer = (syncedTimer_t*) currentNode->val;
+        syncedTimerNowMs();
+    }
 
-        // For as many times as the function should be called
-        while(0 < timer->shouldRunCnt)
+    // Move the wheel's timeline forward
+    uint32_t nowUs = system_get_time();
+    uint32_t elapsedUs = nowUs - wheelLastUs + wheelRemainderUs;
+    uint32_t nowMs = wheelMs + elapsedUs / 1000;
+    wheelLastUs = nowUs;
+    wheelRemainderUs = elapsedUs % 1000;
+
+    while(wheelMs != nowMs)
+    {
+        wheelMs++;
+
+        wheelCursor = syncedTimerWheel[wheelMs & WHEEL_MASK];
+        while(NULL != wheelCursor)
         {
-            debugTmr(timer);
-            // Call the function if it's still armed
-            if(true == timer->isArmed)
+            syncedTimer_t* timer = wheelCursor;
+            wheelCursor = timer->next;
+
+            // Timers for later turns of the wheel share the bucket
+            if(timer->expireMs != wheelMs)
             {
-                // If this is not a repeating timer, mark it disarmed
-                if(false == timer->isRepeat)
-                {
-                    timer->isArmed = false;
-                }
-                // Then call the timer function, this may rearm the timer
-                timer->timerFunc(timer->arg);
-                debugTmr(timer);
+                continue;
             }
 
-            // Decrement, making sure not to underflow
-            if(0 < timer->shouldRunCnt)
+            debugTmr(timer);
+            syncedTimerUnlink(timer);
+            if(timer->isRepeat)
             {
-                timer->shouldRunCnt--;
+                // Schedule the next period from when this one was due, not now
+                timer->expireMs += timer->periodMs;
+                syncedTimerLink(timer);
+            }
+            else
+            {
+                timer->isArmed = false;
             }
-        }
 
-        // Iterate to the next timer
-        currentNode = currentNode->next;
+            // Then call the timer function, this may rearm or disarm any timer
+            traceBeginArg("timer", timer->timerFunc);
+            timer->timerFunc(timer->arg);
+            traceEnd("timer");
+            debugTmr(timer);
+        }
     }
-
-    syncedTimerFlush();
 }
 
 /**
- * Remove all disarmed timers from the list
+ * Disarmed timers are unlinked immediately, so there is nothing to clean up.
+ * This is kept so modes can still call timerFlush() when exiting
  */
 void ICACHE_FLASH_ATTR syncedTimerFlush(void)
 {
-    // remove disarmed timers from the list
-    node_t* currentNode = syncedTimerList.first;
-    while (currentNode != NULL)
-    {
-        // Save the next node because currentNode may be freed below
-        node_t* next = currentNode->next;
-
-        // If the timer isn't armed anymore
-        if(false == (((syncedTimer_t*) currentNode->val))->isArmed)
-        {
-            // Remove it from the list
-            removeEntry(&syncedTimerList, currentNode);
-        }
-
-        // Iterate!
-        currentNode = next;
-    }
+    ;
 }
 
 #endif
@@ -23,10 +23,17 @@
 #define timersCheck()                 syncedTimersCheck()
 #define timerFlush()                  syncedTimerFlush()
 
-typedef struct
+// The number of buckets in the timing wheel, each is one millisecond. Must be
+// a power of two. Timers further out than this wait for more turns
+#define SYNCED_TIMER_WHEEL_SLOTS 64
+
+typedef struct _syncedTimer_t
 {
-    os_timer_t osTimer;
-    uint8_t shouldRunCnt;
+    // Links in the wheel's bucket, only valid while armed
+    struct _syncedTimer_t* next;
+    struct _syncedTimer_t** pprev;
+    uint32_t expireMs;
+    uint32_t periodMs;
     os_timer_func_t* timerFunc;
     void* arg;
     bool isArmed;
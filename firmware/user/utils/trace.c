@@ -0,0 +1,143 @@
+#include "trace.h"
+#include <osapi.h>
+#include <user_interface.h>
+#include <stdlib.h>
+
+// trace.c
+//
+// See trace.h for usage
+
+#if defined(TRACE_ENABLED)
+
+/*============================================================================
+ * Variables
+ *==========================================================================*/
+
+static traceEvt_t traceBuf[TRACE_BUF_LEN];
+// The total number of events recorded, the write index is this mod TRACE_BUF_LEN
+static uint32_t traceNumRecorded = 0;
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * Record a trace event in the ring buffer, overwriting the oldest event if
+ * the buffer is full
+ *
+ * This intentionally does not have ICACHE_FLASH_ATTR because it may be called often
+ *
+ * @param type The type of event, begin, end or instant
+ * @param name The name of the event. The pointer is saved, not the string, so
+ *             it must be a string literal or otherwise live forever
+ * @param arg  An optional argument to save with the event
+ */
+void traceRecord(traceEvtType_t type, const char* name, uint32_t arg)
+{
+    traceEvt_t* evt = &traceBuf[traceNumRecorded++ & (TRACE_BUF_LEN - 1)];
+    evt->timeUs = system_get_time();
+    evt->name = name;
+    evt->arg = arg;
+    evt->type = type;
+}
+
+/**
+ * Record the end event for a TRACE_SCOPE(). This is called automatically when
+ * the scope's variable goes out of scope
+ *
+ * @param name A pointer to the scope's name
+ */
+void traceScopeEnd(const char** name)
+{
+    traceRecord(TRACE_END, *name, 0);
+}
+
+/**
+ * Throw away all recorded events
+ */
+void ICACHE_FLASH_ATTR traceClear(void)
+{
+    traceNumRecorded = 0;
+}
+
+/**
+ * @return The number of events currently in the buffer
+ */
+uint32_t ICACHE_FLASH_ATTR traceGetNumEvents(void)
+{
+    return (traceNumRecorded < TRACE_BUF_LEN) ? traceNumRecorded : TRACE_BUF_LEN;
+}
+
+/**
+ * Write all events in the buffer, oldest first, as Chrome trace JSON.
+ * The output can be opened in chrome://tracing or ui.perfetto.dev
+ *
+ * @param fnWrite A function to write each chunk of JSON with
+ * @param ctx     A context to pass to fnWrite
+ */
+void ICACHE_FLASH_ATTR traceDumpJson(traceWriteFn_t fnWrite, void* ctx)
+{
+    char line[128];
+    uint32_t numEvts = traceGetNumEvents();
+    uint32_t startIdx = traceNumRecorded - numEvts;
+
+    fnWrite("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", ctx);
+    for(uint32_t i = 0; i < numEvts; i++)
+    {
+        traceEvt_t* evt = &traceBuf[(startIdx + i) & (TRACE_BUF_LEN - 1)];
+
+        const char* phase;
+        switch((traceEvtType_t)evt->type)
+        {
+            case TRACE_BEGIN:
+            {
+                phase = "\"ph\":\"B\"";
+                break;
+            }
+            case TRACE_END:
+            {
+                phase = "\"ph\":\"E\"";
+                break;
+            }
+            default:
+            case TRACE_INSTANT:
+            {
+                phase = "\"ph\":\"i\",\"s\":\"t\"";
+                break;
+            }
+        }
+
+        ets_snprintf(line, sizeof(line),
+                     "{\"name\":\"%s\",%s,\"ts\":%u,\"pid\":1,\"tid\":1,\"args\":{\"arg\":%u}}%s\n",
+                     (NULL != evt->name) ? evt->name : "?",
+                     phase,
+                     evt->timeUs,
+                     evt->arg,
+                     (i + 1 < numEvts) ? "," : "");
+        fnWrite(line, ctx);
+    }
+    fnWrite("]}\n", ctx);
+}
+
+/**
+ * Write a chunk of trace JSON to the UART
+ *
+ * @param str The chunk to write
+ * @param ctx unused
+ */
+static void ICACHE_FLASH_ATTR traceWriteUart(const char* str, void* ctx __attribute__((unused)))
+{
+    os_printf("%s", str);
+}
+
+/**
+ * Dump all events in the buffer as Chrome trace JSON over the UART with
+ * os_printf(). Copy everything between the braces from the serial terminal
+ * into a .json file to view it
+ */
+void ICACHE_FLASH_ATTR traceDumpUart(void)
+{
+    traceDumpJson(traceWriteUart, NULL);
+}
+
+#endif
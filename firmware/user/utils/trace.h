@@ -0,0 +1,103 @@
+#ifndef _TRACE_H
+#define _TRACE_H
+#include <osapi.h>
+#include <ets_sys.h>
+// trace.h
+//
+// A ring buffer trace recorder with named begin, end and instant events.
+// Where maxtime.h only keeps the longest duration of a monitored function,
+// this keeps a timeline of the last TRACE_BUF_LEN events which can be dumped
+// as Chrome trace JSON and opened in chrome://tracing or ui.perfetto.dev
+//
+// Recording an event is a timestamp read and a few stores, so it is cheap
+// enough for hot functions. Events are not locked, so events recorded from an
+// interrupt while another event is being recorded may be lost
+//
+// Tracing is always compiled in for the emulator. On the device it is only
+// compiled in if SWADGE_TRACE is defined, i.e. "make SWADGE_TRACE=1". If it is
+// not compiled in, all of these macros compile to nothing
+//
+// eg myFunc()
+// {
+//      TRACE_SCOPE("myFunc");
+//      ....
+//      traceInstant("something happened");
+//      ....
+// } // The end event is recorded automatically when the scope is left
+//
+
+#if defined(EMU) || defined(SWADGE_TRACE)
+    #define TRACE_ENABLED
+#endif
+
+#if defined(EMU)
+    #define TRACE_BUF_LEN 8192 // Must be a power of two
+#else
+    #define TRACE_BUF_LEN 128  // Must be a power of two, 16 bytes each
+#endif
+
+typedef enum
+{
+    TRACE_BEGIN,
+    TRACE_END,
+    TRACE_INSTANT
+} traceEvtType_t;
+
+typedef struct
+{
+    uint32_t timeUs;
+    const char* name;
+    uint32_t arg;
+    uint8_t type;
+} traceEvt_t;
+
+/**
+ * A function which writes a chunk of the trace dump somewhere
+ *
+ * @param str A null terminated string to write
+ * @param ctx The context passed to traceDumpJson()
+ */
+typedef void (*traceWriteFn_t)(const char* str, void* ctx);
+
+#if defined(TRACE_ENABLED)
+
+    void traceRecord(traceEvtType_t type, const char* name, uint32_t arg);
+    void traceScopeEnd(const char** name);
+
+    #define traceBegin(name)          traceRecord(TRACE_BEGIN,   (name), 0)
+    #define traceEnd(name)            traceRecord(TRACE_END,     (name), 0)
+    #define traceInstant(name)        traceRecord(TRACE_INSTANT, (name), 0)
+    #define traceBeginArg(name, arg)  traceRecord(TRACE_BEGIN,   (name), (uint32_t)(uintptr_t)(arg))
+    #define traceInstantArg(name, arg) traceRecord(TRACE_INSTANT, (name), (uint32_t)(uintptr_t)(arg))
+
+    #define _TRACE_CAT2(a, b) a##b
+    #define _TRACE_CAT(a, b) _TRACE_CAT2(a, b)
+    // Record a begin event now and the matching end event when the scope is left
+    #define TRACE_SCOPE(name) \
+        const char* _TRACE_CAT(_traceScope, __LINE__) __attribute__((cleanup(traceScopeEnd), unused)) = \
+            (traceBegin(name), (name))
+    #define TRACE_FUNC() TRACE_SCOPE(__func__)
+
+    void ICACHE_FLASH_ATTR traceClear(void);
+    uint32_t ICACHE_FLASH_ATTR traceGetNumEvents(void);
+    void ICACHE_FLASH_ATTR traceDumpJson(traceWriteFn_t fnWrite, void* ctx);
+    void ICACHE_FLASH_ATTR traceDumpUart(void);
+
+#else
+
+    #define traceBegin(name)
+    #define traceEnd(name)
+    #define traceInstant(name)
+    #define traceBeginArg(name, arg)
+    #define traceInstantArg(name, arg)
+    #define TRACE_SCOPE(name)
+    #define TRACE_FUNC()
+
+    #define traceClear()
+    #define traceGetNumEvents() 0
+    #define traceDumpJson(fnWrite, ctx)
+    #define traceDumpUart()
+
+#endif
+
+#endif
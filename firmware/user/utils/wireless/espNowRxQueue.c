@@ -0,0 +1,118 @@
+/*============================================================================
+ * Includes
+ *==========================================================================*/
+
+#include <user_interface.h>
+
+#include "user_main.h"
+#include "espNowRxQueue.h"
+
+/*============================================================================
+ * Structs
+ *==========================================================================*/
+
+typedef struct
+{
+    uint8_t mac[6];
+    uint8_t rssi;
+    uint8_t len;
+    uint32_t timeUs;
+    uint8_t data[ESPNOW_MAX_LEN];
+} espNowRxFrame_t;
+
+/*============================================================================
+ * Variables
+ *==========================================================================*/
+
+static espNowRxFrame_t espNowRxQueue[ESPNOW_RX_QUEUE_LEN];
+static volatile uint8_t espNowRxHead = 0;
+static volatile uint8_t espNowRxTail = 0;
+static espNowRxStats_t espNowRxStats = {0};
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * Copy a received ESP-NOW frame into the queue. This is called from the
+ * receive callback, so it only copies and counts. The frame is delivered to
+ * the Swadge mode by espNowRxProcess()
+ *
+ * @param mac_addr The MAC address of the sender
+ * @param data     The data which was received
+ * @param len      The length of the data which was received
+ * @param rssi     The received signal strength
+ * @return true if the frame was queued, false if it was dropped
+ */
+bool ICACHE_FLASH_ATTR espNowRxEnqueue(const uint8_t* mac_addr, const uint8_t* data, uint8_t len, uint8_t rssi)
+{
+    uint8_t tail = espNowRxTail;
+    uint8_t nextTail = (tail + 1) % ESPNOW_RX_QUEUE_LEN;
+    if(nextTail == espNowRxHead || len > ESPNOW_MAX_LEN)
+    {
+        espNowRxStats.framesDropped++;
+        return false;
+    }
+
+    espNowRxFrame_t* frame = &espNowRxQueue[tail];
+    ets_memcpy(frame->mac, mac_addr, sizeof(frame->mac));
+    ets_memcpy(frame->data, data, len);
+    frame->len = len;
+    frame->rssi = rssi;
+    frame->timeUs = system_get_time();
+
+    // Publish the frame only after it is fully written
+    espNowRxTail = nextTail;
+
+    espNowRxStats.framesQueued++;
+    uint8_t depth = (nextTail + ESPNOW_RX_QUEUE_LEN - espNowRxHead) % ESPNOW_RX_QUEUE_LEN;
+    if(depth > espNowRxStats.maxDepth)
+    {
+        espNowRxStats.maxDepth = depth;
+    }
+    return true;
+}
+
+/**
+ * Deliver up to ESPNOW_RX_BUDGET queued frames to the Swadge mode, oldest
+ * first. This must be called from procTask()
+ */
+void ICACHE_FLASH_ATTR espNowRxProcess(void)
+{
+    uint8_t budget = ESPNOW_RX_BUDGET;
+    while(budget > 0 && espNowRxHead != espNowRxTail)
+    {
+        espNowRxFrame_t* frame = &espNowRxQueue[espNowRxHead];
+
+        uint32_t latencyUs = system_get_time() - frame->timeUs;
+        espNowRxStats.totalLatencyUs += latencyUs;
+        if(latencyUs > espNowRxStats.maxLatencyUs)
+        {
+            espNowRxStats.maxLatencyUs = latencyUs;
+        }
+        espNowRxStats.framesDelivered++;
+
+        swadgeModeEspNowRecvCb(frame->mac, frame->data, frame->len, frame->rssi);
+
+        // Free the slot only after the mode is done with it
+        espNowRxHead = (espNowRxHead + 1) % ESPNOW_RX_QUEUE_LEN;
+        budget--;
+    }
+}
+
+/**
+ * Discard every queued frame without delivering it, i.e. when ESP-NOW is
+ * turned off and old frames shouldn't reach the next user
+ */
+void ICACHE_FLASH_ATTR espNowRxFlush(void)
+{
+    espNowRxHead = espNowRxTail;
+}
+
+/**
+ * @return The receive queue's counters, since boot
+ */
+const espNowRxStats_t* ICACHE_FLASH_ATTR espNowRxGetStats(void)
+{
+    return &espNowRxStats;
+}
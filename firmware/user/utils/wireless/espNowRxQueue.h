@@ -0,0 +1,52 @@
+#ifndef _ESPNOW_RX_QUEUE_H_
+#define _ESPNOW_RX_QUEUE_H_
+
+#include <osapi.h>
+#include <c_types.h>
+
+/*
+ * Received ESP-NOW frames are copied into this queue by the WiFi callback and
+ * handed to the Swadge mode later from procTask(). Mode code never runs from
+ * the WiFi callback, and frames are delivered at the same point in the main
+ * loop as button events and timers, so the emulator can replay them exactly.
+ *
+ * There is one producer (the receive callback) and one consumer (procTask()),
+ * so the ring only needs volatile head and tail indices, no locks.
+ */
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+// How many received frames can wait for procTask(). One slot is always empty
+#define ESPNOW_RX_QUEUE_LEN 8
+
+// The most frames delivered per procTask() pass, so a burst can't stall a frame
+#define ESPNOW_RX_BUDGET 4
+
+#define ESPNOW_MAX_LEN 250
+
+/*============================================================================
+ * Structs
+ *==========================================================================*/
+
+typedef struct
+{
+    uint32_t framesQueued;    // Frames put in the queue
+    uint32_t framesDelivered; // Frames handed to the Swadge mode
+    uint32_t framesDropped;   // Frames dropped because the queue was full
+    uint8_t maxDepth;         // The most frames ever waiting at once
+    uint32_t maxLatencyUs;    // The longest a frame waited before delivery
+    uint32_t totalLatencyUs;  // Divide by framesDelivered for the average wait
+} espNowRxStats_t;
+
+/*============================================================================
+ * Prototypes
+ *==========================================================================*/
+
+bool ICACHE_FLASH_ATTR espNowRxEnqueue(const uint8_t* mac_addr, const uint8_t* data, uint8_t len, uint8_t rssi);
+void ICACHE_FLASH_ATTR espNowRxProcess(void);
+void ICACHE_FLASH_ATTR espNowRxFlush(void);
+const espNowRxStats_t* ICACHE_FLASH_ATTR espNowRxGetStats(void);
+
+#endif
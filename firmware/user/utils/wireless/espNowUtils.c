@@ -15,8 +15,10 @@
 #include <osapi.h>
 
 #include "espNowUtils.h"
+#include "espNowRxQueue.h"
 #include "user_main.h"
 #include "printControl.h"
+#include "trace.h"
 
 /*============================================================================
  * Variables
@@ -142,6 +144,8 @@ void ICACHE_FLASH_ATTR espNowInit(void)
  */
 void ICACHE_FLASH_ATTR espNowRecvCb(uint8_t* mac_addr, uint8_t* data, uint8_t len)
 {
+    TRACE_SCOPE("espNowRecvCb");
+
     // Buried in a header, goes from 1 (far away) to 91 (practically touching)
     uint8_t rssi = data[-51];
 
@@ -167,7 +171,8 @@ void ICACHE_FLASH_ATTR espNowRecvCb(uint8_t* mac_addr, uint8_t* data, uint8_t le
                 dbg);
 #endif
 
-    swadgeModeEspNowRecvCb(mac_addr, data, len, rssi);
+    // Queue the frame, the Swadge mode gets it from procTask()
+    espNowRxEnqueue(mac_addr, data, len, rssi);
 }
 
 /**
@@ -237,4 +242,5 @@ void ICACHE_FLASH_ATTR espNowDeinit(void)
     esp_now_unregister_recv_cb();
     esp_now_unregister_send_cb();
     esp_now_deinit();
+    espNowRxFlush();
 }
@@ -2,37 +2,46 @@
 
 /* PlantUML documentation
 
+Packets are a p2pPktHdr_t followed by an optional binary payload. They're shown
+here as "type seq dst cmd payload". Reliable packets also carry the sender's
+oldest unACKed sequence number, which isn't shown
+
 == Connection ==
 
 group Part 1
-"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "p2p_con" (broadcast)
-"Swadge_12:12:12:12:12:12" ->  "Swadge_AB:AB:AB:AB:AB:AB" : "p2p_str_00_AB:AB:AB:AB:AB:AB"
+"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "CON" (broadcast)
+"Swadge_12:12:12:12:12:12" ->  "Swadge_AB:AB:AB:AB:AB:AB" : "START 00 AB:AB:AB:AB:AB:AB"
 note left: Stop Broadcasting, set p2p->cnc.rxGameStartMsg
-"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "p2p_ack_00_12:12:12:12:12:12"
+"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "ACK 00 12:12:12:12:12:12"
 note right: set p2p->cnc.rxGameStartAck
 end
 
 group Part 2
-"Swadge_12:12:12:12:12:12" ->  "Swadge_AB:AB:AB:AB:AB:AB" : "p2p_con" (broadcast)
-"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "p2p_str_01_12:12:12:12:12:12"
+"Swadge_12:12:12:12:12:12" ->  "Swadge_AB:AB:AB:AB:AB:AB" : "CON" (broadcast)
+"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "START 01 12:12:12:12:12:12"
 note right: Stop Broadcasting, set p2p->cnc.rxGameStartMsg, become CLIENT
-"Swadge_12:12:12:12:12:12" ->  "Swadge_AB:AB:AB:AB:AB:AB" : "p2p_ack_01_AB:AB:AB:AB:AB:AB"
+"Swadge_12:12:12:12:12:12" ->  "Swadge_AB:AB:AB:AB:AB:AB" : "ACK 01 AB:AB:AB:AB:AB:AB"
 note left: set p2p->cnc.rxGameStartAck, become SERVER
 end
 
 == Unreliable Communication Example ==
 
 group Retries & Sequence Numbers
-"Swadge_AB:AB:AB:AB:AB:AB" ->x "Swadge_12:12:12:12:12:12" : "p2p_cnt_04_12:12:12:12:12:12_up"
+"Swadge_AB:AB:AB:AB:AB:AB" ->x "Swadge_12:12:12:12:12:12" : "MSG 04 12:12:12:12:12:12 cnt [up]"
 note right: msg not received
-"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "p2p_cnt_04_12:12:12:12:12:12_up"
-note left: first retry, up to five retries
-"Swadge_12:12:12:12:12:12" ->x "Swadge_AB:AB:AB:AB:AB:AB" : "p2p_ack_04_AB:AB:AB:AB:AB:AB"
+"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "MSG 05 12:12:12:12:12:12 cnt [dn]"
+note left: sent without waiting, up to P2P_WINDOW_SIZE in flight
+note right: buffered until 04 arrives
+"Swadge_12:12:12:12:12:12" ->  "Swadge_AB:AB:AB:AB:AB:AB" : "ACK 04 AB:AB:AB:AB:AB:AB [01]"
+note left: 05 is selectively ACKed, only 04 is retried
+"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "MSG 04 12:12:12:12:12:12 cnt [up]"
+note right: 04 then 05 are delivered in order
+"Swadge_12:12:12:12:12:12" ->x "Swadge_AB:AB:AB:AB:AB:AB" : "ACK 06 AB:AB:AB:AB:AB:AB [00]"
 note left: ack not received
-"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "p2p_cnt_04_12:12:12:12:12:12_up"
+"Swadge_AB:AB:AB:AB:AB:AB" ->  "Swadge_12:12:12:12:12:12" : "MSG 04 12:12:12:12:12:12 cnt [up]"
 note left: second retry
-note right: duplicate seq num, ignore message
-"Swadge_12:12:12:12:12:12" ->  "Swadge_AB:AB:AB:AB:AB:AB" : "p2p_ack_05_AB:AB:AB:AB:AB:AB"
+note right: old seq num, ACK again but ignore message
+"Swadge_12:12:12:12:12:12" ->  "Swadge_AB:AB:AB:AB:AB:AB" : "ACK 06 AB:AB:AB:AB:AB:AB [00]"
 end
 
 */
@@ -56,42 +65,60 @@ end
 // The time we'll spend retrying messages
 #define RETRY_TIME_MS 3000
 
+// The retry timeout before any round trip time is measured. This is 69ms, the
+// measured worst case, plus up to 16ms for transmission
+#define P2P_INITIAL_RTO_MS 85
+
+// Bounds for the retry timeout. The minimum leaves time for the other swadge's
+// procTask() to run, and the maximum caps the exponential backoff
+#define P2P_MIN_RTO_MS 10
+#define P2P_MAX_RTO_MS 250
+
+// How long messages from the mode are held so more can share their packet.
+// This is less than a frame, so messages sent during one frame go together
+#define P2P_AGG_DELAY_MS 5
+
 // Time to wait between connection events and game rounds.
 // Transmission can be 3s (see above), the round @ 12ms period is 3.636s
 // (240 steps of rotation + (252/4) steps of decay) * 12ms
 #define FAILURE_RESTART_MS 8000
 
-// Indices into messages
-#define CMD_IDX 4
-#define SEQ_IDX 8
-#define MAC_IDX 11
-#define EXT_IDX 29
+// Sequence numbers are eight bits and wrap, so compare them as signed
+// differences. This is negative if a is before b
+#define SEQ_DIFF(a, b) ((int8_t)((uint8_t)(a) - (uint8_t)(b)))
+
+// Sequence numbers index the window slots, so they must wrap together
+_Static_assert(0 == (256 % P2P_WINDOW_SIZE), "P2P_WINDOW_SIZE must divide 256");
+_Static_assert(P2P_WINDOW_SIZE <= 8, "Selective ACKs only have eight bits");
 
 /*============================================================================
  * Variables
  *==========================================================================*/
 
-// Messages to send.
-const char p2pConnectionMsgFmt[] = "%s_con";
-const char p2pNoPayloadMsgFmt[]  = "%s_%s_%02d_%02X:%02X:%02X:%02X:%02X:%02X";
-const char p2pPayloadMsgFmt[]    = "%s_%s_%02d_%02X:%02X:%02X:%02X:%02X:%02X_%s";
-const char p2pMacFmt[] = "%02X:%02X:%02X:%02X:%02X:%02X";
+static const uint8_t p2pBroadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
 /*============================================================================
  * Function Prototypes
  *==========================================================================*/
 
 void ICACHE_FLASH_ATTR p2pConnectionTimeout(void* arg);
-void ICACHE_FLASH_ATTR p2pTxAllRetriesTimeout(void* arg);
 void ICACHE_FLASH_ATTR p2pTxRetryTimeout(void* arg);
 void ICACHE_FLASH_ATTR p2pStartRestartTimer(void* arg);
 void ICACHE_FLASH_ATTR p2pProcConnectionEvt(p2pInfo* p2p, connectionEvt_t event);
 void ICACHE_FLASH_ATTR p2pGameStartAckRecv(void* arg);
-void ICACHE_FLASH_ATTR p2pSendAckToMac(p2pInfo* p2p, uint8_t* mac_addr);
-void ICACHE_FLASH_ATTR p2pSendMsgEx(p2pInfo* p2p, char* msg, uint16_t len,
-                                    bool shouldAck, void (*success)(void*), void (*failure)(void*));
-void ICACHE_FLASH_ATTR p2pModeMsgSuccess(void* arg);
-void ICACHE_FLASH_ATTR p2pModeMsgFailure(void* arg);
+void ICACHE_FLASH_ATTR p2pSendAckToMac(p2pInfo* p2p, uint8_t* mac_addr, uint8_t rxSeq);
+bool ICACHE_FLASH_ATTR p2pSendMsgEx(p2pInfo* p2p, uint8_t* msg, uint16_t len,
+                                    bool shouldAck, void (*success)(void*), void (*failure)(void*),
+                                    p2pMsgTxCbFn* msgTxCbFns, uint8_t numMsgs);
+void ICACHE_FLASH_ATTR p2pAggTimeout(void* arg);
+bool ICACHE_FLASH_ATTR p2pSendHdrToMac(p2pInfo* p2p, p2pPktType_t type, const uint8_t* mac_addr,
+                                       bool shouldAck, void (*success)(void*), void (*failure)(void*));
+void ICACHE_FLASH_ATTR p2pTxSlotSend(p2pTxSlot_t* slot);
+void ICACHE_FLASH_ATTR p2pTxSlotFree(p2pTxSlot_t* slot);
+void ICACHE_FLASH_ATTR p2pRttSample(p2pInfo* p2p, uint32_t rttUs);
+void ICACHE_FLASH_ATTR p2pRecvAck(p2pInfo* p2p, p2pPktHdr_t* hdr, uint8_t* payload);
+void ICACHE_FLASH_ATTR p2pRecvReliable(p2pInfo* p2p, uint8_t* mac_addr, uint8_t* data, uint8_t len);
+void ICACHE_FLASH_ATTR p2pProcessPkt(p2pInfo* p2p, uint8_t* data);
 
 /*============================================================================
  * Functions
@@ -123,62 +150,26 @@ void ICACHE_FLASH_ATTR p2pInitialize(p2pInfo* p2p, char* msgId,
     p2p->conCbFn = conCbFn;
     p2p->msgRxCbFn = msgRxCbFn;
 
-    // Set the initial sequence number at 255 so that a 0 received is valid.
-    p2p->cnc.lastSeqNum = 255;
-
     // Set the connection Rssi, the higher the value, the closer the swadges
     // need to be.
     p2p->connectionRssi = connectionRssi;
 
+    // Retry conservatively until a round trip time is measured
+    p2p->stats.rtoMs = P2P_INITIAL_RTO_MS;
+
     // Set the three character message ID
     ets_strncpy(p2p->msgId, msgId, sizeof(p2p->msgId));
 
-    // Get and save the string form of our MAC address
-    uint8_t mymac[6];
-    wifi_get_macaddr(SOFTAP_IF, mymac);
-    ets_snprintf(p2p->cnc.macStr, sizeof(p2p->cnc.macStr), p2pMacFmt,
-                 mymac[0],
-                 mymac[1],
-                 mymac[2],
-                 mymac[3],
-                 mymac[4],
-                 mymac[5]);
-
-    // Set up the connection message
-    ets_snprintf(p2p->conMsg, sizeof(p2p->conMsg), p2pConnectionMsgFmt,
-                 p2p->msgId);
-
-    // Set up dummy ACK message
-    ets_snprintf(p2p->ackMsg, sizeof(p2p->ackMsg), p2pNoPayloadMsgFmt,
-                 p2p->msgId,
-                 "ack",
-                 0,
-                 0xFF,
-                 0xFF,
-                 0xFF,
-                 0xFF,
-                 0xFF,
-                 0xFF);
-
-    // Set up dummy start message
-    ets_snprintf(p2p->startMsg, sizeof(p2p->startMsg), p2pNoPayloadMsgFmt,
-                 p2p->msgId,
-                 "str",
-                 0,
-                 0xFF,
-                 0xFF,
-                 0xFF,
-                 0xFF,
-                 0xFF,
-                 0xFF);
-
-    // Set up a timer for acking messages
-    timerDisarm(&p2p->tmr.TxRetry);
-    timerSetFn(&p2p->tmr.TxRetry, p2pTxRetryTimeout, p2p);
-
-    // Set up a timer for when a message never gets ACKed
-    timerDisarm(&p2p->tmr.TxAllRetries);
-    timerSetFn(&p2p->tmr.TxAllRetries, p2pTxAllRetriesTimeout, p2p);
+    // Get and save our MAC address, to check that messages are for us
+    wifi_get_macaddr(SOFTAP_IF, p2p->cnc.myMac);
+
+    // Set up a timer per window slot for retrying messages
+    for(uint8_t i = 0; i < P2P_WINDOW_SIZE; i++)
+    {
+        p2p->tx.slots[i].p2p = p2p;
+        timerDisarm(&p2p->tx.slots[i].retry);
+        timerSetFn(&p2p->tx.slots[i].retry, p2pTxRetryTimeout, &p2p->tx.slots[i]);
+    }
 
     // Set up a timer to restart after abject failure
     timerDisarm(&p2p->tmr.Reinit);
@@ -187,6 +178,10 @@ void ICACHE_FLASH_ATTR p2pInitialize(p2pInfo* p2p, char* msgId,
     // Set up a timer to do an initial connection
     timerDisarm(&p2p->tmr.Connection);
     timerSetFn(&p2p->tmr.Connection, p2pConnectionTimeout, p2p);
+
+    // Set up a timer to send messages held for aggregation
+    timerDisarm(&p2p->tmr.Aggregate);
+    timerSetFn(&p2p->tmr.Aggregate, p2pAggTimeout, p2p);
 }
 
 /**
@@ -239,22 +234,28 @@ void ICACHE_FLASH_ATTR p2pDeinit(p2pInfo* p2p)
     P2P_PRINTF("\n");
 
     ets_memset(&(p2p->msgId), 0, sizeof(p2p->msgId));
-    ets_memset(&(p2p->conMsg), 0, sizeof(p2p->conMsg));
-    ets_memset(&(p2p->ackMsg), 0, sizeof(p2p->ackMsg));
-    ets_memset(&(p2p->startMsg), 0, sizeof(p2p->startMsg));
 
     p2p->conCbFn = NULL;
     p2p->msgRxCbFn = NULL;
-    p2p->msgTxCbFn = NULL;
     p2p->connectionRssi = 0;
 
     ets_memset(&(p2p->cnc), 0, sizeof(p2p->cnc));
-    ets_memset(&(p2p->ack), 0, sizeof(p2p->ack));
+
+    for(uint8_t i = 0; i < P2P_WINDOW_SIZE; i++)
+    {
+        timerDisarm(&p2p->tx.slots[i].retry);
+        p2p->tx.slots[i].inUse = false;
+    }
+    p2p->tx.nextSeq = 0;
+    p2p->tx.base = 0;
+    p2p->tx.lastSent = NULL;
+    ets_memset(&(p2p->rx), 0, sizeof(p2p->rx));
+    ets_memset(&(p2p->agg), 0, sizeof(p2p->agg));
+    ets_memset(&(p2p->stats), 0, sizeof(p2p->stats));
 
     timerDisarm(&p2p->tmr.Connection);
-    timerDisarm(&p2p->tmr.TxRetry);
     timerDisarm(&p2p->tmr.Reinit);
-    timerDisarm(&p2p->tmr.TxAllRetries);
+    timerDisarm(&p2p->tmr.Aggregate);
 }
 
 /**
@@ -270,7 +271,7 @@ void ICACHE_FLASH_ATTR p2pConnectionTimeout(void* arg)
 {
     p2pInfo* p2p = (p2pInfo*)arg;
     // Send a connection broadcast
-    p2pSendMsgEx(p2p, p2p->conMsg, ets_strlen(p2p->conMsg), false, NULL, NULL);
+    p2pSendHdrToMac(p2p, P2P_PKT_CON, p2pBroadcastMac, false, NULL, NULL);
 
     // os_random returns a 32 bit number, so this is [500ms,1500ms]
     uint32_t timeoutMs = 100 * (5 + (os_random() % 11));
@@ -281,211 +282,383 @@ void ICACHE_FLASH_ATTR p2pConnectionTimeout(void* arg)
 }
 
 /**
- * Retries sending a message to be acked
+ * Retries sending a message in the window, or gives up on it and calls its
+ * failure callbacks after RETRY_TIME_MS
  *
- * Called from the tmr.TxRetry timer. The timer is set when a message to be
- * ACKed is sent and cleared when an ACK is received
+ * Called from a window slot's retry timer. The timer is set from the retry
+ * timeout when the message is sent and cleared when it's ACKed
  *
- * @param arg The p2pInfo struct with all the state information
+ * @param arg The p2pTxSlot_t for the message
  */
 void ICACHE_FLASH_ATTR p2pTxRetryTimeout(void* arg)
 {
-    P2P_PRINTF("\n");
-
-    p2pInfo* p2p = (p2pInfo*)arg;
+    p2pTxSlot_t* slot = (p2pTxSlot_t*)arg;
+    p2pInfo* p2p = slot->p2p;
 
-    if(p2p->ack.msgToAckLen > 0)
+    if(false == slot->inUse)
     {
-        P2P_PRINTF("Retrying message \"%s\"\n", p2p->ack.msgToAck);
-        p2pSendMsgEx(p2p, p2p->ack.msgToAck, p2p->ack.msgToAckLen, true, p2p->ack.SuccessFn, p2p->ack.FailureFn);
+        return;
     }
-}
 
-/**
- * Stops a message transmission attempt after all retries have been exhausted
- * and calls p2p->ack.FailureFn() if a function was given
- *
- * Called from the tmr.TxAllRetries timer. The timer is set when a message to
- * be ACKed is sent for the first time and cleared when the message is ACKed.
- *
- * @param arg The p2pInfo struct with all the state information
- */
-void ICACHE_FLASH_ATTR p2pTxAllRetriesTimeout(void* arg)
-{
-    P2P_PRINTF("\n");
-
-    p2pInfo* p2p = (p2pInfo*)arg;
-
-    // Disarm all timers
-    timerDisarm(&p2p->tmr.TxRetry);
-    timerDisarm(&p2p->tmr.TxAllRetries);
+    if(system_get_time() - slot->firstSentUs < (RETRY_TIME_MS * 1000))
+    {
+        P2P_PRINTF("Retrying message, seq %d\n", ((p2pPktHdr_t*)slot->msg)->seq);
+        if(slot->retries < UINT8_MAX)
+        {
+            slot->retries++;
+        }
+        p2p->stats.retries++;
+        p2pTxSlotSend(slot);
+        return;
+    }
 
-    // Save the failure function
-    void (*FailureFn)(void*) = p2p->ack.FailureFn;
-    P2P_PRINTF("Message totally failed \"%s\"\n", p2p->ack.msgToAck);
+    P2P_PRINTF("Message totally failed, seq %d\n", ((p2pPktHdr_t*)slot->msg)->seq);
+    p2p->stats.msgsFailed++;
 
-    // Clear out the ack variables
-    ets_memset(&p2p->ack, 0, sizeof(p2p->ack));
+    // Save the failure functions, then free the slot
+    void (*FailureFn)(void*) = slot->FailureFn;
+    p2pMsgTxCbFn msgTxCbFns[P2P_AGG_MAX_MSGS];
+    uint8_t numMsgs = slot->numMsgs;
+    ets_memcpy(msgTxCbFns, slot->msgTxCbFns, sizeof(msgTxCbFns));
+    p2pTxSlotFree(slot);
 
-    // Call the failure function
+    // Call the failure functions
     if(NULL != FailureFn)
     {
         FailureFn(p2p);
     }
+    for(uint8_t i = 0; i < numMsgs; i++)
+    {
+        if(NULL != msgTxCbFns[i])
+        {
+            msgTxCbFns[i](p2p, MSG_FAILED);
+        }
+    }
+
+    // A slot is free now, so send anything which was waiting
+    p2pFlushMsgs(p2p);
 }
 
 /**
  * Send a message from one Swadge to another. This must not be called before
  * the CON_ESTABLISHED event occurs. Message addressing, ACKing, and retries
- * all happen automatically
+ * all happen automatically, and messages are delivered to the other Swadge in
+ * order
+ *
+ * Messages are held for up to P2P_AGG_DELAY_MS so that several can share one
+ * packet and one ACK. Call p2pFlushMsgs() to send held messages right away
  *
  * @param p2p       The p2pInfo struct with all the state information
  * @param msg       The mandatory three char message type
- * @param payload   An optional message payload string, may be NULL, up to 32 chars
- * @param len       The length of the optional message payload string. May be 0
+ * @param payload   An optional binary message payload, may be NULL, up to
+ *                  P2P_MAX_PAYLOAD_LEN bytes
+ * @param len       The length of the optional message payload. May be 0
  * @param msgTxCbFn A callback function when this message is ACKed or dropped
+ * @return true if the message was queued, false if the payload is too long or
+ *         P2P_WINDOW_SIZE packets are already waiting for an ACK and there's
+ *         no room to hold it
  */
-void ICACHE_FLASH_ATTR p2pSendMsg(p2pInfo* p2p, char* msg, char* payload,
+bool ICACHE_FLASH_ATTR p2pSendMsg(p2pInfo* p2p, char* msg, const uint8_t* payload,
                                   uint16_t len, p2pMsgTxCbFn msgTxCbFn)
 {
     P2P_PRINTF("\n");
 
-    char builtMsg[64] = {0};
+    if(NULL == payload)
+    {
+        len = 0;
+    }
+    else if(len > P2P_MAX_PAYLOAD_LEN)
+    {
+        P2P_PRINTF("DISCARD: %d byte payload is too long\n", len);
+        return false;
+    }
+
+    // A lone message is sent as P2P_PKT_MSG, so it can be as long as a packet
+    // allows, but more messages have to fit alongside it
+    if(p2p->agg.numMsgs > 0 &&
+            (p2p->agg.numMsgs >= P2P_AGG_MAX_MSGS ||
+             p2p->agg.len + sizeof(p2pAggRec_t) + len > P2P_MAX_PAYLOAD_LEN))
+    {
+        if(false == p2pFlushMsgs(p2p))
+        {
+            P2P_PRINTF("DISCARD: Window is full\n");
+            return false;
+        }
+    }
 
-    if(NULL == payload || len == 0)
+    p2pAggRec_t* rec = (p2pAggRec_t*)&p2p->agg.recs[p2p->agg.len];
+    ets_memcpy(rec->cmd, msg, sizeof(rec->cmd));
+    rec->len = len;
+    if(len > 0)
     {
-        ets_snprintf(builtMsg, sizeof(builtMsg), p2pNoPayloadMsgFmt,
-                     p2p->msgId,
-                     msg,
-                     0, // sequence number
-                     p2p->cnc.otherMac[0],
-                     p2p->cnc.otherMac[1],
-                     p2p->cnc.otherMac[2],
-                     p2p->cnc.otherMac[3],
-                     p2p->cnc.otherMac[4],
-                     p2p->cnc.otherMac[5]);
+        ets_memcpy(&p2p->agg.recs[p2p->agg.len + sizeof(p2pAggRec_t)], payload, len);
     }
-    else
+    p2p->agg.len += sizeof(p2pAggRec_t) + len;
+    p2p->agg.msgTxCbFns[p2p->agg.numMsgs++] = msgTxCbFn;
+
+    // Start waiting for more messages with the first one
+    if(1 == p2p->agg.numMsgs)
     {
-        ets_snprintf(builtMsg, sizeof(builtMsg), p2pPayloadMsgFmt,
-                     p2p->msgId,
-                     msg,
-                     0, // sequence number, filled in later
-                     p2p->cnc.otherMac[0],
-                     p2p->cnc.otherMac[1],
-                     p2p->cnc.otherMac[2],
-                     p2p->cnc.otherMac[3],
-                     p2p->cnc.otherMac[4],
-                     p2p->cnc.otherMac[5],
-                     payload);
-    }
-
-    p2p->msgTxCbFn = msgTxCbFn;
-    p2pSendMsgEx(p2p, builtMsg, ets_strlen(builtMsg), true, p2pModeMsgSuccess, p2pModeMsgFailure);
+        timerArm(&p2p->tmr.Aggregate, P2P_AGG_DELAY_MS, false);
+    }
+    return true;
 }
 
 /**
- * Callback function for when a message sent by the Swadge mode, not during
- * the connection process, is ACKed
+ * Send all the messages held by p2pSendMsg() in one packet. A single message
+ * is sent as P2P_PKT_MSG, more are sent as P2P_PKT_AGG
  *
- * @param arg The p2pInfo struct with all the state information
+ * @param p2p The p2pInfo struct with all the state information
+ * @return true if there was nothing to send or it was sent, false if
+ *         P2P_WINDOW_SIZE packets are already waiting for an ACK. The messages
+ *         are sent when an ACK frees up the window
  */
-void ICACHE_FLASH_ATTR p2pModeMsgSuccess(void* arg)
+bool ICACHE_FLASH_ATTR p2pFlushMsgs(p2pInfo* p2p)
 {
-    P2P_PRINTF("\n");
+    if(0 == p2p->agg.numMsgs)
+    {
+        return true;
+    }
 
-    p2pInfo* p2p = (p2pInfo*)arg;
-    if(NULL != p2p->msgTxCbFn)
+    uint8_t builtMsg[P2P_MAX_PACKET_LEN];
+    p2pPktHdr_t* hdr = (p2pPktHdr_t*)builtMsg;
+    ets_memset(hdr, 0, sizeof(p2pPktHdr_t));
+    ets_memcpy(hdr->msgId, p2p->msgId, sizeof(hdr->msgId));
+    hdr->seq = 0; // sequence number, filled in later
+    ets_memcpy(hdr->dstMac, p2p->cnc.otherMac, sizeof(hdr->dstMac));
+
+    if(1 == p2p->agg.numMsgs)
     {
-        p2p->msgTxCbFn(p2p, MSG_ACKED);
+        // Move the record's type and length into the header
+        p2pAggRec_t* rec = (p2pAggRec_t*)p2p->agg.recs;
+        hdr->type = P2P_PKT_MSG;
+        ets_memcpy(hdr->cmd, rec->cmd, sizeof(hdr->cmd));
+        hdr->len = rec->len;
+        ets_memcpy(&builtMsg[sizeof(p2pPktHdr_t)], &p2p->agg.recs[sizeof(p2pAggRec_t)], rec->len);
     }
+    else
+    {
+        hdr->type = P2P_PKT_AGG;
+        hdr->len = p2p->agg.len;
+        ets_memcpy(&builtMsg[sizeof(p2pPktHdr_t)], p2p->agg.recs, p2p->agg.len);
+    }
+
+    if(false == p2pSendMsgEx(p2p, builtMsg, sizeof(p2pPktHdr_t) + hdr->len, true, NULL, NULL,
+                             p2p->agg.msgTxCbFns, p2p->agg.numMsgs))
+    {
+        return false;
+    }
+
+    P2P_PRINTF("Sent %d messages in one packet\n", p2p->agg.numMsgs);
+    timerDisarm(&p2p->tmr.Aggregate);
+    p2p->agg.len = 0;
+    p2p->agg.numMsgs = 0;
+    return true;
 }
 
 /**
- * Callback function for when a message sent by the Swadge mode, not during
- * the connection process, is dropped
+ * Send messages held for aggregation once P2P_AGG_DELAY_MS has passed. If the
+ * window is full, they're sent when an ACK frees it up instead
  *
  * @param arg The p2pInfo struct with all the state information
  */
-void ICACHE_FLASH_ATTR p2pModeMsgFailure(void* arg)
+void ICACHE_FLASH_ATTR p2pAggTimeout(void* arg)
 {
-    P2P_PRINTF("\n");
+    p2pFlushMsgs((p2pInfo*)arg);
+}
 
-    p2pInfo* p2p = (p2pInfo*)arg;
-    if(NULL != p2p->msgTxCbFn)
-    {
-        p2p->msgTxCbFn(p2p, MSG_FAILED);
-    }
+/**
+ * Helper function to send a packet without a payload, like a connection
+ * broadcast, start message or ACK
+ *
+ * @param p2p       The p2pInfo struct with all the state information
+ * @param type      The type of packet to send
+ * @param mac_addr  The MAC to address this packet to
+ * @param shouldAck true if this message should be acked, false if we don't care
+ * @param success   A callback function if the message is acked. May be NULL
+ * @param failure   A callback function if the message isn't acked. May be NULL
+ * @return true if the packet was sent, false if the window is full
+ */
+bool ICACHE_FLASH_ATTR p2pSendHdrToMac(p2pInfo* p2p, p2pPktType_t type, const uint8_t* mac_addr,
+                                       bool shouldAck, void (*success)(void*), void (*failure)(void*))
+{
+    p2pPktHdr_t hdr = {0};
+    ets_memcpy(hdr.msgId, p2p->msgId, sizeof(hdr.msgId));
+    hdr.type = type;
+    ets_memcpy(hdr.dstMac, mac_addr, sizeof(hdr.dstMac));
+    return p2pSendMsgEx(p2p, (uint8_t*)&hdr, sizeof(hdr), shouldAck, success, failure, NULL, 0);
 }
 
 /**
- * Wrapper for sending an ESP-NOW message. Handles ACKing and retries for
- * non-broadcast style messages
+ * Wrapper for sending an ESP-NOW message. Messages which should be ACKed are
+ * given the next sequence number and copied into a free window slot for
+ * retries. Other messages are sent once
  *
  * @param p2p       The p2pInfo struct with all the state information
- * @param msg       The message to send, may contain destination MAC
- * @param len       The length of the message to send
+ * @param msg       The packet to send, starting with a p2pPktHdr_t
+ * @param len       The length of the packet to send
  * @param shouldAck true if this message should be acked, false if we don't care
  * @param success   A callback function if the message is acked. May be NULL
  * @param failure   A callback function if the message isn't acked. May be NULL
+ * @param msgTxCbFns Mode callback functions if the message is acked or
+ *                  isn't, one per message in the packet. May be NULL
+ * @param numMsgs   The number of mode callback functions
+ * @return true if the message was sent, false if the window is full
  */
-void ICACHE_FLASH_ATTR p2pSendMsgEx(p2pInfo* p2p, char* msg, uint16_t len,
-                                    bool shouldAck, void (*success)(void*), void (*failure)(void*))
+bool ICACHE_FLASH_ATTR p2pSendMsgEx(p2pInfo* p2p, uint8_t* msg, uint16_t len,
+                                    bool shouldAck, void (*success)(void*), void (*failure)(void*),
+                                    p2pMsgTxCbFn* msgTxCbFns, uint8_t numMsgs)
 {
-    P2P_PRINTF("\n");
+    p2pPktHdr_t* hdr = (p2pPktHdr_t*)msg;
 
-    // If this is a first time message and longer than a connection message
-    if( (p2p->ack.msgToAck != msg) && ets_strlen(p2p->conMsg) < len)
+    if(false == shouldAck)
     {
-        // Insert a sequence number
-        msg[SEQ_IDX + 0] = '0' + (p2p->cnc.mySeqNum / 10);
-        msg[SEQ_IDX + 1] = '0' + (p2p->cnc.mySeqNum % 10);
+        P2P_PRINTF("type %d, len %d\n", hdr->type, len);
+        // Nothing to retry, so p2pSendCb() shouldn't refine a slot's timer
+        p2p->tx.lastSent = NULL;
+        espNowSend(msg, len);
+        return true;
+    }
 
-        // Increment the sequence number, 0-99
-        p2p->cnc.mySeqNum++;
-        if(100 == p2p->cnc.mySeqNum++)
-        {
-            p2p->cnc.mySeqNum = 0;
-        }
+    // Make sure there's room in the window
+    if(SEQ_DIFF(p2p->tx.nextSeq, p2p->tx.base) >= P2P_WINDOW_SIZE)
+    {
+        P2P_PRINTF("DISCARD: Window is full\n");
+        return false;
     }
 
-#ifdef P2P_DEBUG_PRINT
-    char* dbgMsg = (char*)os_zalloc(sizeof(char) * (len + 1));
-    ets_memcpy(dbgMsg, msg, len);
-    P2P_PRINTF("%s\n", dbgMsg);
-    os_free(dbgMsg);
-#endif
+    // Insert a sequence number, it wraps at 255
+    hdr->seq = p2p->tx.nextSeq++;
+
+    // Store the message for potential retries
+    p2pTxSlot_t* slot = &p2p->tx.slots[hdr->seq % P2P_WINDOW_SIZE];
+    ets_memcpy(slot->msg, msg, len);
+    slot->len = len;
+    slot->inUse = true;
+    slot->SuccessFn = success;
+    slot->FailureFn = failure;
+    slot->numMsgs = numMsgs;
+    if(numMsgs > 0)
+    {
+        ets_memcpy(slot->msgTxCbFns, msgTxCbFns, numMsgs * sizeof(p2pMsgTxCbFn));
+    }
+    slot->firstSentUs = system_get_time();
+    slot->retries = 0;
+    p2p->stats.msgsSent++;
+
+    P2P_PRINTF("type %d, seq %d, dst %02X:%02X:%02X:%02X:%02X:%02X, len %d\n",
+               hdr->type, hdr->seq,
+               hdr->dstMac[0], hdr->dstMac[1], hdr->dstMac[2],
+               hdr->dstMac[3], hdr->dstMac[4], hdr->dstMac[5],
+               len);
+
+    p2pTxSlotSend(slot);
+    return true;
+}
 
-    if(shouldAck)
+/**
+ * Send, or resend, the message in a window slot and arm its retry timer
+ *
+ * The retry timeout doubles with every retry of the same message, up to
+ * P2P_MAX_RTO_MS
+ *
+ * @param slot The window slot with the message to send
+ */
+void ICACHE_FLASH_ATTR p2pTxSlotSend(p2pTxSlot_t* slot)
+{
+    p2pInfo* p2p = slot->p2p;
+
+    // Let the receiver know what it doesn't need to wait for anymore
+    ((p2pPktHdr_t*)slot->msg)->base = p2p->tx.base;
+
+    // Remember this in case p2pSendCb() reports a failure
+    p2p->tx.lastSent = slot;
+
+    // Back off exponentially, checking before shifting so it can't overflow
+    uint32_t timeoutMs = p2p->stats.rtoMs;
+    for(uint8_t i = 0; i < slot->retries && timeoutMs < P2P_MAX_RTO_MS; i++)
     {
-        // Set the state to wait for an ack
-        p2p->ack.isWaitingForAck = true;
+        timeoutMs *= 2;
+    }
+    if(timeoutMs > P2P_MAX_RTO_MS)
+    {
+        timeoutMs = P2P_MAX_RTO_MS;
+    }
 
-        // If this is not a retry
-        if(p2p->ack.msgToAck != msg)
-        {
-            P2P_PRINTF("sending for the first time\n");
+    // Add some randomness [0ms to 3ms random] so swadges don't retry in lockstep
+    timerArm(&slot->retry, timeoutMs + (os_random() & 0b11), false);
 
-            // Store the message for potential retries
-            ets_memcpy(p2p->ack.msgToAck, msg, len);
-            p2p->ack.msgToAckLen = len;
-            p2p->ack.SuccessFn = success;
-            p2p->ack.FailureFn = failure;
+    espNowSend(slot->msg, slot->len);
+}
 
-            // Start a timer to retry for 3s total
-            timerDisarm(&p2p->tmr.TxAllRetries);
-            timerArm(&p2p->tmr.TxAllRetries, RETRY_TIME_MS, false);
-        }
-        else
-        {
-            P2P_PRINTF("this is a retry\n");
-        }
+/**
+ * Free a window slot and move the base of the window past any freed slots
+ *
+ * @param slot The window slot to free
+ */
+void ICACHE_FLASH_ATTR p2pTxSlotFree(p2pTxSlot_t* slot)
+{
+    p2pInfo* p2p = slot->p2p;
+
+    timerDisarm(&slot->retry);
+    slot->inUse = false;
+    if(p2p->tx.lastSent == slot)
+    {
+        p2p->tx.lastSent = NULL;
+    }
+
+    while(p2p->tx.base != p2p->tx.nextSeq &&
+            false == p2p->tx.slots[p2p->tx.base % P2P_WINDOW_SIZE].inUse)
+    {
+        p2p->tx.base++;
+    }
+}
+
+/**
+ * Update the smoothed round trip time and variance with a new measurement,
+ * then derive the retry timeout from them, like TCP does (RFC 6298)
+ *
+ * @param p2p   The p2pInfo struct with all the state information
+ * @param rttUs The measured round trip time, in microseconds
+ */
+void ICACHE_FLASH_ATTR p2pRttSample(p2pInfo* p2p, uint32_t rttUs)
+{
+    p2pStats_t* stats = &p2p->stats;
 
-        // Mark the time this transmission started, the retry timer gets
-        // started in p2pSendCb()
-        p2p->ack.timeSentUs = system_get_time();
+    if(0 == stats->srttUs)
+    {
+        // The first measurement
+        stats->srttUs = rttUs;
+        stats->rttvarUs = rttUs / 2;
     }
-    espNowSend((const uint8_t*)msg, len);
+    else
+    {
+        // rttvar = 3/4 rttvar + 1/4 |srtt - rtt|, srtt = 7/8 srtt + 1/8 rtt
+        uint32_t errUs = (stats->srttUs > rttUs) ? (stats->srttUs - rttUs) : (rttUs - stats->srttUs);
+        stats->rttvarUs = ((3 * stats->rttvarUs) + errUs) / 4;
+        stats->srttUs = ((7 * stats->srttUs) + rttUs) / 8;
+    }
+
+    // Make sure srttUs stays nonzero so it isn't mistaken for no measurement
+    if(0 == stats->srttUs)
+    {
+        stats->srttUs = 1;
+    }
+
+    // rto = srtt + 4 * rttvar, rounded up to the next millisecond
+    uint32_t rtoMs = (stats->srttUs + (4 * stats->rttvarUs) + 999) / 1000;
+    if(rtoMs < P2P_MIN_RTO_MS)
+    {
+        rtoMs = P2P_MIN_RTO_MS;
+    }
+    else if(rtoMs > P2P_MAX_RTO_MS)
+    {
+        rtoMs = P2P_MAX_RTO_MS;
+    }
+    stats->rtoMs = rtoMs;
+
+    P2P_PRINTF("rtt %dus, srtt %dus, rttvar %dus, rto %dms\n",
+               rttUs, stats->srttUs, stats->rttvarUs, stats->rtoMs);
 }
 
 /**
@@ -496,30 +669,32 @@ void ICACHE_FLASH_ATTR p2pSendMsgEx(p2pInfo* p2p, char* msg, uint16_t len,
  * @param data     The data
  * @param len      The length of the data
  * @param rssi     The RSSI of th received message, a proxy for distance
- * @return false if the message was processed here,
- *         true if the message should be processed by the swadge mode
  */
 void ICACHE_FLASH_ATTR p2pRecvCb(p2pInfo* p2p, uint8_t* mac_addr, uint8_t* data, uint8_t len, uint8_t rssi)
 {
-#ifdef P2P_DEBUG_PRINT
-    char* dbgMsg = (char*)os_zalloc(sizeof(char) * (len + 1));
-    ets_memcpy(dbgMsg, data, len);
-    P2P_PRINTF("%s\n", dbgMsg);
-    os_free(dbgMsg);
-#endif
+    p2pPktHdr_t* hdr = (p2pPktHdr_t*)data;
 
     // Check if this message matches our message ID
-    if(len < CMD_IDX ||
-            (0 != ets_memcmp(data, p2p->conMsg, CMD_IDX)))
+    if(len < sizeof(p2pPktHdr_t) ||
+            (0 != ets_memcmp(hdr->msgId, p2p->msgId, sizeof(hdr->msgId))))
     {
         // This message is too short, or does not match our message ID
         P2P_PRINTF("DISCARD: Not a message for '%s'\n", p2p->msgId);
         return;
     }
 
-    // If this message has a MAC, check it
-    if(len >= ets_strlen(p2p->ackMsg) &&
-            0 != ets_memcmp(&data[MAC_IDX], p2p->cnc.macStr, ets_strlen(p2p->cnc.macStr)))
+    P2P_PRINTF("type %d, seq %d, base %d, len %d\n", hdr->type, hdr->seq, hdr->base, hdr->len);
+
+    // Make sure the payload is all there
+    if(hdr->len > len - sizeof(p2pPktHdr_t))
+    {
+        P2P_PRINTF("DISCARD: Truncated payload\n");
+        return;
+    }
+
+    // If this message isn't a broadcast, check that it's for us
+    if(P2P_PKT_CON != hdr->type &&
+            0 != ets_memcmp(hdr->dstMac, p2p->cnc.myMac, sizeof(p2p->cnc.myMac)))
     {
         // This MAC isn't for us
         P2P_PRINTF("DISCARD: Not for our MAC\n");
@@ -528,7 +703,7 @@ void ICACHE_FLASH_ATTR p2pRecvCb(p2pInfo* p2p, uint8_t* mac_addr, uint8_t* data,
 
     // If this is anything besides a broadcast, check the other MAC
     if(p2p->cnc.otherMacReceived &&
-            len > ets_strlen(p2p->conMsg) &&
+            P2P_PKT_CON != hdr->type &&
             0 != ets_memcmp(mac_addr, p2p->cnc.otherMac, sizeof(p2p->cnc.otherMac)))
     {
         // This isn't from the other known swadge
@@ -536,73 +711,29 @@ void ICACHE_FLASH_ATTR p2pRecvCb(p2pInfo* p2p, uint8_t* mac_addr, uint8_t* data,
         return;
     }
 
-    // By here, we know the received message matches our message ID, either a
-    // broadcast or for us. If this isn't an ack message, ack it
-    if(len >= SEQ_IDX &&
-            0 != ets_memcmp(data, p2p->ackMsg, SEQ_IDX))
+    switch(hdr->type)
     {
-        p2pSendAckToMac(p2p, mac_addr);
-    }
-
-    // After ACKing the message, check the sequence number to see if we should
-    // process it or ignore it (we already did!)
-    if(len >= ets_strlen(p2p->ackMsg))
-    {
-        // Extract the sequence number
-        uint8_t theirSeq = 0;
-        theirSeq += (data[SEQ_IDX + 0] - '0') * 10;
-        theirSeq += (data[SEQ_IDX + 1] - '0');
-
-        // Check it against the last known sequence number
-        if(theirSeq == p2p->cnc.lastSeqNum)
+        case P2P_PKT_ACK:
         {
-            P2P_PRINTF("DISCARD: Duplicate sequence number\n");
-            return;
+            // ACKs can be received in any state
+            p2pRecvAck(p2p, hdr, &data[sizeof(p2pPktHdr_t)]);
+            break;
         }
-        else
+        case P2P_PKT_START:
+        case P2P_PKT_MSG:
+        case P2P_PKT_AGG:
         {
-            p2p->cnc.lastSeqNum = theirSeq;
-            P2P_PRINTF("Store lastSeqNum %d\n", p2p->cnc.lastSeqNum);
+            // These are ACKed, put in order, then processed
+            p2pRecvReliable(p2p, mac_addr, data, len);
+            break;
         }
-    }
-
-    // ACKs can be received in any state
-    if(p2p->ack.isWaitingForAck)
-    {
-        // Check if this is an ACK
-        if(ets_strlen(p2p->ackMsg) == len &&
-                0 == ets_memcmp(data, p2p->ackMsg, SEQ_IDX))
-        {
-            P2P_PRINTF("ACK Received\n");
-
-            // Clear ack timeout variables
-            timerDisarm(&p2p->tmr.TxRetry);
-            // Disarm the whole transmission ack timer
-            timerDisarm(&p2p->tmr.TxAllRetries);
-            // Save the success function
-            void (*successFn)(void*) = p2p->ack.SuccessFn;
-            // Clear out ACK variables
-            ets_memset(&p2p->ack, 0, sizeof(p2p->ack));
-
-            // Call the function after receiving the ack
-            if(NULL != successFn)
-            {
-                successFn(p2p);
-            }
-        }
-        // Don't process anything else when waiting for an ack
-        return;
-    }
-
-    if(false == p2p->cnc.isConnected)
-    {
-        if(true == p2p->cnc.isConnecting)
+        case P2P_PKT_CON:
         {
             // Received another broadcast, Check if this RSSI is strong enough
-            if(!p2p->cnc.broadcastReceived &&
-                    rssi > p2p->connectionRssi &&
-                    ets_strlen(p2p->conMsg) == len &&
-                    0 == ets_memcmp(data, p2p->conMsg, len))
+            if(false == p2p->cnc.isConnected &&
+                    true == p2p->cnc.isConnecting &&
+                    !p2p->cnc.broadcastReceived &&
+                    rssi > p2p->connectionRssi)
             {
                 // We received a broadcast, don't allow another
                 p2p->cnc.broadcastReceived = true;
@@ -615,76 +746,276 @@ void ICACHE_FLASH_ATTR p2pRecvCb(p2pInfo* p2p, uint8_t* mac_addr, uint8_t* data,
                 p2p->cnc.otherMacReceived = true;
 
                 // Send a message to that ESP to start the game.
-                ets_snprintf(p2p->startMsg, sizeof(p2p->startMsg), p2pNoPayloadMsgFmt,
-                             p2p->msgId,
-                             "str",
-                             0,
-                             mac_addr[0],
-                             mac_addr[1],
-                             mac_addr[2],
-                             mac_addr[3],
-                             mac_addr[4],
-                             mac_addr[5]);
-
                 // If it's acked, call p2pGameStartAckRecv(), if not reinit with p2pRestart()
-                p2pSendMsgEx(p2p, p2p->startMsg, ets_strlen(p2p->startMsg), true, p2pGameStartAckRecv, p2pRestart);
+                p2pSendHdrToMac(p2p, P2P_PKT_START, mac_addr, true, p2pGameStartAckRecv, p2pRestart);
             }
-            // Received a response to our broadcast
-            else if (!p2p->cnc.rxGameStartMsg &&
-                     ets_strlen(p2p->startMsg) == len &&
-                     0 == ets_memcmp(data, p2p->startMsg, SEQ_IDX))
+            break;
+        }
+        default:
+        {
+            P2P_PRINTF("DISCARD: Unknown type\n");
+            break;
+        }
+    }
+}
+
+/**
+ * Free every window slot an ACK covers, then call their success callbacks in
+ * sequence order. The round trip is measured once per ACK, from the message it
+ * answers
+ *
+ * @param p2p     The p2pInfo struct with all the state information
+ * @param hdr     The ACK's header. The sequence number is cumulative
+ * @param payload The ACK's payload, a selective ACK bitmap if hdr->len > 0,
+ *                then the answered sequence number if hdr->len > 1
+ */
+void ICACHE_FLASH_ATTR p2pRecvAck(p2pInfo* p2p, p2pPktHdr_t* hdr, uint8_t* payload)
+{
+    uint8_t sack = (hdr->len > 0) ? payload[0] : 0;
+    bool hasRxSeq = (hdr->len > 1);
+    uint8_t rxSeq = hasRxSeq ? payload[1] : 0;
+    uint32_t nowUs = system_get_time();
+
+    // Callbacks may send more messages, so free all the slots first
+    void (*successFns[P2P_WINDOW_SIZE])(void*);
+    p2pMsgTxCbFn msgTxCbFns[P2P_WINDOW_SIZE][P2P_AGG_MAX_MSGS];
+    uint8_t numMsgs[P2P_WINDOW_SIZE];
+    uint8_t numAcked = 0;
+
+    for(uint8_t seq = p2p->tx.base; seq != p2p->tx.nextSeq; seq++)
+    {
+        p2pTxSlot_t* slot = &p2p->tx.slots[seq % P2P_WINDOW_SIZE];
+        int8_t diff = SEQ_DIFF(seq, hdr->seq);
+        if(slot->inUse &&
+                ((diff < 0) || ((diff >= 1) && (diff <= 8) && (sack & (1 << (diff - 1))))))
+        {
+            P2P_PRINTF("ACK Received, seq %d\n", seq);
+            p2p->stats.msgsAcked++;
+
+            // Only measure the message this ACK answers. Others it covers may
+            // have been ACKed before, by an ACK which was lost. Only measure
+            // messages which were sent once, otherwise it's not known which
+            // transmission this ACK is for
+            if(hasRxSeq && rxSeq == seq && 0 == slot->retries)
             {
-                P2P_PRINTF("Game start message received, ACKing\n");
+                p2pRttSample(p2p, nowUs - slot->firstSentUs);
+            }
 
-                // This is another swadge trying to start a game, which means
-                // they received our p2p->conMsg. First disable our p2p->conMsg
-                timerDisarm(&p2p->tmr.Connection);
+            successFns[numAcked] = slot->SuccessFn;
+            numMsgs[numAcked] = slot->numMsgs;
+            ets_memcpy(msgTxCbFns[numAcked], slot->msgTxCbFns, sizeof(msgTxCbFns[numAcked]));
+            numAcked++;
+            p2pTxSlotFree(slot);
+        }
+    }
 
-                // And process this connection event
-                p2pProcConnectionEvt(p2p, RX_GAME_START_MSG);
+    for(uint8_t i = 0; i < numAcked; i++)
+    {
+        if(NULL != successFns[i])
+        {
+            successFns[i](p2p);
+        }
+        for(uint8_t j = 0; j < numMsgs[i]; j++)
+        {
+            if(NULL != msgTxCbFns[i][j])
+            {
+                msgTxCbFns[i][j](p2p, MSG_ACKED);
             }
         }
-        return;
+    }
+
+    // Slots are free now, so send anything which was waiting
+    if(numAcked > 0)
+    {
+        p2pFlushMsgs(p2p);
+    }
+}
+
+/**
+ * Receive a packet which should be ACKed. It's buffered until everything
+ * before it has been received, so packets are processed in sequence order and
+ * only once. Anything the sender gave up on is skipped
+ *
+ * @param p2p      The p2pInfo struct with all the state information
+ * @param mac_addr The MAC of the swadge that sent the data
+ * @param data     The packet, starting with a p2pPktHdr_t
+ * @param len      The length of the packet
+ */
+void ICACHE_FLASH_ATTR p2pRecvReliable(p2pInfo* p2p, uint8_t* mac_addr, uint8_t* data, uint8_t len)
+{
+    p2pPktHdr_t* hdr = (p2pPktHdr_t*)data;
+
+    // A start message begins the other swadge's sequence numbers
+    if(P2P_PKT_START == hdr->type &&
+            false == p2p->cnc.isConnected &&
+            false == p2p->cnc.rxGameStartMsg)
+    {
+        ets_memset(&(p2p->rx), 0, sizeof(p2p->rx));
+        p2p->rx.nextSeq = hdr->seq;
+    }
+
+    // Skip anything the sender gave up on, processing what was buffered after it
+    while(SEQ_DIFF(hdr->base, p2p->rx.nextSeq) > 0)
+    {
+        p2pRxSlot_t* slot = &p2p->rx.slots[p2p->rx.nextSeq % P2P_WINDOW_SIZE];
+        p2p->rx.nextSeq++;
+        if(slot->present)
+        {
+            slot->present = false;
+            p2p->stats.msgsReceived++;
+            p2pProcessPkt(p2p, slot->msg);
+        }
+    }
+
+    // Buffer this packet if it's new and fits in the window
+    int8_t diff = SEQ_DIFF(hdr->seq, p2p->rx.nextSeq);
+    if(diff < 0)
+    {
+        P2P_PRINTF("DISCARD: Old sequence number, ACK again\n");
+        p2p->stats.msgsDuplicate++;
+    }
+    else if(diff >= P2P_WINDOW_SIZE)
+    {
+        P2P_PRINTF("DISCARD: Sequence number beyond the window\n");
+    }
+    else
+    {
+        p2pRxSlot_t* slot = &p2p->rx.slots[hdr->seq % P2P_WINDOW_SIZE];
+        if(false == slot->present)
+        {
+            ets_memcpy(slot->msg, data, len);
+            slot->len = len;
+            slot->present = true;
+        }
+        else
+        {
+            p2p->stats.msgsDuplicate++;
+        }
+    }
+
+    // Take everything that's now in order out of the window. Each slot holds a
+    // different sequence number, so nothing overwrites these before processing
+    uint8_t toProcess[P2P_WINDOW_SIZE];
+    uint8_t numToProcess = 0;
+    while(p2p->rx.slots[p2p->rx.nextSeq % P2P_WINDOW_SIZE].present)
+    {
+        toProcess[numToProcess++] = p2p->rx.nextSeq % P2P_WINDOW_SIZE;
+        p2p->rx.slots[p2p->rx.nextSeq % P2P_WINDOW_SIZE].present = false;
+        p2p->rx.nextSeq++;
+        p2p->stats.msgsReceived++;
+    }
+
+    // ACK before processing, in case processing takes a while
+    p2pSendAckToMac(p2p, mac_addr, hdr->seq);
+
+    for(uint8_t i = 0; i < numToProcess; i++)
+    {
+        p2pProcessPkt(p2p, p2p->rx.slots[toProcess[i]].msg);
+    }
+}
+
+/**
+ * Process a START or MSG packet, in sequence order
+ *
+ * @param p2p  The p2pInfo struct with all the state information
+ * @param data The packet, starting with a p2pPktHdr_t
+ */
+void ICACHE_FLASH_ATTR p2pProcessPkt(p2pInfo* p2p, uint8_t* data)
+{
+    p2pPktHdr_t* hdr = (p2pPktHdr_t*)data;
+
+    if(false == p2p->cnc.isConnected)
+    {
+        // Received a response to our broadcast
+        if (true == p2p->cnc.isConnecting &&
+                !p2p->cnc.rxGameStartMsg &&
+                P2P_PKT_START == hdr->type)
+        {
+            P2P_PRINTF("Game start message received, ACKing\n");
+
+            // This is another swadge trying to start a game, which means
+            // they received our connection broadcast. First disable our
+            // connection broadcast
+            timerDisarm(&p2p->tmr.Connection);
+
+            // And process this connection event
+            p2pProcConnectionEvt(p2p, RX_GAME_START_MSG);
+        }
     }
     else
     {
         P2P_PRINTF("cnc.isconnected is true\n");
         // Let the mode handle it
-        if(NULL != p2p->msgRxCbFn)
+        if(NULL != p2p->msgRxCbFn && P2P_PKT_MSG == hdr->type)
         {
             P2P_PRINTF("letting mode handle message\n");
             char msgType[4] = {0};
-            ets_memcpy(msgType, &data[CMD_IDX], 3 * sizeof(char));
-            p2p->msgRxCbFn(p2p, msgType, &data[EXT_IDX], len - EXT_IDX);
+            ets_memcpy(msgType, hdr->cmd, sizeof(hdr->cmd));
+            p2p->msgRxCbFn(p2p, msgType, &data[sizeof(p2pPktHdr_t)], hdr->len);
+        }
+        else if(P2P_PKT_AGG == hdr->type)
+        {
+            // Unpack each message. The mode may restart the connection from
+            // its callback, so check before each one
+            uint8_t* recs = &data[sizeof(p2pPktHdr_t)];
+            uint16_t off = 0;
+            while(NULL != p2p->msgRxCbFn && p2p->cnc.isConnected &&
+                    off + sizeof(p2pAggRec_t) <= hdr->len)
+            {
+                p2pAggRec_t* rec = (p2pAggRec_t*)&recs[off];
+                off += sizeof(p2pAggRec_t);
+                if(off + rec->len > hdr->len)
+                {
+                    P2P_PRINTF("DISCARD: Truncated aggregated message\n");
+                    break;
+                }
+
+                P2P_PRINTF("letting mode handle aggregated message\n");
+                char msgType[4] = {0};
+                ets_memcpy(msgType, rec->cmd, sizeof(rec->cmd));
+                p2p->msgRxCbFn(p2p, msgType, &recs[off], rec->len);
+                off += rec->len;
+            }
         }
     }
 }
 
 /**
- * Helper function to send an ACK message to the given MAC
+ * Helper function to send an ACK message to the given MAC. The ACK's sequence
+ * number is the next one expected, and its payload selectively ACKs anything
+ * buffered after that, then names the packet this ACK answers
  *
  * @param p2p      The p2pInfo struct with all the state information
  * @param mac_addr The MAC to address this ACK to
+ * @param rxSeq    The sequence number of the packet which was just received
  */
-void ICACHE_FLASH_ATTR p2pSendAckToMac(p2pInfo* p2p, uint8_t* mac_addr)
+void ICACHE_FLASH_ATTR p2pSendAckToMac(p2pInfo* p2p, uint8_t* mac_addr, uint8_t rxSeq)
 {
     P2P_PRINTF("\n");
 
-    ets_snprintf(p2p->ackMsg, sizeof(p2p->ackMsg), p2pNoPayloadMsgFmt,
-                 p2p->msgId,
-                 "ack",
-                 0,
-                 mac_addr[0],
-                 mac_addr[1],
-                 mac_addr[2],
-                 mac_addr[3],
-                 mac_addr[4],
-                 mac_addr[5]);
-    p2pSendMsgEx(p2p, p2p->ackMsg, ets_strlen(p2p->ackMsg), false, NULL, NULL);
+    uint8_t ack[sizeof(p2pPktHdr_t) + 2] = {0};
+    p2pPktHdr_t* hdr = (p2pPktHdr_t*)ack;
+    ets_memcpy(hdr->msgId, p2p->msgId, sizeof(hdr->msgId));
+    hdr->type = P2P_PKT_ACK;
+    hdr->seq = p2p->rx.nextSeq;
+    ets_memcpy(hdr->dstMac, mac_addr, sizeof(hdr->dstMac));
+    hdr->len = 2;
+
+    // Bit i is set if nextSeq + 1 + i was received
+    for(uint8_t i = 0; i < P2P_WINDOW_SIZE - 1; i++)
+    {
+        if(p2p->rx.slots[(uint8_t)(p2p->rx.nextSeq + 1 + i) % P2P_WINDOW_SIZE].present)
+        {
+            ack[sizeof(p2pPktHdr_t)] |= (1 << i);
+        }
+    }
+    ack[sizeof(p2pPktHdr_t) + 1] = rxSeq;
+
+    p2pSendMsgEx(p2p, ack, sizeof(ack), false, NULL, NULL, NULL, 0);
 }
 
 /**
- * This is called when p2p->startMsg is acked and processes the connection event
+ * This is called when the P2P_PKT_START message is acked and processes the connection event
  *
  * @param arg The p2pInfo struct with all the state information
  */
@@ -821,9 +1152,9 @@ void ICACHE_FLASH_ATTR p2pRestart(void* arg)
  * This must be called by whatever function is registered to the Swadge mode's
  * fnEspNowSendCb
  *
- * This is called after an attempted transmission. If it was successful, and the
- * message should be acked, start a retry timer. If it wasn't successful, just
- * try again
+ * This is called after an attempted transmission. If it wasn't successful, and
+ * the message should be acked, try again right away rather than waiting for
+ * the retry timeout
  *
  * @param p2p      The p2pInfo struct with all the state information
  * @param mac_addr unused
@@ -831,46 +1162,20 @@ void ICACHE_FLASH_ATTR p2pRestart(void* arg)
  */
 void ICACHE_FLASH_ATTR p2pSendCb(p2pInfo* p2p, uint8_t* mac_addr __attribute__((unused)), mt_tx_status status)
 {
-    P2P_PRINTF("s:%d, t:%d\n", status, p2p->ack.timeSentUs);
-    switch(status)
+    // Only the most recent message sent is known, and only if it's waiting
+    // for an ACK. Others wait for their retry timeout
+    p2pTxSlot_t* slot = p2p->tx.lastSent;
+    p2p->tx.lastSent = NULL;
+    P2P_PRINTF("s:%d\n", status);
+    if(NULL == slot || false == slot->inUse)
     {
-        case MT_TX_STATUS_OK:
-        {
-            if(0 != p2p->ack.timeSentUs)
-            {
-                uint32_t transmissionTimeUs = system_get_time() - p2p->ack.timeSentUs;
-                P2P_PRINTF("Transmission time %dus\n", transmissionTimeUs);
-                // The timers are all millisecond, so make sure that
-                // transmissionTimeUs is at least 1ms
-                if(transmissionTimeUs < 1000)
-                {
-                    transmissionTimeUs = 1000;
-                }
-
-                // Round it to the nearest Ms, add 69ms (the measured worst case)
-                // then add some randomness [0ms to 15ms random]
-                uint32_t waitTimeMs = ((transmissionTimeUs + 500) / 1000) + 69 + (os_random() & 0b1111);
+        return;
+    }
 
-                // Start the timer
-                P2P_PRINTF("ack timer set for %dms\n", waitTimeMs);
-                timerArm(&p2p->tmr.TxRetry, waitTimeMs, false);
-            }
-            break;
-        }
-        case MT_TX_STATUS_FAILED:
-        {
-            // If a message is stored
-            if(p2p->ack.msgToAckLen > 0)
-            {
-                // try again in 1ms
-                timerArm(&p2p->tmr.TxRetry, 1, false);
-            }
-            break;
-        }
-        default:
-        {
-            break;
-        }
+    if(MT_TX_STATUS_FAILED == status)
+    {
+        // try again in 1ms
+        timerArm(&slot->retry, 1, false);
     }
 }
 
@@ -904,4 +1209,17 @@ void ICACHE_FLASH_ATTR p2pSetPlayOrder(p2pInfo* p2p, playOrder_t order)
     p2p->cnc.playOrder = order;
 }
 
+/**
+ * Get statistics about the connection's quality, like the round trip time and
+ * how many messages were retried or given up on. These are reset when the
+ * connection restarts
+ *
+ * @param p2p The p2pInfo struct with all the state information
+ * @return    The connection statistics, updated as messages are sent and received
+ */
+const p2pStats_t* ICACHE_FLASH_ATTR p2pGetStats(p2pInfo* p2p)
+{
+    return &p2p->stats;
+}
+
 #endif // P2P_ENABLED
\ No newline at end of file
@@ -30,38 +30,137 @@ typedef enum
     MSG_FAILED
 } messageStatus_t;
 
+typedef enum
+{
+    P2P_PKT_CON,   // A broadcast looking for a connection
+    P2P_PKT_START, // A response to a broadcast, starts the connection
+    P2P_PKT_ACK,   // ACKs P2P_PKT_START and P2P_PKT_MSG, see p2pPktHdr_t
+    P2P_PKT_MSG,   // A message from the Swadge mode
+    P2P_PKT_AGG    // Several messages from the Swadge mode, see p2pAggRec_t
+} p2pPktType_t;
+
+// The header at the start of every packet. Multi-byte fields are raw bytes
+//
+// For P2P_PKT_ACK, seq is cumulative, every sequence number before it was
+// received. The payload's first byte selectively ACKs more, bit i is set if
+// seq + 1 + i was received. Its second byte is the sequence number of the
+// packet which was just received, so the sender can measure one round trip
+typedef struct __attribute__((packed))
+{
+    char msgId[3];     // The Swadge mode's message ID, not null terminated
+    uint8_t type;      // A p2pPktType_t
+    uint8_t seq;       // The sequence number, unused for P2P_PKT_CON
+    uint8_t base;      // The sender's oldest unACKed sequence number. Anything
+                       // older was ACKed or given up on, so don't wait for it
+    uint8_t dstMac[6]; // The MAC this is for, broadcast for P2P_PKT_CON
+    char cmd[3];       // The mode's message type for P2P_PKT_MSG, not null terminated
+    uint8_t len;       // The length of the payload which follows
+} p2pPktHdr_t;
+
+// ESP-NOW packets can be up to 250 bytes
+#define P2P_MAX_PACKET_LEN  250
+#define P2P_MAX_PAYLOAD_LEN (P2P_MAX_PACKET_LEN - sizeof(p2pPktHdr_t))
+
+// A P2P_PKT_AGG payload is a series of these, each followed by its payload.
+// The header's cmd is unused
+typedef struct __attribute__((packed))
+{
+    char cmd[3];  // The mode's message type, not null terminated
+    uint8_t len;  // The length of the payload which follows
+} p2pAggRec_t;
+
+// The most messages which can share one packet
+#define P2P_AGG_MAX_MSGS 8
+
+// How many reliable messages can be waiting for an ACK at once. This is also
+// how far ahead of the next in-order message the receiver buffers, and can't
+// be more than the eight bits of a selective ACK
+#define P2P_WINDOW_SIZE 4
+
 typedef struct _p2pInfo p2pInfo;
 
 typedef void (*p2pConCbFn)(p2pInfo* p2p, connectionEvt_t);
 typedef void (*p2pMsgRxCbFn)(p2pInfo* p2p, char* msg, uint8_t* payload, uint8_t len);
 typedef void (*p2pMsgTxCbFn)(p2pInfo* p2p, messageStatus_t status);
 
+// A reliable message which was sent and is waiting for an ACK
+typedef struct
+{
+    p2pInfo* p2p;
+    bool inUse;
+    uint8_t msg[P2P_MAX_PACKET_LEN];
+    uint16_t len;
+    uint32_t firstSentUs;
+    uint8_t retries;
+    void (*SuccessFn)(void*);
+    void (*FailureFn)(void*);
+    p2pMsgTxCbFn msgTxCbFns[P2P_AGG_MAX_MSGS]; // One per message in the packet
+    uint8_t numMsgs;
+    timer_t retry;
+} p2pTxSlot_t;
+
+// A reliable message which was received ahead of one before it
+typedef struct
+{
+    bool present;
+    uint8_t msg[P2P_MAX_PACKET_LEN];
+    uint8_t len;
+} p2pRxSlot_t;
+
+// Connection quality statistics, see p2pGetStats(). Counts are of reliable
+// packets, which may hold several messages, and include the connection's own
+// start messages
+typedef struct
+{
+    uint32_t msgsSent;      // Reliable packets sent, not counting retries
+    uint32_t msgsAcked;     // Reliable packets which were ACKed
+    uint32_t msgsFailed;    // Reliable packets which were given up on
+    uint32_t retries;       // Retransmissions of reliable packets
+    uint32_t msgsReceived;  // Reliable packets received in order
+    uint32_t msgsDuplicate; // Reliable packets received more than once
+    uint32_t srttUs;        // The smoothed round trip time, 0 before the first ACK
+    uint32_t rttvarUs;      // The smoothed round trip time variance
+    uint32_t rtoMs;         // The current retry timeout, before backoff
+} p2pStats_t;
+
 // Variables to track acking messages
 typedef struct _p2pInfo
 {
-    // Messages that every mode uses
+    // The three character message ID, null terminated
     char msgId[4];
-    char conMsg[8];
-    char ackMsg[32];
-    char startMsg[32];
 
     // Callback function pointers
     p2pConCbFn conCbFn;
     p2pMsgRxCbFn msgRxCbFn;
-    p2pMsgTxCbFn msgTxCbFn;
 
     uint8_t connectionRssi;
 
-    // Variables used for acking and retrying messages
+    // Reliable messages waiting for an ACK, indexed by sequence number
+    struct
+    {
+        p2pTxSlot_t slots[P2P_WINDOW_SIZE];
+        uint8_t nextSeq;
+        uint8_t base; // The oldest unACKed sequence number
+        p2pTxSlot_t* lastSent;
+    } tx;
+
+    // Reliable messages received ahead of order, indexed by sequence number
     struct
     {
-        bool isWaitingForAck;
-        char msgToAck[64];
-        uint16_t msgToAckLen;
-        uint32_t timeSentUs;
-        void (*SuccessFn)(void*);
-        void (*FailureFn)(void*);
-    } ack;
+        p2pRxSlot_t slots[P2P_WINDOW_SIZE];
+        uint8_t nextSeq; // The next sequence number to deliver
+    } rx;
+
+    // Messages from the mode waiting to be sent together, as p2pAggRec_t
+    struct
+    {
+        uint8_t recs[sizeof(p2pAggRec_t) + P2P_MAX_PAYLOAD_LEN];
+        uint8_t len;
+        uint8_t numMsgs;
+        p2pMsgTxCbFn msgTxCbFns[P2P_AGG_MAX_MSGS];
+    } agg;
+
+    p2pStats_t stats;
 
     // Connection state variables
     struct
@@ -72,20 +171,17 @@ typedef struct _p2pInfo
         bool rxGameStartMsg;
         bool rxGameStartAck;
         playOrder_t playOrder;
-        char macStr[18];
+        uint8_t myMac[6];
         uint8_t otherMac[6];
         bool otherMacReceived;
-        uint8_t mySeqNum;
-        uint8_t lastSeqNum;
     } cnc;
 
-    // The timers used for connection and acking
+    // The timers used for connection
     struct
     {
-        timer_t TxRetry;
-        timer_t TxAllRetries;
         timer_t Connection;
         timer_t Reinit;
+        timer_t Aggregate;
     } tmr;
 } p2pInfo;
 
@@ -98,12 +194,15 @@ void ICACHE_FLASH_ATTR p2pRestart(void* arg);
 void ICACHE_FLASH_ATTR p2pStartConnection(p2pInfo* p2p);
 void ICACHE_FLASH_ATTR p2pStopConnection(p2pInfo* p2p);
 
-void ICACHE_FLASH_ATTR p2pSendMsg(p2pInfo* p2p, char* msg, char* payload, uint16_t len, p2pMsgTxCbFn msgTxCbFn);
+bool ICACHE_FLASH_ATTR p2pSendMsg(p2pInfo* p2p, char* msg, const uint8_t* payload, uint16_t len,
+                                  p2pMsgTxCbFn msgTxCbFn);
+bool ICACHE_FLASH_ATTR p2pFlushMsgs(p2pInfo* p2p);
 void ICACHE_FLASH_ATTR p2pSendCb(p2pInfo* p2p, uint8_t* mac_addr, mt_tx_status status);
 void ICACHE_FLASH_ATTR p2pRecvCb(p2pInfo* p2p, uint8_t* mac_addr, uint8_t* data, uint8_t len, uint8_t rssi);
 
 playOrder_t ICACHE_FLASH_ATTR p2pGetPlayOrder(p2pInfo* p2p);
 void ICACHE_FLASH_ATTR p2pSetPlayOrder(p2pInfo* p2p, playOrder_t order);
+const p2pStats_t* ICACHE_FLASH_ATTR p2pGetStats(p2pInfo* p2p);
 
 #endif // P2P_ENABLED
 
@@ -0,0 +1,613 @@
+#ifdef P2P_ENABLED
+
+/*============================================================================
+ * Includes
+ *==========================================================================*/
+
+#include <osapi.h>
+#include <user_interface.h>
+#include <mem.h>
+
+#include "user_main.h"
+#include "p2pSession.h"
+#include "printControl.h"
+
+/*============================================================================
+ * Defines
+ *==========================================================================*/
+
+// How often ACKs are sent, messages are retried, and peers are checked
+#define P2P_SES_TICK_MS 10
+
+// How often to broadcast a HELLO so peers can find this swadge
+#define P2P_SES_HELLO_MS 500
+
+// How long to wait for every peer to ACK before retrying a message. This
+// leaves time for a few ticks' worth of ACKs
+#define P2P_SES_RETRY_MS 40
+
+// The time we'll spend retrying messages
+#define P2P_SES_GIVE_UP_MS 3000
+
+// How long a peer can go without being heard before it's removed. This is
+// several HELLOs, so a few lost packets won't remove a peer
+#define P2P_SES_PEER_TIMEOUT_MS 3000
+
+#define P2P_SES_NO_PEER 0xFF
+
+// Sequence numbers are eight bits and wrap, so compare them as signed
+// differences. This is negative if a is before b
+#define SEQ_DIFF(a, b) ((int8_t)((uint8_t)(a) - (uint8_t)(b)))
+
+_Static_assert(P2P_SES_MAX_PEERS <= 8, "Peer bitmaps only have eight bits");
+_Static_assert(0 == (P2P_SES_BUCKETS & (P2P_SES_BUCKETS - 1)), "P2P_SES_BUCKETS must be a power of two");
+_Static_assert(0 == (256 % P2P_SES_WINDOW_SIZE), "P2P_SES_WINDOW_SIZE must divide 256");
+_Static_assert(sizeof(p2pSesHdr_t) + (P2P_SES_MAX_PEERS * sizeof(p2pSesAck_t)) <= 250,
+               "ACKs for every peer must fit in one packet");
+
+/*============================================================================
+ * Function Prototypes
+ *==========================================================================*/
+
+void ICACHE_FLASH_ATTR p2pSessionTick(void* arg);
+static uint8_t ICACHE_FLASH_ATTR sesHashMac(const uint8_t* mac);
+static int8_t ICACHE_FLASH_ATTR sesFindPeer(p2pSession* ses, const uint8_t* mac);
+static int8_t ICACHE_FLASH_ATTR sesAddPeer(p2pSession* ses, const uint8_t* mac, uint8_t rxNextSeq, uint8_t rssi);
+static void ICACHE_FLASH_ATTR sesRemovePeer(p2pSession* ses, uint8_t idx);
+static void ICACHE_FLASH_ATTR sesRebuildBuckets(p2pSession* ses);
+static void ICACHE_FLASH_ATTR sesSendHdr(p2pSession* ses, p2pSesPktType_t type, uint8_t* payload, uint8_t len);
+static void ICACHE_FLASH_ATTR sesSendSlot(p2pSession* ses, p2pSesTxSlot_t* slot);
+static void ICACHE_FLASH_ATTR sesRecvAck(p2pSession* ses, uint8_t idx, p2pSesAck_t* acks, uint8_t numAcks);
+
+/*============================================================================
+ * Functions
+ *==========================================================================*/
+
+/**
+ * @brief Initialize a multi-peer session and start looking for peers
+ *
+ * @param ses       The p2pSession struct with all the state information
+ * @param msgId     A three character, null terminated message ID. Must be
+ *                  unique per-swadge mode.
+ * @param peerCbFn  A function pointer which will be called when peers join or
+ *                  leave the session. May be NULL
+ * @param msgRxCbFn A function pointer which will be called when a message is
+ *                  received from a peer
+ * @param joinRssi  The strength needed for another swadge to join, 0 lets any
+ *                  swadge in range join
+ */
+void ICACHE_FLASH_ATTR p2pSessionInit(p2pSession* ses, char* msgId, p2pSesPeerCbFn peerCbFn,
+                                      p2pSesMsgRxCbFn msgRxCbFn, uint8_t joinRssi)
+{
+    // Make sure everything is zero!
+    ets_memset(ses, 0, sizeof(p2pSession));
+    ets_memset(ses->buckets, P2P_SES_NO_PEER, sizeof(ses->buckets));
+
+    ets_strncpy(ses->msgId, msgId, sizeof(ses->msgId));
+    ses->peerCbFn = peerCbFn;
+    ses->msgRxCbFn = msgRxCbFn;
+    ses->joinRssi = joinRssi;
+
+    // Get and save our MAC address, to find our ACKs from other swadges
+    wifi_get_macaddr(SOFTAP_IF, ses->myMac);
+
+    // Say hello on the first tick
+    ses->lastHelloUs = system_get_time() - (P2P_SES_HELLO_MS * 1000);
+
+    timerDisarm(&ses->tick);
+    timerSetFn(&ses->tick, p2pSessionTick, ses);
+    timerArm(&ses->tick, P2P_SES_TICK_MS, true);
+}
+
+/**
+ * Stop the session. Messages waiting for ACKs are dropped without callbacks
+ *
+ * @param ses The p2pSession struct with all the state information
+ */
+void ICACHE_FLASH_ATTR p2pSessionDeinit(p2pSession* ses)
+{
+    timerDisarm(&ses->tick);
+    ses->peerCbFn = NULL;
+    ses->msgRxCbFn = NULL;
+    ets_memset(ses->peers, 0, sizeof(ses->peers));
+    ets_memset(ses->buckets, P2P_SES_NO_PEER, sizeof(ses->buckets));
+    ets_memset(&ses->tx, 0, sizeof(ses->tx));
+}
+
+/**
+ * Broadcast a message to every peer in the session. It's retried until every
+ * current peer has ACKed it, and every peer receives messages in order
+ *
+ * @param ses       The p2pSession struct with all the state information
+ * @param msg       The mandatory three char message type
+ * @param payload   An optional binary message payload, may be NULL, up to
+ *                  P2P_SES_MAX_PAYLOAD_LEN bytes
+ * @param len       The length of the optional message payload. May be 0
+ * @param msgTxCbFn A callback function when every peer ACKs this message, or
+ *                  some peer doesn't. May be NULL
+ * @return true if the message was sent, false if the payload is too long or
+ *         P2P_SES_WINDOW_SIZE messages are already waiting for ACKs
+ */
+bool ICACHE_FLASH_ATTR p2pSessionSend(p2pSession* ses, char* msg, const uint8_t* payload, uint8_t len,
+                                      p2pSesMsgTxCbFn msgTxCbFn)
+{
+    if(NULL == payload)
+    {
+        len = 0;
+    }
+    else if(len > P2P_SES_MAX_PAYLOAD_LEN)
+    {
+        P2P_PRINTF("DISCARD: %d byte payload is too long\n", len);
+        return false;
+    }
+
+    if(SEQ_DIFF(ses->tx.nextSeq, ses->tx.base) >= P2P_SES_WINDOW_SIZE)
+    {
+        P2P_PRINTF("DISCARD: Window is full\n");
+        return false;
+    }
+
+    uint8_t seq = ses->tx.nextSeq++;
+    p2pSesTxSlot_t* slot = &ses->tx.slots[seq % P2P_SES_WINDOW_SIZE];
+
+    p2pSesHdr_t* hdr = (p2pSesHdr_t*)slot->msg;
+    ets_memcpy(hdr->msgId, ses->msgId, sizeof(hdr->msgId));
+    hdr->type = P2P_SES_PKT_MSG;
+    hdr->seq = seq;
+    ets_memcpy(hdr->cmd, msg, sizeof(hdr->cmd));
+    hdr->len = len;
+    if(len > 0)
+    {
+        ets_memcpy(&slot->msg[sizeof(p2pSesHdr_t)], payload, len);
+    }
+    slot->len = sizeof(p2pSesHdr_t) + len;
+
+    // Every peer known right now has to ACK this
+    slot->needMask = 0;
+    for(uint8_t i = 0; i < P2P_SES_MAX_PEERS; i++)
+    {
+        if(ses->peers[i].inUse)
+        {
+            slot->needMask |= (1 << i);
+        }
+    }
+    slot->ackedMask = 0;
+    slot->msgTxCbFn = msgTxCbFn;
+    slot->inUse = true;
+    slot->firstSentUs = system_get_time();
+
+    sesSendSlot(ses, slot);
+    return true;
+}
+
+/**
+ * This must be called whenever an ESP NOW packet is received
+ *
+ * @param ses      The p2pSession struct with all the state information
+ * @param mac_addr The MAC of the swadge that sent the data
+ * @param data     The data
+ * @param len      The length of the data
+ * @param rssi     The RSSI of th received message, a proxy for distance
+ */
+void ICACHE_FLASH_ATTR p2pSessionRecvCb(p2pSession* ses, uint8_t* mac_addr, uint8_t* data, uint8_t len,
+                                        uint8_t rssi)
+{
+    p2pSesHdr_t* hdr = (p2pSesHdr_t*)data;
+
+    // Check if this message matches our message ID
+    if(len < sizeof(p2pSesHdr_t) ||
+            (0 != ets_memcmp(hdr->msgId, ses->msgId, sizeof(hdr->msgId))))
+    {
+        P2P_PRINTF("DISCARD: Not a message for '%s'\n", ses->msgId);
+        return;
+    }
+
+    // Make sure the payload is all there
+    if(hdr->len > len - sizeof(p2pSesHdr_t))
+    {
+        P2P_PRINTF("DISCARD: Truncated payload\n");
+        return;
+    }
+
+    // Find the peer, or add it if it's close enough
+    int8_t idx = sesFindPeer(ses, mac_addr);
+    if(idx < 0)
+    {
+        if(rssi <= ses->joinRssi)
+        {
+            P2P_PRINTF("DISCARD: Too far away to join\n");
+            return;
+        }
+
+        // For a message, start with it. Otherwise start with the next one
+        idx = sesAddPeer(ses, mac_addr, hdr->seq, rssi);
+        if(idx < 0)
+        {
+            P2P_PRINTF("DISCARD: No room for another peer\n");
+            return;
+        }
+        if(NULL != ses->peerCbFn)
+        {
+            ses->peerCbFn(ses, &ses->peers[idx], PEER_JOINED);
+        }
+    }
+
+    p2pSesPeer_t* peer = &ses->peers[idx];
+    peer->lastHeardUs = system_get_time();
+    peer->rssi = ((3 * (uint16_t)peer->rssi) + rssi) / 4;
+
+    // Skip anything the peer gave up on
+    if(SEQ_DIFF(hdr->base, peer->rxNextSeq) > 0)
+    {
+        peer->rxNextSeq = hdr->base;
+    }
+
+    switch(hdr->type)
+    {
+        case P2P_SES_PKT_ACK:
+        {
+            sesRecvAck(ses, idx, (p2pSesAck_t*)&data[sizeof(p2pSesHdr_t)], hdr->len / sizeof(p2pSesAck_t));
+            break;
+        }
+        case P2P_SES_PKT_MSG:
+        {
+            // ACK everything, so a lost ACK is replaced
+            peer->ackPending = true;
+
+            int8_t diff = SEQ_DIFF(hdr->seq, peer->rxNextSeq);
+            if(diff < 0)
+            {
+                P2P_PRINTF("DISCARD: Old sequence number, ACK again\n");
+                peer->msgsDuplicate++;
+            }
+            else if(diff > 0)
+            {
+                // The peer retries everything after a gap, so just wait for it
+                P2P_PRINTF("DISCARD: Out of order\n");
+            }
+            else
+            {
+                peer->rxNextSeq++;
+                peer->msgsReceived++;
+                if(NULL != ses->msgRxCbFn)
+                {
+                    char msgType[4] = {0};
+                    ets_memcpy(msgType, hdr->cmd, sizeof(hdr->cmd));
+                    ses->msgRxCbFn(ses, peer, msgType, &data[sizeof(p2pSesHdr_t)], hdr->len);
+                }
+            }
+            break;
+        }
+        case P2P_SES_PKT_HELLO:
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * Find a peer by MAC
+ *
+ * @param ses The p2pSession struct with all the state information
+ * @param mac The peer's MAC
+ * @return The peer, or NULL if it isn't in the session
+ */
+p2pSesPeer_t* ICACHE_FLASH_ATTR p2pSessionGetPeer(p2pSession* ses, const uint8_t* mac)
+{
+    int8_t idx = sesFindPeer(ses, mac);
+    return (idx < 0) ? NULL : &ses->peers[idx];
+}
+
+/**
+ * @param ses The p2pSession struct with all the state information
+ * @return The number of peers in the session, not counting this swadge
+ */
+uint8_t ICACHE_FLASH_ATTR p2pSessionNumPeers(p2pSession* ses)
+{
+    uint8_t numPeers = 0;
+    for(uint8_t i = 0; i < P2P_SES_MAX_PEERS; i++)
+    {
+        if(ses->peers[i].inUse)
+        {
+            numPeers++;
+        }
+    }
+    return numPeers;
+}
+
+/**
+ * Periodically remove peers which went away, finish or retry messages, send
+ * everyone's ACKs in one packet, and say hello
+ *
+ * @param arg The p2pSession struct with all the state information
+ */
+void ICACHE_FLASH_ATTR p2pSessionTick(void* arg)
+{
+    p2pSession* ses = (p2pSession*)arg;
+    uint32_t nowUs = system_get_time();
+
+    // Remove peers which haven't been heard from in a while
+    for(uint8_t i = 0; i < P2P_SES_MAX_PEERS; i++)
+    {
+        if(ses->peers[i].inUse && (nowUs - ses->peers[i].lastHeardUs) >= (P2P_SES_PEER_TIMEOUT_MS * 1000))
+        {
+            sesRemovePeer(ses, i);
+        }
+    }
+
+    // Finish messages every peer ACKed, give up on old ones and retry the
+    // rest. Callbacks may send more messages, so free the slots first
+    p2pSesMsgTxCbFn cbFns[P2P_SES_WINDOW_SIZE];
+    messageStatus_t cbStatus[P2P_SES_WINDOW_SIZE];
+    uint8_t numCbs = 0;
+    for(uint8_t seq = ses->tx.base; seq != ses->tx.nextSeq; seq++)
+    {
+        p2pSesTxSlot_t* slot = &ses->tx.slots[seq % P2P_SES_WINDOW_SIZE];
+        if(false == slot->inUse)
+        {
+            continue;
+        }
+
+        if(0 == (slot->needMask & ~slot->ackedMask))
+        {
+            cbStatus[numCbs] = MSG_ACKED;
+        }
+        else if((nowUs - slot->firstSentUs) >= (P2P_SES_GIVE_UP_MS * 1000))
+        {
+            P2P_PRINTF("Message totally failed, seq %d\n", seq);
+            cbStatus[numCbs] = MSG_FAILED;
+        }
+        else
+        {
+            if((nowUs - slot->lastSentUs) >= (P2P_SES_RETRY_MS * 1000))
+            {
+                sesSendSlot(ses, slot);
+            }
+            continue;
+        }
+
+        cbFns[numCbs++] = slot->msgTxCbFn;
+        slot->inUse = false;
+    }
+    while(ses->tx.base != ses->tx.nextSeq && false == ses->tx.slots[ses->tx.base % P2P_SES_WINDOW_SIZE].inUse)
+    {
+        ses->tx.base++;
+    }
+
+    // ACK every peer in one packet if any of them sent something
+    bool ackPending = false;
+    for(uint8_t i = 0; i < P2P_SES_MAX_PEERS; i++)
+    {
+        ackPending |= (ses->peers[i].inUse && ses->peers[i].ackPending);
+    }
+    if(ackPending)
+    {
+        p2pSesAck_t acks[P2P_SES_MAX_PEERS];
+        uint8_t numAcks = 0;
+        for(uint8_t i = 0; i < P2P_SES_MAX_PEERS; i++)
+        {
+            if(ses->peers[i].inUse)
+            {
+                ets_memcpy(acks[numAcks].mac, ses->peers[i].mac, sizeof(acks[numAcks].mac));
+                acks[numAcks].nextSeq = ses->peers[i].rxNextSeq;
+                numAcks++;
+                ses->peers[i].ackPending = false;
+            }
+        }
+        sesSendHdr(ses, P2P_SES_PKT_ACK, (uint8_t*)acks, numAcks * sizeof(p2pSesAck_t));
+    }
+    // ACKs let peers know this swadge is here too, so only HELLO without them
+    else if((nowUs - ses->lastHelloUs) >= (P2P_SES_HELLO_MS * 1000))
+    {
+        sesSendHdr(ses, P2P_SES_PKT_HELLO, NULL, 0);
+    }
+
+    for(uint8_t i = 0; i < numCbs; i++)
+    {
+        if(NULL != cbFns[i])
+        {
+            cbFns[i](ses, cbStatus[i]);
+        }
+    }
+}
+
+/**
+ * @param mac A MAC address
+ * @return The first bucket to look for that MAC in, from an FNV-1a hash
+ */
+static uint8_t ICACHE_FLASH_ATTR sesHashMac(const uint8_t* mac)
+{
+    uint32_t hash = 2166136261u;
+    for(uint8_t i = 0; i < 6; i++)
+    {
+        hash = (hash ^ mac[i]) * 16777619u;
+    }
+    return hash & (P2P_SES_BUCKETS - 1);
+}
+
+/**
+ * Look up a peer's index in the hash table, probing linearly from its bucket
+ *
+ * @param ses The p2pSession struct with all the state information
+ * @param mac The peer's MAC
+ * @return The peer's index, or -1 if it isn't in the session
+ */
+static int8_t ICACHE_FLASH_ATTR sesFindPeer(p2pSession* ses, const uint8_t* mac)
+{
+    uint8_t bucket = sesHashMac(mac);
+    for(uint8_t probes = 0; probes < P2P_SES_BUCKETS; probes++)
+    {
+        uint8_t idx = ses->buckets[bucket];
+        if(P2P_SES_NO_PEER == idx)
+        {
+            break;
+        }
+        if(0 == ets_memcmp(ses->peers[idx].mac, mac, sizeof(ses->peers[idx].mac)))
+        {
+            return idx;
+        }
+        bucket = (bucket + 1) & (P2P_SES_BUCKETS - 1);
+    }
+    return -1;
+}
+
+/**
+ * Add a peer in the first free index and put it in the hash table
+ *
+ * @param ses       The p2pSession struct with all the state information
+ * @param mac       The peer's MAC
+ * @param rxNextSeq The first message to expect from the peer
+ * @param rssi      The peer's RSSI
+ * @return The peer's index, or -1 if the session is full
+ */
+static int8_t ICACHE_FLASH_ATTR sesAddPeer(p2pSession* ses, const uint8_t* mac, uint8_t rxNextSeq, uint8_t rssi)
+{
+    for(uint8_t idx = 0; idx < P2P_SES_MAX_PEERS; idx++)
+    {
+        p2pSesPeer_t* peer = &ses->peers[idx];
+        if(false == peer->inUse)
+        {
+            ets_memset(peer, 0, sizeof(p2pSesPeer_t));
+            ets_memcpy(peer->mac, mac, sizeof(peer->mac));
+            peer->rxNextSeq = rxNextSeq;
+            peer->rssi = rssi;
+            peer->inUse = true;
+
+            // There are more buckets than peers, so there's always an empty one
+            uint8_t bucket = sesHashMac(mac);
+            while(P2P_SES_NO_PEER != ses->buckets[bucket])
+            {
+                bucket = (bucket + 1) & (P2P_SES_BUCKETS - 1);
+            }
+            ses->buckets[bucket] = idx;
+
+            P2P_PRINTF("Peer %d joined %02X:%02X:%02X:%02X:%02X:%02X\n", idx,
+                       mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+            return idx;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Remove a peer, so messages don't wait for its ACKs anymore
+ *
+ * @param ses The p2pSession struct with all the state information
+ * @param idx The peer's index
+ */
+static void ICACHE_FLASH_ATTR sesRemovePeer(p2pSession* ses, uint8_t idx)
+{
+    P2P_PRINTF("Peer %d left\n", idx);
+
+    if(NULL != ses->peerCbFn)
+    {
+        ses->peerCbFn(ses, &ses->peers[idx], PEER_LEFT);
+    }
+
+    ses->peers[idx].inUse = false;
+    for(uint8_t i = 0; i < P2P_SES_WINDOW_SIZE; i++)
+    {
+        ses->tx.slots[i].needMask &= ~(1 << idx);
+    }
+
+    // Linear probing can't just empty a bucket, later peers may have probed
+    // past it. There are only a few peers, so rebuild the whole table
+    sesRebuildBuckets(ses);
+}
+
+/**
+ * Rebuild the hash table from the peers in use
+ *
+ * @param ses The p2pSession struct with all the state information
+ */
+static void ICACHE_FLASH_ATTR sesRebuildBuckets(p2pSession* ses)
+{
+    ets_memset(ses->buckets, P2P_SES_NO_PEER, sizeof(ses->buckets));
+    for(uint8_t idx = 0; idx < P2P_SES_MAX_PEERS; idx++)
+    {
+        if(ses->peers[idx].inUse)
+        {
+            uint8_t bucket = sesHashMac(ses->peers[idx].mac);
+            while(P2P_SES_NO_PEER != ses->buckets[bucket])
+            {
+                bucket = (bucket + 1) & (P2P_SES_BUCKETS - 1);
+            }
+            ses->buckets[bucket] = idx;
+        }
+    }
+}
+
+/**
+ * Broadcast a HELLO or ACK, which are never retried
+ *
+ * @param ses     The p2pSession struct with all the state information
+ * @param type    The type of packet to send
+ * @param payload The payload, may be NULL
+ * @param len     The length of the payload
+ */
+static void ICACHE_FLASH_ATTR sesSendHdr(p2pSession* ses, p2pSesPktType_t type, uint8_t* payload, uint8_t len)
+{
+    uint8_t pkt[250];
+    p2pSesHdr_t* hdr = (p2pSesHdr_t*)pkt;
+    ets_memset(hdr, 0, sizeof(p2pSesHdr_t));
+    ets_memcpy(hdr->msgId, ses->msgId, sizeof(hdr->msgId));
+    hdr->type = type;
+    hdr->seq = ses->tx.nextSeq;
+    hdr->base = ses->tx.base;
+    hdr->len = len;
+    if(len > 0)
+    {
+        ets_memcpy(&pkt[sizeof(p2pSesHdr_t)], payload, len);
+    }
+
+    // Anything sent lets peers know this swadge is here
+    ses->lastHelloUs = system_get_time();
+    espNowSend(pkt, sizeof(p2pSesHdr_t) + len);
+}
+
+/**
+ * Broadcast, or rebroadcast, a message waiting for ACKs
+ *
+ * @param ses  The p2pSession struct with all the state information
+ * @param slot The window slot with the message to send
+ */
+static void ICACHE_FLASH_ATTR sesSendSlot(p2pSession* ses, p2pSesTxSlot_t* slot)
+{
+    // Let peers know what they don't need to wait for anymore
+    ((p2pSesHdr_t*)slot->msg)->base = ses->tx.base;
+
+    slot->lastSentUs = system_get_time();
+    ses->lastHelloUs = slot->lastSentUs;
+    espNowSend(slot->msg, slot->len);
+}
+
+/**
+ * Find this swadge's entry in a peer's ACK packet, and mark every message it
+ * covers as ACKed by that peer
+ *
+ * @param ses     The p2pSession struct with all the state information
+ * @param idx     The index of the peer which sent the ACKs
+ * @param acks    The ACK entries, one per peer that peer has heard from
+ * @param numAcks The number of ACK entries
+ */
+static void ICACHE_FLASH_ATTR sesRecvAck(p2pSession* ses, uint8_t idx, p2pSesAck_t* acks, uint8_t numAcks)
+{
+    for(uint8_t i = 0; i < numAcks; i++)
+    {
+        if(0 == ets_memcmp(acks[i].mac, ses->myMac, sizeof(ses->myMac)))
+        {
+            for(uint8_t seq = ses->tx.base; seq != ses->tx.nextSeq; seq++)
+            {
+                p2pSesTxSlot_t* slot = &ses->tx.slots[seq % P2P_SES_WINDOW_SIZE];
+                if(slot->inUse && SEQ_DIFF(seq, acks[i].nextSeq) < 0)
+                {
+                    slot->ackedMask |= (1 << idx);
+                }
+            }
+            return;
+        }
+    }
+}
+
+#endif // P2P_ENABLED
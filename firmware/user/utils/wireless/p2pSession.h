@@ -0,0 +1,137 @@
+#ifndef _P2P_SESSION_H_
+#define _P2P_SESSION_H_
+
+#ifdef P2P_ENABLED
+
+#include <osapi.h>
+#include "user_main.h"
+#include "p2pConnection.h"
+
+/*
+ * A session between up to P2P_SES_MAX_PEERS other swadges, for games with more
+ * than two players. Where p2pConnection pairs two swadges with unicast
+ * messages, every session packet is broadcast once and received by every peer.
+ *
+ * Peers are found from HELLO beacons and kept in a small table hashed by MAC.
+ * Each sent message is retried until every peer which was known when it was
+ * sent has ACKed it, tracked as a bitmap of peers. Rather than ACKing each
+ * peer separately, every swadge periodically broadcasts one ACK packet with
+ * the next sequence number it expects from each peer it has heard from, so N
+ * swadges send N ACKs per tick instead of N * (N - 1).
+ *
+ * Messages from each peer are delivered in order, once. A peer which isn't
+ * heard from for P2P_SES_PEER_TIMEOUT_MS is removed and no longer holds up
+ * messages.
+ */
+
+#define P2P_SES_MAX_PEERS 8
+
+// The peer hash table has twice as many buckets as peers, so probes are short
+#define P2P_SES_BUCKETS (2 * P2P_SES_MAX_PEERS)
+
+// How many broadcast messages can be waiting for ACKs at once
+#define P2P_SES_WINDOW_SIZE 4
+
+typedef enum
+{
+    P2P_SES_PKT_HELLO, // A beacon so peers can find each other
+    P2P_SES_PKT_ACK,   // ACKs for every peer, see p2pSesAck_t
+    P2P_SES_PKT_MSG    // A message from the Swadge mode, for every peer
+} p2pSesPktType_t;
+
+// The header at the start of every session packet
+typedef struct __attribute__((packed))
+{
+    char msgId[3]; // The Swadge mode's message ID, not null terminated
+    uint8_t type;  // A p2pSesPktType_t
+    uint8_t seq;   // This message's sequence number, or the next one for other types
+    uint8_t base;  // The sender's oldest message which some peer hasn't ACKed
+    char cmd[3];   // The mode's message type for P2P_SES_PKT_MSG, not null terminated
+    uint8_t len;   // The length of the payload which follows
+} p2pSesHdr_t;
+
+// A P2P_SES_PKT_ACK payload is one of these per peer heard from
+typedef struct __attribute__((packed))
+{
+    uint8_t mac[6];  // The peer being ACKed
+    uint8_t nextSeq; // Every message from that peer before this was received
+} p2pSesAck_t;
+
+#define P2P_SES_MAX_PAYLOAD_LEN (250 - sizeof(p2pSesHdr_t))
+
+typedef struct _p2pSession p2pSession;
+
+typedef struct
+{
+    bool inUse;
+    uint8_t mac[6];
+    uint8_t rssi;       // A running average of this peer's RSSI
+    uint8_t rxNextSeq;  // The next message expected from this peer
+    bool ackPending;    // If this peer should be ACKed on the next tick
+    uint32_t lastHeardUs;
+    uint32_t msgsReceived;
+    uint32_t msgsDuplicate;
+} p2pSesPeer_t;
+
+typedef enum
+{
+    PEER_JOINED,
+    PEER_LEFT
+} p2pSesPeerEvt_t;
+
+typedef void (*p2pSesPeerCbFn)(p2pSession* ses, p2pSesPeer_t* peer, p2pSesPeerEvt_t evt);
+typedef void (*p2pSesMsgRxCbFn)(p2pSession* ses, p2pSesPeer_t* peer, char* msg, uint8_t* payload, uint8_t len);
+typedef void (*p2pSesMsgTxCbFn)(p2pSession* ses, messageStatus_t status);
+
+// A broadcast message waiting for ACKs
+typedef struct
+{
+    bool inUse;
+    uint8_t msg[250];
+    uint8_t len;
+    uint8_t needMask;  // The peers which must ACK this, by index
+    uint8_t ackedMask; // The peers which have ACKed this, by index
+    uint32_t firstSentUs;
+    uint32_t lastSentUs;
+    p2pSesMsgTxCbFn msgTxCbFn;
+} p2pSesTxSlot_t;
+
+typedef struct _p2pSession
+{
+    // The three character message ID, null terminated
+    char msgId[4];
+    uint8_t myMac[6];
+    uint8_t joinRssi;
+
+    p2pSesPeerCbFn peerCbFn;
+    p2pSesMsgRxCbFn msgRxCbFn;
+
+    // Peers by index. The index is the peer's bit in needMask and ackedMask
+    p2pSesPeer_t peers[P2P_SES_MAX_PEERS];
+    // Open addressed hash table of peer indices, keyed by MAC
+    uint8_t buckets[P2P_SES_BUCKETS];
+
+    struct
+    {
+        p2pSesTxSlot_t slots[P2P_SES_WINDOW_SIZE];
+        uint8_t nextSeq;
+        uint8_t base;
+    } tx;
+
+    uint32_t lastHelloUs;
+    timer_t tick;
+} p2pSession;
+
+void ICACHE_FLASH_ATTR p2pSessionInit(p2pSession* ses, char* msgId, p2pSesPeerCbFn peerCbFn,
+                                      p2pSesMsgRxCbFn msgRxCbFn, uint8_t joinRssi);
+void ICACHE_FLASH_ATTR p2pSessionDeinit(p2pSession* ses);
+bool ICACHE_FLASH_ATTR p2pSessionSend(p2pSession* ses, char* msg, const uint8_t* payload, uint8_t len,
+                                      p2pSesMsgTxCbFn msgTxCbFn);
+void ICACHE_FLASH_ATTR p2pSessionRecvCb(p2pSession* ses, uint8_t* mac_addr, uint8_t* data, uint8_t len,
+                                        uint8_t rssi);
+p2pSesPeer_t* ICACHE_FLASH_ATTR p2pSessionGetPeer(p2pSession* ses, const uint8_t* mac);
+uint8_t ICACHE_FLASH_ATTR p2pSessionNumPeers(p2pSession* ses);
+
+#endif // P2P_ENABLED
+
+#endif
@@ -1,166 +1,144 @@
-package com.gelakinetic.magfont;
-
-import java.awt.image.BufferedImage;
-import java.io.BufferedWriter;
-import java.io.File;
-import java.io.FileWriter;
-import java.io.IOException;
-
-import javax.imageio.ImageIO;
-
-public class Magfont {
-
-    private static final String chars = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
-
-    private static void writeFontFiles(File imageFile, String fontName) {
-        int xInd = 0;
-        int charsIdx = 0;
-        try (BufferedWriter cFontFile = new BufferedWriter(new FileWriter(fontName + ".c"));
-             BufferedWriter hFontFile = new BufferedWriter(new FileWriter(fontName + ".h"))) {
-
-            BufferedImage bi = ImageIO.read(imageFile);
-
-            int fontHeight = bi.getHeight() - 2;
-
-            hFontFile.write("#ifndef " + fontName.toUpperCase() + "_H \n");
-            hFontFile.write("#define " + fontName.toUpperCase() + "_H \n");
-            hFontFile.write("\n");
-            hFontFile.write("#include \"font.h\"\n");
-            hFontFile.write("\n");
-            hFontFile.write("#define FONT_HEIGHT_" + fontName.toUpperCase() + " " + fontHeight + "\n");
-            hFontFile.write("\n");
-            hFontFile.write("extern sprite_t font_" + fontName + "[];\n");
-//            hFontFile.write("uint8_t plotChar" + fontName + "(bool dispBuffer[WIDTH][HEIGHT], uint8_t x, uint8_t y, char character);\n");
-            hFontFile.write("\n");
-            hFontFile.write("#endif\n");
-
-//            System.out.print(
-//                    "typedef struct {\n"
-//                            + "    uint8_t  width;\n"
-//                            + "    uint16_t data[FONT_HEIGHT];\n"
-//                            + "} sprite_t;\n\n");
-
-            cFontFile.write("#include \"" + fontName + ".h\"\n");
-            cFontFile.write("\n");
-            cFontFile.write("sprite_t font_" + fontName + "[] = {\n");
-
-            // Scan over the whole bitmap
-            while (xInd < bi.getWidth()) {
-                int charStartX = xInd;
-
-                // Scan the line under each char to see how wide it is
-                int charWidth = 0;
-                while (xInd < bi.getWidth() && 0 == (bi.getRGB(xInd, fontHeight + 1) & 0x00FFFFFF)) {
-                    xInd++;
-                    charWidth++;
-                }
-
-                // Scan the char above the line
-                int[] rowData = new int[fontHeight];
-                for (int charY = 0; charY < fontHeight; charY++) {
-                    rowData[charY] = 0;
-                    for (int charX = charStartX; charX < xInd; charX++) {
-                        rowData[charY] <<= 1;
-                        if (0 == (bi.getRGB(charX, charY) & 0x00FFFFFF)) {
-                            rowData[charY] |= 1;
-//                            System.out.print("X");
-                        } else {
-//                            System.out.print(" ");
-                        }
-                    }
-//                    System.out.print("\n");
-                }
-//                System.out.print("\n");
-
-                String charName = toCamelCase(Character.getName(chars.charAt(charsIdx)));
-                cFontFile.write(
-                        "    {\n"
-                                + "        .width = " + charWidth + ",\n"
-                                + "        .data = {\n");
-                for (int i = 0; i < fontHeight; i++) {
-                    cFontFile.write("            0b" + String.format("%16s", Integer.toBinaryString(rowData[i])).replace(' ', '0') + ", \n");
-                }
-                cFontFile.write(
-                        "         },\n"
-                                + "    },\n");
-                xInd++;
-                charsIdx++;
-
-                while (xInd < bi.getWidth() &&
-                        0 != (bi.getRGB(xInd, fontHeight + 1) & 0x00FFFFFF)) {
-                    xInd++;
-                }
-            }
-
-            cFontFile.write("};\n");
-            cFontFile.write("\n");
-//            cFontFile.write("uint8_t plotChar" + fontName + "(bool dispBuffer[WIDTH][HEIGHT], uint8_t x, uint8_t y, char character) {\n");
-//            cFontFile.write("	if('a' <= character && character <= 'z') {\n");
-//            cFontFile.write("		character = (char)(character - 'a' + 'A');\n");
-//            cFontFile.write("	}\n");
-//            cFontFile.write("	const sprite_t * sprite = &font_" + fontName + "[character - ' '];\n");
-//            cFontFile.write("\n");
-//            cFontFile.write("	for (uint8_t charX = 0; charX < sprite->width; charX++) {\n");
-//            cFontFile.write("		for (uint8_t charY = 0; charY < FONT_HEIGHT_" + fontName.toUpperCase() + "; charY++) {\n");
-//            cFontFile.write("			uint8_t xPx = (uint8_t)(x + (sprite->width - charX) - 1);\n");
-//            cFontFile.write("			uint8_t yPx = (uint8_t)(y + charY);\n");
-//            cFontFile.write("			if (xPx < WIDTH && yPx < HEIGHT) {\n");
-//            cFontFile.write("				if (0 != (sprite->data[charY] & (1 << charX))) {\n");
-//            cFontFile.write("					dispBuffer[xPx][yPx] = true;\n");
-//            cFontFile.write("				} else {\n");
-//            cFontFile.write("					dispBuffer[xPx][yPx] = false;\n");
-//            cFontFile.write("				}\n");
-//            cFontFile.write("			}\n");
-//            cFontFile.write("		}\n");
-//            cFontFile.write("	}\n");
-//            cFontFile.write("\n");
-//            cFontFile.write("	return (uint8_t)(x + sprite->width + 1);\n");
-//            cFontFile.write("}\n");
-
-//            System.out.print("const sprite_t * charMap[95] = {0};\n");
-//            System.out.print("void initCharMap(void) {\n");
-//            for (charsIdx = 0; charsIdx < chars.length(); charsIdx++) {
-//                System.out.print("    charMap['" + chars.charAt(charsIdx) + "' - ' '] = &"
-//                        + toCamelCase(Character.getName(chars.charAt(charsIdx))) + ";\n");
-//                if (Character.isAlphabetic(chars.charAt(charsIdx))) {
-//                    System.out.print("    charMap['" + Character.toLowerCase(chars.charAt(charsIdx)) + "' - ' '] = &"
-//                            + toCamelCase(Character.getName(chars.charAt(charsIdx))) + ";\n");
-//                }
-//            }
-//            System.out.print("}\n\n");
-//
-//            System.out.print("const sprite_t * getCharSprite(char character) {\n");
-//            System.out.print("    if (' ' <= character && character <= '~') {\n");
-//            System.out.print("        return charMap[character - ' '];\n");
-//            System.out.print("    }\n");
-//            System.out.print("    return NULL;\n");
-//            System.out.print("}\n");
-
-        } catch (IOException e) {
-            e.printStackTrace();
-        }
-    }
-
-    public static void main(String[] args) {
-        writeFontFiles(new File("radiostars_12_clean_round_thin.bmp"), "Radiostars");
-        writeFontFiles(new File("tom_thumb.bmp"), "TomThumb");
-        writeFontFiles(new File("ibm_vga_8.bmp"), "IbmVga8");
-    }
-
-    private static String toCamelCase(final String init) {
-        if (init == null) {
-            return null;
-        }
-
-        final StringBuilder ret = new StringBuilder(init.length());
-
-        for (final String word : init.split("[ -]")) {
-            if (!word.isEmpty()) {
-                ret.append(Character.toUpperCase(word.charAt(0)));
-                ret.append(word.substring(1).toLowerCase());
-            }
-        }
-
-        return ret.toString();
-    }
-}
+package com.gelakinetic.magfont;
+
+import java.awt.image.BufferedImage;
+import java.io.BufferedWriter;
+import java.io.File;
+import java.io.FileWriter;
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+
+import javax.imageio.ImageIO;
+
+public class Magfont {
+
+    private static final String chars = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+
+    private static void writeFontFiles(File imageFile, String fontName) {
+        int xInd = 0;
+        try (BufferedWriter cFontFile = new BufferedWriter(new FileWriter(fontName + ".c"))) {
+
+            BufferedImage bi = ImageIO.read(imageFile);
+
+            int fontHeight = bi.getHeight() - 2;
+            // Columns are packed like the OLED framebuffer, eight rows to a byte
+            int pages = (fontHeight + 7) / 8;
+
+            List<Integer> widths = new ArrayList<>();
+            List<int[]> columns = new ArrayList<>();
+
+            // Scan over the whole bitmap
+            while (xInd < bi.getWidth()) {
+                int charStartX = xInd;
+
+                // Scan the line under each char to see how wide it is
+                int charWidth = 0;
+                while (xInd < bi.getWidth() && 0 == (bi.getRGB(xInd, fontHeight + 1) & 0x00FFFFFF)) {
+                    xInd++;
+                    charWidth++;
+                }
+
+                // Scan the char above the line, a column at a time, top row in bit 0
+                int[] colData = new int[charWidth];
+                for (int charX = 0; charX < charWidth; charX++) {
+                    for (int charY = 0; charY < fontHeight; charY++) {
+                        if (0 == (bi.getRGB(charStartX + charX, charY) & 0x00FFFFFF)) {
+                            colData[charX] |= (1 << charY);
+                        }
+                    }
+                }
+                widths.add(charWidth);
+                columns.add(colData);
+                xInd++;
+
+                while (xInd < bi.getWidth() &&
+                        0 != (bi.getRGB(xInd, fontHeight + 1) & 0x00FFFFFF)) {
+                    xInd++;
+                }
+            }
+
+            // Bitmaps without lowercase draw it as uppercase
+            String drawn = (widths.size() == chars.length()) ? chars : chars.replaceAll("[a-z]", "");
+
+            cFontFile.write("#include \"font.h\"\n");
+            cFontFile.write("\n");
+            cFontFile.write("#if defined(FEATURE_OLED)\n");
+            cFontFile.write("\n");
+            cFontFile.write("// Each glyph's columns, left to right. Columns are packed like the framebuffer,\n");
+            cFontFile.write("// " + pages + " byte" + (pages == 1 ? "" : "s") + " of eight rows each, with the top row in bit 0\n");
+            cFontFile.write("// It's read a word at a time, so it's aligned and padded to a whole word on\n");
+            cFontFile.write("// every build, not just where RODATA_ATTR aligns it\n");
+            cFontFile.write("static const uint8_t font_" + fontName + "_cols[] __attribute__((aligned(4))) RODATA_ATTR =\n");
+            cFontFile.write("{\n");
+            int[] offsets = new int[widths.size()];
+            int offset = 0;
+            for (int glyph = 0; glyph < widths.size(); glyph++) {
+                offsets[glyph] = offset;
+                cFontFile.write("    // '" + escape(drawn.charAt(glyph)) + "'\n");
+                List<String> bytes = new ArrayList<>();
+                for (int col : columns.get(glyph)) {
+                    for (int page = 0; page < pages; page++) {
+                        bytes.add(String.format("0x%02X", (col >> (8 * page)) & 0xFF));
+                    }
+                }
+                for (int i = 0; i < bytes.size(); i += 8) {
+                    cFontFile.write("    " + String.join(", ", bytes.subList(i, Math.min(i + 8, bytes.size()))) + ",\n");
+                }
+                offset += bytes.size();
+            }
+            if (0 != offset % 4) {
+                cFontFile.write("    // Padding to a whole word\n");
+                cFontFile.write("    " + String.join(", ", Collections.nCopies(4 - (offset % 4), "0x00")) + ",\n");
+            }
+            cFontFile.write("};\n");
+            cFontFile.write("\n");
+
+            cFontFile.write("// Where each character's columns start, how wide it is, and how far it moves\n");
+            cFontFile.write("// the cursor, from ' ' to '~'\n");
+            cFontFile.write("static const uint32_t font_" + fontName + "_glyphs[] RODATA_ATTR =\n");
+            cFontFile.write("{\n");
+            for (int charsIdx = 0; charsIdx < chars.length(); charsIdx++) {
+                char c = chars.charAt(charsIdx);
+                int glyph = drawn.indexOf(c);
+                if (glyph < 0) {
+                    glyph = drawn.indexOf(Character.toUpperCase(c));
+                }
+                int width = widths.get(glyph);
+                // One blank column between characters
+                int advance = width + 1;
+                cFontFile.write("    FONT_GLYPH(" + offsets[glyph] + ", " + width + ", " + advance + "), // '" + escape(c) + "'\n");
+            }
+            cFontFile.write("};\n");
+            cFontFile.write("\n");
+
+            cFontFile.write("const font_t font_" + fontName + " =\n");
+            cFontFile.write("{\n");
+            cFontFile.write("    .height = FONT_HEIGHT_" + fontName.toUpperCase() + ",\n");
+            cFontFile.write("    .pages = " + pages + ",\n");
+            cFontFile.write("    .glyphs = font_" + fontName + "_glyphs,\n");
+            cFontFile.write("    .cols = font_" + fontName + "_cols,\n");
+            cFontFile.write("};\n");
+            cFontFile.write("\n");
+            cFontFile.write("#endif\n");
+
+            // The height goes in font.h
+            System.out.println("#define FONT_HEIGHT_" + fontName.toUpperCase() + " " + fontHeight);
+        } catch (IOException e) {
+            e.printStackTrace();
+        }
+    }
+
+    private static String escape(char c) {
+        if ('\\' == c || '\'' == c) {
+            return "\\" + c;
+        }
+        return String.valueOf(c);
+    }
+
+    public static void main(String[] args) {
+        writeFontFiles(new File("radiostars_12_clean_round_thin.bmp"), "Radiostars");
+        writeFontFiles(new File("tom_thumb.bmp"), "TomThumb");
+        writeFontFiles(new File("ibm_vga_8.bmp"), "IbmVga8");
+    }
+}